@@ -83,6 +83,11 @@ function linkGoogleTest()
     links { "gtest", "gmock" }
 end
 
+-- Link Google Benchmark
+function linkGoogleBenchmark()
+    links { "benchmark" }
+end
+
 -- Link profiler dependencies
 function linkTracy()
     filter { "configurations:Profile" }
@@ -17,7 +17,8 @@ layout(set = 0, binding = 0) uniform DrawParams {
 
   TransformsArray skinnedMeshTransforms;
   EntitiesArray skinnedMeshEntities;
-  SkeletonsArray skeletons;
+  JointRangesArray skinnedMeshJoints;
+  JointsArray joints;
 
   TransformsArray textTransforms;
   EntitiesArray textEntities;
@@ -15,12 +15,9 @@ const vec2 positions[4] =
 void main() {
   mat4 modelMatrix = getSkinnedMeshTransform(gl_InstanceIndex).modelMatrix;
 
-  SkeletonItem item = getSkeleton(gl_InstanceIndex);
+  JointRangeItem joints = getJointRange(gl_InstanceIndex);
 
-  mat4 skinMatrix = inWeights.x * item.joints[inJoints.x] +
-                    inWeights.y * item.joints[inJoints.y] +
-                    inWeights.z * item.joints[inJoints.z] +
-                    inWeights.w * item.joints[inJoints.w];
+  mat4 skinMatrix = getSkinMatrix(joints, inJoints, inWeights);
 
   vec4 worldPosition =
       getCamera().viewProj * modelMatrix * skinMatrix * vec4(inPosition, 1.0f);
@@ -14,14 +14,16 @@ layout(set = 0, binding = 0) uniform DrawParameters {
   Camera camera;
   Empty gridData;
   TransformsArray outlineTransforms;
-  SkeletonsArray outlineSkeletons;
+  JointsArray outlineJoints;
   Empty glyphs;
 }
 uDrawParams;
 
 #define getOutlineTransform(index) uDrawParams.outlineTransforms.items[index]
 
-#define getOutlineSkeleton(index) uDrawParams.outlineSkeletons.items[index]
+#define getOutlineJoint(joint)                                                 \
+  uDrawParams.outlineJoints                                                    \
+      .items[uOutline.index.y + min(joint, uOutline.index.z - 1)]
 
 /**
  * @brief Push constant for color
@@ -34,12 +36,10 @@ layout(push_constant) uniform PushConstants {
 uOutline;
 
 void main() {
-  SkeletonItem item = getOutlineSkeleton(0);
-
-  mat4 skinMatrix = inWeights.x * item.joints[inJoints.x] +
-                    inWeights.y * item.joints[inJoints.y] +
-                    inWeights.z * item.joints[inJoints.z] +
-                    inWeights.w * item.joints[inJoints.w];
+  mat4 skinMatrix = inWeights.x * getOutlineJoint(inJoints.x) +
+                    inWeights.y * getOutlineJoint(inJoints.y) +
+                    inWeights.z * getOutlineJoint(inJoints.z) +
+                    inWeights.w * getOutlineJoint(inJoints.w);
 
   gl_Position = getCamera().viewProj *
                 getOutlineTransform(gl_InstanceIndex).modelMatrix * skinMatrix *
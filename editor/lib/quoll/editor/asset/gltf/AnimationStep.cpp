@@ -1,4 +1,5 @@
 #include "quoll/core/Base.h"
+#include "quoll/core/Engine.h"
 #include "AnimationStep.h"
 #include "Buffer.h"
 
@@ -225,6 +226,21 @@ void loadAnimations(GLTFImportData &importData) {
       continue;
     }
 
+    if (importData.optimize) {
+      AnimationCompressionSettings settings{};
+      auto it = importData.skeletons.animationCompression.find(
+          static_cast<u32>(targetSkin));
+      if (targetSkin >= 0 &&
+          it != importData.skeletons.animationCompression.end()) {
+        settings = it->second;
+      }
+
+      auto stats = AnimationCompression::compress(animation.data, settings);
+      Engine::getLogger().info()
+          << "Animation " << assetName << " compressed from "
+          << stats.rawSize << " to " << stats.compressedSize << " bytes";
+    }
+
     auto filePath = assetCache.createFromData(animation);
     auto ref = assetCache.request<AnimationAsset>(animation.uuid);
     if (!ref) {
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "quoll/animation/AnimationCompression.h"
 #include "quoll/asset/AssetCache.h"
 #include "quoll/editor/asset/ImageLoader.h"
 #include "quoll/editor/asset/UUIDMap.h"
@@ -17,6 +18,8 @@ struct SkeletonData {
   std::unordered_map<u32, u32> jointSkinMap;
 
   GLTFToAsset<AssetRef<SkeletonAsset>> skeletonMap;
+
+  std::unordered_map<u32, AnimationCompressionSettings> animationCompression;
 };
 
 struct AnimationData {
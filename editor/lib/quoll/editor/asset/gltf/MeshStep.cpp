@@ -422,6 +422,7 @@ void loadMeshes(GLTFImportData &importData) {
       }
 
       if (geometry.positions.size() > 0) {
+        geometry.bounds = BoundingBox::fromPoints(geometry.positions);
         mesh.data.geometries.push_back(geometry);
         materials.push_back(material);
       }
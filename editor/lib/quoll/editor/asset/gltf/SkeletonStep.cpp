@@ -5,6 +5,12 @@
 
 namespace quoll::editor {
 
+/**
+ * Skeletons smaller than this do not
+ * tighten animation position error further
+ */
+static constexpr f32 MinCompressionExtent = 0.1f;
+
 void loadSkeletons(GLTFImportData &importData) {
   auto &assetCache = importData.assetCache;
   const auto &model = importData.model;
@@ -121,6 +127,19 @@ void loadSkeletons(GLTFImportData &importData) {
       asset.data.jointParents.push_back(parent >= 0 ? parent : 0);
     }
 
+    // Position error of animations is relative to
+    // the size of the skeleton in bind pose
+    f32 extent = 0.0f;
+    for (const auto &inverseBindMatrix : inverseBindMatrices) {
+      const glm::vec3 position(glm::inverse(inverseBindMatrix)[3]);
+      extent = std::max(extent, glm::length(position));
+    }
+
+    AnimationCompressionSettings compression{};
+    compression.positionError *= std::max(extent, MinCompressionExtent);
+    importData.skeletons.animationCompression.insert_or_assign(si,
+                                                               compression);
+
     auto path = assetCache.createFromData(asset);
     auto ref = assetCache.request<SkeletonAsset>(asset.uuid);
 
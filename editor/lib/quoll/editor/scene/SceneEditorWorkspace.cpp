@@ -108,7 +108,7 @@ void SceneEditorWorkspace::updateFrameData(rhi::RenderCommandList &commandList,
   auto &scene = mState.scene;
 
   mSceneRenderer.updateFrameData(scene.entityDatabase, mState.activeCamera,
-                                 frameIndex);
+                                 frameIndex, &scene.spatialIndex);
   mEditorRenderer.updateFrameData(scene.entityDatabase, mState.activeCamera,
                                   mState, frameIndex);
 
@@ -95,7 +95,8 @@ void SceneSimulatorWorkspace::updateFrameData(
     rhi::RenderCommandList &commandList, u32 frameIndex) {
 
   mSceneRenderer.updateFrameData(mState.scene.entityDatabase,
-                                 mState.activeCamera, frameIndex);
+                                 mState.activeCamera, frameIndex,
+                                 &mState.scene.spatialIndex);
   mEditorRenderer.updateFrameData(mState.scene.entityDatabase,
                                   mState.activeCamera, mState, frameIndex);
 
@@ -705,14 +705,17 @@ void EditorRenderer::renderMeshOutlines(rhi::RenderCommandList &commandList,
   pc.scale = glm::vec4(scale);
   pc.index.x = instanceStart;
 
-  commandList.pushConstants(
-      pipeline, rhi::ShaderStage::Vertex | rhi::ShaderStage::Fragment, 0,
-      sizeof(PushConstants), &pc);
-
   for (u32 instanceIndex = instanceStart; instanceIndex < instanceEnd;
        ++instanceIndex) {
     const auto &outline = frameData.getMeshOutlines().at(instanceIndex);
 
+    // Skinned meshes read joints from outline joints
+    pc.index.y = outline.joints.offset;
+    pc.index.z = outline.joints.count;
+    commandList.pushConstants(
+        pipeline, rhi::ShaderStage::Vertex | rhi::ShaderStage::Fragment, 0,
+        sizeof(PushConstants), &pc);
+
     commandList.bindVertexBuffers(outline.vertexBuffers,
                                   outline.vertexBufferOffsets);
     commandList.bindIndexBuffer(outline.indexBuffer, rhi::IndexType::Uint32);
@@ -5,8 +5,6 @@
 
 namespace quoll::editor {
 
-static constexpr usize MaxNumJoints = 32;
-
 EditorRendererFrameData::EditorRendererFrameData(RenderStorage &renderStorage,
                                                  usize reservedSpace)
     : mReservedSpace(reservedSpace),
@@ -67,9 +65,9 @@ EditorRendererFrameData::EditorRendererFrameData(RenderStorage &renderStorage,
 
   {
     auto desc = defaultDesc;
-    desc.size = mReservedSpace * MaxNumJoints * sizeof(glm::mat4);
-    desc.debugName = "Outline skeletons";
-    mOutlineSkeletonsBuffer = renderStorage.createBuffer(desc);
+    desc.debugName = "Outline joints";
+    mOutlineJointsBuffer = GrowableBuffer(renderStorage, desc,
+                                          sizeof(glm::mat4), mReservedSpace);
   }
 
   {
@@ -197,25 +195,12 @@ void EditorRendererFrameData::addSkinnedMeshOutline(
     lastVertexOffset += drawData.geometries.at(i).numVertices;
   }
 
-  mMeshOutlines.push_back(outline);
-
-  const usize currentOffset = mLastOutlineSkeleton * MaxNumJoints;
-  const usize newSize = currentOffset + MaxNumJoints;
-
-  // Resize skeletons if new skeleton does not fit
-  if (mOutlineSkeletonCapacity < newSize) {
-    mOutlineSkeletonCapacity = newSize * 2;
-    auto *newVector = new glm::mat4[mOutlineSkeletonCapacity];
+  outline.joints = {static_cast<u32>(mOutlineJoints.size()),
+                    static_cast<u32>(skeleton.size())};
+  mOutlineJoints.insert(mOutlineJoints.end(), skeleton.begin(),
+                        skeleton.end());
 
-    memcpy(newVector, mOutlineSkeletons.get(),
-           currentOffset * sizeof(glm::mat4));
-    mOutlineSkeletons.reset(newVector);
-  }
-
-  auto *currentSkeleton = mOutlineSkeletons.get() + currentOffset;
-  const usize dataSize = std::min(skeleton.size(), MaxNumJoints);
-  memcpy(currentSkeleton, skeleton.data(), dataSize * sizeof(glm::mat4));
-  mLastOutlineSkeleton++;
+  mMeshOutlines.push_back(outline);
 
   mOutlineSkinnedMeshEnd++;
 }
@@ -246,14 +231,12 @@ void EditorRendererFrameData::updateBuffers() {
       mTextGlyphOutlines.data(),
       mTextGlyphOutlines.size() * sizeof(SceneRendererFrameData::GlyphData));
 
-  if (mLastOutlineSkeleton > 0) {
-    auto *skeletonsBuffer =
-        static_cast<glm::mat4 *>(mOutlineSkeletonsBuffer.map());
-    memcpy(skeletonsBuffer, mOutlineSkeletons.get(),
-           mLastOutlineSkeleton * MaxNumJoints * sizeof(glm::mat4));
-
-    mOutlineSkeletonsBuffer.unmap();
+  mOutlineJointsBuffer.collectGarbage();
+  if (mOutlineJointsBuffer.reserve(mOutlineJoints.size())) {
+    mBindlessParams.update();
   }
+  mOutlineJointsBuffer.update(mOutlineJoints.data(),
+                              mOutlineJoints.size() * sizeof(glm::mat4));
 
   mCollidableEntityBuffer.update(&mCollidableEntityParams,
                                  sizeof(CollidableEntity));
@@ -274,7 +257,7 @@ void EditorRendererFrameData::clear() {
   mOutlineMeshEnd = 0;
   mOutlineSkinnedMeshEnd = 0;
   mOutlineTransforms.clear();
-  mLastOutlineSkeleton = 0;
+  mOutlineJoints.clear();
 
   mCollidableEntity = Entity::Null;
 }
@@ -314,18 +297,21 @@ void EditorRendererFrameData::createBindlessParamsRange() {
     rhi::DeviceAddress camera;
     rhi::DeviceAddress gridData;
     rhi::DeviceAddress outlineTransforms;
-    rhi::DeviceAddress outlineSkeletons;
+    rhi::DeviceAddress outlineJoints;
     rhi::DeviceAddress outlineTextGlyphs;
   };
 
-  mBindlessParams.addRange(EditorDrawParams{
-      mGizmoTransformsBuffer.getAddress(),
-      mSkeletonTransformsBuffer.getAddress(),
-      mSkeletonBoneTransformsBuffer.getAddress(),
-      mCollidableEntityBuffer.getAddress(), mCameraBuffer.getAddress(),
-      mEditorGridBuffer.getAddress(), mOutlineTransformsBuffer.getAddress(),
-      mOutlineSkeletonsBuffer.getAddress(),
-      mOutlineTextGlyphsBuffer.getAddress()});
+  mBindlessParams.addDynamicRange([this] {
+    return EditorDrawParams{mGizmoTransformsBuffer.getAddress(),
+                            mSkeletonTransformsBuffer.getAddress(),
+                            mSkeletonBoneTransformsBuffer.getAddress(),
+                            mCollidableEntityBuffer.getAddress(),
+                            mCameraBuffer.getAddress(),
+                            mEditorGridBuffer.getAddress(),
+                            mOutlineTransformsBuffer.getAddress(),
+                            mOutlineJointsBuffer.getAddress(),
+                            mOutlineTextGlyphsBuffer.getAddress()};
+  });
 }
 
 } // namespace quoll::editor
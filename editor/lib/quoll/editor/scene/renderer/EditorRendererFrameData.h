@@ -4,6 +4,8 @@
 #include "quoll/entity/EntityDatabase.h"
 #include "quoll/physics/Collidable.h"
 #include "quoll/renderer/BindlessDrawParameters.h"
+#include "quoll/renderer/GrowableBuffer.h"
+#include "quoll/renderer/JointPalette.h"
 #include "quoll/renderer/MeshDrawData.h"
 #include "quoll/renderer/RenderStorage.h"
 #include "quoll/renderer/SceneRendererFrameData.h"
@@ -41,6 +43,11 @@ public:
     std::vector<u32> indexOffsets;
 
     std::vector<u32> vertexOffsets;
+
+    /**
+     * Joints in outline joints of skinned mesh
+     */
+    JointRange joints;
   };
 
 public:
@@ -157,10 +164,8 @@ private:
   std::vector<MeshOutline> mMeshOutlines;
 
   usize mOutlineSkinnedMeshEnd = 0;
-  std::unique_ptr<glm::mat4> mOutlineSkeletons;
-  usize mLastOutlineSkeleton = 0;
-  usize mOutlineSkeletonCapacity = 0;
-  rhi::Buffer mOutlineSkeletonsBuffer;
+  std::vector<glm::mat4> mOutlineJoints;
+  GrowableBuffer mOutlineJointsBuffer;
 
   // Camera
   Camera mCameraData;
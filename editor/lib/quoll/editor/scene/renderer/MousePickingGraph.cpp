@@ -44,31 +44,21 @@ MousePickingGraph::MousePickingGraph(
 
   rhi::BufferDescription defaultDesc{};
   defaultDesc.usage = rhi::BufferUsage::Storage;
-  defaultDesc.size = sizeof(Entity) * mFrameData.at(0).getReservedSpace();
   defaultDesc.mapped = true;
 
-  {
-    auto desc = defaultDesc;
-    desc.debugName = "sprite entities";
-    mSpriteEntitiesBuffer = renderStorage.createBuffer(desc);
-  }
-
-  {
-    auto desc = defaultDesc;
-    desc.debugName = "mesh entities";
-    mMeshEntitiesBuffer = renderStorage.createBuffer(desc);
-  }
-
-  {
+  auto createEntitiesBuffer = [&](const String &debugName) {
     auto desc = defaultDesc;
-    desc.debugName = "skinned mesh entities";
-    mSkinnedMeshEntitiesBuffer = renderStorage.createBuffer(desc);
-  }
+    desc.debugName = debugName;
+    return GrowableBuffer(renderStorage, desc, sizeof(Entity),
+                          mFrameData.at(0).getReservedSpace());
+  };
 
-  {
-    auto desc = defaultDesc;
-    desc.debugName = "text entities";
-    mTextEntitiesBuffer = renderStorage.createBuffer(desc);
+  for (auto &data : mMousePickingFrameData) {
+    data.spriteEntitiesBuffer = createEntitiesBuffer("sprite entities");
+    data.meshEntitiesBuffer = createEntitiesBuffer("mesh entities");
+    data.skinnedMeshEntitiesBuffer =
+        createEntitiesBuffer("skinned mesh entities");
+    data.textEntitiesBuffer = createEntitiesBuffer("text entities");
   }
 }
 
@@ -76,8 +66,9 @@ void MousePickingGraph::execute(rhi::RenderCommandList &commandList,
                                 const glm::vec2 &mousePos, u32 frameIndex) {
   mFrameIndex = frameIndex;
   const auto &frameData = mFrameData.at(frameIndex);
+  auto &pickingData = mMousePickingFrameData.at(frameIndex);
 
-  auto &textBounds = mMousePickingFrameData.at(frameIndex).textBounds;
+  auto &textBounds = pickingData.textBounds;
   textBounds.clear();
   textBounds.reserve(frameData.getTexts().size());
 
@@ -98,33 +89,49 @@ void MousePickingGraph::execute(rhi::RenderCommandList &commandList,
     textBounds.push_back(bounds);
   }
 
-  mSpriteEntitiesBuffer.update(frameData.getSpriteEntities().data(),
-                               frameData.getSpriteEntities().size() *
-                                   sizeof(Entity));
-  mTextEntitiesBuffer.update(frameData.getTextEntities().data(),
-                             frameData.getTextEntities().size() *
-                                 sizeof(Entity));
+  // Buffers of this frame that are replaced when
+  // the frame was last recorded are not used anymore
+  pickingData.spriteEntitiesBuffer.collectGarbage();
+  pickingData.meshEntitiesBuffer.collectGarbage();
+  pickingData.skinnedMeshEntitiesBuffer.collectGarbage();
+  pickingData.textEntitiesBuffer.collectGarbage();
+
+  pickingData.spriteEntitiesBuffer.reserve(
+      frameData.getSpriteEntities().size());
+  pickingData.textEntitiesBuffer.reserve(frameData.getTextEntities().size());
+  pickingData.meshEntitiesBuffer.reserve(frameData.getMeshCapacity());
+  pickingData.skinnedMeshEntitiesBuffer.reserve(
+      frameData.getSkinnedMeshCapacity());
+
+  // Entity and frame data buffers can be recreated
+  // in any frame; so, addresses are always updated
+  mBindlessParams.at(frameIndex).update();
+
+  pickingData.spriteEntitiesBuffer.update(
+      frameData.getSpriteEntities().data(),
+      frameData.getSpriteEntities().size() * sizeof(Entity));
+  pickingData.textEntitiesBuffer.update(frameData.getTextEntities().data(),
+                                        frameData.getTextEntities().size() *
+                                            sizeof(Entity));
 
   {
-    usize offset = 0;
-    auto *bufferData = static_cast<Entity *>(mMeshEntitiesBuffer.map());
-    for (auto &[_, meshData] : frameData.getMeshGroups()) {
-      memcpy(bufferData + offset, meshData.entities.data(),
-             sizeof(Entity) * meshData.entities.size());
-      offset += meshData.entities.size();
+    auto *bufferData =
+        static_cast<Entity *>(pickingData.meshEntitiesBuffer.map());
+    for (const auto &group : frameData.getMeshGroups()) {
+      memcpy(bufferData + group.firstSlot, group.entities.data(),
+             sizeof(Entity) * group.entities.size());
     }
-    mMeshEntitiesBuffer.unmap();
+    pickingData.meshEntitiesBuffer.unmap();
   }
 
   {
-    usize offset = 0;
-    auto *bufferData = static_cast<Entity *>(mSkinnedMeshEntitiesBuffer.map());
-    for (auto &[_, meshData] : frameData.getSkinnedMeshGroups()) {
-      memcpy(bufferData + offset, meshData.entities.data(),
-             sizeof(Entity) * meshData.entities.size());
-      offset += meshData.entities.size();
+    auto *bufferData =
+        static_cast<Entity *>(pickingData.skinnedMeshEntitiesBuffer.map());
+    for (const auto &group : frameData.getSkinnedMeshGroups()) {
+      memcpy(bufferData + group.firstSlot, group.entities.data(),
+             sizeof(Entity) * group.entities.size());
     }
-    mSkinnedMeshEntitiesBuffer.unmap();
+    pickingData.skinnedMeshEntitiesBuffer.unmap();
   }
 
   mMousePos = mousePos;
@@ -261,7 +268,8 @@ void MousePickingGraph::createRenderGraph() {
 
     rhi::DeviceAddress skinnedMeshTransforms;
     rhi::DeviceAddress skinnedMeshEntities;
-    rhi::DeviceAddress skeletons;
+    rhi::DeviceAddress skinnedMeshJoints;
+    rhi::DeviceAddress joints;
 
     rhi::DeviceAddress textTransforms;
     rhi::DeviceAddress textEntities;
@@ -271,19 +279,27 @@ void MousePickingGraph::createRenderGraph() {
   usize offset = 0;
   for (usize i = 0; i < mBindlessParams.size(); ++i) {
     auto &frameData = mFrameData.at(i);
-    offset = mBindlessParams.at(i).addRange(MousePickingDrawParams{
-        mSelectedEntityBuffer.getAddress(), frameData.getCameraBuffer(),
-
-        frameData.getSpriteTransformsBuffer(),
-        mSpriteEntitiesBuffer.getAddress(),
-
-        frameData.getMeshTransformsBuffer(), mMeshEntitiesBuffer.getAddress(),
-
-        frameData.getSkinnedMeshTransformsBuffer(),
-        mSkinnedMeshEntitiesBuffer.getAddress(), frameData.getSkeletonsBuffer(),
-
-        frameData.getTextTransformsBuffer(), mTextEntitiesBuffer.getAddress(),
-        frameData.getGlyphsBuffer()});
+    auto &pickingData = mMousePickingFrameData.at(i);
+    offset = mBindlessParams.at(i).addDynamicRange([this, &frameData,
+                                                    &pickingData] {
+      return MousePickingDrawParams{
+          mSelectedEntityBuffer.getAddress(), frameData.getCameraBuffer(),
+
+          frameData.getSpriteTransformsBuffer(),
+          pickingData.spriteEntitiesBuffer.getAddress(),
+
+          frameData.getMeshTransformsBuffer(),
+          pickingData.meshEntitiesBuffer.getAddress(),
+
+          frameData.getSkinnedMeshTransformsBuffer(),
+          pickingData.skinnedMeshEntitiesBuffer.getAddress(),
+          frameData.getSkinnedMeshJointsBuffer(),
+          frameData.getJointPaletteBuffer(),
+
+          frameData.getTextTransformsBuffer(),
+          pickingData.textEntitiesBuffer.getAddress(),
+          frameData.getGlyphsBuffer()};
+    });
   }
 
   pass.setExecutor([this, spritePipeline, meshPipeline, skinnedMeshPipeline,
@@ -314,25 +330,16 @@ void MousePickingGraph::createRenderGraph() {
                                  mBindlessParams.at(frameIndex).getDescriptor(),
                                  offsets);
 
-      u32 instanceStart = 0;
-      for (auto &[handle, meshData] : frameData.getMeshGroups()) {
-        const u32 numInstances = static_cast<u32>(meshData.transforms.size());
-
+      // Instances that are not visible in camera
+      // might have stale transforms; so, they
+      // are not drawn
+      for (const auto &group : frameData.getMeshGroups()) {
         commandList.bindVertexBuffers(
-            MeshRenderUtils::getGeometryBuffers(meshData.drawData),
-            MeshRenderUtils::getGeometryBufferOffsets(meshData.drawData));
-        commandList.bindIndexBuffer(meshData.drawData->indexBuffer,
+            MeshRenderUtils::getGeometryBuffers(group.drawData),
+            MeshRenderUtils::getGeometryBufferOffsets(group.drawData));
+        commandList.bindIndexBuffer(group.drawData->indexBuffer,
                                     rhi::IndexType::Uint32);
-
-        i32 vertexOffset = 0;
-        u32 indexOffset = 0;
-        for (const auto &geometry : meshData.drawData->geometries) {
-          commandList.drawIndexed(geometry.numIndices, indexOffset,
-                                  vertexOffset, numInstances, instanceStart);
-          vertexOffset += static_cast<i32>(geometry.numVertices);
-          indexOffset += geometry.numIndices;
-        }
-        instanceStart += numInstances;
+        drawVisibleGeometries(commandList, group);
       }
     }
 
@@ -344,26 +351,13 @@ void MousePickingGraph::createRenderGraph() {
                                  mBindlessParams.at(frameIndex).getDescriptor(),
                                  offsets);
 
-      u32 instanceStart = 0;
-      for (auto &[handle, meshData] : frameData.getSkinnedMeshGroups()) {
-        const u32 numInstances = static_cast<u32>(meshData.transforms.size());
-
+      for (const auto &group : frameData.getSkinnedMeshGroups()) {
         commandList.bindVertexBuffers(
-            MeshRenderUtils::getSkinnedGeometryBuffers(meshData.drawData),
-            MeshRenderUtils::getSkinnedGeometryBufferOffsets(
-                meshData.drawData));
-        commandList.bindIndexBuffer(meshData.drawData->indexBuffer,
+            MeshRenderUtils::getSkinnedGeometryBuffers(group.drawData),
+            MeshRenderUtils::getSkinnedGeometryBufferOffsets(group.drawData));
+        commandList.bindIndexBuffer(group.drawData->indexBuffer,
                                     rhi::IndexType::Uint32);
-
-        i32 vertexOffset = 0;
-        u32 indexOffset = 0;
-        for (const auto &geometry : meshData.drawData->geometries) {
-          commandList.drawIndexed(geometry.numIndices, indexOffset,
-                                  vertexOffset, numInstances, instanceStart);
-          vertexOffset += static_cast<i32>(geometry.numVertices);
-          indexOffset += geometry.numIndices;
-        }
-        instanceStart += numInstances;
+        drawVisibleGeometries(commandList, group);
       }
     }
 
@@ -391,4 +385,20 @@ void MousePickingGraph::createRenderGraph() {
   }
 }
 
+void MousePickingGraph::drawVisibleGeometries(
+    rhi::RenderCommandList &commandList,
+    const SceneRendererFrameData::MeshGroup &group) {
+  i32 vertexOffset = 0;
+  u32 indexOffset = 0;
+  for (usize g = 0; g < group.drawData->geometries.size(); ++g) {
+    const auto &geometry = group.drawData->geometries.at(g);
+    MeshRenderUtils::drawVisibleInstances(
+        commandList, group.drawData, g, indexOffset, vertexOffset,
+        group.firstSlot, group.visibility,
+        SceneRendererFrameData::CameraViewBit);
+    vertexOffset += static_cast<i32>(geometry.numVertices);
+    indexOffset += geometry.numIndices;
+  }
+}
+
 } // namespace quoll::editor
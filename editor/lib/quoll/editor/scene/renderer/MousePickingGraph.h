@@ -1,6 +1,7 @@
 #pragma once
 
 #include "quoll/asset/AssetRegistry.h"
+#include "quoll/renderer/GrowableBuffer.h"
 #include "quoll/renderer/RenderGraph.h"
 #include "quoll/renderer/SceneRendererFrameData.h"
 #include "quoll/window/Window.h"
@@ -14,8 +15,18 @@ class RendererAssetRegistry;
 namespace quoll::editor {
 
 class MousePickingGraph {
+  /**
+   * Entity buffers are owned by frames; so,
+   * buffers that are replaced in a frame are
+   * only destroyed after the frame finishes
+   */
   struct MousePickingFrameData {
     std::vector<glm::vec4> textBounds;
+
+    GrowableBuffer spriteEntitiesBuffer;
+    GrowableBuffer meshEntitiesBuffer;
+    GrowableBuffer skinnedMeshEntitiesBuffer;
+    GrowableBuffer textEntitiesBuffer;
   };
 
 public:
@@ -39,6 +50,10 @@ public:
 private:
   void createRenderGraph();
 
+  static void
+  drawVisibleGeometries(rhi::RenderCommandList &commandList,
+                        const SceneRendererFrameData::MeshGroup &group);
+
 private:
   RenderStorage &mRenderStorage;
   RendererAssetRegistry &mRendererAssetRegistry;
@@ -51,10 +66,6 @@ private:
   std::array<MousePickingFrameData, rhi::RenderDevice::NumFrames>
       mMousePickingFrameData;
 
-  rhi::Buffer mSpriteEntitiesBuffer;
-  rhi::Buffer mMeshEntitiesBuffer;
-  rhi::Buffer mSkinnedMeshEntitiesBuffer;
-  rhi::Buffer mTextEntitiesBuffer;
   rhi::Buffer mSelectedEntityBuffer;
 
   glm::vec2 mMousePos{};
@@ -103,10 +103,14 @@ void EditorWindow::start(const Project &rawProject) {
                           std::filesystem::current_path() / "assets" / "icons");
 
   SceneRenderer sceneRenderer(assetManager.getAssetRegistry(), renderStorage,
-                              rendererAssetRegistry);
+                              rendererAssetRegistry, initialOptions);
   EditorRenderer editorRenderer(assetManager.getAssetRegistry(), renderStorage,
                                 rendererAssetRegistry);
 
+  renderer.setCullingStats(&sceneRenderer.getCullingStats());
+  renderer.setUploadStats(&sceneRenderer.getUploadStats());
+  renderer.setResidencyStats(&rendererAssetRegistry.getResidencyStats());
+
   renderer.setGraphBuilder([&](auto &graph, const auto &options) {
     auto scenePassGroup = sceneRenderer.attach(graph, options);
     auto imguiPassGroup = imguiRenderer.attach(graph, options);
@@ -133,8 +137,8 @@ void EditorWindow::start(const Project &rawProject) {
   MainEngineModules engineModules(mDeviceManager, mWindow,
                                   assetManager.getCache());
 
-  debug::PerformanceDebugPanel performanceDebugPanel(mDevice, metricsCollector,
-                                                     fpsCounter);
+  debug::PerformanceDebugPanel performanceDebugPanel(
+      mDevice, metricsCollector, fpsCounter, &engineModules.getSceneUpdater());
 
   ImguiDebugLayer debugLayer(
       {renderer.getDebugPanel(), &performanceDebugPanel,
@@ -243,6 +247,8 @@ void EditorWindow::start(const Project &rawProject) {
       imguiRenderer.updateFrameData(renderFrame.frameIndex);
       workspace->updateFrameData(renderFrame.commandList,
                                  renderFrame.frameIndex);
+      rendererAssetRegistry.update(renderFrame.commandList,
+                                   renderFrame.frameIndex);
 
       renderer.execute(renderFrame.commandList, renderFrame.frameIndex);
 
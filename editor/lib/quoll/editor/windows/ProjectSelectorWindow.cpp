@@ -138,6 +138,8 @@ std::optional<Project> ProjectSelectorWindow::start() {
 
     if (renderFrame.frameIndex < std::numeric_limits<u32>::max()) {
       imgui.updateFrameData(renderFrame.frameIndex);
+      rendererAssetRegistry.update(renderFrame.commandList,
+                                   renderFrame.frameIndex);
       renderer.execute(renderFrame.commandList, renderFrame.frameIndex);
 
       presenter.present(renderFrame.commandList, renderer.getFinalTexture(),
@@ -0,0 +1,25 @@
+#ifndef DRAW_GLSL
+#define DRAW_GLSL
+
+/**
+ * @brief Indirect draw command of mesh geometry
+ */
+struct DrawCommandItem {
+  uint indexCount;
+  uint instanceCount;
+  uint firstIndex;
+  int vertexOffset;
+  uint firstInstance;
+
+  /**
+   * Geometry index in mesh
+   */
+  uint geometryIndex;
+};
+
+Buffer(4) DrawCommandsArray { DrawCommandItem items[]; };
+
+#define getGeometryIndex(params)                                               \
+  params.drawCommands.items[params.firstDraw + gl_DrawID].geometryIndex
+
+#endif
@@ -1,13 +1,29 @@
 /**
- * @brief Single skeleton joints
+ * @brief Joint range of skinned mesh
  */
-struct SkeletonItem {
+struct JointRangeItem {
   /**
-   * Joints for skeleton
+   * First joint in joint palette
    */
-  mat4 joints[32];
+  uint offset;
+
+  /**
+   * Number of joints
+   */
+  uint count;
 };
 
-Buffer(64) SkeletonsArray { SkeletonItem items[]; };
+Buffer(8) JointRangesArray { JointRangeItem items[]; };
+
+Buffer(64) JointsArray { mat4 items[]; };
+
+#define getJointRange(index) uDrawParams.skinnedMeshJoints.items[index]
+
+#define getJoint(range, joint)                                                 \
+  uDrawParams.joints.items[range.offset + min(joint, range.count - 1)]
 
-#define getSkeleton(index) uDrawParams.skeletons.items[index]
+#define getSkinMatrix(range, joints, weights)                                  \
+  (weights.x * getJoint(range, joints.x) +                                     \
+   weights.y * getJoint(range, joints.y) +                                     \
+   weights.z * getJoint(range, joints.z) +                                     \
+   weights.w * getJoint(range, joints.w))
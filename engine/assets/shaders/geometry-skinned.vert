@@ -1,8 +1,8 @@
 #version 460
 
 layout(location = 0) in vec3 inPosition;
-layout(location = 1) in vec3 inNormal;
-layout(location = 2) in vec4 inTangent;
+layout(location = 1) in vec2 inNormal;
+layout(location = 2) in vec2 inTangent;
 layout(location = 3) in vec2 inTextureCoord0;
 layout(location = 4) in vec2 inTextureCoord1;
 layout(location = 5) in uvec4 inJoints;
@@ -15,8 +15,10 @@ layout(location = 6) out uint outMaterialIndex;
 
 #include "bindless/base.glsl"
 #include "bindless/camera.glsl"
+#include "bindless/draw.glsl"
 #include "bindless/material.glsl"
 #include "bindless/mesh.glsl"
+#include "octahedral.glsl"
 
 layout(set = 0, binding = 0) uniform texture2D uGlobalTextures[];
 layout(set = 0, binding = 1) uniform sampler uGlobalSamplers[];
@@ -28,7 +30,8 @@ layout(set = 1, binding = 0) uniform DrawParameters {
   MaterialRangeArray meshMaterialRanges;
   TransformsArray skinnedMeshTransforms;
   MaterialRangeArray skinnedMeshMaterialRanges;
-  SkeletonsArray skeletons;
+  JointRangesArray skinnedMeshJoints;
+  JointsArray joints;
   Camera camera;
   Empty scene;
   Empty directionalLights;
@@ -37,17 +40,18 @@ layout(set = 1, binding = 0) uniform DrawParameters {
 }
 uDrawParams;
 
-layout(std430, push_constant) uniform PushConstants { uint submeshIndex; }
+layout(std430, push_constant) uniform PushConstants {
+  DrawCommandsArray drawCommands;
+  uint firstDraw;
+  uint pad0;
+}
 uMeshParams;
 
 void main() {
   mat4 worldMatrix = getSkinnedMeshTransform(gl_InstanceIndex).modelMatrix;
-  SkeletonItem item = getSkeleton(gl_InstanceIndex);
+  JointRangeItem joints = getJointRange(gl_InstanceIndex);
 
-  mat4 skinMatrix = inWeights.x * item.joints[inJoints.x] +
-                    inWeights.y * item.joints[inJoints.y] +
-                    inWeights.z * item.joints[inJoints.z] +
-                    inWeights.w * item.joints[inJoints.w];
+  mat4 skinMatrix = getSkinMatrix(joints, inJoints, inWeights);
 
   mat4 modelMatrix = worldMatrix * skinMatrix;
 
@@ -55,8 +59,11 @@ void main() {
 
   mat4 normalMatrix = transpose(inverse(modelMatrix));
 
-  vec3 normal = normalize(vec3(normalMatrix * vec4(inNormal.xyz, 0.0)));
-  vec3 tangent = normalize(vec3(modelMatrix * vec4(inTangent.xyz, 0.0)));
+  vec3 localNormal = decodeOctahedral(inNormal);
+  vec4 localTangent = decodeOctahedralTangent(inTangent);
+
+  vec3 normal = normalize(vec3(normalMatrix * vec4(localNormal, 0.0)));
+  vec3 tangent = normalize(vec3(modelMatrix * vec4(localTangent.xyz, 0.0)));
   vec3 bitangent = normalize(cross(normal, tangent));
 
   outWorldPosition = worldPosition.xyz;
@@ -67,6 +74,6 @@ void main() {
 
   outMaterialIndex =
       min(uDrawParams.skinnedMeshMaterialRanges.items[gl_InstanceIndex].start +
-              uMeshParams.submeshIndex,
+              getGeometryIndex(uMeshParams),
           uDrawParams.skinnedMeshMaterialRanges.items[gl_InstanceIndex].end);
 }
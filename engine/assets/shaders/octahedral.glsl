@@ -0,0 +1,32 @@
+/**
+ * @brief Decode unit vector from octahedral coordinates
+ *
+ * @param encoded Octahedral coordinates
+ * @return Unit vector
+ */
+vec3 decodeOctahedral(vec2 encoded) {
+  vec3 v = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+  float fold = max(-v.z, 0.0);
+  v.x += v.x >= 0.0 ? -fold : fold;
+  v.y += v.y >= 0.0 ? -fold : fold;
+  return normalize(v);
+}
+
+/**
+ * Smallest magnitude of encoded tangent component
+ */
+const float TangentSignBias = 1.0 / 32767.0;
+
+/**
+ * @brief Decode tangent from octahedral coordinates
+ *
+ * Sign of second component is the bitangent sign
+ *
+ * @param encoded Encoded tangent
+ * @return Tangent with bitangent sign in w
+ */
+vec4 decodeOctahedralTangent(vec2 encoded) {
+  float y = (abs(encoded.y) - TangentSignBias) / (1.0 - TangentSignBias);
+  return vec4(decodeOctahedral(vec2(encoded.x, y * 2.0 - 1.0)),
+              encoded.y < 0.0 ? -1.0 : 1.0);
+}
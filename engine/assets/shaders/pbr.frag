@@ -28,7 +28,8 @@ layout(set = 1, binding = 0) uniform DrawParameters {
   MaterialRangeArray meshMaterialRanges;
   Empty skinnedMeshTransforms;
   MaterialRangeArray skinnedMaterialRanges;
-  Empty skeletons;
+  Empty skinnedMeshJoints;
+  Empty joints;
   Camera camera;
   Scene scene;
   DirectionalLightsArray directionalLights;
@@ -13,7 +13,8 @@ layout(location = 2) in vec4 inWeights;
 layout(set = 0, binding = 0) uniform DrawParameters {
   TransformsArray meshTransforms;
   TransformsArray skinnedMeshTransforms;
-  SkeletonsArray skeletons;
+  JointRangesArray skinnedMeshJoints;
+  JointsArray joints;
   ShadowMapsArray shadows;
 }
 uDrawParams;
@@ -23,12 +24,9 @@ uShadowParams;
 
 void main() {
   mat4 modelMatrix = getSkinnedMeshTransform(gl_InstanceIndex).modelMatrix;
-  SkeletonItem item = getSkeleton(gl_InstanceIndex);
+  JointRangeItem joints = getJointRange(gl_InstanceIndex);
 
-  mat4 skinMatrix = inWeights.x * item.joints[inJoints.x] +
-                    inWeights.y * item.joints[inJoints.y] +
-                    inWeights.z * item.joints[inJoints.z] +
-                    inWeights.w * item.joints[inJoints.w];
+  mat4 skinMatrix = getSkinMatrix(joints, inJoints, inWeights);
 
   gl_Position = getShadowMap(uShadowParams.shadow.x).shadowMatrix *
                 modelMatrix * skinMatrix * vec4(inPosition, 1.0);
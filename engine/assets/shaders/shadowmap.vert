@@ -11,7 +11,8 @@ layout(location = 0) in vec3 inPosition;
 layout(set = 0, binding = 0) uniform DrawParameters {
   TransformsArray meshTransforms;
   TransformsArray skinnedMeshTransforms;
-  SkeletonsArray skeletons;
+  JointRangesArray skinnedMeshJoints;
+  JointsArray joints;
   ShadowMapsArray shadows;
 }
 uDrawParams;
@@ -8,6 +8,16 @@ enum class KeyframeSequenceAssetTarget : u8 { Position, Rotation, Scale };
 
 enum class KeyframeSequenceAssetInterpolation : u8 { Step, Linear };
 
+/**
+ * @brief Keyframe sequence storage format
+ *
+ * Raw sequences store every keyframe time and value.
+ * Constant sequences store a single value. Uniform
+ * sequences store quantized values that are sampled
+ * at uniform intervals between start and end time.
+ */
+enum class KeyframeSequenceAssetEncoding : u8 { Raw, Constant, Uniform };
+
 struct KeyframeSequenceAsset {
   std::vector<f32> keyframeTimes;
 
@@ -21,6 +31,34 @@ struct KeyframeSequenceAsset {
 
   KeyframeSequenceAssetInterpolation interpolation =
       KeyframeSequenceAssetInterpolation::Step;
+
+  KeyframeSequenceAssetEncoding encoding = KeyframeSequenceAssetEncoding::Raw;
+
+  /**
+   * Constant value or minimum of
+   * quantized uniform values
+   */
+  glm::vec4 rangeMin{0.0f};
+
+  /**
+   * Range of quantized uniform values
+   */
+  glm::vec4 rangeExtent{0.0f};
+
+  f32 startTime = 0.0f;
+
+  f32 endTime = 0.0f;
+
+  u32 numSamples = 0;
+
+  /**
+   * Quantized uniform values
+   *
+   * Positions and scales use three values
+   * per sample. Rotations use four values
+   * per sample.
+   */
+  std::vector<u16> compressedValues;
 };
 
 struct AnimationAsset {
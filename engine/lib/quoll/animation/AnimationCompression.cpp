@@ -0,0 +1,325 @@
+#include "quoll/core/Base.h"
+#include "AnimationCompression.h"
+#include "KeyframeInterpolator.h"
+
+namespace quoll {
+
+namespace {
+
+static constexpr f32 QuantizedMax = 65535.0f;
+
+static constexpr u32 RotationComponentBits = 20;
+static constexpr u64 RotationComponentMask =
+    (u64{1} << RotationComponentBits) - 1;
+
+// Three smallest components of a unit
+// quaternion are within [-1/sqrt(2), 1/sqrt(2)]
+static constexpr f32 RotationComponentRange = 0.70710678f;
+
+static constexpr usize Vec3Stride = 3;
+static constexpr usize RotationStride = 4;
+
+usize getStride(const KeyframeSequenceAsset &sequence) {
+  return sequence.target == KeyframeSequenceAssetTarget::Rotation
+             ? RotationStride
+             : Vec3Stride;
+}
+
+void encodeRotation(glm::vec4 q, u16 *out) {
+  const f32 length = std::sqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+
+  glm::length_t largest = 0;
+  for (glm::length_t i = 0; i < 4; ++i) {
+    q[i] /= length;
+    if (std::abs(q[i]) > std::abs(q[largest])) {
+      largest = i;
+    }
+  }
+
+  // Negated quaternion is the same rotation;
+  // so, largest component is always positive
+  const f32 sign = q[largest] < 0.0f ? -1.0f : 1.0f;
+
+  u64 packed = static_cast<u64>(largest);
+  u32 shift = 2;
+  for (glm::length_t i = 0; i < 4; ++i) {
+    if (i == largest) {
+      continue;
+    }
+
+    const f32 shifted = q[i] * sign + RotationComponentRange;
+    const f32 normalized =
+        std::clamp(shifted / (2.0f * RotationComponentRange), 0.0f, 1.0f);
+    const u64 value = static_cast<u64>(
+        std::round(normalized * static_cast<f32>(RotationComponentMask)));
+
+    packed |= value << shift;
+    shift += RotationComponentBits;
+  }
+
+  for (usize i = 0; i < RotationStride; ++i) {
+    out[i] = static_cast<u16>(packed >> (i * 16));
+  }
+}
+
+glm::vec4 decodeRotation(const u16 *in) {
+  u64 packed = 0;
+  for (usize i = 0; i < RotationStride; ++i) {
+    packed |= static_cast<u64>(in[i]) << (i * 16);
+  }
+
+  const auto largest = static_cast<glm::length_t>(packed & 0x3);
+
+  glm::vec4 q{0.0f};
+  f32 sum = 0.0f;
+  u32 shift = 2;
+  for (glm::length_t i = 0; i < 4; ++i) {
+    if (i == largest) {
+      continue;
+    }
+
+    const f32 normalized =
+        static_cast<f32>((packed >> shift) & RotationComponentMask) /
+        static_cast<f32>(RotationComponentMask);
+    q[i] = normalized * 2.0f * RotationComponentRange - RotationComponentRange;
+    sum += q[i] * q[i];
+    shift += RotationComponentBits;
+  }
+
+  q[largest] = std::sqrt(std::max(0.0f, 1.0f - sum));
+  return q;
+}
+
+glm::vec4 sample(const KeyframeSequenceAsset &sequence, f32 time,
+                 usize &cursor) {
+  if (sequence.target == KeyframeSequenceAssetTarget::Rotation) {
+    auto q = KeyframeInterpolator::interpolateQuat(sequence, time, cursor);
+    return glm::vec4(q.x, q.y, q.z, q.w);
+  }
+
+  return glm::vec4(
+      KeyframeInterpolator::interpolateVec3(sequence, time, cursor), 0.0f);
+}
+
+/**
+ * @brief Get distance between two sequence values
+ *
+ * @param sequence Keyframe sequence
+ * @param a First value
+ * @param b Second value
+ * @return Angle between rotations or distance between vectors
+ */
+f32 getError(const KeyframeSequenceAsset &sequence, const glm::vec4 &a,
+             const glm::vec4 &b) {
+  if (sequence.target == KeyframeSequenceAssetTarget::Rotation) {
+    const f32 lengths = std::sqrt((a.x * a.x + a.y * a.y + a.z * a.z +
+                                   a.w * a.w) *
+                                  (b.x * b.x + b.y * b.y + b.z * b.z +
+                                   b.w * b.w));
+    const f32 dot = a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+    return 2.0f * std::acos(std::min(std::abs(dot) / lengths, 1.0f));
+  }
+
+  return glm::length(glm::vec3(a) - glm::vec3(b));
+}
+
+/**
+ * @brief Get maximum error of compressed sequence
+ *
+ * Error is measured at every keyframe and between
+ * every pair of keyframes of the raw sequence.
+ *
+ * @param raw Raw keyframe sequence
+ * @param compressed Compressed keyframe sequence
+ * @return Maximum error
+ */
+f32 getMaxError(const KeyframeSequenceAsset &raw,
+                const KeyframeSequenceAsset &compressed) {
+  usize rawCursor = 0;
+  usize compressedCursor = 0;
+
+  f32 maxError = 0.0f;
+  auto measure = [&](f32 time) {
+    maxError = std::max(maxError,
+                        getError(raw, sample(raw, time, rawCursor),
+                                 sample(compressed, time, compressedCursor)));
+  };
+
+  const auto &times = raw.keyframeTimes;
+  for (usize i = 0; i < times.size(); ++i) {
+    measure(times.at(i));
+    if (i + 1 < times.size()) {
+      measure((times.at(i) + times.at(i + 1)) * 0.5f);
+    }
+  }
+
+  return maxError;
+}
+
+/**
+ * @brief Resample sequence uniformly and quantize values
+ *
+ * @param raw Raw keyframe sequence
+ * @param numSamples Number of samples
+ * @return Uniform keyframe sequence
+ */
+KeyframeSequenceAsset createUniformSequence(const KeyframeSequenceAsset &raw,
+                                            u32 numSamples) {
+  KeyframeSequenceAsset sequence;
+  sequence.joint = raw.joint;
+  sequence.jointTarget = raw.jointTarget;
+  sequence.target = raw.target;
+  sequence.interpolation = raw.interpolation;
+  sequence.encoding = KeyframeSequenceAssetEncoding::Uniform;
+  sequence.startTime = raw.keyframeTimes.front();
+  sequence.endTime = raw.keyframeTimes.back();
+  sequence.numSamples = numSamples;
+
+  const usize stride = getStride(raw);
+  sequence.compressedValues.resize(numSamples * stride);
+
+  std::vector<glm::vec4> values(numSamples);
+  usize cursor = 0;
+  for (u32 i = 0; i < numSamples; ++i) {
+    const f32 k = static_cast<f32>(i) / static_cast<f32>(numSamples - 1);
+    const f32 time =
+        sequence.startTime + k * (sequence.endTime - sequence.startTime);
+    values.at(i) = sample(raw, time, cursor);
+  }
+
+  if (raw.target == KeyframeSequenceAssetTarget::Rotation) {
+    for (u32 i = 0; i < numSamples; ++i) {
+      encodeRotation(values.at(i), &sequence.compressedValues.at(i * stride));
+    }
+
+    return sequence;
+  }
+
+  glm::vec4 min = values.at(0);
+  glm::vec4 max = values.at(0);
+  for (const auto &value : values) {
+    for (glm::length_t c = 0; c < 3; ++c) {
+      min[c] = std::min(min[c], value[c]);
+      max[c] = std::max(max[c], value[c]);
+    }
+  }
+
+  sequence.rangeMin = glm::vec4(glm::vec3(min), 0.0f);
+  sequence.rangeExtent = glm::vec4(glm::vec3(max) - glm::vec3(min), 0.0f);
+
+  for (u32 i = 0; i < numSamples; ++i) {
+    for (glm::length_t c = 0; c < 3; ++c) {
+      const f32 extent = sequence.rangeExtent[c];
+      const f32 normalized =
+          extent > 0.0f ? (values.at(i)[c] - min[c]) / extent : 0.0f;
+
+      sequence.compressedValues.at(i * stride + c) =
+          static_cast<u16>(std::round(normalized * QuantizedMax));
+    }
+  }
+
+  return sequence;
+}
+
+} // namespace
+
+AnimationCompressionStats
+AnimationCompression::compress(AnimationAsset &animation,
+                               const AnimationCompressionSettings &settings) {
+  AnimationCompressionStats stats{};
+
+  for (auto &sequence : animation.keyframes) {
+    stats.rawSize += getSize(sequence);
+
+    if (sequence.target == KeyframeSequenceAssetTarget::Position) {
+      compress(sequence, settings.positionError);
+    } else if (sequence.target == KeyframeSequenceAssetTarget::Rotation) {
+      compress(sequence, settings.rotationError);
+    } else if (sequence.target == KeyframeSequenceAssetTarget::Scale) {
+      compress(sequence, settings.scaleError);
+    }
+
+    stats.compressedSize += getSize(sequence);
+  }
+
+  return stats;
+}
+
+void AnimationCompression::compress(KeyframeSequenceAsset &sequence,
+                                    f32 maxError) {
+  if (sequence.encoding != KeyframeSequenceAssetEncoding::Raw ||
+      sequence.keyframeTimes.empty()) {
+    return;
+  }
+
+  const auto &values = sequence.keyframeValues;
+
+  bool constant = true;
+  for (usize i = 1; i < values.size() && constant; ++i) {
+    constant = getError(sequence, values.at(0), values.at(i)) <= maxError;
+  }
+
+  if (constant) {
+    sequence.encoding = KeyframeSequenceAssetEncoding::Constant;
+    sequence.rangeMin = values.at(0);
+    sequence.keyframeTimes.clear();
+    sequence.keyframeValues.clear();
+    return;
+  }
+
+  // Resampling moves the time of steps
+  if (sequence.interpolation == KeyframeSequenceAssetInterpolation::Step ||
+      sequence.keyframeTimes.back() <= sequence.keyframeTimes.front()) {
+    return;
+  }
+
+  const usize rawSize = getSize(sequence);
+
+  // Sample count is doubled until the error is within bounds
+  // or compressed sequence becomes larger than the raw one
+  for (u32 numSamples = 2;; numSamples = (numSamples - 1) * 2 + 1) {
+    auto uniform = createUniformSequence(sequence, numSamples);
+    if (getSize(uniform) >= rawSize) {
+      return;
+    }
+
+    if (getMaxError(sequence, uniform) <= maxError) {
+      sequence = std::move(uniform);
+      return;
+    }
+  }
+}
+
+usize AnimationCompression::getSize(const KeyframeSequenceAsset &sequence) {
+  switch (sequence.encoding) {
+  case KeyframeSequenceAssetEncoding::Constant:
+    return sizeof(glm::vec4);
+  case KeyframeSequenceAssetEncoding::Uniform:
+    return sizeof(glm::vec4) * 2 + sizeof(f32) * 2 + sizeof(u32) +
+           sequence.compressedValues.size() * sizeof(u16);
+  default:
+    return sequence.keyframeTimes.size() * sizeof(f32) +
+           sequence.keyframeValues.size() * sizeof(glm::vec4);
+  }
+}
+
+glm::vec4 AnimationCompression::decodeSample(
+    const KeyframeSequenceAsset &sequence, usize index) {
+  const usize stride = getStride(sequence);
+  const u16 *data = sequence.compressedValues.data() + index * stride;
+
+  if (sequence.target == KeyframeSequenceAssetTarget::Rotation) {
+    return decodeRotation(data);
+  }
+
+  glm::vec4 value{0.0f};
+  for (glm::length_t c = 0; c < 3; ++c) {
+    value[c] = sequence.rangeMin[c] + sequence.rangeExtent[c] *
+                                          static_cast<f32>(data[c]) /
+                                          QuantizedMax;
+  }
+
+  return value;
+}
+
+} // namespace quoll
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "AnimationAsset.h"
+
+namespace quoll {
+
+/**
+ * @brief Maximum allowed error of compressed animations
+ */
+struct AnimationCompressionSettings {
+  /**
+   * Maximum position error in world units
+   */
+  f32 positionError = 0.0001f;
+
+  /**
+   * Maximum rotation error in radians
+   */
+  f32 rotationError = 0.0005f;
+
+  /**
+   * Maximum scale error
+   */
+  f32 scaleError = 0.0001f;
+};
+
+/**
+ * @brief Animation size before and after compression
+ */
+struct AnimationCompressionStats {
+  usize rawSize = 0;
+
+  usize compressedSize = 0;
+};
+
+/**
+ * @brief Animation clip compression
+ *
+ * Sequences whose values do not change are stored
+ * as a single value. Linear sequences are resampled
+ * at uniform intervals, which removes keyframe times.
+ * Positions and scales are quantized within the
+ * range of the sequence and rotations are stored
+ * as the smallest three quaternion components.
+ * Sequences that cannot be compressed within the
+ * error bounds stay uncompressed.
+ */
+class AnimationCompression {
+public:
+  /**
+   * @brief Compress animation
+   *
+   * @param animation Animation
+   * @param settings Compression settings
+   * @return Animation size before and after compression
+   */
+  static AnimationCompressionStats
+  compress(AnimationAsset &animation,
+           const AnimationCompressionSettings &settings);
+
+  /**
+   * @brief Compress keyframe sequence
+   *
+   * @param sequence Keyframe sequence
+   * @param maxError Maximum error of sequence values
+   */
+  static void compress(KeyframeSequenceAsset &sequence, f32 maxError);
+
+  /**
+   * @brief Get size of keyframe sequence data
+   *
+   * @param sequence Keyframe sequence
+   * @return Size of keyframe data in bytes
+   */
+  static usize getSize(const KeyframeSequenceAsset &sequence);
+
+  /**
+   * @brief Decode uniform sample
+   *
+   * @param sequence Uniform keyframe sequence
+   * @param index Sample index
+   * @return Sample value
+   */
+  static glm::vec4 decodeSample(const KeyframeSequenceAsset &sequence,
+                                usize index);
+};
+
+} // namespace quoll
@@ -0,0 +1,111 @@
+#include "quoll/core/Base.h"
+#include "AnimationPose.h"
+
+namespace quoll {
+
+namespace {
+
+glm::quat blendRotation(const glm::quat &a, const glm::quat &b, f32 weight) {
+  if (weight >= 1.0f) {
+    return b;
+  }
+
+  // Negated quaternion is the same rotation;
+  // blend towards the one in the same hemisphere
+  const f32 dot = a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+  const f32 sign = dot < 0.0f ? -1.0f : 1.0f;
+  const f32 k = 1.0f - weight;
+  const f32 l = weight * sign;
+
+  return glm::normalize(glm::quat(a.w * k + b.w * l, a.x * k + b.x * l,
+                                  a.y * k + b.y * l, a.z * k + b.z * l));
+}
+
+f32 getMaskWeight(std::span<const f32> mask, usize index, f32 weight) {
+  if (mask.empty()) {
+    return weight;
+  }
+
+  return index < mask.size() ? mask[index] * weight : 0.0f;
+}
+
+} // namespace
+
+void AnimationPose::resize(usize size) {
+  positions.resize(size);
+  rotations.resize(size);
+  scales.resize(size);
+}
+
+void AnimationPose::blend(const AnimationPose &pose, f32 weight) {
+  blend(pose, weight, {});
+}
+
+void AnimationPose::blend(const AnimationPose &pose, f32 weight,
+                          std::span<const f32> mask) {
+  QuollAssert(pose.size() == size(), "Pose sizes must match");
+
+  if (weight >= 1.0f && mask.empty()) {
+    positions = pose.positions;
+    rotations = pose.rotations;
+    scales = pose.scales;
+    return;
+  }
+
+  for (usize i = 0; i < positions.size(); ++i) {
+    const f32 w = getMaskWeight(mask, i, weight);
+    if (w > 0.0f) {
+      positions[i] += (pose.positions[i] - positions[i]) * w;
+    }
+  }
+
+  for (usize i = 0; i < rotations.size(); ++i) {
+    const f32 w = getMaskWeight(mask, i, weight);
+    if (w > 0.0f) {
+      rotations[i] = blendRotation(rotations[i], pose.rotations[i], w);
+    }
+  }
+
+  for (usize i = 0; i < scales.size(); ++i) {
+    const f32 w = getMaskWeight(mask, i, weight);
+    if (w > 0.0f) {
+      scales[i] += (pose.scales[i] - scales[i]) * w;
+    }
+  }
+}
+
+void AnimationPose::add(const AnimationPose &pose,
+                        const AnimationPose &reference, f32 weight,
+                        std::span<const f32> mask) {
+  QuollAssert(pose.size() == size() && reference.size() == size(),
+              "Pose sizes must match");
+
+  static const glm::quat Identity{1.0f, 0.0f, 0.0f, 0.0f};
+
+  for (usize i = 0; i < positions.size(); ++i) {
+    const f32 w = getMaskWeight(mask, i, weight);
+    if (w > 0.0f) {
+      positions[i] += (pose.positions[i] - reference.positions[i]) * w;
+    }
+  }
+
+  for (usize i = 0; i < rotations.size(); ++i) {
+    const f32 w = getMaskWeight(mask, i, weight);
+    if (w > 0.0f) {
+      const auto delta =
+          glm::inverse(reference.rotations[i]) * pose.rotations[i];
+      rotations[i] =
+          glm::normalize(rotations[i] * blendRotation(Identity, delta, w));
+    }
+  }
+
+  for (usize i = 0; i < scales.size(); ++i) {
+    const f32 w = getMaskWeight(mask, i, weight);
+    if (w > 0.0f) {
+      const glm::vec3 delta = pose.scales[i] / reference.scales[i];
+      scales[i] *= glm::vec3(1.0f) + (delta - glm::vec3(1.0f)) * w;
+    }
+  }
+}
+
+} // namespace quoll
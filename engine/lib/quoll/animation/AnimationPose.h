@@ -0,0 +1,69 @@
+#pragma once
+
+namespace quoll {
+
+/**
+ * @brief Local transforms of animated targets
+ *
+ * Stored as structure of arrays, so that
+ * blending passes stream over every
+ * component separately.
+ */
+struct AnimationPose {
+  std::vector<glm::vec3> positions;
+
+  std::vector<glm::quat> rotations;
+
+  std::vector<glm::vec3> scales;
+
+  /**
+   * @brief Get number of targets
+   *
+   * @return Number of targets
+   */
+  inline usize size() const { return positions.size(); }
+
+  /**
+   * @brief Resize pose
+   *
+   * @param size Number of targets
+   */
+  void resize(usize size);
+
+  /**
+   * @brief Blend pose towards another pose
+   *
+   * @param pose Target pose
+   * @param weight Weight of target pose
+   */
+  void blend(const AnimationPose &pose, f32 weight);
+
+  /**
+   * @brief Blend pose towards another pose per target
+   *
+   * Targets outside of the mask are not
+   * affected. Empty mask affects all targets.
+   *
+   * @param pose Target pose
+   * @param weight Weight of target pose
+   * @param mask Weight of every target
+   */
+  void blend(const AnimationPose &pose, f32 weight,
+             std::span<const f32> mask);
+
+  /**
+   * @brief Add difference between two poses
+   *
+   * Targets outside of the mask are not
+   * affected. Empty mask affects all targets.
+   *
+   * @param pose Additive pose
+   * @param reference Pose that additive pose is relative to
+   * @param weight Weight of difference
+   * @param mask Weight of every target
+   */
+  void add(const AnimationPose &pose, const AnimationPose &reference,
+           f32 weight, std::span<const f32> mask);
+};
+
+} // namespace quoll
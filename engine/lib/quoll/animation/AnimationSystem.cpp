@@ -1,4 +1,5 @@
 #include "quoll/core/Base.h"
+#include "quoll/core/Engine.h"
 #include "quoll/core/Profiler.h"
 #include "quoll/asset/AssetRegistry.h"
 #include "quoll/entity/EntityDatabase.h"
@@ -10,12 +11,386 @@
 
 namespace quoll {
 
+namespace {
+
+static constexpr usize NoState = std::numeric_limits<usize>::max();
+
+/**
+ * Cross-fade blends two states and every
+ * state blends up to two animations
+ */
+static constexpr usize MaxStateAnimations = 4;
+
+struct StateAnimation {
+  const AssetRef<AnimationAsset> *animation = nullptr;
+
+  f32 normalizedTime = 0.0f;
+
+  f32 weight = 0.0f;
+};
+
+using StateAnimations = std::array<StateAnimation, MaxStateAnimations>;
+
+bool isStateValid(const AnimationState &state) {
+  if (state.blendSpace.empty()) {
+    return state.animation;
+  }
+
+  for (const auto &point : state.blendSpace) {
+    if (!point.animation) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * @brief Get position of parameter in blend space
+ *
+ * @param state Animation state with blend space
+ * @param animator Animator
+ * @param[out] index Index of first blended point
+ * @return Weight of second blended point
+ */
+f32 getBlendSpaceWeight(const AnimationState &state, const Animator &animator,
+                        usize &index) {
+  const auto &points = state.blendSpace;
+
+  const f32 value = state.blendParameter < animator.parameters.size()
+                        ? animator.parameters.at(state.blendParameter)
+                        : 0.0f;
+
+  index = 0;
+  while (index + 2 < points.size() &&
+         points.at(index + 1).position <= value) {
+    ++index;
+  }
+
+  if (index + 1 == points.size()) {
+    return 0.0f;
+  }
+
+  const f32 start = points.at(index).position;
+  const f32 end = points.at(index + 1).position;
+  if (end <= start) {
+    return 0.0f;
+  }
+
+  return std::clamp((value - start) / (end - start), 0.0f, 1.0f);
+}
+
+f32 getStateDuration(const AnimationState &state, const Animator &animator) {
+  if (state.blendSpace.empty()) {
+    return state.animation->time;
+  }
+
+  // Animations in blend space are synchronized;
+  // so, duration is blended as well
+  usize index = 0;
+  const f32 k = getBlendSpaceWeight(state, animator, index);
+  const f32 duration = state.blendSpace.at(index).animation->time;
+  if (k == 0.0f) {
+    return duration;
+  }
+
+  return duration +
+         (state.blendSpace.at(index + 1).animation->time - duration) * k;
+}
+
+f32 advanceStateTime(const AnimationState &state, const Animator &animator,
+                     f32 normalizedTime, f32 dt) {
+  // Divide delta time by animation time
+  // to advance time at a constant speed
+  normalizedTime =
+      std::min(normalizedTime +
+                   (dt * state.speed / getStateDuration(state, animator)),
+               1.0f);
+
+  if (normalizedTime >= 1.0f && state.loopMode == AnimationLoopMode::Linear) {
+    return 0.0f;
+  }
+
+  return normalizedTime;
+}
+
+void addStateAnimations(const AnimationState &state, const Animator &animator,
+                        f32 normalizedTime, f32 weight,
+                        StateAnimations &animations, usize &count) {
+  if (state.blendSpace.empty()) {
+    animations.at(count++) = {&state.animation, normalizedTime, weight};
+    return;
+  }
+
+  usize index = 0;
+  const f32 k = getBlendSpaceWeight(state, animator, index);
+
+  animations.at(count++) = {&state.blendSpace.at(index).animation,
+                            normalizedTime, weight * (1.0f - k)};
+  if (k > 0.0f) {
+    animations.at(count++) = {&state.blendSpace.at(index + 1).animation,
+                              normalizedTime, weight * k};
+  }
+}
+
+/**
+ * @brief Sample animation into pose
+ *
+ * Joint sequences target the joints of the
+ * pose and other sequences target the
+ * last item of the pose, which stores the
+ * transform of the entity.
+ *
+ * @param animation Animation
+ * @param sample Animation sample
+ */
+void sampleAnimation(const AnimationAsset &animation,
+                     AnimationSample &sample) {
+  auto &pose = sample.pose;
+  const usize transformIndex = pose.size() - 1;
+  const bool hasSkeleton = transformIndex > 0;
+
+  // Cursors of a previously sampled animation
+  // only affect lookup speed, not the result
+  auto &cursors = sample.keyframeCursors;
+  cursors.resize(animation.keyframes.size(), 0);
+
+  sample.animatesTransform = false;
+
+  const f32 time = sample.normalizedTime;
+  for (usize i = 0; i < animation.keyframes.size(); ++i) {
+    const auto &sequence = animation.keyframes.at(i);
+    auto &cursor = cursors.at(i);
+
+    usize index = transformIndex;
+    if (sequence.jointTarget && hasSkeleton) {
+      if (sequence.joint >= transformIndex) {
+        continue;
+      }
+
+      index = sequence.joint;
+    } else {
+      sample.animatesTransform = true;
+    }
+
+    if (sequence.target == KeyframeSequenceAssetTarget::Position) {
+      pose.positions[index] =
+          KeyframeInterpolator::interpolateVec3(sequence, time, cursor);
+    } else if (sequence.target == KeyframeSequenceAssetTarget::Rotation) {
+      pose.rotations[index] =
+          KeyframeInterpolator::interpolateQuat(sequence, time, cursor);
+    } else if (sequence.target == KeyframeSequenceAssetTarget::Scale) {
+      pose.scales[index] =
+          KeyframeInterpolator::interpolateVec3(sequence, time, cursor);
+    }
+  }
+}
+
+/**
+ * @brief Get sample of animation at a point in time
+ *
+ * Animation is sampled only once per frame
+ * for every point in time.
+ *
+ * @param animator Animator
+ * @param animation Animation
+ * @param normalizedTime Normalized time
+ * @return Index of sample
+ */
+usize requestSample(Animator &animator,
+                    const AssetRef<AnimationAsset> &animation,
+                    f32 normalizedTime) {
+  for (usize i = 0; i < animator.numSamples; ++i) {
+    const auto &sample = animator.samples.at(i);
+    if (sample.animation == animation.handle() &&
+        sample.normalizedTime == normalizedTime) {
+      return i;
+    }
+  }
+
+  const usize index = animator.numSamples++;
+  if (index == animator.samples.size()) {
+    animator.samples.emplace_back();
+  }
+
+  auto &sample = animator.samples.at(index);
+  sample.animation = animation.handle();
+  sample.normalizedTime = normalizedTime;
+
+  // Targets that are not animated keep
+  // their values from the previous frame
+  sample.pose = animator.pose;
+  sampleAnimation(animation.get(), sample);
+
+  return index;
+}
+
+void advanceAnimator(f32 dt, Animator &animator) {
+  const auto &asset = animator.asset.get();
+  const auto &state = asset.states.at(animator.currentState);
+
+  animator.normalizedTime =
+      advanceStateTime(state, animator, animator.normalizedTime, dt);
+
+  if (animator.previousState != NoState) {
+    animator.transitionTime += dt;
+    if (animator.transitionTime >= animator.transitionDuration) {
+      animator.previousState = NoState;
+    } else {
+      animator.previousNormalizedTime = advanceStateTime(
+          asset.states.at(animator.previousState), animator,
+          animator.previousNormalizedTime, dt);
+    }
+  }
+
+  animator.layerNormalizedTimes.resize(asset.layers.size(), 0.0f);
+  for (usize i = 0; i < asset.layers.size(); ++i) {
+    const auto &layer = asset.layers.at(i);
+    if (!layer.animation) {
+      continue;
+    }
+
+    // Layers always loop
+    auto &time = animator.layerNormalizedTimes.at(i);
+    time += dt * layer.speed / layer.animation->time;
+    time -= std::floor(time);
+  }
+}
+
+void updateAnimator(f32 dt, Entity entity, LocalTransform &transform,
+                    Animator &animator, EntityDatabase &entityDatabase) {
+  const auto &asset = animator.asset.get();
+  const auto &state = asset.states.at(animator.currentState);
+
+  if (!isStateValid(state)) {
+    return;
+  }
+
+  if (animator.previousState != NoState &&
+      !isStateValid(asset.states.at(animator.previousState))) {
+    animator.previousState = NoState;
+  }
+
+  if (animator.playing) {
+    advanceAnimator(dt, animator);
+  }
+
+  Skeleton *skeleton = entityDatabase.has<Skeleton>(entity)
+                           ? &entityDatabase.get<Skeleton>(entity)
+                           : nullptr;
+
+  const usize numJoints =
+      skeleton ? skeleton->jointLocalPositions.size() : 0;
+
+  auto &pose = animator.pose;
+  pose.resize(numJoints + 1);
+  if (skeleton) {
+    std::copy(skeleton->jointLocalPositions.begin(),
+              skeleton->jointLocalPositions.end(), pose.positions.begin());
+    std::copy(skeleton->jointLocalRotations.begin(),
+              skeleton->jointLocalRotations.end(), pose.rotations.begin());
+    std::copy(skeleton->jointLocalScales.begin(),
+              skeleton->jointLocalScales.end(), pose.scales.begin());
+  }
+  pose.positions.at(numJoints) = transform.localPosition;
+  pose.rotations.at(numJoints) = transform.localRotation;
+  pose.scales.at(numJoints) = transform.localScale;
+
+  animator.numSamples = 0;
+
+  StateAnimations animations{};
+  usize numAnimations = 0;
+  if (animator.previousState != NoState) {
+    const f32 k = animator.transitionTime / animator.transitionDuration;
+    addStateAnimations(asset.states.at(animator.previousState), animator,
+                       animator.previousNormalizedTime, 1.0f - k, animations,
+                       numAnimations);
+    addStateAnimations(state, animator, animator.normalizedTime, k,
+                       animations, numAnimations);
+  } else {
+    addStateAnimations(state, animator, animator.normalizedTime, 1.0f,
+                       animations, numAnimations);
+  }
+
+  // Blending with normalized weights produces the weighted
+  // average of all animations without an accumulation pose
+  f32 totalWeight = 0.0f;
+  for (usize i = 0; i < numAnimations; ++i) {
+    const auto &animation = animations.at(i);
+    if (animation.weight <= 0.0f) {
+      continue;
+    }
+
+    const usize index = requestSample(animator, *animation.animation,
+                                      animation.normalizedTime);
+
+    totalWeight += animation.weight;
+    pose.blend(animator.samples.at(index).pose,
+               animation.weight / totalWeight);
+  }
+
+  for (usize i = 0; i < asset.layers.size(); ++i) {
+    const auto &layer = asset.layers.at(i);
+    const f32 weight = i < animator.layerWeights.size()
+                           ? animator.layerWeights.at(i)
+                           : layer.weight;
+
+    if (!layer.animation || weight <= 0.0f) {
+      continue;
+    }
+
+    const usize index = requestSample(animator, layer.animation,
+                                      animator.layerNormalizedTimes.at(i));
+
+    if (layer.blendMode == AnimationLayerBlendMode::Additive) {
+      // Additive animations are relative to their first frame
+      const usize referenceIndex =
+          requestSample(animator, layer.animation, 0.0f);
+
+      pose.add(animator.samples.at(index).pose,
+               animator.samples.at(referenceIndex).pose, weight,
+               layer.jointMask);
+    } else {
+      pose.blend(animator.samples.at(index).pose, weight, layer.jointMask);
+    }
+  }
+
+  if (skeleton) {
+    std::copy_n(pose.positions.begin(), numJoints,
+                skeleton->jointLocalPositions.begin());
+    std::copy_n(pose.rotations.begin(), numJoints,
+                skeleton->jointLocalRotations.begin());
+    std::copy_n(pose.scales.begin(), numJoints,
+                skeleton->jointLocalScales.begin());
+  }
+
+  bool animatesTransform = false;
+  for (usize i = 0; i < animator.numSamples; ++i) {
+    animatesTransform |= animator.samples.at(i).animatesTransform;
+  }
+
+  if (animatesTransform) {
+    transform.localPosition = pose.positions.at(numJoints);
+    transform.localRotation = pose.rotations.at(numJoints);
+    transform.localScale = pose.scales.at(numJoints);
+    transform.dirty.mark();
+  }
+}
+
+} // namespace
+
 void AnimationSystem::prepare(SystemView &view) {
   QUOLL_PROFILE_EVENT("AnimationSystem::prepare");
 
   auto &entityDatabase = view.scene->entityDatabase;
 
-  for (auto [entity, ref] : entityDatabase.view<AnimatorAssetRef>()) {
+  // Cursor is not moved if an asset is not loaded or
+  // invalid; so, the ref is checked again in next prepare
+  const auto lastCursor = mAnimatorAssetChanges;
+  const u64 since =
+      entityDatabase.readChanges<AnimatorAssetRef>(mAnimatorAssetChanges);
+  for (auto [entity, ref] : entityDatabase.view<AnimatorAssetRef>()
+                                .changedSince<AnimatorAssetRef>(since)) {
     if (entityDatabase.has<AnimatorCurrentAsset>(entity) &&
         entityDatabase.get<AnimatorCurrentAsset>(entity).handle ==
             ref.asset.handle()) {
@@ -23,25 +398,43 @@ void AnimationSystem::prepare(SystemView &view) {
     }
 
     if (!ref.asset) {
+      mAnimatorAssetChanges = lastCursor;
       continue;
     }
 
     bool stop = false;
     for (const auto &state : ref.asset->states) {
-      if (!state.animation) {
+      if (!isStateValid(state)) {
+        stop = true;
+        break;
+      }
+    }
+
+    for (const auto &layer : ref.asset->layers) {
+      if (!layer.animation) {
         stop = true;
         break;
       }
     }
 
     if (stop) {
+      mAnimatorAssetChanges = lastCursor;
       continue;
     }
 
-    const Animator animator{.asset = ref.asset,
-                            .currentState = ref.asset->initialState,
-                            .normalizedTime = 0.0f,
-                            .playing = true};
+    Animator animator{.asset = ref.asset,
+                      .currentState = ref.asset->initialState,
+                      .normalizedTime = 0.0f,
+                      .playing = true};
+
+    for (const auto &parameter : ref.asset->parameters) {
+      animator.parameters.push_back(parameter.value);
+    }
+
+    for (const auto &layer : ref.asset->layers) {
+      animator.layerWeights.push_back(layer.weight);
+    }
+    animator.layerNormalizedTimes.resize(ref.asset->layers.size(), 0.0f);
 
     entityDatabase.set(entity, animator);
     entityDatabase.set(entity, AnimatorCurrentAsset{ref.asset.handle()});
@@ -58,6 +451,15 @@ void AnimationSystem::update(f32 dt, SystemView &view) {
 
     for (auto &transition : state.transitions) {
       if (transition.eventName == animatorEvent.eventName) {
+        if (transition.duration > 0.0f) {
+          animator.previousState = animator.currentState;
+          animator.previousNormalizedTime = animator.normalizedTime;
+          animator.transitionTime = 0.0f;
+          animator.transitionDuration = transition.duration;
+        } else {
+          animator.previousState = NoState;
+        }
+
         animator.currentState = transition.target;
         animator.normalizedTime = 0.0f;
         break;
@@ -67,60 +469,13 @@ void AnimationSystem::update(f32 dt, SystemView &view) {
 
   entityDatabase.destroyComponents<AnimatorEvent>();
 
-  for (auto [entity, transform, animator] :
-       entityDatabase.view<LocalTransform, Animator>()) {
-
-    const auto &state = animator.asset->states.at(animator.currentState);
-
-    const auto &animation = state.animation;
-
-    if (!animation) {
-      continue;
-    }
-
-    if (animator.playing) {
-      animator.normalizedTime = std::min(
-          // Divide delta time by animation time
-          // to advance time at a constant speed
-          animator.normalizedTime + (dt * state.speed / animation->time), 1.0f);
-      if (animator.normalizedTime >= 1.0f &&
-          state.loopMode == AnimationLoopMode::Linear) {
-        animator.normalizedTime = 0.0f;
-      }
-    }
-
-    const bool hasSkeleton = entityDatabase.has<Skeleton>(entity);
-
-    for (const auto &sequence : animation->keyframes) {
-      if (sequence.jointTarget && hasSkeleton) {
-        auto &skeleton = entityDatabase.get<Skeleton>(entity);
-        if (sequence.target == KeyframeSequenceAssetTarget::Position) {
-          skeleton.jointLocalPositions.at(sequence.joint) =
-              KeyframeInterpolator::interpolateVec3(sequence,
-                                                    animator.normalizedTime);
-        } else if (sequence.target == KeyframeSequenceAssetTarget::Rotation) {
-          skeleton.jointLocalRotations.at(sequence.joint) =
-              KeyframeInterpolator::interpolateQuat(sequence,
-                                                    animator.normalizedTime);
-        } else if (sequence.target == KeyframeSequenceAssetTarget::Scale) {
-          skeleton.jointLocalScales.at(sequence.joint) =
-              KeyframeInterpolator::interpolateVec3(sequence,
-                                                    animator.normalizedTime);
-        }
-      } else {
-        if (sequence.target == KeyframeSequenceAssetTarget::Position) {
-          transform.localPosition = KeyframeInterpolator::interpolateVec3(
-              sequence, animator.normalizedTime);
-        } else if (sequence.target == KeyframeSequenceAssetTarget::Rotation) {
-          transform.localRotation = KeyframeInterpolator::interpolateQuat(
-              sequence, animator.normalizedTime);
-        } else if (sequence.target == KeyframeSequenceAssetTarget::Scale) {
-          transform.localScale = KeyframeInterpolator::interpolateVec3(
-              sequence, animator.normalizedTime);
-        }
-      }
-    }
-  }
+  // Animators only modify components of their own entity
+  entityDatabase.view<LocalTransform, Animator>().parallelForEach(
+      Engine::getThreadPool(),
+      [dt, &entityDatabase](Entity entity, LocalTransform &transform,
+                            Animator &animator) {
+        updateAnimator(dt, entity, transform, animator, entityDatabase);
+      });
 }
 
 } // namespace quoll
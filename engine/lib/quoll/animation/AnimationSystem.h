@@ -1,5 +1,6 @@
 #pragma once
 
+#include "quoll/entity/EntityStorageSparseSetChangeCursor.h"
 #include "KeyframeInterpolator.h"
 
 namespace quoll {
@@ -15,6 +16,8 @@ public:
 
 private:
   KeyframeInterpolator mKeyframeInterpolator;
+
+  EntityStorageSparseSetChangeCursor mAnimatorAssetChanges;
 };
 
 } // namespace quoll
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "quoll/asset/AssetRef.h"
+#include "AnimationPose.h"
 #include "AnimatorAsset.h"
 
 namespace quoll {
@@ -13,6 +14,29 @@ struct AnimatorCurrentAsset {
   AssetHandle<AnimatorAsset> handle;
 };
 
+/**
+ * @brief Animation sampled at a point in time
+ *
+ * Every animation is sampled once per frame
+ * regardless of how many states and layers
+ * reference it at the same time.
+ */
+struct AnimationSample {
+  AssetHandle<AnimationAsset> animation;
+
+  f32 normalizedTime = 0.0f;
+
+  /**
+   * Last sampled keyframe of every
+   * sequence in the animation
+   */
+  std::vector<usize> keyframeCursors;
+
+  AnimationPose pose;
+
+  bool animatesTransform = false;
+};
+
 struct Animator {
   AssetRef<AnimatorAsset> asset;
 
@@ -21,6 +45,43 @@ struct Animator {
   f32 normalizedTime = 0.0f;
 
   bool playing = true;
+
+  /**
+   * State that is faded out during
+   * cross-fade transition
+   */
+  usize previousState = std::numeric_limits<usize>::max();
+
+  f32 previousNormalizedTime = 0.0f;
+
+  /**
+   * Elapsed cross-fade time in seconds
+   */
+  f32 transitionTime = 0.0f;
+
+  f32 transitionDuration = 0.0f;
+
+  /**
+   * Values of animator asset parameters
+   */
+  std::vector<f32> parameters;
+
+  std::vector<f32> layerWeights;
+
+  std::vector<f32> layerNormalizedTimes;
+
+  /**
+   * Animations sampled in current frame
+   */
+  std::vector<AnimationSample> samples;
+
+  usize numSamples = 0;
+
+  /**
+   * Blended pose that is written
+   * to skeleton and transform
+   */
+  AnimationPose pose;
 };
 
 } // namespace quoll
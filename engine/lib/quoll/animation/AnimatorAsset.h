@@ -7,10 +7,29 @@ namespace quoll {
 
 enum class AnimationLoopMode { None = 0, Linear = 1 };
 
+enum class AnimationLayerBlendMode { Override = 0, Additive = 1 };
+
 struct AnimationStateTransition {
   String eventName;
 
   usize target;
+
+  /**
+   * Cross-fade duration in seconds
+   *
+   * Target state is switched to
+   * immediately if duration is zero
+   */
+  f32 duration = 0.0f;
+};
+
+/**
+ * @brief Animation in 1D blend space
+ */
+struct AnimationBlendPoint {
+  AssetRef<AnimationAsset> animation;
+
+  f32 position = 0.0f;
 };
 
 struct AnimationState {
@@ -23,12 +42,57 @@ struct AnimationState {
   AnimationLoopMode loopMode = AnimationLoopMode::None;
 
   std::vector<AnimationStateTransition> transitions;
+
+  /**
+   * Blend space points sorted by position
+   *
+   * State blends two neighboring animations
+   * based on value of blend parameter if
+   * blend space is not empty
+   */
+  std::vector<AnimationBlendPoint> blendSpace;
+
+  usize blendParameter = 0;
+};
+
+struct AnimatorParameter {
+  String name;
+
+  f32 value = 0.0f;
+};
+
+/**
+ * @brief Looping animation applied on top of states
+ */
+struct AnimationLayer {
+  String name;
+
+  AssetRef<AnimationAsset> animation;
+
+  f32 weight = 1.0f;
+
+  f32 speed = 1.0f;
+
+  AnimationLayerBlendMode blendMode = AnimationLayerBlendMode::Override;
+
+  /**
+   * Weight of every joint
+   *
+   * Joints outside of the mask are not affected.
+   * Empty mask affects all joints and the
+   * transform of the entity.
+   */
+  std::vector<f32> jointMask;
 };
 
 struct AnimatorAsset {
   usize initialState = 0;
 
   std::vector<AnimationState> states;
+
+  std::vector<AnimatorParameter> parameters;
+
+  std::vector<AnimationLayer> layers;
 };
 
 } // namespace quoll
@@ -35,6 +35,48 @@ sol_maybe<AnimationStateLuaTable> AnimatorLuaTable::getCurrentState() {
   return AnimationStateLuaTable(state);
 }
 
+void AnimatorLuaTable::setParameter(String name, f32 value) {
+  if (!mScriptGlobals.entityDatabase.has<Animator>(mEntity)) {
+    Engine::getUserLogger().error()
+        << lua::Messages::componentDoesNotExist(getName(), mEntity);
+    return;
+  }
+
+  auto &animator = mScriptGlobals.entityDatabase.get<Animator>(mEntity);
+  const auto &parameters = animator.asset->parameters;
+  for (usize i = 0; i < parameters.size(); ++i) {
+    if (parameters.at(i).name == name) {
+      animator.parameters.resize(parameters.size(), 0.0f);
+      animator.parameters.at(i) = value;
+      return;
+    }
+  }
+
+  Engine::getUserLogger().error()
+      << "Animator parameter \"" << name << "\" does not exist";
+}
+
+void AnimatorLuaTable::setLayerWeight(String name, f32 weight) {
+  if (!mScriptGlobals.entityDatabase.has<Animator>(mEntity)) {
+    Engine::getUserLogger().error()
+        << lua::Messages::componentDoesNotExist(getName(), mEntity);
+    return;
+  }
+
+  auto &animator = mScriptGlobals.entityDatabase.get<Animator>(mEntity);
+  const auto &layers = animator.asset->layers;
+  for (usize i = 0; i < layers.size(); ++i) {
+    if (layers.at(i).name == name) {
+      animator.layerWeights.resize(layers.size(), 1.0f);
+      animator.layerWeights.at(i) = std::clamp(weight, 0.0f, 1.0f);
+      return;
+    }
+  }
+
+  Engine::getUserLogger().error()
+      << "Animator layer \"" << name << "\" does not exist";
+}
+
 void AnimatorLuaTable::trigger(String event) {
   mScriptGlobals.entityDatabase.set<AnimatorEvent>(mEntity, {event});
 }
@@ -61,6 +103,8 @@ void AnimatorLuaTable::create(sol::usertype<AnimatorLuaTable> usertype,
       sol::property(&AnimatorLuaTable::getNormalizedTime);
   usertype["currentState"] = sol::property(&AnimatorLuaTable::getCurrentState);
   usertype["trigger"] = &AnimatorLuaTable::trigger;
+  usertype["setParameter"] = &AnimatorLuaTable::setParameter;
+  usertype["setLayerWeight"] = &AnimatorLuaTable::setLayerWeight;
   usertype["delete"] = &AnimatorLuaTable::deleteThis;
 }
 
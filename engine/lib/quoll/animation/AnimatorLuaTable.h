@@ -15,6 +15,10 @@ public:
 
   void trigger(String event);
 
+  void setParameter(String name, f32 value);
+
+  void setLayerWeight(String name, f32 weight);
+
   void deleteThis();
 
   static const String getName() { return "animator"; }
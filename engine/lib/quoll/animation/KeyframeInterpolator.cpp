@@ -1,5 +1,6 @@
 #include "quoll/core/Base.h"
 #include "AnimationAsset.h"
+#include "AnimationCompression.h"
 #include "KeyframeInterpolator.h"
 
 namespace quoll {
@@ -19,32 +20,55 @@ glm::quat interpolateLinear(const glm::quat &a, const glm::quat &b, f32 k) {
   return glm::normalize(glm::slerp(a, b, k));
 }
 
-template <class T>
-T getStepValue(const KeyframeSequenceAsset &sequence, f32 time) {
-  usize found = 0;
-
-  for (usize i = 0; i < sequence.keyframeTimes.size(); ++i) {
-    if (time < sequence.keyframeTimes.at(i)) {
-      break;
+/**
+ * @brief Find keyframe at or before time
+ *
+ * Playback time mostly moves forward in small
+ * steps; so, search starts from the cursor and
+ * grows exponentially. Lookup cost depends on
+ * the number of skipped keyframes instead of
+ * the total number of keyframes.
+ *
+ * @param times Sorted keyframe times
+ * @param time Time
+ * @param cursor Keyframe found in previous lookup
+ * @return Index of last keyframe that starts at or before time
+ */
+usize findKeyframe(const std::vector<f32> &times, f32 time, usize cursor) {
+  const usize size = times.size();
+
+  if (cursor < size && times[cursor] <= time) {
+    usize low = cursor;
+    usize step = 1;
+    while (low + step < size && times[low + step] <= time) {
+      low += step;
+      step *= 2;
     }
 
-    found = i;
+    auto it = std::upper_bound(times.begin() + low + 1,
+                               times.begin() + std::min(low + step, size),
+                               time);
+    return static_cast<usize>(it - times.begin()) - 1;
   }
 
-  return convertVec4<T>(sequence.keyframeValues.at(found));
+  auto it = std::upper_bound(times.begin(), times.end(), time);
+  return it == times.begin() ? 0
+                             : static_cast<usize>(it - times.begin()) - 1;
 }
 
 template <class T>
-const T getLinearValue(const KeyframeSequenceAsset &sequence, f32 time) {
-  usize found = 0;
+T getStepValue(const KeyframeSequenceAsset &sequence, f32 time,
+               usize &cursor) {
+  cursor = findKeyframe(sequence.keyframeTimes, time, cursor);
 
-  for (usize i = 0; i < sequence.keyframeTimes.size(); ++i) {
-    if (time < sequence.keyframeTimes.at(i)) {
-      break;
-    }
+  return convertVec4<T>(sequence.keyframeValues.at(cursor));
+}
 
-    found = i;
-  }
+template <class T>
+const T getLinearValue(const KeyframeSequenceAsset &sequence, f32 time,
+                       usize &cursor) {
+  const usize found = findKeyframe(sequence.keyframeTimes, time, cursor);
+  cursor = found;
 
   if (found == sequence.keyframeTimes.size() - 1) {
     return convertVec4<T>(sequence.keyframeValues.at(found));
@@ -62,24 +86,65 @@ const T getLinearValue(const KeyframeSequenceAsset &sequence, f32 time) {
 }
 
 template <class T>
-T interpolate(const KeyframeSequenceAsset &sequence, f32 time) {
+T getUniformValue(const KeyframeSequenceAsset &sequence, f32 time) {
+  const f32 duration = sequence.endTime - sequence.startTime;
+  const f32 position = std::clamp((time - sequence.startTime) / duration,
+                                  0.0f, 1.0f) *
+                       static_cast<f32>(sequence.numSamples - 1);
+
+  const usize lastIndex = static_cast<usize>(sequence.numSamples) - 1;
+  const usize index = std::min(static_cast<usize>(position), lastIndex - 1);
+  const f32 k = position - static_cast<f32>(index);
+
+  const auto &currentVal =
+      convertVec4<T>(AnimationCompression::decodeSample(sequence, index));
+  const auto &nextVal =
+      convertVec4<T>(AnimationCompression::decodeSample(sequence, index + 1));
+
+  return interpolateLinear(currentVal, nextVal, k);
+}
+
+template <class T>
+T interpolate(const KeyframeSequenceAsset &sequence, f32 time, usize &cursor) {
+  if (sequence.encoding == KeyframeSequenceAssetEncoding::Constant) {
+    return convertVec4<T>(sequence.rangeMin);
+  }
+
+  if (sequence.encoding == KeyframeSequenceAssetEncoding::Uniform) {
+    return getUniformValue<T>(sequence, time);
+  }
+
   if (sequence.interpolation == KeyframeSequenceAssetInterpolation::Step) {
-    return getStepValue<T>(sequence, time);
+    return getStepValue<T>(sequence, time, cursor);
   }
 
-  return getLinearValue<T>(sequence, time);
+  return getLinearValue<T>(sequence, time, cursor);
 }
 
 glm::vec3
 KeyframeInterpolator::interpolateVec3(const KeyframeSequenceAsset &sequence,
                                       f32 time) {
-  return interpolate<glm::vec3>(sequence, time);
+  usize cursor = 0;
+  return interpolate<glm::vec3>(sequence, time, cursor);
+}
+
+glm::vec3
+KeyframeInterpolator::interpolateVec3(const KeyframeSequenceAsset &sequence,
+                                      f32 time, usize &cursor) {
+  return interpolate<glm::vec3>(sequence, time, cursor);
 }
 
 glm::quat
 KeyframeInterpolator::interpolateQuat(const KeyframeSequenceAsset &sequence,
                                       f32 time) {
-  return interpolate<glm::quat>(sequence, time);
+  usize cursor = 0;
+  return interpolate<glm::quat>(sequence, time, cursor);
+}
+
+glm::quat
+KeyframeInterpolator::interpolateQuat(const KeyframeSequenceAsset &sequence,
+                                      f32 time, usize &cursor) {
+  return interpolate<glm::quat>(sequence, time, cursor);
 }
 
 } // namespace quoll
@@ -9,8 +9,34 @@ public:
   static glm::vec3 interpolateVec3(const KeyframeSequenceAsset &sequence,
                                    f32 time);
 
+  /**
+   * @brief Interpolate vec3 using keyframe cursor
+   *
+   * Cursor stores the keyframe that was found in
+   * previous lookup, which makes sampling with
+   * increasing time constant in most cases.
+   *
+   * @param sequence Keyframe sequence
+   * @param time Time
+   * @param cursor Keyframe cursor
+   * @return Interpolated value
+   */
+  static glm::vec3 interpolateVec3(const KeyframeSequenceAsset &sequence,
+                                   f32 time, usize &cursor);
+
   static glm::quat interpolateQuat(const KeyframeSequenceAsset &sequence,
                                    f32 time);
+
+  /**
+   * @brief Interpolate quaternion using keyframe cursor
+   *
+   * @param sequence Keyframe sequence
+   * @param time Time
+   * @param cursor Keyframe cursor
+   * @return Interpolated value
+   */
+  static glm::quat interpolateQuat(const KeyframeSequenceAsset &sequence,
+                                   f32 time, usize &cursor);
 };
 
 } // namespace quoll
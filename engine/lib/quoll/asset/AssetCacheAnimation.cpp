@@ -7,6 +7,18 @@
 
 namespace quoll {
 
+namespace {
+
+/**
+ * Version of animation file layout
+ *
+ * Version 0 files do not store encodings
+ * and all their keyframes are raw
+ */
+constexpr u32 AnimationFileVersion = 1;
+
+} // namespace
+
 Result<void> AssetCache::createAnimationFromData(const AnimationAsset &data,
                                                  const Path &assetPath) {
   OutputBinaryStream file(assetPath);
@@ -17,7 +29,8 @@ Result<void> AssetCache::createAnimationFromData(const AnimationAsset &data,
 
   AssetFileHeader header{};
   header.type = AssetType::Animation;
-  header.magic = AssetFileHeader::MagicConstant;
+  header.magic = AssetFileHeader::VersionedMagicConstant;
+  header.version = AnimationFileVersion;
   file.write(header);
 
   file.write(data.time);
@@ -29,11 +42,25 @@ Result<void> AssetCache::createAnimationFromData(const AnimationAsset &data,
     file.write(keyframe.interpolation);
     file.write(keyframe.jointTarget);
     file.write(keyframe.joint);
-
-    const u32 numValues = static_cast<u32>(keyframe.keyframeTimes.size());
-    file.write(numValues);
-    file.write(keyframe.keyframeTimes);
-    file.write(keyframe.keyframeValues);
+    file.write(keyframe.encoding);
+
+    if (keyframe.encoding == KeyframeSequenceAssetEncoding::Constant) {
+      file.write(keyframe.rangeMin);
+    } else if (keyframe.encoding == KeyframeSequenceAssetEncoding::Uniform) {
+      file.write(keyframe.startTime);
+      file.write(keyframe.endTime);
+      file.write(keyframe.rangeMin);
+      file.write(keyframe.rangeExtent);
+      file.write(keyframe.numSamples);
+      const u32 numValues = static_cast<u32>(keyframe.compressedValues.size());
+      file.write(numValues);
+      file.write(keyframe.compressedValues);
+    } else {
+      const u32 numValues = static_cast<u32>(keyframe.keyframeTimes.size());
+      file.write(numValues);
+      file.write(keyframe.keyframeTimes);
+      file.write(keyframe.keyframeValues);
+    }
   }
 
   return Ok();
@@ -44,11 +71,17 @@ Result<AnimationAsset> AssetCache::loadAnimation(const Path &path) {
 
   AssetFileHeader header;
   stream.read(header);
-  if (header.magic != AssetFileHeader::MagicConstant ||
+  if ((header.magic != AssetFileHeader::MagicConstant &&
+       header.magic != AssetFileHeader::VersionedMagicConstant) ||
       header.type != AssetType::Animation) {
     return Error("Invalid file format");
   }
 
+  if (header.version > AnimationFileVersion) {
+    return Error("Unsupported animation file version: " +
+                 std::to_string(header.version));
+  }
+
   AnimationAsset animation{};
 
   stream.read(animation.time);
@@ -62,12 +95,40 @@ Result<AnimationAsset> AssetCache::loadAnimation(const Path &path) {
     stream.read(keyframe.jointTarget);
     stream.read(keyframe.joint);
 
-    u32 numValues = 0;
-    stream.read(numValues);
-    keyframe.keyframeTimes.resize(numValues);
-    keyframe.keyframeValues.resize(numValues);
-    stream.read(keyframe.keyframeTimes);
-    stream.read(keyframe.keyframeValues);
+    if (header.version > 0) {
+      stream.read(keyframe.encoding);
+    }
+
+    if (keyframe.encoding == KeyframeSequenceAssetEncoding::Constant) {
+      stream.read(keyframe.rangeMin);
+    } else if (keyframe.encoding == KeyframeSequenceAssetEncoding::Uniform) {
+      stream.read(keyframe.startTime);
+      stream.read(keyframe.endTime);
+      stream.read(keyframe.rangeMin);
+      stream.read(keyframe.rangeExtent);
+      stream.read(keyframe.numSamples);
+
+      u32 numValues = 0;
+      stream.read(numValues);
+      keyframe.compressedValues.resize(numValues);
+      stream.read(keyframe.compressedValues);
+
+      const u32 stride =
+          keyframe.target == KeyframeSequenceAssetTarget::Rotation ? 4 : 3;
+      if (keyframe.numSamples < 2 ||
+          numValues != keyframe.numSamples * stride) {
+        return Error("Invalid number of animation samples");
+      }
+    } else if (keyframe.encoding == KeyframeSequenceAssetEncoding::Raw) {
+      u32 numValues = 0;
+      stream.read(numValues);
+      keyframe.keyframeTimes.resize(numValues);
+      keyframe.keyframeValues.resize(numValues);
+      stream.read(keyframe.keyframeTimes);
+      stream.read(keyframe.keyframeValues);
+    } else {
+      return Error("Invalid animation keyframe encoding");
+    }
   }
 
   return animation;
@@ -27,6 +27,24 @@ AnimationLoopMode deserializeLoopMode(String loopMode) {
   return AnimationLoopMode::None;
 }
 
+String serializeBlendMode(AnimationLayerBlendMode blendMode) {
+  switch (blendMode) {
+  case AnimationLayerBlendMode::Additive:
+    return "additive";
+  case AnimationLayerBlendMode::Override:
+  default:
+    return "override";
+  }
+}
+
+AnimationLayerBlendMode deserializeBlendMode(String blendMode) {
+  if (blendMode == "additive") {
+    return AnimationLayerBlendMode::Additive;
+  }
+
+  return AnimationLayerBlendMode::Override;
+}
+
 } // namespace
 
 Result<void> AssetCache::createAnimatorFromData(const AnimatorAsset &data,
@@ -36,12 +54,35 @@ Result<void> AssetCache::createAnimatorFromData(const AnimatorAsset &data,
   root["type"] = "animator";
   root["initial"] = data.states.at(data.initialState).name;
 
+  for (const auto &parameter : data.parameters) {
+    YAML::Node parameterNode(YAML::NodeType::Map);
+    parameterNode["name"] = parameter.name;
+    parameterNode["value"] = parameter.value;
+
+    root["parameters"].push_back(parameterNode);
+  }
+
   auto statesNode = root["states"];
 
   for (const auto &state : data.states) {
     auto stateNode = statesNode[state.name];
-    stateNode["output"]["type"] = "animation";
-    stateNode["output"]["animation"] = getAssetUuid(state.animation);
+    if (state.blendSpace.empty()) {
+      stateNode["output"]["type"] = "animation";
+      stateNode["output"]["animation"] = getAssetUuid(state.animation);
+    } else {
+      stateNode["output"]["type"] = "blend";
+      stateNode["output"]["parameter"] =
+          data.parameters.at(state.blendParameter).name;
+
+      for (const auto &point : state.blendSpace) {
+        YAML::Node pointNode(YAML::NodeType::Map);
+        pointNode["animation"] = getAssetUuid(point.animation);
+        pointNode["position"] = point.position;
+
+        stateNode["output"]["points"].push_back(pointNode);
+      }
+    }
+
     stateNode["output"]["speed"] = state.speed;
     stateNode["output"]["loopMode"] = serializeLoopMode(state.loopMode);
 
@@ -50,11 +91,29 @@ Result<void> AssetCache::createAnimatorFromData(const AnimatorAsset &data,
       transitionNode["type"] = "event";
       transitionNode["event"] = transition.eventName;
       transitionNode["target"] = data.states.at(transition.target).name;
+      if (transition.duration > 0.0f) {
+        transitionNode["duration"] = transition.duration;
+      }
 
       stateNode["on"].push_back(transitionNode);
     }
   }
 
+  for (const auto &layer : data.layers) {
+    YAML::Node layerNode(YAML::NodeType::Map);
+    layerNode["name"] = layer.name;
+    layerNode["animation"] = getAssetUuid(layer.animation);
+    layerNode["weight"] = layer.weight;
+    layerNode["speed"] = layer.speed;
+    layerNode["blendMode"] = serializeBlendMode(layer.blendMode);
+
+    if (!layer.jointMask.empty()) {
+      layerNode["mask"] = layer.jointMask;
+    }
+
+    root["layers"].push_back(layerNode);
+  }
+
   std::ofstream stream(assetPath);
   stream << root;
   stream.close();
@@ -83,6 +142,30 @@ Result<AnimatorAsset> AssetCache::loadAnimator(const Path &path) {
 
   std::vector<String> warnings;
 
+  auto addWarnings = [&warnings](const auto &res) {
+    if (res.hasWarnings()) {
+      warnings.insert(warnings.end(), res.warnings().begin(),
+                      res.warnings().end());
+    }
+
+    if (!res) {
+      warnings.push_back(res.error());
+    }
+  };
+
+  if (root["parameters"] && root["parameters"].IsSequence()) {
+    for (auto parameterNode : root["parameters"]) {
+      auto name = parameterNode["name"].as<String>("");
+      if (name.empty()) {
+        warnings.push_back("Parameter is ignored because `name` is empty");
+        continue;
+      }
+
+      asset.parameters.push_back(
+          {name, parameterNode["value"].as<f32>(0.0f)});
+    }
+  }
+
   std::vector<YAML::Node> transitionNodes;
 
   for (auto stateNodePair : root["states"]) {
@@ -110,15 +193,49 @@ Result<AnimatorAsset> AssetCache::loadAnimator(const Path &path) {
         state.speed = std::max(output["speed"].as<f32>(1.0f), 0.0f);
         state.loopMode = deserializeLoopMode(output["loopMode"].as<String>(""));
 
-        if (res.hasWarnings()) {
-          warnings.insert(warnings.end(), res.warnings().begin(),
-                          res.warnings().end());
-        }
+        addWarnings(res);
+      }
+    } else if (output["type"] && output["type"].as<String>("") == "blend") {
+      auto parameter = output["parameter"].as<String>("");
+      usize i = 0;
+      for (; i < asset.parameters.size() &&
+             asset.parameters.at(i).name != parameter;
+           ++i) {
+      }
+
+      if (i < asset.parameters.size()) {
+        state.blendParameter = i;
+      } else {
+        warnings.push_back("Blend space of " + name +
+                           " is ignored because \"" + parameter +
+                           "\" parameter does not exist");
+      }
 
-        if (!res) {
-          warnings.push_back(res.error());
+      auto points = output["points"];
+      if (i < asset.parameters.size() && points && points.IsSequence()) {
+        for (auto pointNode : points) {
+          auto animation = pointNode["animation"].as<Uuid>(Uuid{});
+          if (animation.isEmpty()) {
+            continue;
+          }
+
+          auto res = request<AnimationAsset>(animation);
+          addWarnings(res);
+
+          if (res) {
+            state.blendSpace.push_back(
+                {res.data(), pointNode["position"].as<f32>(0.0f)});
+          }
         }
       }
+
+      std::stable_sort(state.blendSpace.begin(), state.blendSpace.end(),
+                       [](const auto &a, const auto &b) {
+                         return a.position < b.position;
+                       });
+
+      state.speed = std::max(output["speed"].as<f32>(1.0f), 0.0f);
+      state.loopMode = deserializeLoopMode(output["loopMode"].as<String>(""));
     }
 
     transitionNodes.push_back(stateNode["on"]);
@@ -184,6 +301,8 @@ Result<AnimatorAsset> AssetCache::loadAnimator(const Path &path) {
         AnimationStateTransition transition{};
         transition.eventName = transitionNode["event"].as<String>("");
         transition.target = i;
+        transition.duration =
+            std::max(transitionNode["duration"].as<f32>(0.0f), 0.0f);
         state.transitions.push_back(transition);
       } else {
         warnings.push_back(transitionIndex + " is ignored because \"" + target +
@@ -192,6 +311,39 @@ Result<AnimatorAsset> AssetCache::loadAnimator(const Path &path) {
     }
   }
 
+  if (root["layers"] && root["layers"].IsSequence()) {
+    for (usize i = 0; i < root["layers"].size(); ++i) {
+      auto layerNode = root["layers"][i];
+      auto layerIndex = "Layer at index " + std::to_string(i);
+
+      auto animation = layerNode["animation"].as<Uuid>(Uuid{});
+      if (animation.isEmpty()) {
+        warnings.push_back(layerIndex +
+                           " is ignored because `animation` is empty");
+        continue;
+      }
+
+      auto res = request<AnimationAsset>(animation);
+      addWarnings(res);
+      if (!res) {
+        continue;
+      }
+
+      AnimationLayer layer{};
+      layer.name = layerNode["name"].as<String>("");
+      layer.animation = res.data();
+      layer.weight =
+          std::clamp(layerNode["weight"].as<f32>(1.0f), 0.0f, 1.0f);
+      layer.speed = std::max(layerNode["speed"].as<f32>(1.0f), 0.0f);
+      layer.blendMode =
+          deserializeBlendMode(layerNode["blendMode"].as<String>(""));
+      layer.jointMask =
+          layerNode["mask"].as<std::vector<f32>>(std::vector<f32>{});
+
+      asset.layers.push_back(layer);
+    }
+  }
+
   if (asset.states.empty()) {
     AnimationState dummyState{};
     dummyState.name = "INITIAL";
@@ -105,8 +105,12 @@ Result<MeshAsset> AssetCache::loadMesh(const Path &path) {
 
     mesh.geometries.at(i).indices.resize(size);
     stream.read(mesh.geometries.at(i).indices);
+
+    g.bounds = BoundingBox::fromPoints(g.positions);
   }
 
+  mesh.vertexLayout = MeshVertexLayout::choose(mesh);
+
   return {mesh, warnings};
 }
 
@@ -9,9 +9,19 @@ static constexpr usize AssetFileMagicLength = 11;
 struct AssetFileHeader {
   static constexpr const char *MagicConstant = "QLASSETFILE";
 
+  /**
+   * Magic of headers that store a file version
+   *
+   * Files with the unversioned magic only store
+   * the type and have version zero
+   */
+  static constexpr const char *VersionedMagicConstant = "QLASSETFILEV";
+
   String magic;
 
   AssetType type = AssetType::None;
+
+  u32 version = 0;
 };
 
 } // namespace quoll
@@ -79,6 +79,8 @@ public:
 
   constexpr bool valid() const { return mHandle; }
 
+  constexpr AssetMap<TAssetData> *map() const { return mMap; }
+
 private:
   AssetHandle<TAssetData> mHandle;
   AssetMap<TAssetData> *mMap = nullptr;
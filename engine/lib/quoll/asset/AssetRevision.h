@@ -22,7 +22,7 @@ enum class AssetRevision : u32 {
   Texture = 230901,
   Mesh = 240828,
   Skeleton = 240827,
-  Animation = 240827,
+  Animation = 261016,
   Audio = 230901,
   Prefab = 240827,
   LuaScript = 230901,
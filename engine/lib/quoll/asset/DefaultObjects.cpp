@@ -152,9 +152,11 @@ MeshAsset createCube() {
   geometry.tangents = tangents;
   geometry.texCoords0 = texCoords;
   geometry.texCoords1 = texCoords;
+  geometry.bounds = BoundingBox::fromPoints(positions);
 
   MeshAsset mesh;
   mesh.geometries.push_back(geometry);
+  mesh.vertexLayout = MeshVertexLayout::choose(mesh);
   return mesh;
 
   // NOLINTEND(cppcoreguidelines-avoid-magic-numbers)
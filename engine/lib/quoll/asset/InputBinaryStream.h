@@ -76,6 +76,11 @@ template <> inline void InputBinaryStream::read(std::vector<Uuid> &value) {
 template <> inline void InputBinaryStream::read(AssetFileHeader &header) {
   read(header.magic);
   read(header.type);
+
+  header.version = 0;
+  if (header.magic == AssetFileHeader::VersionedMagicConstant) {
+    read(header.version);
+  }
 }
 
 template <> inline void InputBinaryStream::read(AssetMeta &meta) {
@@ -62,6 +62,10 @@ template <>
 inline void OutputBinaryStream::write(const AssetFileHeader &value) {
   write(value.magic);
   write(value.type);
+
+  if (value.magic == AssetFileHeader::VersionedMagicConstant) {
+    write(value.version);
+  }
 }
 
 template <>
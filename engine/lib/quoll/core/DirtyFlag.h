@@ -0,0 +1,57 @@
+#pragma once
+
+namespace quoll {
+
+/**
+ * @brief Dirty flag
+ *
+ * Flag is raised when it is created or copied.
+ * Values that are copied into entity storage are
+ * therefore always dirty and only values that are
+ * modified in place need to be explicitly marked.
+ *
+ * Moving keeps the flag of the source; so, values
+ * that are only moved around in storage (e.g when
+ * pools are compacted or grow) stay clean.
+ */
+class DirtyFlag {
+public:
+  constexpr DirtyFlag() = default;
+
+  constexpr DirtyFlag(const DirtyFlag &) {}
+
+  constexpr DirtyFlag &operator=(const DirtyFlag &) {
+    mDirty = true;
+    return *this;
+  }
+
+  constexpr DirtyFlag(DirtyFlag &&rhs) noexcept : mDirty(rhs.mDirty) {}
+
+  constexpr DirtyFlag &operator=(DirtyFlag &&rhs) noexcept {
+    mDirty = rhs.mDirty;
+    return *this;
+  }
+
+  /**
+   * @brief Raise flag
+   */
+  constexpr void mark() { mDirty = true; }
+
+  /**
+   * @brief Clear flag
+   */
+  constexpr void clear() { mDirty = false; }
+
+  /**
+   * @brief Check if flag is raised
+   *
+   * @retval true Flag is raised
+   * @retval false Flag is not raised
+   */
+  constexpr bool isDirty() const { return mDirty; }
+
+private:
+  bool mDirty = true;
+};
+
+} // namespace quoll
@@ -1,5 +1,6 @@
 #include "quoll/core/Base.h"
 #include "quoll/logger/StreamTransport.h"
+#include "ThreadPool.h"
 #include "Engine.h"
 
 namespace quoll {
@@ -29,4 +30,16 @@ void Engine::resetLoggers() {
   engine.mUserLogger.setTransport(createStreamTransport(std::cout));
 }
 
+ThreadPool &Engine::getThreadPool() {
+  // Pool is created on first use in order to
+  // not start threads in applications that do
+  // not need them
+  if (!engine.mThreadPool) {
+    engine.mThreadPool =
+        std::make_unique<ThreadPool>(ThreadPool::getDefaultNumThreads());
+  }
+
+  return *engine.mThreadPool;
+}
+
 } // namespace quoll
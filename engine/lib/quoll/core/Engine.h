@@ -4,6 +4,8 @@
 
 namespace quoll {
 
+class ThreadPool;
+
 /**
  * Singleton with values that are set once
  * during application load and read from various
@@ -29,6 +31,8 @@ public:
 
   static void resetLoggers();
 
+  static ThreadPool &getThreadPool();
+
 private:
   Engine();
 
@@ -39,6 +43,8 @@ private:
   Logger mSystemLogger;
 
   Logger mUserLogger;
+
+  std::unique_ptr<ThreadPool> mThreadPool;
 };
 
 // NOLINTBEGIN(cppcoreguidelines-macro-usage)
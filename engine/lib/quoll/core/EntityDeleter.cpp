@@ -1,4 +1,5 @@
 #include "quoll/core/Base.h"
+#include "quoll/core/Profiler.h"
 #include "quoll/scene/Children.h"
 #include "quoll/scene/Parent.h"
 #include "quoll/scene/Scene.h"
@@ -8,18 +9,28 @@
 
 namespace quoll {
 
+namespace {
+
 void addToDeleteList(Entity entity, EntityDatabase &entityDatabase,
                      std::vector<Entity> &deleteList) {
-  if (entityDatabase.has<Children>(entity)) {
-    for (auto &child : entityDatabase.get<Children>(entity).children) {
-      addToDeleteList(child, entityDatabase, deleteList);
+  const usize start = deleteList.size();
+  deleteList.push_back(entity);
+
+  // Delete list is used as the traversal queue
+  // to avoid recursing through deep hierarchies
+  for (usize i = start; i < deleteList.size(); ++i) {
+    auto current = deleteList.at(i);
+    if (entityDatabase.has<Children>(current)) {
+      const auto &children = entityDatabase.get<Children>(current).children;
+      deleteList.insert(deleteList.end(), children.begin(), children.end());
     }
   }
-
-  deleteList.push_back(entity);
 }
 
+} // namespace
+
 void EntityDeleter::update(SystemView &view) {
+  QUOLL_PROFILE_EVENT("EntityDeleter::update");
   auto *scene = view.scene;
   auto &entityDatabase = scene->entityDatabase;
   auto activeCamera = scene->activeCamera;
@@ -29,8 +40,8 @@ void EntityDeleter::update(SystemView &view) {
     return;
   }
 
-  std::vector<Entity> deleteList;
-  deleteList.reserve(count);
+  mDeleteList.clear();
+  mParents.clear();
 
   bool cameraDeleted = false;
 
@@ -38,27 +49,34 @@ void EntityDeleter::update(SystemView &view) {
     cameraDeleted = cameraDeleted || (activeCamera == entity);
 
     if (entityDatabase.has<Parent>(entity)) {
-      auto parent = entityDatabase.get<Parent>(entity).parent;
-
-      if (entityDatabase.has<Children>(parent)) {
-        auto &children = entityDatabase.get<Children>(parent).children;
-
-        auto it = std::find(children.begin(), children.end(), entity);
-        if (it != children.end()) {
-          children.erase(it);
-        }
-      }
+      mParents.push_back(entityDatabase.get<Parent>(entity).parent);
     }
 
-    addToDeleteList(entity, entityDatabase, deleteList);
+    addToDeleteList(entity, entityDatabase, mDeleteList);
   }
 
   if (cameraDeleted) {
     scene->activeCamera = scene->dummyCamera;
   }
 
-  for (auto entity : deleteList) {
-    entityDatabase.deleteEntity(entity);
+  entityDatabase.deleteEntities(mDeleteList);
+
+  // Deleted entities are removed from children
+  // of their parents in one pass per parent
+  std::sort(mParents.begin(), mParents.end());
+  mParents.erase(std::unique(mParents.begin(), mParents.end()), mParents.end());
+
+  for (auto parent : mParents) {
+    if (!entityDatabase.exists(parent) ||
+        !entityDatabase.has<Children>(parent)) {
+      continue;
+    }
+
+    std::erase_if(
+        entityDatabase.get<Children>(parent).children,
+        [&entityDatabase](Entity child) {
+          return !entityDatabase.exists(child);
+        });
   }
 }
 
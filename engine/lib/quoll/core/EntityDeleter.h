@@ -1,5 +1,7 @@
 #pragma once
 
+#include "quoll/entity/Entity.h"
+
 namespace quoll {
 
 struct SystemView;
@@ -7,6 +9,10 @@ struct SystemView;
 class EntityDeleter {
 public:
   void update(SystemView &view);
+
+private:
+  std::vector<Entity> mDeleteList;
+  std::vector<Entity> mParents;
 };
 
 } // namespace quoll
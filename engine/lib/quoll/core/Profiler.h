@@ -6,11 +6,13 @@
 #define QUOLL_PROFILE_EVENT(name) ZoneScopedN(name)
 #define QUOLL_PROFILE_FRAME(...) FrameMark
 #define QUOLL_PROFILE_TAG(y, x) ZoneText(x, strlen(x))
+#define QUOLL_PROFILE_THREAD(name) tracy::SetThreadName(name)
 
 #else
 
 #define QUOLL_PROFILE_EVENT(...)
 #define QUOLL_PROFILE_FRAME(...)
 #define QUOLL_PROFILE_TAG(...)
+#define QUOLL_PROFILE_THREAD(...)
 
 #endif
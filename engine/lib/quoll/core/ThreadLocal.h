@@ -0,0 +1,55 @@
+#pragma once
+
+#include "ThreadPool.h"
+
+namespace quoll {
+
+/**
+ * @brief Value per thread of thread pool
+ *
+ * Used for collecting results of parallel
+ * loops without synchronization. Values are
+ * merged after the loop is finished.
+ *
+ * Only one thread outside of the pool can
+ * use the values at a time.
+ *
+ * @tparam TValue Value type
+ */
+template <class TValue> class ThreadLocal {
+public:
+  /**
+   * @brief Create values for thread pool
+   *
+   * @param threadPool Thread pool
+   */
+  ThreadLocal(const ThreadPool &threadPool)
+      : mThreadPool(threadPool), mValues(threadPool.getNumThreads() + 1) {}
+
+  /**
+   * @brief Get value of current thread
+   *
+   * @return Value of current thread
+   */
+  TValue &get() { return mValues[mThreadPool.getThreadIndex()]; }
+
+  /**
+   * @brief Get begin iterator over all values
+   *
+   * @return Begin iterator
+   */
+  inline auto begin() { return mValues.begin(); }
+
+  /**
+   * @brief Get end iterator over all values
+   *
+   * @return End iterator
+   */
+  inline auto end() { return mValues.end(); }
+
+private:
+  const ThreadPool &mThreadPool;
+  std::vector<TValue> mValues;
+};
+
+} // namespace quoll
@@ -0,0 +1,181 @@
+#include "quoll/core/Base.h"
+#include "quoll/core/Profiler.h"
+#include "ThreadPool.h"
+
+namespace quoll {
+
+namespace {
+
+// Pool that the current thread works for;
+// used to find the queue of the current worker
+thread_local const ThreadPool *sCurrentPool = nullptr;
+thread_local u32 sCurrentThreadIndex = 0;
+
+} // namespace
+
+ThreadPool::ThreadPool(u32 numThreads) {
+  mWorkers.reserve(numThreads);
+  for (u32 i = 0; i < numThreads; ++i) {
+    mWorkers.push_back(std::make_unique<Worker>());
+  }
+
+  mThreads.reserve(numThreads);
+  for (u32 i = 0; i < numThreads; ++i) {
+    mThreads.emplace_back([this, i] { work(i + 1); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard lock(mSleepMutex);
+    mStopping = true;
+  }
+  mJobAvailable.notify_all();
+
+  for (auto &thread : mThreads) {
+    thread.join();
+  }
+}
+
+void ThreadPool::submit(std::function<void()> &&job) {
+  if (mWorkers.empty()) {
+    job();
+    return;
+  }
+
+  // Jobs submitted from outside of the pool
+  // are spread between workers
+  u32 threadIndex = getThreadIndex();
+  usize workerIndex = threadIndex > 0
+                          ? threadIndex - 1
+                          : mNextWorker.fetch_add(1) % mWorkers.size();
+
+  {
+    // Counter is changed while holding the sleep
+    // mutex so that sleeping workers do not miss it.
+    // It is increased before the job is queued to
+    // never go below zero when job is stolen
+    std::lock_guard lock(mSleepMutex);
+    mNumJobs.fetch_add(1, std::memory_order_release);
+  }
+
+  {
+    auto &worker = *mWorkers.at(workerIndex);
+    std::lock_guard lock(worker.mutex);
+    worker.jobs.push_back(std::move(job));
+  }
+  mJobAvailable.notify_one();
+}
+
+void ThreadPool::parallelFor(usize count, usize chunkSize,
+                             const std::function<void(usize, usize)> &fn) {
+  QUOLL_PROFILE_EVENT("ThreadPool::parallelFor");
+
+  chunkSize = std::max(chunkSize, usize{1});
+  const usize numChunks = (count + chunkSize - 1) / chunkSize;
+  if (numChunks <= 1 || mWorkers.empty()) {
+    fn(0, count);
+    return;
+  }
+
+  struct State {
+    std::atomic<usize> nextChunk{0};
+    std::atomic<usize> remainingChunks{0};
+  };
+
+  // Helpers can start after the loop is finished;
+  // so, state is owned by all of them
+  auto state = std::make_shared<State>();
+  state->remainingChunks.store(numChunks, std::memory_order_relaxed);
+
+  auto runChunks = [state, numChunks, count, chunkSize, &fn] {
+    usize chunk = state->nextChunk.fetch_add(1, std::memory_order_relaxed);
+    for (; chunk < numChunks;
+         chunk = state->nextChunk.fetch_add(1, std::memory_order_relaxed)) {
+      const usize start = chunk * chunkSize;
+      fn(start, std::min(start + chunkSize, count));
+      state->remainingChunks.fetch_sub(1, std::memory_order_acq_rel);
+    }
+  };
+
+  const usize numHelpers = std::min(numChunks - 1, mWorkers.size());
+  for (usize i = 0; i < numHelpers; ++i) {
+    submit(runChunks);
+  }
+
+  runChunks();
+
+  const u32 threadIndex = getThreadIndex();
+  while (state->remainingChunks.load(std::memory_order_acquire) > 0) {
+    if (!tryRunJob(threadIndex)) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+u32 ThreadPool::getThreadIndex() const {
+  return sCurrentPool == this ? sCurrentThreadIndex : 0;
+}
+
+u32 ThreadPool::getDefaultNumThreads() {
+  // Hardware concurrency can be zero
+  // if it is not computable
+  return std::max(std::thread::hardware_concurrency(), 1u) - 1;
+}
+
+void ThreadPool::work(u32 threadIndex) {
+  QUOLL_PROFILE_THREAD("Worker");
+  sCurrentPool = this;
+  sCurrentThreadIndex = threadIndex;
+
+  while (true) {
+    if (tryRunJob(threadIndex)) {
+      continue;
+    }
+
+    std::unique_lock lock(mSleepMutex);
+    mJobAvailable.wait(lock, [this] {
+      return mStopping || mNumJobs.load(std::memory_order_acquire) > 0;
+    });
+
+    // Remaining jobs are finished before stopping
+    if (mStopping && mNumJobs.load(std::memory_order_acquire) == 0) {
+      return;
+    }
+  }
+}
+
+bool ThreadPool::tryRunJob(u32 threadIndex) {
+  std::function<void()> job;
+
+  // Own queue is used as a stack to keep
+  // recently submitted jobs on the same thread
+  if (threadIndex > 0) {
+    auto &worker = *mWorkers.at(threadIndex - 1);
+    std::lock_guard lock(worker.mutex);
+    if (!worker.jobs.empty()) {
+      job = std::move(worker.jobs.back());
+      worker.jobs.pop_back();
+    }
+  }
+
+  // Steal oldest job from other workers
+  for (usize i = 0; i < mWorkers.size() && !job; ++i) {
+    auto &worker = *mWorkers.at((threadIndex + i) % mWorkers.size());
+    std::lock_guard lock(worker.mutex);
+    if (!worker.jobs.empty()) {
+      job = std::move(worker.jobs.front());
+      worker.jobs.pop_front();
+    }
+  }
+
+  if (!job) {
+    return false;
+  }
+
+  mNumJobs.fetch_sub(1, std::memory_order_acq_rel);
+  job();
+  return true;
+}
+
+} // namespace quoll
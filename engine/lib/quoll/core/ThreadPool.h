@@ -0,0 +1,105 @@
+#pragma once
+
+namespace quoll {
+
+/**
+ * @brief Work stealing thread pool
+ *
+ * Every worker thread has its own job queue.
+ * Workers take jobs from the back of their own
+ * queue and steal jobs from the front of other
+ * queues when their own queue is empty.
+ */
+class ThreadPool : NoCopyMove {
+  struct Worker {
+    std::mutex mutex;
+
+    std::deque<std::function<void()>> jobs;
+  };
+
+public:
+  /**
+   * @brief Create thread pool
+   *
+   * @param numThreads Number of worker threads
+   */
+  ThreadPool(u32 numThreads);
+
+  /**
+   * @brief Destroy thread pool
+   *
+   * Waits for all submitted jobs to finish
+   */
+  ~ThreadPool();
+
+  /**
+   * @brief Submit job
+   *
+   * Jobs submitted from a worker thread are added
+   * to the queue of the worker. Job is executed
+   * immediately in the calling thread if pool
+   * has no worker threads.
+   *
+   * @param job Job
+   */
+  void submit(std::function<void()> &&job);
+
+  /**
+   * @brief Run function over range in chunks
+   *
+   * Chunks are distributed between the calling
+   * thread and worker threads. Calling thread runs
+   * other jobs while waiting for chunks to finish.
+   *
+   * @param count Number of items in range
+   * @param chunkSize Maximum number of items in a chunk
+   * @param fn Function that receives chunk start and end
+   */
+  void parallelFor(usize count, usize chunkSize,
+                   const std::function<void(usize, usize)> &fn);
+
+  /**
+   * @brief Get number of worker threads
+   *
+   * @return Number of worker threads
+   */
+  inline u32 getNumThreads() const {
+    return static_cast<u32>(mThreads.size());
+  }
+
+  /**
+   * @brief Get index of current thread
+   *
+   * Worker threads have indices starting
+   * from one. All other threads have index zero.
+   *
+   * @return Thread index
+   */
+  u32 getThreadIndex() const;
+
+  /**
+   * @brief Get default number of worker threads
+   *
+   * Leaves one hardware thread for the main thread
+   *
+   * @return Default number of worker threads
+   */
+  static u32 getDefaultNumThreads();
+
+private:
+  void work(u32 threadIndex);
+
+  bool tryRunJob(u32 threadIndex);
+
+private:
+  std::vector<std::thread> mThreads;
+  std::vector<std::unique_ptr<Worker>> mWorkers;
+  std::atomic<usize> mNextWorker{0};
+
+  std::mutex mSleepMutex;
+  std::condition_variable mJobAvailable;
+  std::atomic<usize> mNumJobs{0};
+  bool mStopping = false;
+};
+
+} // namespace quoll
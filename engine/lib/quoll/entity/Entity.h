@@ -2,6 +2,62 @@
 
 namespace quoll {
 
+/**
+ * @brief Entity handle
+ *
+ * Handles store the entity index in the lower bits
+ * and the generation of the index in the upper bits.
+ * Generation is incremented every time an index is
+ * recycled; so, handles of deleted entities never
+ * alias entities that are created after deletion.
+ *
+ * First generation is zero, which makes handles of
+ * never recycled entities equal to their indices.
+ * Bare entity ids that are serialized before handles
+ * had generations are therefore valid handles.
+ */
 enum class Entity : u32 { Null = 0 };
 
+static constexpr u32 EntityIndexBits = 24;
+
+static constexpr u32 EntityIndexMask = (1u << EntityIndexBits) - 1;
+
+static constexpr u32 MaxEntityGeneration =
+    std::numeric_limits<u32>::max() >> EntityIndexBits;
+
+/**
+ * @brief Create entity handle
+ *
+ * @param index Entity index
+ * @param generation Entity generation
+ * @return Entity handle
+ */
+constexpr Entity makeEntity(u32 index, u32 generation) {
+  return static_cast<Entity>((generation << EntityIndexBits) |
+                             (index & EntityIndexMask));
+}
+
+/**
+ * @brief Get entity index
+ *
+ * Indices are dense and used for indexing
+ * per-entity data in arrays
+ *
+ * @param entity Entity
+ * @return Entity index
+ */
+constexpr u32 getEntityIndex(Entity entity) {
+  return static_cast<u32>(entity) & EntityIndexMask;
+}
+
+/**
+ * @brief Get entity generation
+ *
+ * @param entity Entity
+ * @return Entity generation
+ */
+constexpr u32 getEntityGeneration(Entity entity) {
+  return static_cast<u32>(entity) >> EntityIndexBits;
+}
+
 } // namespace quoll
@@ -41,6 +41,27 @@
 
 namespace quoll {
 
+namespace {
+
+template <class... TComponents> struct ComponentGroup {
+  static std::vector<usize> getComponentIds() {
+    return {EntityDatabase::getComponentId<TComponents>()...};
+  }
+
+  static void create(EntityDatabase &entityDatabase) {
+    entityDatabase.group<TComponents...>();
+  }
+};
+
+// Groups of components that are
+// iterated together every frame
+using ComponentGroups =
+    std::tuple<ComponentGroup<LocalTransform, WorldTransform>,
+               ComponentGroup<Mesh, MeshRenderer>,
+               ComponentGroup<Skeleton, SkinnedMeshRenderer>>;
+
+} // namespace
+
 EntityDatabase::EntityDatabase() {
   reg<Id>();
   reg<Name>();
@@ -88,6 +109,25 @@ EntityDatabase::EntityDatabase() {
   reg<InputMap>();
   reg<UICanvas>();
   reg<UICanvasRenderRequest>();
+
+  std::apply([this](auto... groups) { (groups.create(*this), ...); },
+             ComponentGroups{});
+}
+
+std::span<const usize> EntityDatabase::getGroupedComponentIds(usize id) {
+  static const std::vector<std::vector<usize>> Groups = std::apply(
+      [](auto... groups) {
+        return std::vector<std::vector<usize>>{groups.getComponentIds()...};
+      },
+      ComponentGroups{});
+
+  for (const auto &group : Groups) {
+    if (std::find(group.begin(), group.end(), id) != group.end()) {
+      return group;
+    }
+  }
+
+  return {};
 }
 
 } // namespace quoll
@@ -8,6 +8,19 @@ namespace quoll {
 class EntityDatabase : public EntityStorageSparseSet {
 public:
   EntityDatabase();
+
+  /**
+   * @brief Get components that are grouped with component
+   *
+   * Adding or removing a grouped component
+   * moves entries of all components in its group
+   *
+   * @param id Component id
+   * @return Ids of all components in the group
+   *         of the component; empty if the
+   *         component is not grouped
+   */
+  static std::span<const usize> getGroupedComponentIds(usize id);
 };
 
 template <class TComponent>
@@ -6,41 +6,94 @@ namespace quoll {
 EntityStorageSparseSet::~EntityStorageSparseSet() { destroy(); }
 
 void EntityStorageSparseSet::duplicate(EntityStorageSparseSet &rhs) {
-  rhs.mComponentPools = mComponentPools;
-  rhs.mLastEntity = mLastEntity;
-  rhs.mDeleted = mDeleted;
+  if (rhs.mComponentPools.size() < mComponentPools.size()) {
+    rhs.mComponentPools.resize(mComponentPools.size());
+    rhs.mRemoveObserverPools.resize(mComponentPools.size());
+    rhs.mPendingRemovals.resize(mComponentPools.size());
+  }
+
+  for (auto &pool : rhs.mComponentPools) {
+    if (pool) {
+      pool->group = nullptr;
+    }
+  }
+
+  // Cloned pools get new versions; so, readers that
+  // cache versions of this storage see them as changed
+  for (usize id = 0; id < mComponentPools.size(); ++id) {
+    if (mComponentPools[id]) {
+      rhs.mComponentPools[id] = mComponentPools[id]->clone();
+      rhs.mComponentPools[id]->markChanged();
+    }
+  }
+
+  // Cloned pools point to groups of this storage
+  rhs.mGroups.clear();
+  for (const auto &group : mGroups) {
+    auto &rhsGroup = rhs.mGroups.emplace_back(
+        std::make_unique<EntityStorageSparseSetGroup>(*group));
+    for (auto id : rhsGroup->componentIds) {
+      rhs.mComponentPools[id]->group = rhsGroup.get();
+    }
+  }
+
+  rhs.mId = ++sNextStorageId;
+  rhs.mSlots = mSlots;
+  rhs.mFreeHead = mFreeHead;
+  rhs.mFreeTail = mFreeTail;
   rhs.mNumEntities = mNumEntities;
+
+  const usize maskWords = rhs.mMaskWords;
+  rhs.mComponentMasks = mComponentMasks;
+  rhs.mMaskWords = mMaskWords;
+  if (maskWords > mMaskWords) {
+    rhs.resizeComponentMasks(maskWords);
+  }
 }
 
 Entity EntityStorageSparseSet::create() {
   mNumEntities++;
-  if (mDeleted.size() > 0) {
-    auto eid = mDeleted.front();
-    mDeleted.pop_front();
-    return eid;
+  if (mFreeHead != NullIndex) {
+    auto &slot = mSlots[mFreeHead];
+    mFreeHead = slot.nextFree;
+    if (mFreeHead == NullIndex) {
+      mFreeTail = NullIndex;
+    }
+
+    slot.nextFree = NullIndex;
+    slot.alive = true;
+    return slot.entity;
   }
 
-  auto eid = mLastEntity;
-  mLastEntity = Entity{static_cast<u32>(mLastEntity) + 1};
-  return eid;
+  const auto index = static_cast<u32>(mSlots.size());
+  QuollAssert(index <= EntityIndexMask, "Maximum number of entities reached");
+
+  mSlots.push_back({makeEntity(index, 0), NullIndex, true});
+  mComponentMasks.resize(mSlots.size() * mMaskWords, 0);
+  return mSlots.back().entity;
 }
 
 bool EntityStorageSparseSet::exists(Entity entity) const {
-  for (auto &deletedEntity : mDeleted) {
-    if (deletedEntity == entity)
-      return false;
-  }
-
-  return entity > Entity::Null && entity < mLastEntity;
+  const auto index = getEntityIndex(entity);
+  return index < mSlots.size() && mSlots[index].alive &&
+         mSlots[index].entity == entity;
 }
 
 void EntityStorageSparseSet::deleteEntity(Entity entity) {
-  if (entity == Entity::Null)
-    return;
+  deleteEntities({&entity, 1});
+}
 
-  deleteAllEntityComponents(entity);
-  mDeleted.push_back(entity);
-  this->mNumEntities--;
+void EntityStorageSparseSet::deleteEntities(std::span<const Entity> entities) {
+  for (auto entity : entities) {
+    if (!exists(entity)) {
+      continue;
+    }
+
+    queueComponentRemovals(getEntityIndex(entity));
+    freeEntity(entity);
+  }
+
+  removeQueuedComponents();
 }
 
 void EntityStorageSparseSet::destroy() {
@@ -49,59 +102,188 @@ void EntityStorageSparseSet::destroy() {
   deleteAllEntities();
 }
 
-void EntityStorageSparseSet::deleteAllEntityComponents(Entity entity) {
-  for (auto &[index, pool] : mComponentPools) {
-    const usize sEntity = static_cast<usize>(entity);
+void EntityStorageSparseSet::queueComponentRemovals(u32 index) {
+  // Removing from groups first moves the entity
+  // out of packed ranges; so, removals never
+  // break packed ranges of groups
+  for (auto &group : mGroups) {
+    removeFromGroup(*group, index);
+  }
 
-    if (sEntity < pool.entityIndices.size() &&
-        pool.entityIndices[sEntity] < DeadIndex) {
+  u64 *mask = mComponentMasks.data() + index * mMaskWords;
 
-      const usize movedEntity = static_cast<usize>(pool.entities.back());
-      const usize entityIndexToDelete = pool.entityIndices[sEntity];
+  for (usize word = 0; word < mMaskWords; ++word) {
+    while (mask[word] != 0) {
+      const usize bit = std::countr_zero(mask[word]);
+      mask[word] &= mask[word] - 1;
 
-      auto &observers = mRemoveObserverPools.at(index);
-      for (auto &observer : observers) {
-        observer.entities.push_back(entity);
-        observer.components.push_back(pool.components[entityIndexToDelete]);
+      const usize id = word * MaskWordBits + bit;
+      auto &pool = *mComponentPools[id];
+      mPendingRemovals[id].push_back(pool.entityIndices[index]);
+      pool.entityIndices[index] = DeadIndex;
+    }
+  }
+}
+
+void EntityStorageSparseSet::removeQueuedComponents() {
+  for (usize id = 0; id < mPendingRemovals.size(); ++id) {
+    auto &removals = mPendingRemovals[id];
+    if (removals.empty()) {
+      continue;
+    }
+
+    auto &pool = *mComponentPools[id];
+
+    for (auto &observer : mRemoveObserverPools[id]) {
+      for (auto entityIndexToDelete : removals) {
+        pool.appendTo(entityIndexToDelete, *observer);
       }
+    }
+
+    // Removing from the back guarantees that the
+    // last entity in the array is never removed
+    // later; so, every removal is a swap and pop
+    std::sort(removals.begin(), removals.end(), std::greater<usize>());
+
+    for (auto entityIndexToDelete : removals) {
+      const Entity movedEntity = pool.entities.back();
 
       // Move last entity in the array to place of deleted entity
-      pool.entities[entityIndexToDelete] = static_cast<Entity>(movedEntity);
+      pool.entities[entityIndexToDelete] = movedEntity;
 
       // Change index of moved entity to the index of deleted entity
-      pool.entityIndices[movedEntity] = entityIndexToDelete;
+      // unless the deleted entity is the last one
+      if (entityIndexToDelete != pool.entities.size() - 1) {
+        pool.entityIndices[getEntityIndex(movedEntity)] = entityIndexToDelete;
+      }
 
       // Delete last item from entities array
       pool.entities.pop_back();
 
+      pool.ticks[entityIndexToDelete] = pool.ticks.back();
+      pool.ticks.pop_back();
+
       // Move last component in the array to place of deleted component
-      pool.components[entityIndexToDelete] = pool.components.back();
+      // and delete last item from components array
+      pool.swapAndPopComponent(entityIndexToDelete);
+    }
+
+    removals.clear();
+    pool.markChanged();
+  }
+}
+
+void EntityStorageSparseSet::createGroup(std::vector<usize> componentIds) {
+  auto &group = *mGroups.emplace_back(
+      std::make_unique<EntityStorageSparseSetGroup>());
+  group.componentIds = std::move(componentIds);
+  group.mask.resize(mMaskWords, 0);
+
+  for (auto id : group.componentIds) {
+    group.mask[id / MaskWordBits] |= getMaskBit(id);
+    mComponentPools[id]->group = &group;
+  }
 
-      // Delete last item from components array
-      pool.components.pop_back();
+  // Entities are only moved to indices that are
+  // already visited; so, every entity is visited once
+  const auto &pool = *mComponentPools[group.componentIds.at(0)];
+  for (usize i = 0; i < pool.entities.size(); ++i) {
+    addToGroup(group, getEntityIndex(pool.entities[i]));
+  }
+}
 
-      pool.entityIndices[sEntity] = DeadIndex;
+void EntityStorageSparseSet::addToGroup(EntityStorageSparseSetGroup &group,
+                                        usize index) {
+  u64 *mask = mComponentMasks.data() + index * mMaskWords;
+  for (usize word = 0; word < group.mask.size(); ++word) {
+    const u64 bits =
+        std::atomic_ref(mask[word]).load(std::memory_order_relaxed);
+    if ((bits & group.mask[word]) != group.mask[word]) {
+      return;
     }
   }
+
+  for (auto id : group.componentIds) {
+    auto &pool = *mComponentPools[id];
+    pool.swapEntries(pool.entityIndices[index], group.size);
+  }
+
+  group.size++;
+}
+
+void EntityStorageSparseSet::removeFromGroup(EntityStorageSparseSetGroup &group,
+                                             usize index) {
+  const auto &firstPool = *mComponentPools[group.componentIds.at(0)];
+  if (index >= firstPool.entityIndices.size() ||
+      firstPool.entityIndices[index] >= group.size) {
+    return;
+  }
+
+  group.size--;
+  for (auto id : group.componentIds) {
+    auto &pool = *mComponentPools[id];
+    pool.swapEntries(pool.entityIndices[index], group.size);
+  }
+}
+
+void EntityStorageSparseSet::freeEntity(Entity entity) {
+  const auto index = getEntityIndex(entity);
+  const auto generation = getEntityGeneration(entity);
+  auto &slot = mSlots[index];
+  slot.alive = false;
+
+  // Indices with exhausted generations are never
+  // recycled; so, old handles can never alias them
+  if (generation < MaxEntityGeneration) {
+    slot.entity = makeEntity(index, generation + 1);
+
+    if (mFreeTail == NullIndex) {
+      mFreeHead = index;
+    } else {
+      mSlots[mFreeTail].nextFree = index;
+    }
+    mFreeTail = index;
+  }
+
+  mNumEntities--;
+}
+
+void EntityStorageSparseSet::resizeComponentMasks(usize maskWords) {
+  std::vector<u64> masks(mSlots.size() * maskWords, 0);
+  for (usize index = 0; index < mSlots.size(); ++index) {
+    for (usize word = 0; word < mMaskWords; ++word) {
+      masks[index * maskWords + word] =
+          mComponentMasks[index * mMaskWords + word];
+    }
+  }
+
+  mComponentMasks = std::move(masks);
+  mMaskWords = maskWords;
 }
 
 void EntityStorageSparseSet::deleteAllEntities() {
-  mLastEntity = Entity{1};
-  mDeleted.clear();
+  mSlots.assign(1, {});
+  mComponentMasks.assign(mMaskWords, 0);
+  mFreeHead = NullIndex;
+  mFreeTail = NullIndex;
   mNumEntities = 0;
 }
 
 void EntityStorageSparseSet::deleteAllComponents() {
-  for (auto &[_, pool] : mComponentPools) {
-    pool.components.clear();
-    pool.entities.clear();
-    pool.entityIndices.clear();
+  for (auto &pool : mComponentPools) {
+    if (pool) {
+      pool->clear();
+    }
+  }
+
+  for (auto &group : mGroups) {
+    group->size = 0;
   }
 }
 
 void EntityStorageSparseSet::deleteAllObservers() {
-  for (auto &[_, pool] : mRemoveObserverPools) {
-    pool.clear();
+  for (auto &observers : mRemoveObserverPools) {
+    observers.clear();
   }
 }
 
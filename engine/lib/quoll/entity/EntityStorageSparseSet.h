@@ -1,7 +1,9 @@
 #pragma once
 
 #include "Entity.h"
+#include "EntityStorageSparseSetChangeCursor.h"
 #include "EntityStorageSparseSetComponentPool.h"
+#include "EntityStorageSparseSetGroup.h"
 #include "EntityStorageSparseSetObserver.h"
 #include "EntityStorageSparseSetView.h"
 #include "EntityUtils.h"
@@ -14,6 +16,10 @@ namespace quoll {
 class EntityStorageSparseSet : NoCopyMove {
   static constexpr usize DeadIndex = std::numeric_limits<usize>::max();
 
+  static constexpr u32 NullIndex = std::numeric_limits<u32>::max();
+
+  static constexpr usize MaskWordBits = 64;
+
   static constexpr usize MaxObserverPoolSizePerComponent = 100;
 
 public:
@@ -29,6 +35,9 @@ public:
   /**
    * @brief Duplicate contents into new storage
    *
+   * Component pools of the new storage get
+   * new versions.
+   *
    * @param rhs Other storage
    */
   void duplicate(EntityStorageSparseSet &rhs);
@@ -41,20 +50,30 @@ public:
   template <class TComponentType> void reg() {
     auto id = getComponentId<TComponentType>();
 
-    QuollAssert(mComponentPools.find(id) == mComponentPools.end(),
+    QuollAssert(!hasComponentPool<TComponentType>(),
                 "Component pool " + String(typeid(TComponentType).name()) +
                     " already exists");
 
-    mComponentPools.insert({id, {}});
+    if (id >= mComponentPools.size()) {
+      mComponentPools.resize(id + 1);
+      mRemoveObserverPools.resize(id + 1);
+      mPendingRemovals.resize(id + 1);
+    }
 
-    std::vector<EntityStorageSparseSetComponentPool> removeObserverPool;
-    removeObserverPool.reserve(MaxObserverPoolSizePerComponent);
-    mRemoveObserverPools.insert({id, std::move(removeObserverPool)});
+    if (id >= mMaskWords * MaskWordBits) {
+      resizeComponentMasks(id / MaskWordBits + 1);
+    }
+
+    mComponentPools[id] = std::make_unique<
+        EntityStorageSparseSetTypedComponentPool<TComponentType>>();
   }
 
   /**
    * @brief Create entity
    *
+   * Recycles indices of deleted entities in
+   * the order that they are deleted
+   *
    * @return Newly created entity
    */
   Entity create();
@@ -62,6 +81,9 @@ public:
   /**
    * @brief Check if entity exists
    *
+   * Handles of deleted entities do not exist
+   * even if their indices are recycled
+   *
    * @param entity Entity
    * @retval true Entity exists
    * @retval false Entity does not exist
@@ -78,10 +100,26 @@ public:
   /**
    * @brief Delete entity
    *
+   * Does nothing if entity does not exist
+   *
    * @param entity Entity
    */
   void deleteEntity(Entity entity);
 
+  /**
+   * @brief Delete entities
+   *
+   * Removals are grouped per component pool and
+   * only pools that contain the deleted entities
+   * are touched. Remove observers of a pool are
+   * notified once for all removed components.
+   * Entities that do not exist or are listed
+   * more than once are skipped.
+   *
+   * @param entities Entities
+   */
+  void deleteEntities(std::span<const Entity> entities);
+
   /**
    * @brief Set component
    *
@@ -101,20 +139,30 @@ public:
 
     auto &pool = getPoolForComponent<TComponentType>();
 
-    usize sEntity = static_cast<usize>(entity);
+    usize sEntity = getEntityIndex(entity);
     if (sEntity >= pool.entityIndices.size()) {
       // TODO: Make this better
       pool.entityIndices.resize((sEntity + 1) * 2, DeadIndex);
     }
 
+    pool.markChanged();
+
     usize index = pool.entityIndices[sEntity];
     if (index != DeadIndex) {
       pool.components[index] = value;
-      pool.entities[index] = entity;
+      pool.ticks[index] = pool.version;
+      pool.recordChange(index);
     } else {
       pool.entities.push_back(entity);
       pool.components.push_back(value);
+      pool.ticks.push_back(pool.version);
       pool.entityIndices[sEntity] = pool.entities.size() - 1;
+      pool.recordChange(pool.entities.size() - 1);
+      setMaskBit(sEntity, getComponentId<TComponentType>());
+
+      if (pool.group) {
+        addToGroup(*pool.group, sEntity);
+      }
     }
   }
 
@@ -133,8 +181,7 @@ public:
                     std::to_string(static_cast<u32>(entity)));
     const auto &pool = getPoolForComponent<TComponentType>();
 
-    return std::any_cast<const TComponentType &>(
-        pool.components[pool.entityIndices[static_cast<usize>(entity)]]);
+    return pool.components[pool.entityIndices[getEntityIndex(entity)]];
   }
 
   /**
@@ -151,46 +198,59 @@ public:
                     std::to_string(static_cast<u32>(entity)));
     auto &pool = getPoolForComponent<TComponentType>();
 
-    return std::any_cast<TComponentType &>(
-        pool.components[pool.entityIndices[static_cast<usize>(entity)]]);
+    return pool.components[pool.entityIndices[getEntityIndex(entity)]];
   }
 
   /**
    * @brief Check if component exists in entity
    *
+   * Components of recycled indices do not
+   * exist for handles of deleted entities
+   *
    * @tparam ComponentType Component type
    * @param entity Entity
    * @retval true Entity has component
    * @retval false Entity does not have component
    */
   template <class TComponentType> bool has(Entity entity) const {
-    usize sEntity = static_cast<usize>(entity);
+    usize sEntity = getEntityIndex(entity);
     const auto &pool = getPoolForComponent<TComponentType>();
     return sEntity < pool.entityIndices.size() &&
-           pool.entityIndices[sEntity] != DeadIndex;
+           pool.entityIndices[sEntity] != DeadIndex &&
+           pool.entities[pool.entityIndices[sEntity]] == entity;
   }
 
   /**
    * @brief Remove component from entity
    *
+   * Handles of deleted entities do not remove
+   * components of entities that recycled their index
+   *
    * @tparam ComponentType Component type
    * @param entity Entity
    */
   template <class TComponentType> void remove(Entity entity) {
-    usize sEntity = static_cast<usize>(entity);
-
-    auto &pool = getPoolForComponent<TComponentType>();
-    QuollAssert(sEntity < pool.entityIndices.size(),
+    const bool hasComponent = has<TComponentType>(entity);
+    QuollAssert(hasComponent,
                 "Component named " + String(typeid(TComponentType).name()) +
                     " does not exist for entity " +
                     std::to_string(static_cast<u32>(entity)));
+    if (!hasComponent) {
+      return;
+    }
+
+    usize sEntity = getEntityIndex(entity);
+    auto &pool = getPoolForComponent<TComponentType>();
+
+    if (pool.group) {
+      removeFromGroup(*pool.group, sEntity);
+    }
 
     usize entityIndexToDelete = pool.entityIndices[sEntity];
 
     auto &observers = getRemoveObserverPoolForComponent<TComponentType>();
     for (auto &observer : observers) {
-      observer.entities.push_back(entity);
-      observer.components.push_back(pool.components[entityIndexToDelete]);
+      pool.appendTo(entityIndexToDelete, *observer);
     }
 
     Entity movedEntity = pool.entities.back();
@@ -199,18 +259,21 @@ public:
     pool.entities[entityIndexToDelete] = movedEntity;
 
     // Change index of moved entity to the index of deleted entity
-    pool.entityIndices[static_cast<usize>(movedEntity)] = entityIndexToDelete;
+    pool.entityIndices[getEntityIndex(movedEntity)] = entityIndexToDelete;
 
     // Delete last item from entities array
     pool.entities.pop_back();
 
-    // Move last component in the array to place of deleted component
-    pool.components[entityIndexToDelete] = pool.components.back();
+    pool.ticks[entityIndexToDelete] = pool.ticks.back();
+    pool.ticks.pop_back();
 
-    // Delete last item from components array
-    pool.components.pop_back();
+    // Move last component in the array to place of deleted component
+    // and delete last item from components array
+    pool.swapAndPopComponent(entityIndexToDelete);
 
     pool.entityIndices[sEntity] = DeadIndex;
+    clearMaskBit(sEntity, getComponentId<TComponentType>());
+    pool.markChanged();
   }
 
   /**
@@ -223,6 +286,24 @@ public:
     return getPoolForComponent<TComponentType>().entities.size();
   }
 
+  /**
+   * @brief Get version of component type
+   *
+   * Version changes every time a component of
+   * this type is set or removed. Versions are unique
+   * across all storages, which makes them usable for
+   * detecting changes without storing the storage.
+   *
+   * Modifying components through references returned
+   * from getters does not change the version.
+   *
+   * @tparam TComponentType Component type
+   * @return Component version
+   */
+  template <class TComponentType> u64 getComponentVersion() const {
+    return getPoolForComponent<TComponentType>().version;
+  }
+
   /**
    * @brief Destroys all entities and components
    */
@@ -235,10 +316,62 @@ public:
    */
   template <class TComponentType> void destroyComponents() {
     auto &pool = getPoolForComponent<TComponentType>();
+    const auto id = getComponentId<TComponentType>();
+    for (auto entity : pool.entities) {
+      clearMaskBit(getEntityIndex(entity), id);
+    }
 
-    pool.components.clear();
-    pool.entities.clear();
-    pool.entityIndices.clear();
+    if (pool.group) {
+      pool.group->size = 0;
+    }
+
+    pool.clear();
+  }
+
+  /**
+   * @brief Group components
+   *
+   * Entities that have all grouped components
+   * are kept packed at the front of the pools
+   * in the same order. Views that pick all
+   * grouped components iterate the packed
+   * range without membership checks.
+   *
+   * A component can only be in one group.
+   * Iterating a view of grouped components
+   * while removing grouped components can
+   * skip entities.
+   *
+   * @tparam ...TOwnedComponents Grouped components
+   */
+  template <class... TOwnedComponents> void group() {
+    static_assert(sizeof...(TOwnedComponents) > 1,
+                  "Group must have at least two components");
+    static_assert(entity_utils::AreTypesUnique<TOwnedComponents...>,
+                  "Grouped components must be unique");
+
+    QuollAssert((!getPoolForComponent<TOwnedComponents>().group && ...),
+                "Component is already in a group");
+
+    createGroup({getComponentId<TOwnedComponents>()...});
+  }
+
+  /**
+   * @brief Get number of entities in group
+   *
+   * @tparam ...TOwnedComponents Grouped components
+   * @return Number of entities that have
+   *         all grouped components
+   */
+  template <class... TOwnedComponents> usize getGroupSize() const {
+    const std::array<const EntityStorageSparseSetComponentPool *,
+                     sizeof...(TOwnedComponents)>
+        pools{&getPoolForComponent<TOwnedComponents>()...};
+
+    auto *group = pools.at(0)->group;
+    QuollAssert(group && group->componentIds.size() == pools.size(),
+                "Components are not grouped");
+    return group->size;
   }
 
   /**
@@ -249,10 +382,10 @@ public:
    */
   template <class... TPickComponents>
   EntityStorageSparseSetView<TPickComponents...> view() {
-    std::array<EntityStorageSparseSetComponentPool *,
-               sizeof...(TPickComponents)>
+    typename EntityStorageSparseSetView<TPickComponents...>::PickedPools
         pickedPools{&getPoolForComponent<TPickComponents>()...};
-    return EntityStorageSparseSetView<TPickComponents...>(pickedPools);
+    return EntityStorageSparseSetView<TPickComponents...>(pickedPools,
+                                                          mComponentPools);
   }
 
   /**
@@ -268,23 +401,51 @@ public:
     QuollAssert(observers.size() < MaxObserverPoolSizePerComponent - 1,
                 "Maximum number of observers is reached");
 
-    observers.push_back({});
+    auto observer = std::make_unique<
+        EntityStorageSparseSetTypedComponentPool<TComponentType>>();
+    auto *observerPtr = observer.get();
+    observers.push_back(std::move(observer));
 
-    return EntityStorageSparseSetObserver<TComponentType>(
-        &observers.at(observers.size() - 1));
+    return EntityStorageSparseSetObserver<TComponentType>(observerPtr);
   }
 
-private:
   /**
    * @brief Get component id from type
    *
+   * Component ids are sequential integers that are
+   * shared between all storages and assigned the first
+   * time a component type is used. They are used to index
+   * component pools without hashing the type.
+   *
    * @tparam TComponentType Component type
    * @return Component id
    */
-  template <class TComponentType> static std::type_index getComponentId() {
-    return std::type_index(typeid(TComponentType));
+  template <class TComponentType> static usize getComponentId() {
+    return EntityStorageSparseSetComponentPool::getComponentId<
+        TComponentType>();
+  }
+
+  /**
+   * @brief Read changes of component type
+   *
+   * Returns the version since which components
+   * are changed for the reader and moves the
+   * cursor to the current version. Cursors of
+   * other storages read all components.
+   *
+   * @tparam TComponentType Component type
+   * @param cursor Change cursor of the reader
+   * @return Version to pass to view change filter
+   */
+  template <class TComponentType>
+  u64 readChanges(EntityStorageSparseSetChangeCursor &cursor) const {
+    const u64 since = cursor.storageId == mId ? cursor.version : 0;
+    cursor = {mId, getComponentVersion<TComponentType>()};
+    return since;
   }
 
+private:
+
   /**
    * @brief Get constant pool for component
    *
@@ -294,13 +455,15 @@ private:
    * @return Component pool for component type
    */
   template <class TComponentType>
-  const EntityStorageSparseSetComponentPool &getPoolForComponent() const {
-    auto id = getComponentId<TComponentType>();
-    QuollAssert(mComponentPools.find(id) != mComponentPools.end(),
+  const EntityStorageSparseSetTypedComponentPool<TComponentType> &
+  getPoolForComponent() const {
+    QuollAssert(hasComponentPool<TComponentType>(),
                 "Component pool " + String(typeid(TComponentType).name()) +
                     " does not exists");
 
-    return mComponentPools.at(id);
+    using TypedPool = EntityStorageSparseSetTypedComponentPool<TComponentType>;
+    return static_cast<const TypedPool &>(
+        *mComponentPools[getComponentId<TComponentType>()]);
   }
 
   /**
@@ -312,13 +475,15 @@ private:
    * @return Component pool for component type
    */
   template <class TComponentType>
-  EntityStorageSparseSetComponentPool &getPoolForComponent() {
-    auto id = getComponentId<TComponentType>();
-    QuollAssert(mComponentPools.find(id) != mComponentPools.end(),
+  EntityStorageSparseSetTypedComponentPool<TComponentType> &
+  getPoolForComponent() {
+    QuollAssert(hasComponentPool<TComponentType>(),
                 "Component pool " + String(typeid(TComponentType).name()) +
                     " does not exists");
 
-    return mComponentPools.at(id);
+    using TypedPool = EntityStorageSparseSetTypedComponentPool<TComponentType>;
+    return static_cast<TypedPool &>(
+        *mComponentPools[getComponentId<TComponentType>()]);
   }
 
   /**
@@ -330,14 +495,13 @@ private:
    * @return Component pool for component type
    */
   template <class TComponentType>
-  std::vector<EntityStorageSparseSetComponentPool> &
+  std::vector<std::unique_ptr<EntityStorageSparseSetComponentPool>> &
   getRemoveObserverPoolForComponent() {
-    auto id = getComponentId<TComponentType>();
-    QuollAssert(mRemoveObserverPools.find(id) != mRemoveObserverPools.end(),
+    QuollAssert(hasComponentPool<TComponentType>(),
                 "Component pool " + String(typeid(TComponentType).name()) +
                     " does not exist");
 
-    return mRemoveObserverPools.at(id);
+    return mRemoveObserverPools[getComponentId<TComponentType>()];
   }
 
   /**
@@ -348,75 +512,108 @@ private:
    * @retval false Component type does not exist
    */
   template <class TComponentType> bool hasComponentPool() const {
-    return mComponentPools.find(getComponentId<TComponentType>()) !=
-           mComponentPools.end();
+    auto id = getComponentId<TComponentType>();
+    return id < mComponentPools.size() && mComponentPools[id] != nullptr;
   }
 
   /**
-   * @brief Get all entities with specified components
+   * @brief Queue removal of all entity components
    *
-   * Infers template parameter for indices using index sequence
-   * and uses the index to get the needed values for components
+   * Uses component mask of the entity to
+   * find pools that contain the entity
    *
-   * @tparam PickComponents Components to pick
-   * @tparam PickComponentIndices Indices of picked components
-   * @param iterFn Iterator function
-   * @param sequence Index sequence of picked components
+   * @param index Entity index
    */
-  template <class... TPickComponents, usize... TPickComponentIndices>
-  void iterateEntitiesInternal(
-      const std::function<void(Entity, TPickComponents &...)> &iterFn,
-      std::index_sequence<TPickComponentIndices...> sequence) {
-
-    std::array<EntityStorageSparseSetComponentPool *,
-               sizeof...(TPickComponents)>
-        pickedPools{&getPoolForComponent<TPickComponents>()...};
+  void queueComponentRemovals(u32 index);
 
-    EntityStorageSparseSetComponentPool *smallestPool = pickedPools.at(0);
-    for (auto *pool : pickedPools) {
-      if (pool->entities.size() < smallestPool->entities.size()) {
-        smallestPool = pool;
-      }
-    }
+  /**
+   * @brief Remove queued components from pools
+   */
+  void removeQueuedComponents();
 
-    const auto &smallestEntities = smallestPool->entities;
+  /**
+   * @brief Create group
+   *
+   * @param componentIds Ids of grouped components
+   */
+  void createGroup(std::vector<usize> componentIds);
 
-    for (usize i = 0; i < smallestEntities.size(); ++i) {
-      Entity entity = smallestEntities[i];
+  /**
+   * @brief Add entity to group if it has all components
+   *
+   * @param group Group
+   * @param index Entity index
+   */
+  void addToGroup(EntityStorageSparseSetGroup &group, usize index);
 
-      bool isDead = false;
-      for (usize i = 0; i < pickedPools.size() && !isDead; ++i) {
-        auto *pool = pickedPools.at(i);
-        isDead = entity >= pool->entityIndices.size() ||
-                 pool->entityIndices[entity] == DeadIndex;
-      }
+  /**
+   * @brief Remove entity from group if it is in the group
+   *
+   * @param group Group
+   * @param index Entity index
+   */
+  void removeFromGroup(EntityStorageSparseSetGroup &group, usize index);
 
-      if (isDead) {
-        continue;
-      }
+  /**
+   * @brief Free entity index
+   *
+   * @param entity Entity
+   */
+  void freeEntity(Entity entity);
 
-      const auto &indices =
-          std::array{std::get<TPickComponentIndices>(pickedPools)
-                         ->entityIndices[entity]...};
+  /**
+   * @brief Resize component masks of all entities
+   *
+   * @param maskWords Number of mask words per entity
+   */
+  void resizeComponentMasks(usize maskWords);
 
-      std::tuple<TPickComponents &...> components = {
-          std::any_cast<TPickComponents &>(
-              std::get<TPickComponentIndices>(pickedPools)
-                  ->components[std::get<TPickComponentIndices>(indices)])...};
+  /**
+   * @brief Get component mask word of entity
+   *
+   * @param index Entity index
+   * @param id Component id
+   * @return Mask word that stores the component bit
+   */
+  inline u64 &getMaskWord(usize index, usize id) {
+    return mComponentMasks[index * mMaskWords + id / MaskWordBits];
+  }
 
-      iterFn(entity, std::get<TPickComponentIndices>(components)...);
-    }
+  /**
+   * @brief Set component bit in mask of entity
+   *
+   * Mask words are shared between components;
+   * so, bits are updated atomically, which allows
+   * systems to add different components concurrently
+   *
+   * @param index Entity index
+   * @param id Component id
+   */
+  inline void setMaskBit(usize index, usize id) {
+    std::atomic_ref(getMaskWord(index, id))
+        .fetch_or(getMaskBit(id), std::memory_order_relaxed);
   }
 
   /**
-   * @brief Delete all entity components
+   * @brief Clear component bit in mask of entity
    *
-   * Recursion function. Loops through component pools and deletes entity.
+   * @param index Entity index
+   * @param id Component id
+   */
+  inline void clearMaskBit(usize index, usize id) {
+    std::atomic_ref(getMaskWord(index, id))
+        .fetch_and(~getMaskBit(id), std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Get component bit in mask word
    *
-   * @tparam Index Tuple index of component pool
-   * @param entity Entity
+   * @param id Component id
+   * @return Component bit
    */
-  void deleteAllEntityComponents(Entity entity);
+  static constexpr u64 getMaskBit(usize id) {
+    return u64{1} << (id % MaskWordBits);
+  }
 
   /**
    * @brief Delete all components
@@ -434,16 +631,70 @@ private:
   void deleteAllObservers();
 
 private:
-  std::unordered_map<std::type_index, EntityStorageSparseSetComponentPool>
+  static inline std::atomic<u64> sNextStorageId{0};
+
+  /**
+   * Unique id of storage contents
+   *
+   * Changes when contents are replaced
+   * by duplicating another storage
+   */
+  u64 mId = ++sNextStorageId;
+
+  std::vector<std::unique_ptr<EntityStorageSparseSetComponentPool>>
       mComponentPools;
 
-  std::unordered_map<std::type_index,
-                     std::vector<EntityStorageSparseSetComponentPool>>
+  std::vector<std::vector<std::unique_ptr<EntityStorageSparseSetComponentPool>>>
       mRemoveObserverPools;
 
-  Entity mLastEntity{1};
-  std::list<Entity> mDeleted;
+  /**
+   * Entity slot of an index
+   */
+  struct EntitySlot {
+    /**
+     * Entity handle with the current
+     * generation of the index
+     */
+    Entity entity = Entity::Null;
+
+    /**
+     * Next index in the free list
+     */
+    u32 nextFree = NullIndex;
+
+    bool alive = false;
+  };
+
+  /**
+   * First slot is reserved for null entity
+   */
+  std::vector<EntitySlot> mSlots = std::vector<EntitySlot>(1);
+
+  /**
+   * Free indices in the order that they
+   * are deleted. Free list is stored in
+   * the entity slots; so, deleting and
+   * recycling entities does not allocate.
+   */
+  u32 mFreeHead = NullIndex;
+  u32 mFreeTail = NullIndex;
+
   usize mNumEntities = 0;
+
+  /**
+   * Bit mask of components of every entity index.
+   * Bits are indexed by component ids.
+   */
+  std::vector<u64> mComponentMasks;
+  usize mMaskWords = 0;
+
+  /**
+   * Dense indices of queued component
+   * removals of every component pool
+   */
+  std::vector<std::vector<usize>> mPendingRemovals;
+
+  std::vector<std::unique_ptr<EntityStorageSparseSetGroup>> mGroups;
 };
 
 } // namespace quoll
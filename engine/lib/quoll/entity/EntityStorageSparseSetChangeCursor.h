@@ -0,0 +1,24 @@
+#pragma once
+
+namespace quoll {
+
+/**
+ * @brief Last read version of a component type
+ *
+ * Stored by systems that only process
+ * components that are changed since
+ * the last time they were read
+ */
+struct EntityStorageSparseSetChangeCursor {
+  /**
+   * Id of the read storage
+   */
+  u64 storageId = 0;
+
+  /**
+   * Last read component version
+   */
+  u64 version = 0;
+};
+
+} // namespace quoll
@@ -1,13 +1,265 @@
 #pragma once
 
+#include "EntityStorageSparseSetGroup.h"
+
 namespace quoll {
 
-struct EntityStorageSparseSetComponentPool {
+/**
+ * @brief Type erased component pool
+ *
+ * Stores sparse entity indices and dense entity
+ * array of a component type. Components are stored
+ * in a typed dense array of the derived pool; virtual
+ * functions are only used for operations where the
+ * component type is not known (e.g deleting entity).
+ */
+class EntityStorageSparseSetComponentPool {
+  static constexpr usize DeadIndex = std::numeric_limits<usize>::max();
+
+  /**
+   * Minimum number of recorded changes
+   * before the change log is compacted
+   */
+  static constexpr usize MinChangesToCompact = 64;
+
+public:
+  /**
+   * Entity whose component is set
+   * at a pool version
+   */
+  struct Change {
+    Entity entity = Entity::Null;
+
+    u64 version = 0;
+  };
+
+public:
+  /**
+   * @brief Destroy component pool
+   */
+  virtual ~EntityStorageSparseSetComponentPool() = default;
+
+  /**
+   * @brief Remove component at dense index
+   *
+   * Moves last component into the
+   * removed component's place
+   *
+   * @param index Dense index
+   */
+  virtual void swapAndPopComponent(usize index) = 0;
+
+  /**
+   * @brief Swap components at dense indices
+   *
+   * @param a First dense index
+   * @param b Second dense index
+   */
+  virtual void swapComponents(usize a, usize b) = 0;
+
+  /**
+   * @brief Append component at dense index to another pool
+   *
+   * Used for storing removed components
+   * in observer pools
+   *
+   * @param index Dense index
+   * @param pool Destination pool of the same type
+   */
+  virtual void appendTo(usize index,
+                        EntityStorageSparseSetComponentPool &pool) const = 0;
+
+  /**
+   * @brief Create copy of the pool
+   *
+   * @return Pool with copies of all entities and components
+   */
+  virtual std::unique_ptr<EntityStorageSparseSetComponentPool>
+  clone() const = 0;
+
+  /**
+   * @brief Clear all entities and components
+   */
+  virtual void clear() = 0;
+
+  /**
+   * @brief Mark pool as changed
+   *
+   * Assigns a new version to the pool. Versions
+   * are unique across all pools of all storages.
+   */
+  inline void markChanged() {
+    version = sNextVersion.fetch_add(1, std::memory_order_relaxed) + 1;
+  }
+
+  /**
+   * @brief Record change of dense entry
+   *
+   * Changes are recorded in version order. Older
+   * changes of the same entry are dropped when
+   * the log grows to twice the number of entries;
+   * so, the log stays proportional to the pool.
+   *
+   * @param index Dense index
+   */
+  inline void recordChange(usize index) {
+    changes.push_back({entities[index], ticks[index]});
+
+    if (changes.size() > MinChangesToCompact &&
+        changes.size() > 2 * entities.size()) {
+      std::erase_if(changes, [this](const Change &change) {
+        return !isLatestChange(change);
+      });
+    }
+  }
+
+  /**
+   * @brief Check if change is the latest change of entry
+   *
+   * Versions are unique; so, a change is the latest
+   * change of its entry if the entry is last set
+   * at the version of the change
+   *
+   * @param change Recorded change
+   * @retval true Change is the latest change of entry
+   * @retval false Entry is removed or set again
+   */
+  inline bool isLatestChange(const Change &change) const {
+    const auto entity = getEntityIndex(change.entity);
+    return entity < entityIndices.size() &&
+           entityIndices[entity] != DeadIndex &&
+           ticks[entityIndices[entity]] == change.version;
+  }
+
+  /**
+   * @brief Get changes after version
+   *
+   * @param version Pool version
+   * @return Recorded changes after the version
+   */
+  inline std::span<const Change> getChangesSince(u64 version) const {
+    auto it = std::upper_bound(
+        changes.begin(), changes.end(), version,
+        [](u64 value, const Change &change) { return value < change.version; });
+    return {it, changes.end()};
+  }
+
+  /**
+   * @brief Swap entries at dense indices
+   *
+   * Swaps entities and components and
+   * updates sparse indices of both entities
+   *
+   * @param a First dense index
+   * @param b Second dense index
+   */
+  inline void swapEntries(usize a, usize b) {
+    if (a == b) {
+      return;
+    }
+
+    std::swap(entities[a], entities[b]);
+    std::swap(ticks[a], ticks[b]);
+    entityIndices[getEntityIndex(entities[a])] = a;
+    entityIndices[getEntityIndex(entities[b])] = b;
+    swapComponents(a, b);
+  }
+
+  /**
+   * @brief Get component id from type
+   *
+   * Component ids are sequential integers that are
+   * shared between all storages and assigned the first
+   * time a component type is used. They are used to index
+   * component pools without hashing the type.
+   *
+   * @tparam TComponentType Component type
+   * @return Component id
+   */
+  template <class TComponentType> static usize getComponentId() {
+    static const usize Id = sNextComponentId++;
+    return Id;
+  }
+
+public:
   std::vector<usize> entityIndices;
 
   std::vector<Entity> entities;
 
-  std::vector<std::any> components;
+  /**
+   * Pool version when the component
+   * of every dense entry is last set
+   */
+  std::vector<u64> ticks;
+
+  /**
+   * Log of set components in version order
+   *
+   * Contains the latest change of every entry
+   * and older changes that are not compacted yet
+   */
+  std::vector<Change> changes;
+
+  u64 version = 0;
+
+  /**
+   * Group that owns the pool
+   */
+  EntityStorageSparseSetGroup *group = nullptr;
+
+private:
+  static inline std::atomic<u64> sNextVersion{0};
+
+  static inline std::atomic<usize> sNextComponentId{0};
+};
+
+/**
+ * @brief Component pool for specific component type
+ *
+ * Components are stored contiguously in the
+ * same order as the entities in the dense array
+ *
+ * @tparam TComponentType Component type
+ */
+template <class TComponentType>
+class EntityStorageSparseSetTypedComponentPool
+    : public EntityStorageSparseSetComponentPool {
+public:
+  void swapAndPopComponent(usize index) override {
+    if (index != components.size() - 1) {
+      components[index] = std::move(components.back());
+    }
+    components.pop_back();
+  }
+
+  void swapComponents(usize a, usize b) override {
+    std::swap(components[a], components[b]);
+  }
+
+  void appendTo(usize index,
+                EntityStorageSparseSetComponentPool &pool) const override {
+    auto &typedPool =
+        static_cast<EntityStorageSparseSetTypedComponentPool &>(pool);
+    typedPool.entities.push_back(entities[index]);
+    typedPool.ticks.push_back(ticks[index]);
+    typedPool.components.push_back(components[index]);
+  }
+
+  std::unique_ptr<EntityStorageSparseSetComponentPool> clone() const override {
+    return std::make_unique<EntityStorageSparseSetTypedComponentPool>(*this);
+  }
+
+  void clear() override {
+    components.clear();
+    entities.clear();
+    ticks.clear();
+    changes.clear();
+    entityIndices.clear();
+    markChanged();
+  }
+
+public:
+  std::vector<TComponentType> components;
 };
 
 } // namespace quoll
@@ -0,0 +1,32 @@
+#pragma once
+
+namespace quoll {
+
+/**
+ * @brief Group of owned component pools
+ *
+ * Entities that have all owned components are
+ * packed at the front of every owned pool in
+ * the same order. Views of owned components
+ * iterate the packed range without checking
+ * membership of entities in owned pools.
+ */
+struct EntityStorageSparseSetGroup {
+  /**
+   * Ids of owned components
+   */
+  std::vector<usize> componentIds;
+
+  /**
+   * Component mask of owned components
+   */
+  std::vector<u64> mask;
+
+  /**
+   * Number of entities that have
+   * all owned components
+   */
+  usize size = 0;
+};
+
+} // namespace quoll
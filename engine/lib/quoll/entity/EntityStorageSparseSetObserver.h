@@ -8,7 +8,8 @@ template <class TComponent> class EntityStorageSparseSetObserver {
 public:
   class Iterator {
   public:
-    Iterator(usize index, EntityStorageSparseSetComponentPool *pool)
+    Iterator(usize index,
+             EntityStorageSparseSetTypedComponentPool<TComponent> *pool)
         : mIndex(index), mPool(pool) {}
 
     Iterator &operator++() {
@@ -21,19 +22,19 @@ public:
     bool operator!=(Iterator &rhs) { return mIndex != rhs.mIndex; }
 
     std::tuple<Entity, TComponent> operator*() {
-      return {mPool->entities.at(mIndex),
-              std::any_cast<TComponent>(mPool->components.at(mIndex))};
+      return {mPool->entities.at(mIndex), mPool->components.at(mIndex)};
     }
 
   private:
     usize mIndex = 0;
-    EntityStorageSparseSetComponentPool *mPool;
+    EntityStorageSparseSetTypedComponentPool<TComponent> *mPool;
   };
 
 public:
   EntityStorageSparseSetObserver() = default;
 
-  EntityStorageSparseSetObserver(EntityStorageSparseSetComponentPool *pool)
+  EntityStorageSparseSetObserver(
+      EntityStorageSparseSetTypedComponentPool<TComponent> *pool)
       : mPool(pool) {}
 
   Iterator begin() {
@@ -46,13 +47,10 @@ public:
 
   inline usize size() { return mPool->entities.size(); }
 
-  void clear() {
-    mPool->entities.clear();
-    mPool->components.clear();
-  }
+  void clear() { mPool->clear(); }
 
 private:
-  EntityStorageSparseSetComponentPool *mPool = nullptr;
+  EntityStorageSparseSetTypedComponentPool<TComponent> *mPool = nullptr;
 };
 
 } // namespace quoll
@@ -1,27 +1,90 @@
 #pragma once
 
+#include "quoll/core/ThreadPool.h"
 #include "EntityStorageSparseSetComponentPool.h"
 
 namespace quoll {
 
 template <class... TComponentTypes> class EntityStorageSparseSetView {
+  static constexpr usize DeadIndex = std::numeric_limits<usize>::max();
+
+public:
   using PickedPools = std::array<EntityStorageSparseSetComponentPool *,
                                  sizeof...(TComponentTypes)>;
 
-  static constexpr usize DeadIndex = std::numeric_limits<usize>::max();
+  using ComponentPools =
+      std::vector<std::unique_ptr<EntityStorageSparseSetComponentPool>>;
+
+  using Item = std::tuple<Entity, TComponentTypes &...>;
+
+  /**
+   * Default number of entities in
+   * a parallel iteration chunk
+   */
+  static constexpr usize DefaultChunkSize = 256;
+
+  /**
+   * Maximum number of excluded or
+   * changed components in a view
+   */
+  static constexpr usize MaxFilters = 4;
+
+  /**
+   * Component that must be changed
+   * since the version
+   */
+  struct ChangeFilter {
+    EntityStorageSparseSetComponentPool *pool = nullptr;
+
+    u64 version = 0;
+  };
+
+  /**
+   * Filters of entities in the view
+   */
+  struct Filters {
+    std::array<EntityStorageSparseSetComponentPool *, MaxFilters> excluded{};
+
+    usize numExcluded = 0;
+
+    std::array<ChangeFilter, MaxFilters> changed{};
+
+    usize numChanged = 0;
+  };
+
+  /**
+   * Range of dense indices that are iterated
+   *
+   * Picked pools that store their components
+   * at the iterated dense indices are accessed
+   * directly without checking membership.
+   *
+   * If changes are set, recorded changes of
+   * the pool are iterated instead of its
+   * dense indices.
+   */
+  struct Range {
+    EntityStorageSparseSetComponentPool *pool = nullptr;
+
+    const EntityStorageSparseSetComponentPool::Change *changes = nullptr;
+
+    usize size = 0;
+
+    std::array<bool, sizeof...(TComponentTypes)> direct{};
+
+    Filters filters;
+  };
 
 public:
   class Iterator {
   public:
-    Iterator(usize index, PickedPools &pools,
-             EntityStorageSparseSetComponentPool *smallestPool)
-        : mIndex(index), mPools(pools), mSmallestPool(smallestPool) {}
+    Iterator(usize index, PickedPools &pools, const Range &range)
+        : mIndex(index), mPools(pools), mRange(range) {}
 
     Iterator &operator++() {
       do {
         mIndex++;
-      } while (mIndex < mSmallestPool->entities.size() &&
-               !isValidIndex(mIndex, mPools, mSmallestPool));
+      } while (mIndex < mRange.size && !isValidIndex(mIndex, mPools, mRange));
 
       return *this;
     }
@@ -30,76 +93,287 @@ public:
 
     bool operator!=(Iterator &rhs) { return mIndex != rhs.mIndex; }
 
-    std::tuple<Entity, TComponentTypes &...> operator*() {
-      return get(std::index_sequence_for<TComponentTypes...>{});
-    }
-
-  private:
-    template <usize... TComponentIndices>
-    std::tuple<Entity, TComponentTypes &...>
-    get(std::index_sequence<TComponentIndices...> sequence) {
-      auto entity = mSmallestPool->entities.at(mIndex);
-
-      const auto &indices =
-          std::array{std::get<TComponentIndices>(mPools)
-                         ->entityIndices[static_cast<usize>(entity)]...};
-
-      return {mSmallestPool->entities.at(mIndex),
-              std::any_cast<TComponentTypes &>(
-                  std::get<TComponentIndices>(mPools)
-                      ->components[std::get<TComponentIndices>(indices)])...};
+    Item operator*() {
+      return getItem(mIndex, mPools, mRange,
+                     std::index_sequence_for<TComponentTypes...>{});
     }
 
   private:
     usize mIndex = 0;
     PickedPools &mPools;
-    EntityStorageSparseSetComponentPool *mSmallestPool = nullptr;
+    const Range &mRange;
   };
 
 public:
-  EntityStorageSparseSetView(PickedPools pools) : mPools(pools) {}
+  EntityStorageSparseSetView(PickedPools pools,
+                             const ComponentPools &componentPools)
+      : mPools(pools), mComponentPools(&componentPools) {}
+
+  /**
+   * @brief Exclude entities with components
+   *
+   * @tparam ...TExcludedComponents Excluded components
+   * @return View without entities that have
+   *         any of the excluded components
+   */
+  template <class... TExcludedComponents>
+  EntityStorageSparseSetView exclude() const {
+    auto view = *this;
+    (view.addExcluded(getPool<TExcludedComponents>()), ...);
+    return view;
+  }
+
+  /**
+   * @brief Only view entities with changed component
+   *
+   * Components are changed when they are added
+   * or set. Modifying components through references
+   * does not change them.
+   *
+   * Iterating the view only visits changes that
+   * are recorded after the version if there are
+   * fewer of them than entities in the view.
+   * Changed component must not be set while
+   * iterating the view.
+   *
+   * @tparam TChangedComponent Changed component
+   * @param version Component version to compare against
+   * @return View of entities whose component is
+   *         changed after the version
+   */
+  template <class TChangedComponent>
+  EntityStorageSparseSetView changedSince(u64 version) const {
+    QuollAssert(mFilters.numChanged < MaxFilters,
+                "Maximum number of changed filters reached");
+
+    auto view = *this;
+    view.mFilters.changed[view.mFilters.numChanged++] = {
+        getPool<TChangedComponent>(), version};
+    return view;
+  }
 
   Iterator begin() {
-    mSmallestPool = mPools.at(0);
-    for (auto *pool : mPools) {
-      if (pool->entities.size() < mSmallestPool->entities.size()) {
-        mSmallestPool = pool;
-      }
-    }
+    mRange = findRange();
 
     usize index = 0;
-    while (index < mSmallestPool->entities.size() &&
-           !isValidIndex(index, mPools, mSmallestPool)) {
+    while (index < mRange.size && !isValidIndex(index, mPools, mRange)) {
       index++;
     }
 
-    return Iterator(index, mPools, mSmallestPool);
+    return Iterator(index, mPools, mRange);
   }
 
   Iterator end() {
-    QuollAssert(mSmallestPool != nullptr, "Begin is not called");
+    QuollAssert(mRange.pool != nullptr, "Begin is not called");
 
-    return Iterator(mSmallestPool->entities.size(), mPools, mSmallestPool);
+    return Iterator(mRange.size, mPools, mRange);
+  }
+
+  /**
+   * @brief Run function for every entity in parallel
+   *
+   * Iterated dense range is split into chunks
+   * that are run on the thread pool. Function
+   * must not add or remove components of
+   * the viewed types.
+   *
+   * @param threadPool Thread pool
+   * @param fn Function that receives entity and components
+   * @param chunkSize Number of entities in a chunk
+   */
+  template <class TFunction>
+  void parallelForEach(ThreadPool &threadPool, TFunction &&fn,
+                       usize chunkSize = DefaultChunkSize) {
+    using Sequence = std::index_sequence_for<TComponentTypes...>;
+
+    const auto range = findRange();
+    auto &pools = mPools;
+
+    threadPool.parallelFor(
+        range.size, chunkSize, [&fn, &pools, &range](usize start, usize end) {
+          for (usize index = start; index < end; ++index) {
+            if (isValidIndex(index, pools, range)) {
+              std::apply(fn, getItem(index, pools, range, Sequence{}));
+            }
+          }
+        });
   }
 
 private:
+  /**
+   * @brief Find iterated range
+   *
+   * Packed range of the largest group whose
+   * owned components are all picked is
+   * iterated if it exists. Otherwise, all
+   * entities of the smallest pool are iterated.
+   * Recorded changes of a changed filter are
+   * iterated instead if they are fewer.
+   *
+   * @return Iterated range
+   */
+  Range findRange() {
+    EntityStorageSparseSetGroup *group = nullptr;
+    for (auto *pool : mPools) {
+      auto *candidate = pool->group;
+      if (candidate && isGroupPicked(*candidate) &&
+          (!group ||
+           candidate->componentIds.size() > group->componentIds.size())) {
+        group = candidate;
+      }
+    }
+
+    Range range;
+    range.filters = mFilters;
+
+    // Nothing is changed since the versions
+    for (usize i = 0; i < mFilters.numChanged; ++i) {
+      const auto &filter = mFilters.changed[i];
+      if (filter.pool->version <= filter.version) {
+        range.pool = mPools.at(0);
+        return range;
+      }
+    }
+
+    if (group) {
+      for (usize i = 0; i < mPools.size(); ++i) {
+        range.direct[i] = mPools[i]->group == group;
+        if (range.direct[i] && !range.pool) {
+          range.pool = mPools[i];
+        }
+      }
+      range.size = group->size;
+    } else {
+      range.pool = findSmallestPool();
+      range.size = range.pool->entities.size();
+      for (usize i = 0; i < mPools.size(); ++i) {
+        range.direct[i] = mPools[i] == range.pool;
+      }
+    }
+
+    for (usize i = 0; i < mFilters.numChanged; ++i) {
+      const auto &filter = mFilters.changed[i];
+      auto changes = filter.pool->getChangesSince(filter.version);
+      if (changes.size() < range.size) {
+        range.pool = filter.pool;
+        range.changes = changes.data();
+        range.size = changes.size();
+        range.direct.fill(false);
+      }
+    }
+
+    return range;
+  }
+
+  template <class TComponentType>
+  EntityStorageSparseSetComponentPool *getPool() const {
+    const auto id =
+        EntityStorageSparseSetComponentPool::getComponentId<TComponentType>();
+    QuollAssert(id < mComponentPools->size() && mComponentPools->at(id),
+                "Component pool " + String(typeid(TComponentType).name()) +
+                    " does not exist");
+    return mComponentPools->at(id).get();
+  }
+
+  void addExcluded(EntityStorageSparseSetComponentPool *pool) {
+    QuollAssert(mFilters.numExcluded < MaxFilters,
+                "Maximum number of excluded components reached");
+    mFilters.excluded[mFilters.numExcluded++] = pool;
+  }
+
+  bool isGroupPicked(const EntityStorageSparseSetGroup &group) const {
+    usize numPicked = 0;
+    for (auto *pool : mPools) {
+      numPicked += pool->group == &group ? 1 : 0;
+    }
+
+    return numPicked == group.componentIds.size();
+  }
+
+  EntityStorageSparseSetComponentPool *findSmallestPool() {
+    auto *smallestPool = mPools.at(0);
+    for (auto *pool : mPools) {
+      if (pool->entities.size() < smallestPool->entities.size()) {
+        smallestPool = pool;
+      }
+    }
+
+    return smallestPool;
+  }
+
+  template <usize... TComponentIndices>
+  static Item getItem(usize index, PickedPools &pools, const Range &range,
+                      std::index_sequence<TComponentIndices...> sequence) {
+    auto entity = getEntity(index, range);
+
+    return {entity, getComponent<TComponentTypes>(
+                        std::get<TComponentIndices>(pools), entity, index,
+                        range.direct[TComponentIndices])...};
+  }
+
+  template <class TComponentType>
+  static TComponentType &getComponent(EntityStorageSparseSetComponentPool *pool,
+                                      Entity entity, usize index,
+                                      bool direct) {
+    auto *typedPool =
+        static_cast<EntityStorageSparseSetTypedComponentPool<TComponentType> *>(
+            pool);
+    if (direct) {
+      return typedPool->components[index];
+    }
+
+    return typedPool
+        ->components[typedPool->entityIndices[getEntityIndex(entity)]];
+  }
+
+  static Entity getEntity(usize index, const Range &range) {
+    return range.changes ? range.changes[index].entity
+                         : range.pool->entities[index];
+  }
+
   static bool isValidIndex(usize index, PickedPools &pools,
-                           EntityStorageSparseSetComponentPool *smallestPool) {
-    bool isValid = true;
-    auto entity = static_cast<usize>(smallestPool->entities.at(index));
+                           const Range &range) {
+    // Older changes of the same entry are skipped;
+    // so, every entity is visited once
+    bool isValid =
+        !range.changes || range.pool->isLatestChange(range.changes[index]);
+    auto entity = getEntityIndex(getEntity(index, range));
     for (usize i = 0; i < pools.size() && isValid; ++i) {
+      if (range.direct[i]) {
+        continue;
+      }
+
       auto *pool = pools.at(i);
       isValid = entity < pool->entityIndices.size() &&
                 pool->entityIndices[entity] != DeadIndex;
     }
 
+    const auto &filters = range.filters;
+    for (usize i = 0; i < filters.numExcluded && isValid; ++i) {
+      auto *pool = filters.excluded[i];
+      isValid = entity >= pool->entityIndices.size() ||
+                pool->entityIndices[entity] == DeadIndex;
+    }
+
+    for (usize i = 0; i < filters.numChanged && isValid; ++i) {
+      const auto &filter = filters.changed[i];
+      isValid = entity < filter.pool->entityIndices.size() &&
+                filter.pool->entityIndices[entity] != DeadIndex &&
+                filter.pool->ticks[filter.pool->entityIndices[entity]] >
+                    filter.version;
+    }
+
     return isValid;
   }
 
 private:
   PickedPools mPools;
 
-  EntityStorageSparseSetComponentPool *mSmallestPool = nullptr;
+  const ComponentPools *mComponentPools = nullptr;
+
+  Filters mFilters;
+
+  Range mRange;
 };
 
 } // namespace quoll
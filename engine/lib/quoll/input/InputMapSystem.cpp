@@ -12,18 +12,18 @@ InputMapSystem::InputMapSystem(InputDeviceManager &deviceManager)
 
 void InputMapSystem::update(SystemView &view) {
   auto &entityDatabase = view.scene->entityDatabase;
-  for (auto [entity, ref] : entityDatabase.view<InputMapAssetRef>()) {
-    if (ref.asset && !entityDatabase.has<InputMap>(entity)) {
+  for (auto [entity, ref] :
+       entityDatabase.view<InputMapAssetRef>().exclude<InputMap>()) {
+    if (ref.asset) {
       entityDatabase.set(entity,
                          createInputMap(ref.asset.get(), ref.defaultScheme));
     }
   }
 
   std::vector<Entity> componentsToDelete(0);
-  for (auto [entity, ref] : entityDatabase.view<InputMap>()) {
-    if (!entityDatabase.has<InputMapAssetRef>(entity)) {
-      componentsToDelete.push_back(entity);
-    }
+  for (auto [entity, ref] :
+       entityDatabase.view<InputMap>().exclude<InputMapAssetRef>()) {
+    componentsToDelete.push_back(entity);
   }
 
   for (auto entity : componentsToDelete) {
@@ -1,6 +1,19 @@
 #include "quoll/core/Base.h"
+#include "quoll/animation/Animator.h"
+#include "quoll/animation/AnimatorEvent.h"
+#include "quoll/input/InputMap.h"
 #include "quoll/physx/PhysxBackend.h"
+#include "quoll/renderer/Mesh.h"
+#include "quoll/scene/AutoAspectRatio.h"
+#include "quoll/scene/Camera.h"
+#include "quoll/scene/DirectionalLight.h"
+#include "quoll/scene/LocalTransform.h"
+#include "quoll/scene/Parent.h"
+#include "quoll/scene/PerspectiveLens.h"
 #include "quoll/scene/Scene.h"
+#include "quoll/scene/WorldTransform.h"
+#include "quoll/skeleton/JointAttachment.h"
+#include "quoll/skeleton/Skeleton.h"
 #include "MainEngineModules.h"
 
 namespace quoll {
@@ -8,14 +21,14 @@ namespace quoll {
 MainEngineModules::MainEngineModules(InputDeviceManager &deviceManager,
                                      Window &window, AssetCache &assetCache)
     : mWindow(window), mInputMapSystem(deviceManager),
-      mScriptingSystem(assetCache), mPhysicsSystem(new PhysxBackend) {}
+      mScriptingSystem(assetCache), mPhysicsSystem(new PhysxBackend) {
+  createPrepareSchedule();
+  createFixedUpdateSchedule();
+  createUpdateSchedule();
+}
 
 void MainEngineModules::prepare(SystemView &view) {
-  mEntityDeleter.update(view);
-  mCameraAspectRatioUpdater.update(view);
-  mSkeletonUpdater.update(view);
-  mSceneUpdater.update(view);
-  mAnimationSystem.prepare(view);
+  mPrepareScheduler.run(0.0f, view);
 }
 
 void MainEngineModules::cleanup(SystemView &view) {
@@ -25,16 +38,11 @@ void MainEngineModules::cleanup(SystemView &view) {
 }
 
 void MainEngineModules::fixedUpdate(f32 dt, SystemView &view) {
-  mPhysicsSystem.update(dt, view);
-
-  mInputMapSystem.update(view);
-  mScriptingSystem.start(view, mPhysicsSystem, mWindow.getSignals());
-  mScriptingSystem.update(dt, view);
-  mAnimationSystem.update(dt, view);
+  mFixedUpdateScheduler.run(dt, view);
 }
 
 void MainEngineModules::update(f32 dt, SystemView &view) {
-  mAudioSystem.output(view);
+  mUpdateScheduler.run(dt, view);
 }
 
 void MainEngineModules::render(SystemView &view) {
@@ -51,4 +59,86 @@ SystemView MainEngineModules::createSystemView(Scene &scene) {
   return std::move(view);
 }
 
+void MainEngineModules::createPrepareSchedule() {
+  mPrepareScheduler.add("EntityDeleter", SystemAccess().exclusive(),
+                        [this](f32, SystemView &view) {
+                          mEntityDeleter.update(view);
+                        });
+
+  mPrepareScheduler.add(
+      "CameraAspectRatioUpdater",
+      SystemAccess().read<AutoAspectRatio>().write<PerspectiveLens>(),
+      [this](f32, SystemView &view) {
+        mCameraAspectRatioUpdater.update(view);
+      });
+
+  mPrepareScheduler.add(
+      "SkeletonUpdater",
+      SystemAccess()
+          .read<SkeletonAssetRef>()
+          .write<SkeletonDebug>()
+          .structural<Skeleton, SkeletonCurrentAsset>(),
+      [this](f32, SystemView &view) { mSkeletonUpdater.update(view); });
+
+  mPrepareScheduler.add(
+      "SceneUpdater",
+      SystemAccess()
+          .read<Parent, JointAttachment, Skeleton, PerspectiveLens>()
+          .write<LocalTransform, WorldTransform, Camera, DirectionalLight>(),
+      [this](f32, SystemView &view) { mSceneUpdater.update(view); });
+
+  // Reads world transforms that are
+  // updated by scene updater
+  mPrepareScheduler.add(
+      "SpatialIndexUpdater",
+      SystemAccess()
+          .read<WorldTransform, Mesh, Skeleton>()
+          .write<SpatialIndex>(),
+      [this](f32, SystemView &view) {
+        mSpatialIndexUpdater.update(view,
+                                    mSceneUpdater.getUpdatedEntities());
+      });
+
+  mPrepareScheduler.add(
+      "AnimationSystem::prepare",
+      SystemAccess()
+          .read<AnimatorAssetRef>()
+          .structural<Animator, AnimatorCurrentAsset>(),
+      [this](f32, SystemView &view) { mAnimationSystem.prepare(view); });
+}
+
+void MainEngineModules::createFixedUpdateSchedule() {
+  // Collision signals are handled by scripts
+  // during simulation
+  mFixedUpdateScheduler.add(
+      "PhysicsSystem", SystemAccess().exclusive(),
+      [this](f32 dt, SystemView &view) { mPhysicsSystem.update(dt, view); });
+
+  mFixedUpdateScheduler.add(
+      "InputMapSystem",
+      SystemAccess().read<InputMapAssetRef>().structural<InputMap>(),
+      [this](f32, SystemView &view) { mInputMapSystem.update(view); });
+
+  mFixedUpdateScheduler.add(
+      "LuaScriptingSystem", SystemAccess().exclusive(),
+      [this](f32 dt, SystemView &view) {
+        mScriptingSystem.start(view, mPhysicsSystem, mWindow.getSignals());
+        mScriptingSystem.update(dt, view);
+      });
+
+  mFixedUpdateScheduler.add(
+      "AnimationSystem::update",
+      SystemAccess()
+          .write<Animator, LocalTransform, Skeleton>()
+          .structural<AnimatorEvent>(),
+      [this](f32 dt, SystemView &view) { mAnimationSystem.update(dt, view); });
+}
+
+void MainEngineModules::createUpdateSchedule() {
+  mUpdateScheduler.add(
+      "AudioSystem",
+      SystemAccess().read<AudioSource>().structural<AudioStart, AudioStatus>(),
+      [this](f32, SystemView &view) { mAudioSystem.output(view); });
+}
+
 } // namespace quoll
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "quoll/core/Engine.h"
 #include "quoll/core/EntityDeleter.h"
 #include "quoll/animation/AnimationSystem.h"
 #include "quoll/audio/AudioSystem.h"
@@ -8,7 +9,9 @@
 #include "quoll/physics/PhysicsSystem.h"
 #include "quoll/scene/CameraAspectRatioUpdater.h"
 #include "quoll/scene/SceneUpdater.h"
+#include "quoll/scene/SpatialIndexUpdater.h"
 #include "quoll/skeleton/SkeletonUpdater.h"
+#include "quoll/system/SystemScheduler.h"
 #include "quoll/ui/UICanvasUpdater.h"
 #include "quoll/window/Window.h"
 
@@ -22,6 +25,10 @@ class AssetCache;
  * Maintains all the main engine modules
  * required to run a simulation and provides
  * the execution order of system updates.
+ *
+ * Prepare, fixed update, and update systems are
+ * run by schedulers; systems are added in the order
+ * they would run serially.
  */
 class MainEngineModules {
 public:
@@ -46,6 +53,15 @@ public:
 
   constexpr PhysicsSystem &getPhysicsSystem() { return mPhysicsSystem; }
 
+  constexpr SceneUpdater &getSceneUpdater() { return mSceneUpdater; }
+
+private:
+  void createPrepareSchedule();
+
+  void createFixedUpdateSchedule();
+
+  void createUpdateSchedule();
+
 private:
   Window &mWindow;
 
@@ -53,12 +69,17 @@ private:
   EntityDeleter mEntityDeleter;
   SkeletonUpdater mSkeletonUpdater;
   SceneUpdater mSceneUpdater;
+  SpatialIndexUpdater mSpatialIndexUpdater;
   AnimationSystem mAnimationSystem{};
   LuaScriptingSystem mScriptingSystem;
   PhysicsSystem mPhysicsSystem;
   AudioSystem<DefaultAudioBackend> mAudioSystem;
   InputMapSystem mInputMapSystem;
   UICanvasUpdater mUICanvasUpdater;
+
+  SystemScheduler mPrepareScheduler{Engine::getThreadPool()};
+  SystemScheduler mFixedUpdateScheduler{Engine::getThreadPool()};
+  SystemScheduler mUpdateScheduler{Engine::getThreadPool()};
 };
 
 } // namespace quoll
@@ -5,6 +5,7 @@
 #include "quoll/input/InputSystemLuaTable.h"
 #include "quoll/logger/UserLoggerLuaTable.h"
 #include "quoll/physics/PhysicsSystemLuaTable.h"
+#include "quoll/scene/SpatialIndexLuaTable.h"
 #include "quoll/ui/UILuaTable.h"
 #include "GameLuaTable.h"
 
@@ -46,6 +47,11 @@ sol::object GameLuaTable::getService(String name) {
         state, PhysicsSystemLuaTable::create(state, mEntity, mScriptGlobals));
   }
 
+  if (name == "Spatial") {
+    SpatialIndexLuaTable::create(state);
+    return sol::make_object(state, SpatialIndexLuaTable(mScriptGlobals));
+  }
+
   return sol::make_object(state, sol::nil);
 }
 
@@ -18,7 +18,8 @@ void LuaScriptingSystem::start(SystemView &view, PhysicsSystem &physicsSystem,
   QUOLL_PROFILE_EVENT("LuaScriptingSystem::start");
   auto &entityDatabase = view.scene->entityDatabase;
 
-  ScriptGlobals scriptGlobals{windowSignals, entityDatabase, physicsSystem,
+  ScriptGlobals scriptGlobals{windowSignals, entityDatabase,
+                              view.scene->spatialIndex, physicsSystem,
                               mAssetCache, mScriptLoop};
 
   lua::ScriptDecorator scriptDecorator;
@@ -6,6 +6,7 @@ namespace quoll {
 
 class WindowSignals;
 class EntityDatabase;
+class SpatialIndex;
 class PhysicsSystem;
 class AssetCache;
 
@@ -14,6 +15,8 @@ struct ScriptGlobals {
 
   EntityDatabase &entityDatabase;
 
+  SpatialIndex &spatialIndex;
+
   PhysicsSystem &physicsSystem;
 
   AssetCache &assetCache;
@@ -522,6 +522,8 @@ void PhysxBackend::synchronizeTransforms(SystemView &view) {
           transform.localPosition = position;
           transform.localRotation = rotation;
         }
+
+        transform.dirty.mark();
       }
     }
   }
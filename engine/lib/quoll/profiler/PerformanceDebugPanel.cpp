@@ -1,5 +1,6 @@
 #include "quoll/core/Base.h"
 #include "quoll/imgui/ImguiUtils.h"
+#include "quoll/scene/SceneUpdater.h"
 #include "FPSCounter.h"
 #include "MetricsCollector.h"
 #include "PerformanceDebugPanel.h"
@@ -20,9 +21,10 @@ void renderTableRow(StringView header, StringView value) {
 
 PerformanceDebugPanel::PerformanceDebugPanel(rhi::RenderDevice *device,
                                              MetricsCollector &metricsCollector,
-                                             const FPSCounter &fpsCounter)
+                                             const FPSCounter &fpsCounter,
+                                             const SceneUpdater *sceneUpdater)
     : mDevice(device), mMetricsCollector(&metricsCollector),
-      mFpsCounter(&fpsCounter) {}
+      mFpsCounter(&fpsCounter), mSceneUpdater(sceneUpdater) {}
 
 void PerformanceDebugPanel::onRenderMenu() {
   ImGui::MenuItem("Performance Metrics", nullptr, &mOpen);
@@ -44,6 +46,12 @@ void PerformanceDebugPanel::onRender() {
       renderTableRow("FPS", std::to_string(fps));
       renderTableRow("Frame time",
                      std::to_string(fps > 0 ? OneSecondInMs / fps : 0) + "ms");
+
+      if (mSceneUpdater) {
+        renderTableRow(
+            "Updated transforms",
+            std::to_string(mSceneUpdater->getNumUpdatedTransforms()));
+      }
       ImGui::EndTable();
     }
 
@@ -12,6 +12,7 @@ namespace quoll {
 
 class FPSCounter;
 class MetricsCollector;
+class SceneUpdater;
 
 } // namespace quoll
 
@@ -21,7 +22,8 @@ class PerformanceDebugPanel : public DebugPanel {
 public:
   PerformanceDebugPanel(rhi::RenderDevice *device,
                         MetricsCollector &metricsCollector,
-                        const FPSCounter &fpsCounter);
+                        const FPSCounter &fpsCounter,
+                        const SceneUpdater *sceneUpdater = nullptr);
 
   void onRenderMenu() override;
 
@@ -31,6 +33,7 @@ private:
   rhi::RenderDevice *mDevice;
   MetricsCollector *mMetricsCollector;
   const FPSCounter *mFpsCounter;
+  const SceneUpdater *mSceneUpdater;
 
   bool mOpen = false;
 };
@@ -57,6 +57,28 @@ void BindlessDrawParameters::build(rhi::RenderDevice *device) {
   }
 }
 
+void BindlessDrawParameters::update() {
+  u8 *data = nullptr;
+  if (rhi::isHandleValid(mBuffer.getHandle())) {
+    data = static_cast<u8 *>(mBuffer.map());
+  }
+
+  for (auto &range : mRanges) {
+    if (!range.generate) {
+      continue;
+    }
+
+    range.generate(range.data);
+    if (data) {
+      memcpy(data + range.offset, range.data, range.size);
+    }
+  }
+
+  if (data) {
+    mBuffer.unmap();
+  }
+}
+
 void BindlessDrawParameters::destroy(rhi::RenderDevice *device) {
   mRanges.clear();
   mLastOffset = 0;
@@ -9,6 +9,7 @@ class BindlessDrawParameters {
     usize offset = 0;
     usize size = 0;
     void *data = nullptr;
+    std::function<void(void *)> generate;
   };
 
 public:
@@ -27,8 +28,39 @@ public:
     return currentOffset;
   }
 
+  /**
+   * @brief Add range that is generated again on update
+   *
+   * Used for parameters that store addresses
+   * of buffers that can be recreated
+   *
+   * @param generate Function that returns range data
+   * @return Range offset
+   */
+  template <class TFunction> usize addDynamicRange(TFunction &&generate) {
+    using TData = std::invoke_result_t<TFunction>;
+
+    usize offset = addRange(generate());
+    mRanges.back().generate = [generate](void *data) {
+      *static_cast<TData *>(data) = generate();
+    };
+    return offset;
+  }
+
+  /**
+   * @brief Generate dynamic ranges again
+   *
+   * Writes generated ranges to the
+   * buffer if parameters are built
+   */
+  void update();
+
   inline const rhi::Descriptor &getDescriptor() const { return mDescriptor; }
 
+  inline rhi::BufferHandle getBufferHandle() const {
+    return mBuffer.getHandle();
+  }
+
   void build(rhi::RenderDevice *device);
 
   void destroy(rhi::RenderDevice *device);
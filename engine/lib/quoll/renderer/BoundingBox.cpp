@@ -0,0 +1,51 @@
+#include "quoll/core/Base.h"
+#include "BoundingBox.h"
+
+namespace quoll {
+
+BoundingBox BoundingBox::fromPoints(std::span<const glm::vec3> points) {
+  if (points.empty()) {
+    return {};
+  }
+
+  BoundingBox bounds{points.front(), points.front()};
+  for (const auto &point : points) {
+    bounds.min = glm::min(bounds.min, point);
+    bounds.max = glm::max(bounds.max, point);
+  }
+
+  return bounds;
+}
+
+BoundingBox BoundingBox::merge(const BoundingBox &other) const {
+  return {glm::min(min, other.min), glm::max(max, other.max)};
+}
+
+BoundingBox BoundingBox::transform(const glm::mat4 &transform) const {
+  const glm::vec3 localCenter = (min + max) * 0.5f;
+  const glm::vec3 localExtent = (max - min) * 0.5f;
+
+  const glm::vec3 center = glm::vec3(transform * glm::vec4(localCenter, 1.0f));
+  const glm::vec3 extent = glm::abs(glm::vec3(transform[0])) * localExtent.x +
+                           glm::abs(glm::vec3(transform[1])) * localExtent.y +
+                           glm::abs(glm::vec3(transform[2])) * localExtent.z;
+
+  return {center - extent, center + extent};
+}
+
+bool BoundingBox::contains(const BoundingBox &other) const {
+  return glm::all(glm::lessThanEqual(min, other.min)) &&
+         glm::all(glm::greaterThanEqual(max, other.max));
+}
+
+bool BoundingBox::overlaps(const BoundingBox &other) const {
+  return glm::all(glm::lessThanEqual(min, other.max)) &&
+         glm::all(glm::greaterThanEqual(max, other.min));
+}
+
+f32 BoundingBox::getSurfaceArea() const {
+  const glm::vec3 size = max - min;
+  return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+} // namespace quoll
@@ -0,0 +1,63 @@
+#pragma once
+
+namespace quoll {
+
+/**
+ * @brief Axis aligned bounding box
+ */
+struct BoundingBox {
+  glm::vec3 min{0.0f};
+
+  glm::vec3 max{0.0f};
+
+  /**
+   * @brief Create bounding box that encloses points
+   *
+   * @param points Points
+   * @return Bounding box of points
+   */
+  static BoundingBox fromPoints(std::span<const glm::vec3> points);
+
+  /**
+   * @brief Get box that encloses both boxes
+   *
+   * @param other Other bounding box
+   * @return Bounding box of both boxes
+   */
+  BoundingBox merge(const BoundingBox &other) const;
+
+  /**
+   * @brief Get box that encloses transformed box
+   *
+   * @param transform Affine transform
+   * @return Axis aligned bounding box of transformed box
+   */
+  BoundingBox transform(const glm::mat4 &transform) const;
+
+  /**
+   * @brief Check if box encloses other box
+   *
+   * @param other Other bounding box
+   * @retval true Other box is inside this box
+   * @retval false Other box is not inside this box
+   */
+  bool contains(const BoundingBox &other) const;
+
+  /**
+   * @brief Check if boxes overlap
+   *
+   * @param other Other bounding box
+   * @retval true Boxes overlap
+   * @retval false Boxes do not overlap
+   */
+  bool overlaps(const BoundingBox &other) const;
+
+  /**
+   * @brief Get surface area
+   *
+   * @return Surface area
+   */
+  f32 getSurfaceArea() const;
+};
+
+} // namespace quoll
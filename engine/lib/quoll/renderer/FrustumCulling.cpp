@@ -0,0 +1,200 @@
+#include "quoll/core/Base.h"
+#include "FrustumCulling.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define QUOLL_FRUSTUM_CULLING_SSE
+#include <immintrin.h>
+#endif
+
+namespace quoll {
+
+namespace {
+
+/**
+ * @brief Get center and half extents of transformed box
+ *
+ * @param bounds Bounding box
+ * @param transform Affine transform
+ * @param center Output center
+ * @param extent Output half extents
+ */
+void transformBox(const BoundingBox &bounds, const glm::mat4 &transform,
+                  glm::vec3 &center, glm::vec3 &extent) {
+  const glm::vec3 localCenter = (bounds.min + bounds.max) * 0.5f;
+  const glm::vec3 localExtent = (bounds.max - bounds.min) * 0.5f;
+
+  center = glm::vec3(transform * glm::vec4(localCenter, 1.0f));
+  extent = glm::abs(glm::vec3(transform[0])) * localExtent.x +
+           glm::abs(glm::vec3(transform[1])) * localExtent.y +
+           glm::abs(glm::vec3(transform[2])) * localExtent.z;
+}
+
+void cullScalar(const CullingBounds &bounds, const Frustum &frustum, u32 bit,
+                std::span<u32> visibility, usize start) {
+  for (usize i = start; i < bounds.size(); ++i) {
+    bool inside = true;
+    for (const auto &plane : frustum.planes) {
+      const f32 distance = plane.x * bounds.centerX[i] +
+                           plane.y * bounds.centerY[i] +
+                           plane.z * bounds.centerZ[i] + plane.w;
+      const f32 radius = std::abs(plane.x) * bounds.extentX[i] +
+                         std::abs(plane.y) * bounds.extentY[i] +
+                         std::abs(plane.z) * bounds.extentZ[i];
+
+      if (distance + radius < 0.0f) {
+        inside = false;
+        break;
+      }
+    }
+
+    if (inside) {
+      visibility[i] |= bit;
+    }
+  }
+}
+
+#ifdef QUOLL_FRUSTUM_CULLING_SSE
+
+usize cullSSE(const CullingBounds &bounds, const Frustum &frustum, u32 bit,
+              std::span<u32> visibility) {
+  static constexpr usize Width = 4;
+  const usize batchedCount = (bounds.size() / Width) * Width;
+
+  const __m128 signMask = _mm_set1_ps(-0.0f);
+  const __m128 zero = _mm_setzero_ps();
+
+  for (usize i = 0; i < batchedCount; i += Width) {
+    const __m128 cx = _mm_loadu_ps(&bounds.centerX[i]);
+    const __m128 cy = _mm_loadu_ps(&bounds.centerY[i]);
+    const __m128 cz = _mm_loadu_ps(&bounds.centerZ[i]);
+    const __m128 ex = _mm_loadu_ps(&bounds.extentX[i]);
+    const __m128 ey = _mm_loadu_ps(&bounds.extentY[i]);
+    const __m128 ez = _mm_loadu_ps(&bounds.extentZ[i]);
+
+    int outside = 0;
+    for (const auto &plane : frustum.planes) {
+      const __m128 nx = _mm_set1_ps(plane.x);
+      const __m128 ny = _mm_set1_ps(plane.y);
+      const __m128 nz = _mm_set1_ps(plane.z);
+
+      __m128 distance = _mm_add_ps(_mm_mul_ps(nx, cx), _mm_mul_ps(ny, cy));
+      distance = _mm_add_ps(distance, _mm_mul_ps(nz, cz));
+      distance = _mm_add_ps(distance, _mm_set1_ps(plane.w));
+
+      __m128 radius = _mm_add_ps(_mm_mul_ps(_mm_andnot_ps(signMask, nx), ex),
+                                 _mm_mul_ps(_mm_andnot_ps(signMask, ny), ey));
+      radius = _mm_add_ps(radius, _mm_mul_ps(_mm_andnot_ps(signMask, nz), ez));
+
+      outside |=
+          _mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(distance, radius), zero));
+
+      // All boxes in the batch are outside
+      if (outside == 0xF) {
+        break;
+      }
+    }
+
+    for (usize j = 0; j < Width; ++j) {
+      if ((outside & (1 << j)) == 0) {
+        visibility[i + j] |= bit;
+      }
+    }
+  }
+
+  return batchedCount;
+}
+
+#endif
+
+} // namespace
+
+Frustum Frustum::fromMatrix(const glm::mat4 &projectionView) {
+  auto row = [&projectionView](glm::length_t index) {
+    return glm::vec4(projectionView[0][index], projectionView[1][index],
+                     projectionView[2][index], projectionView[3][index]);
+  };
+
+  // Depth range is [0, 1]; so, near plane
+  // is the third row of the matrix
+  Frustum frustum{{row(3) + row(0), row(3) - row(0), row(3) + row(1),
+                   row(3) - row(1), row(2), row(3) - row(2)}};
+
+  for (auto &plane : frustum.planes) {
+    const f32 length = glm::length(glm::vec3(plane));
+    if (length > 0.0f) {
+      plane /= length;
+    }
+  }
+
+  return frustum;
+}
+
+void CullingBounds::add(const BoundingBox &bounds,
+                        const glm::mat4 &transform) {
+  glm::vec3 center{0.0f};
+  glm::vec3 extent{0.0f};
+  transformBox(bounds, transform, center, extent);
+
+  centerX.push_back(center.x);
+  centerY.push_back(center.y);
+  centerZ.push_back(center.z);
+  extentX.push_back(extent.x);
+  extentY.push_back(extent.y);
+  extentZ.push_back(extent.z);
+}
+
+void CullingBounds::add(const BoundingBox &bounds,
+                        std::span<const glm::mat4> joints,
+                        const glm::mat4 &transform) {
+  if (joints.empty()) {
+    add(bounds, transform);
+    return;
+  }
+
+  BoundingBox skinned{glm::vec3(std::numeric_limits<f32>::max()),
+                      glm::vec3(std::numeric_limits<f32>::lowest())};
+
+  for (const auto &joint : joints) {
+    glm::vec3 center{0.0f};
+    glm::vec3 extent{0.0f};
+    transformBox(bounds, joint, center, extent);
+
+    skinned.min = glm::min(skinned.min, center - extent);
+    skinned.max = glm::max(skinned.max, center + extent);
+  }
+
+  add(skinned, transform);
+}
+
+void CullingBounds::clear() {
+  centerX.clear();
+  centerY.clear();
+  centerZ.clear();
+  extentX.clear();
+  extentY.clear();
+  extentZ.clear();
+}
+
+void FrustumCulling::cull(const CullingBounds &bounds,
+                          std::span<const Frustum> frustums,
+                          std::span<u32> visibility) {
+  QuollAssert(frustums.size() <= MaxFrustums, "Too many frustums");
+  QuollAssert(visibility.size() == bounds.size(),
+              "Visibility size must match number of bounding boxes");
+
+  std::fill(visibility.begin(), visibility.end(), 0);
+
+  for (usize f = 0; f < frustums.size(); ++f) {
+    const u32 bit = 1u << f;
+
+#ifdef QUOLL_FRUSTUM_CULLING_SSE
+    const usize start = cullSSE(bounds, frustums[f], bit, visibility);
+#else
+    const usize start = 0;
+#endif
+
+    cullScalar(bounds, frustums[f], bit, visibility, start);
+  }
+}
+
+} // namespace quoll
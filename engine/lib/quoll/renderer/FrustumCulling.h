@@ -0,0 +1,126 @@
+#pragma once
+
+#include "BoundingBox.h"
+
+namespace quoll {
+
+/**
+ * @brief View frustum
+ *
+ * Planes point inside the frustum.
+ */
+struct Frustum {
+  /**
+   * Planes
+   *
+   * First three values are plane normal
+   * Last value is plane distance
+   */
+  std::array<glm::vec4, 6> planes{};
+
+  /**
+   * @brief Create frustum from projection view matrix
+   *
+   * @param projectionView Projection view matrix
+   * @return Frustum
+   */
+  static Frustum fromMatrix(const glm::mat4 &projectionView);
+};
+
+/**
+ * @brief Bounding boxes of cullable objects
+ *
+ * Boxes are stored as centers and half extents
+ * in world space. Every component is stored in
+ * a separate array, so that boxes are tested
+ * against frustum planes in batches.
+ */
+struct CullingBounds {
+  std::vector<f32> centerX;
+
+  std::vector<f32> centerY;
+
+  std::vector<f32> centerZ;
+
+  std::vector<f32> extentX;
+
+  std::vector<f32> extentY;
+
+  std::vector<f32> extentZ;
+
+  /**
+   * @brief Add bounding box
+   *
+   * @param bounds Local bounding box
+   * @param transform Local to world transform
+   */
+  void add(const BoundingBox &bounds, const glm::mat4 &transform);
+
+  /**
+   * @brief Add bounding box of skinned geometry
+   *
+   * Every joint transform moves the box and the
+   * result encloses all of them; so, vertices
+   * that are influenced by any joints are always
+   * inside of the resulting box.
+   *
+   * @param bounds Bounding box in bind pose
+   * @param joints Joint transforms
+   * @param transform Local to world transform
+   */
+  void add(const BoundingBox &bounds, std::span<const glm::mat4> joints,
+           const glm::mat4 &transform);
+
+  /**
+   * @brief Get number of bounding boxes
+   *
+   * @return Number of bounding boxes
+   */
+  inline usize size() const { return centerX.size(); }
+
+  /**
+   * @brief Remove all bounding boxes
+   */
+  void clear();
+};
+
+/**
+ * @brief Culling statistics of a frame
+ */
+struct FrustumCullingStats {
+  u32 visibleInstances = 0;
+
+  u32 culledInstances = 0;
+
+  u32 visibleGeometries = 0;
+
+  u32 culledGeometries = 0;
+};
+
+/**
+ * @brief Frustum culling
+ *
+ * Tests four bounding boxes at once
+ * with SSE when it is available.
+ */
+class FrustumCulling {
+public:
+  static constexpr usize MaxFrustums = 32;
+
+public:
+  /**
+   * @brief Test bounding boxes against frustums
+   *
+   * Sets bit N of box visibility if the box
+   * intersects or is inside frustum N.
+   *
+   * @param bounds Bounding boxes
+   * @param frustums Frustums
+   * @param visibility Output visibility of every box
+   */
+  static void cull(const CullingBounds &bounds,
+                   std::span<const Frustum> frustums,
+                   std::span<u32> visibility);
+};
+
+} // namespace quoll
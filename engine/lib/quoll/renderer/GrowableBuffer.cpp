@@ -0,0 +1,61 @@
+#include "quoll/core/Base.h"
+#include "quoll/core/Profiler.h"
+#include "GrowableBuffer.h"
+#include "RenderStorage.h"
+
+namespace quoll {
+
+GrowableBuffer::GrowableBuffer(RenderStorage &renderStorage,
+                               const rhi::BufferDescription &description,
+                               usize itemSize, usize initialCapacity,
+                               bool shrink)
+    : mRenderStorage(&renderStorage), mDescription(description),
+      mItemSize(itemSize),
+      mInitialCapacity(std::max<usize>(initialCapacity, 1)),
+      mCapacity(mInitialCapacity), mShrink(shrink) {
+  mDescription.size = mCapacity * mItemSize;
+  mBuffer = mRenderStorage->createBuffer(mDescription);
+}
+
+bool GrowableBuffer::reserve(usize numItems) {
+  if (numItems > mCapacity) {
+    recreate(std::max(numItems, mCapacity * 2));
+    return true;
+  }
+
+  if (mShrink && mCapacity > mInitialCapacity &&
+      numItems * ShrinkRatio < mCapacity) {
+    recreate(std::max(numItems * 2, mInitialCapacity));
+    return true;
+  }
+
+  return false;
+}
+
+void GrowableBuffer::collectGarbage() {
+  for (auto handle : mRetired) {
+    mRenderStorage->destroyBuffer(handle);
+  }
+  mRetired.clear();
+}
+
+void GrowableBuffer::recreate(usize capacity) {
+  QUOLL_PROFILE_EVENT("GrowableBuffer::recreate");
+
+  auto description = mDescription;
+  description.size = capacity * mItemSize;
+  auto buffer = mRenderStorage->createBuffer(description);
+
+  // Instances are uploaded sparsely; so,
+  // existing contents must be kept
+  const usize size = std::min(capacity, mCapacity) * mItemSize;
+  memcpy(buffer.map(), mBuffer.map(), size);
+  buffer.unmap();
+  mBuffer.unmap();
+
+  mRetired.push_back(mBuffer.getHandle());
+  mBuffer = buffer;
+  mCapacity = capacity;
+}
+
+} // namespace quoll
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "quoll/rhi/Buffer.h"
+#include "quoll/rhi/BufferDescription.h"
+
+namespace quoll {
+
+class RenderStorage;
+
+/**
+ * @brief Buffer that grows with its contents
+ *
+ * Capacity is doubled when more items are
+ * reserved and, if shrinking is enabled, halved
+ * when less than a quarter of it is used.
+ *
+ * Buffer is recreated with a new handle and
+ * device address when capacity changes. Existing
+ * contents are copied to the new buffer and the
+ * old buffer is kept until the next garbage
+ * collection; so, frames that are still using
+ * the old buffer can finish.
+ */
+class GrowableBuffer {
+  /**
+   * Shrink when less than 1 / ShrinkRatio
+   * of capacity is used
+   */
+  static constexpr usize ShrinkRatio = 4;
+
+public:
+  GrowableBuffer() = default;
+
+  /**
+   * @brief Create growable buffer
+   *
+   * @param renderStorage Render storage
+   * @param description Buffer description without size
+   * @param itemSize Size of a single item
+   * @param initialCapacity Initial number of items
+   * @param shrink Shrink buffer when most of it is unused
+   */
+  GrowableBuffer(RenderStorage &renderStorage,
+                 const rhi::BufferDescription &description, usize itemSize,
+                 usize initialCapacity, bool shrink = true);
+
+  /**
+   * @brief Reserve space for items
+   *
+   * Recreates buffer when capacity is changed
+   *
+   * @param numItems Number of items
+   * @retval true Buffer is recreated
+   * @retval false Buffer is not changed
+   */
+  bool reserve(usize numItems);
+
+  /**
+   * @brief Destroy buffers that are replaced
+   *
+   * Buffers that are replaced since the previous
+   * collection are destroyed. Owners collect garbage
+   * once per frame after the frame is started; so,
+   * frames that used replaced buffers have finished.
+   */
+  void collectGarbage();
+
+  /**
+   * @brief Map buffer
+   *
+   * @return Mapped data
+   */
+  inline void *map() { return mBuffer.map(); }
+
+  /**
+   * @brief Unmap buffer
+   */
+  inline void unmap() { mBuffer.unmap(); }
+
+  /**
+   * @brief Update buffer contents
+   *
+   * @param data Data
+   * @param size Data size
+   */
+  inline void update(const void *data, usize size) {
+    mBuffer.update(data, size);
+  }
+
+  /**
+   * @brief Get device address
+   *
+   * @return Device address of current buffer
+   */
+  inline rhi::DeviceAddress getAddress() const { return mBuffer.getAddress(); }
+
+  /**
+   * @brief Get buffer handle
+   *
+   * @return Handle of current buffer
+   */
+  inline rhi::BufferHandle getHandle() const { return mBuffer.getHandle(); }
+
+  /**
+   * @brief Get capacity
+   *
+   * @return Number of items that fit in buffer
+   */
+  inline usize getCapacity() const { return mCapacity; }
+
+  /**
+   * @brief Get number of buffers waiting to be destroyed
+   *
+   * @return Number of replaced buffers
+   */
+  inline usize getNumRetired() const { return mRetired.size(); }
+
+private:
+  void recreate(usize capacity);
+
+private:
+  RenderStorage *mRenderStorage = nullptr;
+  rhi::BufferDescription mDescription;
+  usize mItemSize = 0;
+  usize mInitialCapacity = 0;
+  usize mCapacity = 0;
+  bool mShrink = true;
+
+  rhi::Buffer mBuffer;
+  std::vector<rhi::BufferHandle> mRetired;
+};
+
+} // namespace quoll
@@ -0,0 +1,163 @@
+#include "quoll/core/Base.h"
+#include "quoll/core/Profiler.h"
+#include "JointPalette.h"
+
+namespace quoll {
+
+void JointPalette::begin() { mFrame++; }
+
+JointRange JointPalette::set(Entity skeleton,
+                             std::span<const glm::mat4> joints) {
+  auto *palette = getPalette(skeleton);
+  const auto count = static_cast<u32>(joints.size());
+
+  // Skeleton is already set by another mesh
+  if (palette->exists && palette->updatedFrame == mFrame &&
+      palette->range.count == count) {
+    return palette->range;
+  }
+
+  if (!palette->exists) {
+    palette->exists = true;
+    palette->range = allocate(count);
+    mSkeletons.push_back(skeleton);
+  } else if (palette->range.count != count) {
+    free(palette->range);
+    palette->range = allocate(count);
+  } else if (std::equal(joints.begin(), joints.end(),
+                        mJoints.begin() + palette->range.offset)) {
+    palette->frame = mFrame;
+    palette->updatedFrame = mFrame;
+    return palette->range;
+  }
+
+  palette->frame = mFrame;
+  palette->updatedFrame = mFrame;
+  std::copy(joints.begin(), joints.end(),
+            mJoints.begin() + palette->range.offset);
+  mChangedRanges.push_back(palette->range);
+
+  return palette->range;
+}
+
+bool JointPalette::keep(Entity skeleton) {
+  if (!contains(skeleton)) {
+    return false;
+  }
+
+  mPalettes.at(getEntityIndex(skeleton)).frame = mFrame;
+  return true;
+}
+
+void JointPalette::end() {
+  QUOLL_PROFILE_EVENT("JointPalette::end");
+
+  usize i = 0;
+  while (i < mSkeletons.size()) {
+    auto &palette = mPalettes.at(getEntityIndex(mSkeletons.at(i)));
+    if (palette.frame != mFrame) {
+      free(palette.range);
+      palette = {};
+
+      mSkeletons.at(i) = mSkeletons.back();
+      mSkeletons.pop_back();
+    } else {
+      ++i;
+    }
+  }
+}
+
+usize JointPalette::upload(glm::mat4 *target) {
+  QUOLL_PROFILE_EVENT("JointPalette::upload");
+
+  usize bytes = 0;
+  for (const auto &range : mChangedRanges) {
+    // Ranges that are freed at the end
+    // of the palette no longer exist
+    if (range.offset + range.count > mJoints.size()) {
+      continue;
+    }
+
+    const usize size = range.count * sizeof(glm::mat4);
+    memcpy(target + range.offset, mJoints.data() + range.offset, size);
+    bytes += size;
+  }
+
+  mChangedRanges.clear();
+  return bytes;
+}
+
+bool JointPalette::contains(Entity skeleton) const {
+  const auto index = getEntityIndex(skeleton);
+  return index < mPalettes.size() && mPalettes.at(index).exists;
+}
+
+JointRange JointPalette::getRange(Entity skeleton) const {
+  QuollAssert(contains(skeleton), "Skeleton does not exist in joint palette");
+  return mPalettes.at(getEntityIndex(skeleton)).range;
+}
+
+JointRange JointPalette::allocate(u32 count) {
+  for (auto it = mFreeRanges.begin(); it != mFreeRanges.end(); ++it) {
+    if (it->count < count) {
+      continue;
+    }
+
+    JointRange range{it->offset, count};
+    it->offset += count;
+    it->count -= count;
+    if (it->count == 0) {
+      mFreeRanges.erase(it);
+    }
+
+    return range;
+  }
+
+  JointRange range{static_cast<u32>(mJoints.size()), count};
+  mJoints.resize(mJoints.size() + count, glm::mat4{1.0f});
+  return range;
+}
+
+void JointPalette::free(const JointRange &range) {
+  if (range.count == 0) {
+    return;
+  }
+
+  auto it = std::lower_bound(mFreeRanges.begin(), mFreeRanges.end(), range,
+                             [](const JointRange &a, const JointRange &b) {
+                               return a.offset < b.offset;
+                             });
+  it = mFreeRanges.insert(it, range);
+
+  // Merge with adjacent free ranges
+  auto next = std::next(it);
+  if (next != mFreeRanges.end() && it->offset + it->count == next->offset) {
+    it->count += next->count;
+    mFreeRanges.erase(next);
+  }
+
+  if (it != mFreeRanges.begin()) {
+    auto prev = std::prev(it);
+    if (prev->offset + prev->count == it->offset) {
+      prev->count += it->count;
+      it = std::prev(mFreeRanges.erase(it));
+    }
+  }
+
+  // Free range at the end shrinks the palette
+  if (it->offset + it->count == mJoints.size()) {
+    mJoints.resize(it->offset);
+    mFreeRanges.erase(it);
+  }
+}
+
+JointPalette::Palette *JointPalette::getPalette(Entity skeleton) {
+  const auto index = getEntityIndex(skeleton);
+  if (index >= mPalettes.size()) {
+    mPalettes.resize((index + 1) * 2);
+  }
+
+  return &mPalettes.at(index);
+}
+
+} // namespace quoll
@@ -0,0 +1,160 @@
+#pragma once
+
+#include "quoll/entity/Entity.h"
+
+namespace quoll {
+
+/**
+ * @brief Range of skeleton joints in joint palette
+ */
+struct JointRange {
+  u32 offset = 0;
+
+  u32 count = 0;
+
+  bool operator==(const JointRange &) const = default;
+};
+
+/**
+ * @brief Packed joint palette of skeletons
+ *
+ * Joints of every skeleton are stored once in a
+ * contiguous range of the palette and all meshes
+ * that are skinned to the skeleton point to this
+ * range. Ranges are allocated with the exact number
+ * of joints and skeletons keep their ranges between
+ * frames; so, only changed joints are uploaded.
+ *
+ * Palettes are updated every frame between `begin`
+ * and `end`. Skeletons that are not set or kept
+ * during the update are removed in `end`.
+ */
+class JointPalette {
+public:
+  /**
+   * @brief Begin updating skeletons
+   */
+  void begin();
+
+  /**
+   * @brief Set joints of skeleton
+   *
+   * Adds skeleton if it does not exist. Joints
+   * are copied only once per frame; so, meshes
+   * that share a skeleton share its range.
+   *
+   * @param skeleton Skeleton entity
+   * @param joints Joint transforms
+   * @return Joint range of skeleton
+   */
+  JointRange set(Entity skeleton, std::span<const glm::mat4> joints);
+
+  /**
+   * @brief Keep skeleton without changing joints
+   *
+   * @param skeleton Skeleton entity
+   * @retval true Skeleton is kept
+   * @retval false Skeleton does not exist
+   */
+  bool keep(Entity skeleton);
+
+  /**
+   * @brief End updating skeletons
+   *
+   * Removes skeletons that are not set
+   * or kept since `begin` and frees
+   * their ranges for new skeletons
+   */
+  void end();
+
+  /**
+   * @brief Upload changed joints
+   *
+   * @param target Mapped joint palette buffer
+   * @return Number of uploaded bytes
+   */
+  usize upload(glm::mat4 *target);
+
+  /**
+   * @brief Check if skeleton exists
+   *
+   * @param skeleton Skeleton entity
+   * @retval true Skeleton exists
+   * @retval false Skeleton does not exist
+   */
+  bool contains(Entity skeleton) const;
+
+  /**
+   * @brief Get joint range of skeleton
+   *
+   * @param skeleton Skeleton entity
+   * @return Joint range
+   */
+  JointRange getRange(Entity skeleton) const;
+
+  /**
+   * @brief Get number of skeletons
+   *
+   * @return Number of skeletons
+   */
+  inline usize size() const { return mSkeletons.size(); }
+
+  /**
+   * @brief Get number of joints in palette
+   *
+   * Includes joints of freed ranges that
+   * are not at the end of the palette
+   *
+   * @return Number of joints
+   */
+  inline usize getCapacity() const { return mJoints.size(); }
+
+  /**
+   * @brief Get all joints
+   *
+   * @return Joint transforms
+   */
+  inline const std::vector<glm::mat4> &getJoints() const { return mJoints; }
+
+private:
+  /**
+   * Palette of skeleton entity
+   */
+  struct Palette {
+    JointRange range;
+
+    /**
+     * Last frame that skeleton is set or kept
+     */
+    u32 frame = 0;
+
+    /**
+     * Last frame that joints are set
+     */
+    u32 updatedFrame = 0;
+
+    bool exists = false;
+  };
+
+  JointRange allocate(u32 count);
+
+  void free(const JointRange &range);
+
+  Palette *getPalette(Entity skeleton);
+
+private:
+  u32 mFrame = 0;
+
+  std::vector<Palette> mPalettes;
+  std::vector<Entity> mSkeletons;
+
+  std::vector<glm::mat4> mJoints;
+
+  /**
+   * Free ranges sorted by offset
+   */
+  std::vector<JointRange> mFreeRanges;
+  std::vector<JointRange> mChangedRanges;
+};
+
+} // namespace quoll
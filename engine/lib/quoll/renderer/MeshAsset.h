@@ -1,6 +1,8 @@
 #pragma once
 
 #include "quoll/rhi/RenderHandle.h"
+#include "BoundingBox.h"
+#include "MeshVertexLayout.h"
 
 namespace quoll {
 
@@ -20,10 +22,20 @@ struct BaseGeometryAsset {
   std::vector<glm::vec4> weights;
 
   std::vector<u32> indices;
+
+  /**
+   * Bounds of vertex positions
+   */
+  BoundingBox bounds;
 };
 
 struct MeshAsset {
   std::vector<BaseGeometryAsset> geometries;
+
+  /**
+   * Vertex layout of draw data
+   */
+  MeshVertexLayout vertexLayout;
 };
 
 } // namespace quoll
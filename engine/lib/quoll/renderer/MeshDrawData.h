@@ -1,12 +1,16 @@
 #pragma once
 
 #include "quoll/rhi/RenderHandle.h"
+#include "BoundingBox.h"
+#include "MeshVertexLayout.h"
 
 namespace quoll {
 
 struct MeshGeometryInfo {
   u32 numVertices = 0;
   u32 numIndices = 0;
+
+  BoundingBox bounds;
 };
 
 struct MeshDrawData {
@@ -14,6 +18,8 @@ struct MeshDrawData {
   std::vector<u64> vertexBufferOffsets;
   rhi::BufferHandle indexBuffer = rhi::BufferHandle::Null;
 
+  MeshVertexLayout vertexLayout;
+
   std::vector<MeshGeometryInfo> geometries;
 };
 
@@ -0,0 +1,457 @@
+#include "quoll/core/Base.h"
+#include "quoll/core/Profiler.h"
+#include "MeshInstanceTable.h"
+
+namespace quoll {
+
+namespace {
+
+/**
+ * Groups get twice the number of
+ * required slots when they are laid out;
+ * so, adding instances rarely moves groups
+ */
+static constexpr u32 GroupGrowthFactor = 2;
+
+static constexpr u32 MinGroupCapacity = 4;
+
+/**
+ * Slots are compacted when less than
+ * 1 / CompactRatio of them are used
+ */
+static constexpr usize CompactRatio = 4;
+
+} // namespace
+
+void MeshInstanceTable::begin() { mFrame++; }
+
+void MeshInstanceTable::set(Entity entity, AssetHandle<MeshAsset> handle,
+                            const MeshDrawData &drawData,
+                            const glm::mat4 &transform,
+                            std::span<const rhi::DeviceAddress> materials,
+                            const JointRange &joints,
+                            std::span<const u32> visibility) {
+  QuollAssert(visibility.size() == drawData.geometries.size(),
+              "Visibility must be set for every geometry");
+  const usize numGeometries = drawData.geometries.size();
+  const u32 numMaterials = static_cast<u32>(materials.size());
+
+  auto *location = getLocation(entity);
+  if (location->handle && location->handle != handle) {
+    removeInstance(findGroup(location->handle), location->index);
+  }
+
+  u8 changed = 0;
+  usize groupIndex = findGroup(handle);
+  if (groupIndex == mGroups.size() || mGroups.at(groupIndex).handle != handle) {
+    groupIndex = insertGroup(handle);
+  }
+
+  const auto size = static_cast<u32>(mGroups.at(groupIndex).entities.size());
+  if (!location->handle) {
+    reserve(groupIndex, size + 1, numMaterials);
+    auto &group = mGroups.at(groupIndex);
+
+    location->handle = handle;
+    location->index = static_cast<u32>(group.entities.size());
+    group.entities.push_back(entity);
+    group.visibility.resize(group.visibility.size() + numGeometries, 0);
+    mNumInstances++;
+    changed = ChangedAll;
+  } else {
+    reserve(groupIndex, size, numMaterials);
+  }
+
+  auto &group = mGroups.at(groupIndex);
+  group.drawData = &drawData;
+
+  // Geometries of mesh are changed
+  if (group.visibility.size() != group.entities.size() * numGeometries) {
+    group.visibility.assign(group.entities.size() * numGeometries, 0);
+  }
+
+  const u32 index = location->index;
+  const u32 slot = group.firstSlot + index;
+  location->frame = mFrame;
+
+  std::copy(visibility.begin(), visibility.end(),
+            group.visibility.begin() + index * numGeometries);
+
+  if ((changed & ChangedTransform) != 0 || mTransforms.at(slot) != transform) {
+    mTransforms.at(slot) = transform;
+    changed |= ChangedTransform;
+  }
+
+  {
+    const auto current = std::span(mMaterials).subspan(
+        group.firstMaterial + index * group.materialStride, numMaterials);
+    const bool sameMaterials =
+        mMaterialCounts.at(slot) == numMaterials &&
+        std::equal(materials.begin(), materials.end(), current.begin());
+
+    if ((changed & ChangedMaterials) != 0 || !sameMaterials) {
+      setMaterials(group, index, materials);
+      changed |= ChangedMaterials;
+    }
+  }
+
+  if ((changed & ChangedJoints) != 0 || mJointRanges.at(slot) != joints) {
+    mJointRanges.at(slot) = joints;
+    changed |= ChangedJoints;
+  }
+
+  if (changed != 0) {
+    markChanged(slot, changed);
+  }
+}
+
+bool MeshInstanceTable::keep(Entity entity) {
+  auto *location = getLocation(entity);
+  if (!location->handle) {
+    return false;
+  }
+
+  location->frame = mFrame;
+
+  auto &group = mGroups.at(findGroup(location->handle));
+  const usize numGeometries = group.drawData->geometries.size();
+  std::fill_n(group.visibility.begin() + location->index * numGeometries,
+              numGeometries, 0);
+
+  return true;
+}
+
+void MeshInstanceTable::end() {
+  QUOLL_PROFILE_EVENT("MeshInstanceTable::end");
+
+  for (usize g = 0; g < mGroups.size(); ++g) {
+    auto &group = mGroups.at(g);
+
+    usize i = 0;
+    while (i < group.entities.size()) {
+      const auto &location =
+          mLocations.at(getEntityIndex(group.entities.at(i)));
+      if (location.frame != mFrame) {
+        removeInstance(g, static_cast<u32>(i));
+      } else {
+        ++i;
+      }
+    }
+  }
+
+  // Empty groups are removed because their
+  // draw data might be destroyed. Their slots
+  // are reclaimed when groups are laid out again
+  std::erase_if(mGroups,
+                [](const Group &group) { return group.entities.empty(); });
+
+  // Groups are laid out again when most slots are
+  // unused; so, instance buffers can shrink as well
+  if (mNumInstances * CompactRatio < getCapacity()) {
+    relayout(mGroups.size(), 0, 0);
+  }
+}
+
+usize MeshInstanceTable::upload(const UploadTarget &target) {
+  QUOLL_PROFILE_EVENT("MeshInstanceTable::upload");
+  if (mChangedSlots.empty()) {
+    return 0;
+  }
+
+  std::sort(mChangedSlots.begin(), mChangedSlots.end());
+
+  usize bytes = 0;
+  usize groupIndex = 0;
+  usize i = 0;
+  while (i < mChangedSlots.size()) {
+    const u32 first = mChangedSlots.at(i);
+    const u8 changed = mChangedFlags.at(first);
+
+    // Slots of removed groups are not uploaded
+    while (groupIndex < mGroups.size() &&
+           mGroups.at(groupIndex).firstSlot + mGroups.at(groupIndex).capacity <=
+               first) {
+      groupIndex++;
+    }
+
+    if (groupIndex == mGroups.size() ||
+        mGroups.at(groupIndex).firstSlot > first) {
+      mChangedFlags.at(first) = 0;
+      i++;
+      continue;
+    }
+
+    const auto &group = mGroups.at(groupIndex);
+    const u32 groupEnd = group.firstSlot + group.capacity;
+
+    // Consecutive slots with the same
+    // changes are uploaded together
+    u32 count = 1;
+    while (i + count < mChangedSlots.size() &&
+           mChangedSlots.at(i + count) == first + count &&
+           first + count < groupEnd &&
+           mChangedFlags.at(first + count) == changed) {
+      count++;
+    }
+
+    if ((changed & ChangedTransform) != 0) {
+      const usize size = count * sizeof(glm::mat4);
+      memcpy(target.transforms + first, mTransforms.data() + first, size);
+      bytes += size;
+    }
+
+    if ((changed & ChangedMaterials) != 0) {
+      const usize rangesSize = count * sizeof(MaterialRange);
+      memcpy(target.materialRanges + first, mMaterialRanges.data() + first,
+             rangesSize);
+
+      const usize materialStart =
+          group.firstMaterial +
+          static_cast<usize>(first - group.firstSlot) * group.materialStride;
+      const usize materialsSize =
+          static_cast<usize>(count) * group.materialStride *
+          sizeof(rhi::DeviceAddress);
+      memcpy(target.materials + materialStart,
+             mMaterials.data() + materialStart, materialsSize);
+      bytes += rangesSize + materialsSize;
+    }
+
+    if ((changed & ChangedJoints) != 0 && target.jointRanges) {
+      const usize size = count * sizeof(JointRange);
+      memcpy(target.jointRanges + first, mJointRanges.data() + first, size);
+      bytes += size;
+    }
+
+    for (u32 slot = first; slot < first + count; ++slot) {
+      mChangedFlags.at(slot) = 0;
+    }
+    i += count;
+  }
+
+  mChangedSlots.clear();
+  return bytes;
+}
+
+void MeshInstanceTable::setMaterialBase(u32 base) {
+  if (mMaterialBase == base) {
+    return;
+  }
+
+  mMaterialBase = base;
+  for (const auto &group : mGroups) {
+    for (u32 i = 0; i < static_cast<u32>(group.entities.size()); ++i) {
+      const u32 slot = group.firstSlot + i;
+      const u32 count = mMaterialCounts.at(slot);
+      if (count > 0) {
+        const u32 start = mMaterialBase + group.firstMaterial +
+                          i * group.materialStride;
+        mMaterialRanges.at(slot) = {start, start + count - 1};
+        markChanged(slot, ChangedMaterials);
+      }
+    }
+  }
+}
+
+bool MeshInstanceTable::contains(Entity entity) const {
+  const auto index = getEntityIndex(entity);
+  return index < mLocations.size() && mLocations.at(index).handle;
+}
+
+u32 MeshInstanceTable::getSlot(Entity entity) const {
+  QuollAssert(contains(entity), "Entity does not exist in instance table");
+
+  const auto &location = mLocations.at(getEntityIndex(entity));
+  return mGroups.at(findGroup(location.handle)).firstSlot + location.index;
+}
+
+usize MeshInstanceTable::findGroup(AssetHandle<MeshAsset> handle) const {
+  auto it = std::lower_bound(mGroups.begin(), mGroups.end(), handle,
+                             [](const Group &group, const auto &handle) {
+                               return group.handle.getRawId() <
+                                      handle.getRawId();
+                             });
+  return static_cast<usize>(std::distance(mGroups.begin(), it));
+}
+
+usize MeshInstanceTable::insertGroup(AssetHandle<MeshAsset> handle) {
+  const usize index = findGroup(handle);
+
+  Group group{};
+  group.handle = handle;
+  mGroups.insert(mGroups.begin() + static_cast<std::ptrdiff_t>(index),
+                 std::move(group));
+  return index;
+}
+
+void MeshInstanceTable::reserve(usize groupIndex, u32 numInstances,
+                                u32 numMaterials) {
+  const auto &group = mGroups.at(groupIndex);
+  if (group.capacity < numInstances || group.materialStride < numMaterials) {
+    relayout(groupIndex, numInstances, numMaterials);
+  }
+}
+
+void MeshInstanceTable::relayout(usize groupIndex, u32 numInstances,
+                                 u32 numMaterials) {
+  QUOLL_PROFILE_EVENT("MeshInstanceTable::relayout");
+
+  std::vector<glm::mat4> transforms;
+  std::vector<MaterialRange> materialRanges;
+  std::vector<u32> materialCounts;
+  std::vector<rhi::DeviceAddress> materials;
+  std::vector<JointRange> jointRanges;
+
+  u32 firstSlot = 0;
+  u32 firstMaterial = 0;
+  for (usize g = 0; g < mGroups.size(); ++g) {
+    auto &group = mGroups.at(g);
+    const u32 size = static_cast<u32>(group.entities.size());
+
+    u32 required = size;
+    u32 stride = group.materialStride;
+    if (g == groupIndex) {
+      required = std::max(required, numInstances);
+      stride = std::max(stride, numMaterials);
+    }
+
+    const u32 capacity =
+        std::max(required * GroupGrowthFactor, MinGroupCapacity);
+
+    transforms.resize(firstSlot + capacity, glm::mat4{1.0f});
+    materialRanges.resize(firstSlot + capacity);
+    materialCounts.resize(firstSlot + capacity, 0);
+    materials.resize(firstMaterial + capacity * stride,
+                     rhi::DeviceAddress::Null);
+    jointRanges.resize(firstSlot + capacity);
+
+    for (u32 i = 0; i < size; ++i) {
+      const u32 oldSlot = group.firstSlot + i;
+      const u32 newSlot = firstSlot + i;
+      const u32 count = mMaterialCounts.at(oldSlot);
+
+      transforms.at(newSlot) = mTransforms.at(oldSlot);
+      materialCounts.at(newSlot) = count;
+
+      const u32 oldMaterial = group.firstMaterial + i * group.materialStride;
+      const u32 newMaterial = firstMaterial + i * stride;
+      std::copy_n(mMaterials.begin() + oldMaterial, count,
+                  materials.begin() + newMaterial);
+      if (count > 0) {
+        materialRanges.at(newSlot) = {mMaterialBase + newMaterial,
+                                      mMaterialBase + newMaterial + count - 1};
+      }
+
+      jointRanges.at(newSlot) = mJointRanges.at(oldSlot);
+    }
+
+    group.firstSlot = firstSlot;
+    group.capacity = capacity;
+    group.firstMaterial = firstMaterial;
+    group.materialStride = stride;
+
+    firstSlot += capacity;
+    firstMaterial += capacity * stride;
+  }
+
+  mTransforms = std::move(transforms);
+  mMaterialRanges = std::move(materialRanges);
+  mMaterialCounts = std::move(materialCounts);
+  mMaterials = std::move(materials);
+  mJointRanges = std::move(jointRanges);
+
+  // Every instance is moved
+  mChangedSlots.clear();
+  mChangedFlags.assign(mTransforms.size(), 0);
+  for (const auto &group : mGroups) {
+    for (u32 i = 0; i < static_cast<u32>(group.entities.size()); ++i) {
+      markChanged(group.firstSlot + i, ChangedAll);
+    }
+  }
+}
+
+void MeshInstanceTable::removeInstance(usize groupIndex, u32 index) {
+  auto &group = mGroups.at(groupIndex);
+  const u32 last = static_cast<u32>(group.entities.size()) - 1;
+  const usize numGeometries =
+      group.entities.empty() ? 0 : group.visibility.size() / (last + 1);
+
+  mLocations.at(getEntityIndex(group.entities.at(index))) = {};
+
+  // Last instance is moved to the removed slot
+  // so that instances of the group stay contiguous
+  if (index != last) {
+    const u32 slot = group.firstSlot + index;
+    const u32 lastSlot = group.firstSlot + last;
+    const auto moved = group.entities.at(last);
+
+    mTransforms.at(slot) = mTransforms.at(lastSlot);
+
+    const u32 count = mMaterialCounts.at(lastSlot);
+    mMaterialCounts.at(slot) = count;
+    std::copy_n(mMaterials.begin() + group.firstMaterial +
+                    last * group.materialStride,
+                count,
+                mMaterials.begin() + group.firstMaterial +
+                    index * group.materialStride);
+    if (count > 0) {
+      const u32 start =
+          mMaterialBase + group.firstMaterial + index * group.materialStride;
+      mMaterialRanges.at(slot) = {start, start + count - 1};
+    } else {
+      mMaterialRanges.at(slot) = {};
+    }
+
+    mJointRanges.at(slot) = mJointRanges.at(lastSlot);
+
+    std::copy_n(group.visibility.begin() + last * numGeometries,
+                numGeometries,
+                group.visibility.begin() + index * numGeometries);
+
+    group.entities.at(index) = moved;
+    mLocations.at(getEntityIndex(moved)).index = index;
+    markChanged(slot, ChangedAll);
+  }
+
+  group.entities.pop_back();
+  group.visibility.resize(group.entities.size() * numGeometries);
+  mNumInstances--;
+}
+
+void MeshInstanceTable::setMaterials(
+    const Group &group, u32 index,
+    std::span<const rhi::DeviceAddress> materials) {
+  const u32 slot = group.firstSlot + index;
+  const u32 start = group.firstMaterial + index * group.materialStride;
+  const u32 count = static_cast<u32>(materials.size());
+
+  std::copy(materials.begin(), materials.end(), mMaterials.begin() + start);
+  mMaterialCounts.at(slot) = count;
+
+  // Instances without materials use the
+  // default material at the first index
+  if (count > 0) {
+    mMaterialRanges.at(slot) = {mMaterialBase + start,
+                                mMaterialBase + start + count - 1};
+  } else {
+    mMaterialRanges.at(slot) = {};
+  }
+}
+
+void MeshInstanceTable::markChanged(u32 slot, u8 changed) {
+  if (mChangedFlags.at(slot) == 0) {
+    mChangedSlots.push_back(slot);
+  }
+
+  mChangedFlags.at(slot) |= changed;
+}
+
+MeshInstanceTable::Location *MeshInstanceTable::getLocation(Entity entity) {
+  const auto index = getEntityIndex(entity);
+  if (index >= mLocations.size()) {
+    mLocations.resize((index + 1) * 2);
+  }
+
+  return &mLocations.at(index);
+}
+
+} // namespace quoll
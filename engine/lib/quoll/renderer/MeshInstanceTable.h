@@ -0,0 +1,313 @@
+#pragma once
+
+#include "quoll/asset/AssetHandle.h"
+#include "quoll/entity/Entity.h"
+#include "quoll/rhi/DeviceAddress.h"
+#include "JointPalette.h"
+#include "MeshAsset.h"
+#include "MeshDrawData.h"
+
+namespace quoll {
+
+/**
+ * @brief Upload statistics of mesh instances
+ */
+struct MeshInstanceUploadStats {
+  u32 numInstances = 0;
+
+  u32 uploadedInstances = 0;
+
+  usize uploadedBytes = 0;
+};
+
+/**
+ * @brief Persistent table of mesh instances
+ *
+ * Instances of the same mesh are stored in a
+ * contiguous range of slots and keep their slots
+ * between frames. Groups are stored in an array
+ * that is sorted by mesh handle. Instance data is
+ * compared with the previous frame and only slots
+ * that are changed are uploaded to GPU buffers.
+ *
+ * Tables are updated every frame between `begin`
+ * and `end`. Instances that are not set or kept
+ * during the update are removed in `end`.
+ */
+class MeshInstanceTable {
+public:
+  /**
+   * Range of instance materials in flat material array
+   */
+  struct MaterialRange {
+    u32 start = 0;
+
+    u32 end = 0;
+  };
+
+  /**
+   * @brief Instances of a mesh
+   */
+  struct Group {
+    AssetHandle<MeshAsset> handle;
+
+    const MeshDrawData *drawData = nullptr;
+
+    /**
+     * First slot of the group
+     *
+     * Instance N of the group is
+     * stored in slot `firstSlot + N`
+     */
+    u32 firstSlot = 0;
+
+    /**
+     * Number of slots reserved for the group
+     */
+    u32 capacity = 0;
+
+    /**
+     * First material of the group
+     */
+    u32 firstMaterial = 0;
+
+    /**
+     * Number of materials reserved for every instance
+     */
+    u32 materialStride = 0;
+
+    std::vector<Entity> entities;
+
+    /**
+     * View bits of every geometry of every instance
+     */
+    std::vector<u32> visibility;
+  };
+
+  /**
+   * @brief Mapped buffers that instances are uploaded to
+   */
+  struct UploadTarget {
+    glm::mat4 *transforms = nullptr;
+
+    MaterialRange *materialRanges = nullptr;
+
+    /**
+     * Flat materials starting from material base
+     */
+    rhi::DeviceAddress *materials = nullptr;
+
+    /**
+     * Joint ranges of skinned instances
+     */
+    JointRange *jointRanges = nullptr;
+  };
+
+public:
+  /**
+   * @brief Begin updating instances
+   */
+  void begin();
+
+  /**
+   * @brief Set instance of entity
+   *
+   * Adds instance if entity does not exist and
+   * moves it to the new group if mesh is changed.
+   *
+   * @param entity Entity
+   * @param handle Mesh handle
+   * @param drawData Mesh draw data
+   * @param transform World transform
+   * @param materials Materials
+   * @param joints Joints of skeleton in joint palette
+   * @param visibility View bits of every geometry
+   */
+  void set(Entity entity, AssetHandle<MeshAsset> handle,
+           const MeshDrawData &drawData, const glm::mat4 &transform,
+           std::span<const rhi::DeviceAddress> materials,
+           const JointRange &joints, std::span<const u32> visibility);
+
+  /**
+   * @brief Keep instance of entity without drawing it
+   *
+   * Instance data is not changed; so, instances
+   * that are not visible in any view keep their
+   * slots without being gathered.
+   *
+   * @param entity Entity
+   * @retval true Instance is kept
+   * @retval false Entity does not exist
+   */
+  bool keep(Entity entity);
+
+  /**
+   * @brief End updating instances
+   *
+   * Removes instances that are not set or
+   * kept since `begin` and compacts slots
+   * when most of them are unused
+   */
+  void end();
+
+  /**
+   * @brief Upload changed instances
+   *
+   * @param target Mapped buffers
+   * @return Number of uploaded bytes
+   */
+  usize upload(const UploadTarget &target);
+
+  /**
+   * @brief Set index of first material in flat array
+   *
+   * All material ranges are changed
+   * if base is changed
+   *
+   * @param base First material index
+   */
+  void setMaterialBase(u32 base);
+
+  /**
+   * @brief Check if entity exists
+   *
+   * @param entity Entity
+   * @retval true Entity exists
+   * @retval false Entity does not exist
+   */
+  bool contains(Entity entity) const;
+
+  /**
+   * @brief Get slot of entity
+   *
+   * @param entity Entity
+   * @return Slot
+   */
+  u32 getSlot(Entity entity) const;
+
+  /**
+   * @brief Get groups sorted by mesh handle
+   *
+   * @return Instance groups
+   */
+  inline const std::vector<Group> &getGroups() const { return mGroups; }
+
+  /**
+   * @brief Get number of instances
+   *
+   * @return Number of instances
+   */
+  inline usize size() const { return mNumInstances; }
+
+  /**
+   * @brief Get number of slots
+   *
+   * @return Number of slots in all groups
+   */
+  inline usize getCapacity() const { return mTransforms.size(); }
+
+  /**
+   * @brief Get number of materials
+   *
+   * @return Number of materials in all groups
+   */
+  inline usize getMaterialCapacity() const { return mMaterials.size(); }
+
+  /**
+   * @brief Get number of instances that will be uploaded
+   *
+   * @return Number of changed instances
+   */
+  inline usize getNumChanged() const { return mChangedSlots.size(); }
+
+  /**
+   * @brief Get transforms of all slots
+   *
+   * @return Transforms
+   */
+  inline const std::vector<glm::mat4> &getTransforms() const {
+    return mTransforms;
+  }
+
+  /**
+   * @brief Get material ranges of all slots
+   *
+   * @return Material ranges
+   */
+  inline const std::vector<MaterialRange> &getMaterialRanges() const {
+    return mMaterialRanges;
+  }
+
+  /**
+   * @brief Get materials of all groups
+   *
+   * @return Materials relative to material base
+   */
+  inline const std::vector<rhi::DeviceAddress> &getMaterials() const {
+    return mMaterials;
+  }
+
+  /**
+   * @brief Get joint ranges of all slots
+   *
+   * @return Joint ranges
+   */
+  inline const std::vector<JointRange> &getJointRanges() const {
+    return mJointRanges;
+  }
+
+private:
+  /**
+   * Location of entity instance
+   */
+  struct Location {
+    AssetHandle<MeshAsset> handle;
+
+    u32 index = 0;
+
+    u32 frame = 0;
+  };
+
+  enum Changed : u8 {
+    ChangedTransform = 1,
+    ChangedMaterials = 2,
+    ChangedJoints = 4,
+    ChangedAll = ChangedTransform | ChangedMaterials | ChangedJoints
+  };
+
+  usize findGroup(AssetHandle<MeshAsset> handle) const;
+
+  usize insertGroup(AssetHandle<MeshAsset> handle);
+
+  void reserve(usize groupIndex, u32 numInstances, u32 numMaterials);
+
+  void relayout(usize groupIndex, u32 numInstances, u32 numMaterials);
+
+  void removeInstance(usize groupIndex, u32 index);
+
+  void setMaterials(const Group &group, u32 index,
+                    std::span<const rhi::DeviceAddress> materials);
+
+  void markChanged(u32 slot, u8 changed);
+
+  Location *getLocation(Entity entity);
+
+private:
+  u32 mFrame = 0;
+  u32 mMaterialBase = 0;
+  usize mNumInstances = 0;
+
+  std::vector<Group> mGroups;
+  std::vector<Location> mLocations;
+
+  std::vector<glm::mat4> mTransforms;
+  std::vector<MaterialRange> mMaterialRanges;
+  std::vector<u32> mMaterialCounts;
+  std::vector<rhi::DeviceAddress> mMaterials;
+  std::vector<JointRange> mJointRanges;
+
+  std::vector<u32> mChangedSlots;
+  std::vector<u8> mChangedFlags;
+};
+
+} // namespace quoll
@@ -3,9 +3,8 @@
 
 namespace quoll {
 
-static constexpr usize PositionsIndex = 0;
-static constexpr usize JointsIndex = 5;
-static constexpr usize WeightsIndex = 6;
+static constexpr usize PositionsIndex = MeshVertexLayout::PositionStream;
+static constexpr usize SkinIndex = MeshVertexLayout::SkinStream;
 
 std::array<rhi::BufferHandle, 1>
 MeshRenderUtils::getGeometryBuffers(const MeshDrawData *drawData) {
@@ -20,15 +19,91 @@ MeshRenderUtils::getGeometryBufferOffsets(const MeshDrawData *drawData) {
 std::array<rhi::BufferHandle, MeshRenderUtils::SkinGeometryContributors>
 MeshRenderUtils::getSkinnedGeometryBuffers(const MeshDrawData *drawData) {
   return std::array{drawData->vertexBuffers.at(PositionsIndex),
-                    drawData->vertexBuffers.at(JointsIndex),
-                    drawData->vertexBuffers.at(WeightsIndex)};
+                    drawData->vertexBuffers.at(SkinIndex)};
 }
 
 std::array<u64, MeshRenderUtils::SkinGeometryContributors>
 MeshRenderUtils::getSkinnedGeometryBufferOffsets(const MeshDrawData *drawData) {
   return std::array{drawData->vertexBufferOffsets.at(PositionsIndex),
-                    drawData->vertexBufferOffsets.at(JointsIndex),
-                    drawData->vertexBufferOffsets.at(WeightsIndex)};
+                    drawData->vertexBufferOffsets.at(SkinIndex)};
+}
+
+namespace {
+
+/**
+ * @brief Call function for every run of visible instances
+ *
+ * @param visibility Visibility of mesh instances
+ * @param numGeometries Number of geometries in mesh
+ * @param geometryIndex Geometry index
+ * @param viewMask View bit
+ * @param fn Function that receives first instance and
+ *           number of instances of every run
+ */
+template <class TFunction>
+void forEachVisibleRun(std::span<const u32> visibility, usize numGeometries,
+                       usize geometryIndex, u32 viewMask, TFunction &&fn) {
+  const usize numInstances = visibility.size() / numGeometries;
+
+  usize runStart = 0;
+  bool inRun = false;
+  for (usize i = 0; i <= numInstances; ++i) {
+    const bool visible =
+        i < numInstances &&
+        (visibility[i * numGeometries + geometryIndex] & viewMask) != 0;
+
+    if (visible && !inRun) {
+      runStart = i;
+      inRun = true;
+    } else if (!visible && inRun) {
+      fn(static_cast<u32>(runStart), static_cast<u32>(i - runStart));
+      inRun = false;
+    }
+  }
+}
+
+} // namespace
+
+void MeshRenderUtils::drawVisibleInstances(
+    rhi::RenderCommandList &commandList, const MeshDrawData *drawData,
+    usize geometryIndex, u32 firstIndex, i32 vertexOffset, u32 instanceStart,
+    std::span<const u32> visibility, u32 viewMask) {
+  const auto &geometry = drawData->geometries.at(geometryIndex);
+
+  forEachVisibleRun(visibility, drawData->geometries.size(), geometryIndex,
+                    viewMask, [&](u32 runStart, u32 runLength) {
+                      commandList.drawIndexed(geometry.numIndices, firstIndex,
+                                              vertexOffset, runLength,
+                                              instanceStart + runStart);
+                    });
+}
+
+void MeshRenderUtils::addVisibleDrawCommands(
+    std::vector<MeshDrawCommand> &commands, const MeshDrawData *drawData,
+    u32 instanceStart, std::span<const u32> visibility, u32 viewMask) {
+  const usize numGeometries = drawData->geometries.size();
+
+  i32 vertexOffset = 0;
+  u32 firstIndex = 0;
+  for (usize g = 0; g < numGeometries; ++g) {
+    const auto &geometry = drawData->geometries.at(g);
+
+    forEachVisibleRun(visibility, numGeometries, g, viewMask,
+                      [&](u32 runStart, u32 runLength) {
+                        MeshDrawCommand command{};
+                        command.command.indexCount = geometry.numIndices;
+                        command.command.instanceCount = runLength;
+                        command.command.firstIndex = firstIndex;
+                        command.command.vertexOffset = vertexOffset;
+                        command.command.firstInstance =
+                            instanceStart + runStart;
+                        command.geometryIndex = static_cast<u32>(g);
+                        commands.push_back(command);
+                      });
+
+    vertexOffset += static_cast<i32>(geometry.numVertices);
+    firstIndex += geometry.numIndices;
+  }
 }
 
 } // namespace quoll
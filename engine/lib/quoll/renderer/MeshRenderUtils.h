@@ -1,14 +1,28 @@
 #pragma once
 
+#include "quoll/rhi/DrawIndirectCommand.h"
+#include "quoll/rhi/RenderCommandList.h"
 #include "MeshDrawData.h"
 
 namespace quoll {
 
+/**
+ * @brief Indirect draw command of mesh geometry
+ *
+ * Geometry index is read by shaders
+ * to find material of the geometry
+ */
+struct MeshDrawCommand {
+  rhi::DrawIndexedIndirectCommand command;
+
+  u32 geometryIndex = 0;
+};
+
 /**
  * Mesh render utilities
  */
 class MeshRenderUtils {
-  static constexpr usize SkinGeometryContributors = 3;
+  static constexpr usize SkinGeometryContributors = 2;
 
 public:
   /**
@@ -40,6 +54,48 @@ public:
    */
   static std::array<u64, SkinGeometryContributors>
   getSkinnedGeometryBufferOffsets(const MeshDrawData *drawData);
+
+  /**
+   * @brief Draw instances of geometry that are visible in a view
+   *
+   * Visibility stores view bits of every geometry
+   * of every instance. Consecutive visible instances
+   * are drawn with a single draw call.
+   *
+   * @param commandList Render command list
+   * @param drawData Mesh draw data
+   * @param geometryIndex Geometry index
+   * @param firstIndex First index of geometry
+   * @param vertexOffset Vertex offset of geometry
+   * @param instanceStart First instance of mesh
+   * @param visibility Visibility of mesh instances
+   * @param viewMask View bit
+   */
+  static void drawVisibleInstances(rhi::RenderCommandList &commandList,
+                                   const MeshDrawData *drawData,
+                                   usize geometryIndex, u32 firstIndex,
+                                   i32 vertexOffset, u32 instanceStart,
+                                   std::span<const u32> visibility,
+                                   u32 viewMask);
+
+  /**
+   * @brief Add draw commands of instances that are visible in a view
+   *
+   * Adds commands of every geometry. Consecutive
+   * visible instances of a geometry are drawn with
+   * a single command.
+   *
+   * @param commands Draw commands
+   * @param drawData Mesh draw data
+   * @param instanceStart First instance of mesh
+   * @param visibility Visibility of mesh instances
+   * @param viewMask View bit
+   */
+  static void addVisibleDrawCommands(std::vector<MeshDrawCommand> &commands,
+                                     const MeshDrawData *drawData,
+                                     u32 instanceStart,
+                                     std::span<const u32> visibility,
+                                     u32 viewMask);
 };
 
 } // namespace quoll
@@ -0,0 +1,262 @@
+#include "quoll/core/Base.h"
+#include "MeshAsset.h"
+#include "MeshVertexLayout.h"
+
+namespace quoll {
+
+namespace {
+
+/**
+ * Smallest magnitude of encoded tangent component
+ *
+ * Keeps the component non-zero after snorm16
+ * quantization; so, its sign is preserved
+ */
+constexpr f32 TangentSignBias = 1.0f / 32767.0f;
+
+f32 signNotZero(f32 value) { return value >= 0.0f ? 1.0f : -1.0f; }
+
+template <class TValue> void write(u8 *&data, const TValue &value) {
+  memcpy(data, &value, sizeof(TValue));
+  data += sizeof(TValue);
+}
+
+void writeSnorm(u8 *&data, const glm::vec2 &value) {
+  write(data, glm::packSnorm1x16(value.x));
+  write(data, glm::packSnorm1x16(value.y));
+}
+
+} // namespace
+
+MeshVertexLayout MeshVertexLayout::choose(const MeshAsset &mesh) {
+  auto fitsHalf = [](const std::vector<glm::vec2> &texCoords) {
+    return std::all_of(texCoords.begin(), texCoords.end(),
+                       [](const glm::vec2 &texCoord) {
+                         return std::abs(texCoord.x) <= MaxHalfTexCoord &&
+                                std::abs(texCoord.y) <= MaxHalfTexCoord;
+                       });
+  };
+
+  const bool halfTexCoords = std::all_of(
+      mesh.geometries.begin(), mesh.geometries.end(),
+      [&fitsHalf](const BaseGeometryAsset &geometry) {
+        return fitsHalf(geometry.texCoords0) && fitsHalf(geometry.texCoords1);
+      });
+
+  MeshVertexLayout layout{};
+  layout.texCoordFormat =
+      halfTexCoords ? rhi::Format::Rg16Float : rhi::Format::Rg32Float;
+  return layout;
+}
+
+MeshVertexLayout MeshVertexLayout::fromVariant(usize variant) {
+  QuollAssert(variant < NumVariants, "Invalid vertex layout variant");
+
+  MeshVertexLayout layout{};
+  layout.texCoordFormat =
+      variant == 0 ? rhi::Format::Rg16Float : rhi::Format::Rg32Float;
+  return layout;
+}
+
+usize MeshVertexLayout::getVariant() const {
+  return texCoordFormat == rhi::Format::Rg16Float ? 0 : 1;
+}
+
+u32 MeshVertexLayout::getAttributeStride() const {
+  const u32 texCoordSize = texCoordFormat == rhi::Format::Rg16Float
+                               ? 2 * sizeof(u16)
+                               : sizeof(glm::vec2);
+
+  // Normal, tangent, and two texture coordinates
+  return 2 * 2 * sizeof(u16) + 2 * texCoordSize;
+}
+
+void MeshVertexLayout::writePositions(const BaseGeometryAsset &geometry,
+                                      u8 *data) {
+  memcpy(data, geometry.positions.data(),
+         geometry.positions.size() * sizeof(glm::vec3));
+}
+
+void MeshVertexLayout::writeAttributes(const BaseGeometryAsset &geometry,
+                                       u8 *data) const {
+  auto writeTexCoord = [this](u8 *&data,
+                              const std::vector<glm::vec2> &texCoords,
+                              usize index) {
+    const auto texCoord =
+        index < texCoords.size() ? texCoords.at(index) : glm::vec2(0.0f);
+
+    if (texCoordFormat == rhi::Format::Rg16Float) {
+      write(data, glm::packHalf1x16(texCoord.x));
+      write(data, glm::packHalf1x16(texCoord.y));
+    } else {
+      write(data, texCoord);
+    }
+  };
+
+  for (usize i = 0; i < geometry.positions.size(); ++i) {
+    const auto normal = i < geometry.normals.size()
+                            ? geometry.normals.at(i)
+                            : glm::vec3(0.0f, 0.0f, 1.0f);
+    const auto tangent = i < geometry.tangents.size()
+                             ? geometry.tangents.at(i)
+                             : glm::vec4(1.0f, 0.0f, 0.0f, 1.0f);
+
+    writeSnorm(data, encodeOctahedral(normal));
+    writeSnorm(data, encodeOctahedralTangent(tangent));
+    writeTexCoord(data, geometry.texCoords0, i);
+    writeTexCoord(data, geometry.texCoords1, i);
+  }
+}
+
+void MeshVertexLayout::writeSkin(const BaseGeometryAsset &geometry,
+                                 u8 *data) {
+  for (usize i = 0; i < geometry.positions.size(); ++i) {
+    const auto joints =
+        i < geometry.joints.size() ? geometry.joints.at(i) : glm::uvec4(0);
+    const auto weights =
+        i < geometry.weights.size() ? geometry.weights.at(i) : glm::vec4(0.0f);
+
+    for (glm::length_t c = 0; c < 4; ++c) {
+      QuollAssert(joints[c] <= std::numeric_limits<u16>::max(),
+                  "Joint index does not fit in 16 bits");
+      write(data, static_cast<u16>(joints[c]));
+    }
+
+    for (glm::length_t c = 0; c < 4; ++c) {
+      write(data, glm::packUnorm1x16(weights[c]));
+    }
+  }
+}
+
+glm::vec2 encodeOctahedral(const glm::vec3 &vector) {
+  const f32 length =
+      std::abs(vector.x) + std::abs(vector.y) + std::abs(vector.z);
+  if (length == 0.0f) {
+    return glm::vec2(0.0f);
+  }
+
+  glm::vec2 encoded(vector.x / length, vector.y / length);
+
+  // Lower hemisphere is folded over the diagonals
+  if (vector.z < 0.0f) {
+    encoded = glm::vec2((1.0f - std::abs(encoded.y)) * signNotZero(encoded.x),
+                        (1.0f - std::abs(encoded.x)) * signNotZero(encoded.y));
+  }
+
+  return encoded;
+}
+
+glm::vec3 decodeOctahedral(const glm::vec2 &encoded) {
+  glm::vec3 vector(encoded.x, encoded.y,
+                   1.0f - std::abs(encoded.x) - std::abs(encoded.y));
+
+  const f32 fold = std::max(-vector.z, 0.0f);
+  vector.x += vector.x >= 0.0f ? -fold : fold;
+  vector.y += vector.y >= 0.0f ? -fold : fold;
+
+  return glm::normalize(vector);
+}
+
+glm::vec2 encodeOctahedralTangent(const glm::vec4 &tangent) {
+  auto encoded = encodeOctahedral(glm::vec3(tangent));
+
+  const f32 y = TangentSignBias +
+                (encoded.y * 0.5f + 0.5f) * (1.0f - TangentSignBias);
+  encoded.y = tangent.w < 0.0f ? -y : y;
+  return encoded;
+}
+
+glm::vec4 decodeOctahedralTangent(const glm::vec2 &encoded) {
+  const f32 y =
+      (std::abs(encoded.y) - TangentSignBias) / (1.0f - TangentSignBias);
+
+  return glm::vec4(decodeOctahedral(glm::vec2(encoded.x, y * 2.0f - 1.0f)),
+                   encoded.y < 0.0f ? -1.0f : 1.0f);
+}
+
+rhi::PipelineVertexInputLayout createMeshPositionLayout() {
+  rhi::PipelineVertexInputLayout layout{};
+  layout.bindings = {{.binding = MeshVertexLayout::PositionStream,
+                      .stride = MeshVertexLayout::PositionStride,
+                      .inputRate = rhi::VertexInputRate::Vertex}};
+  layout.attributes = {{.slot = 0,
+                        .binding = MeshVertexLayout::PositionStream,
+                        .format = rhi::Format::Rgb32Float,
+                        .offset = 0}};
+
+  return layout;
+}
+
+rhi::PipelineVertexInputLayout createSkinnedMeshPositionLayout() {
+  auto layout = createMeshPositionLayout();
+
+  // Skin stream is bound after positions
+  layout.bindings.push_back({.binding = 1,
+                             .stride = MeshVertexLayout::SkinStride,
+                             .inputRate = rhi::VertexInputRate::Vertex});
+  layout.attributes.push_back({.slot = 1,
+                               .binding = 1,
+                               .format = rhi::Format::Rgba16Uint,
+                               .offset = 0});
+  layout.attributes.push_back({.slot = 2,
+                               .binding = 1,
+                               .format = rhi::Format::Rgba16Unorm,
+                               .offset = 4 * sizeof(u16)});
+
+  return layout;
+}
+
+rhi::PipelineVertexInputLayout
+createMeshVertexLayout(const MeshVertexLayout &meshLayout) {
+  static constexpr u32 NormalOffset = 0;
+  static constexpr u32 TangentOffset = 2 * sizeof(u16);
+  static constexpr u32 TexCoordOffset = 4 * sizeof(u16);
+
+  const u32 texCoordSize =
+      (meshLayout.getAttributeStride() - TexCoordOffset) / 2;
+
+  auto layout = createMeshPositionLayout();
+  layout.bindings.push_back({.binding = MeshVertexLayout::AttributeStream,
+                             .stride = meshLayout.getAttributeStride(),
+                             .inputRate = rhi::VertexInputRate::Vertex});
+
+  layout.attributes.push_back({.slot = 1,
+                               .binding = MeshVertexLayout::AttributeStream,
+                               .format = rhi::Format::Rg16Snorm,
+                               .offset = NormalOffset});
+  layout.attributes.push_back({.slot = 2,
+                               .binding = MeshVertexLayout::AttributeStream,
+                               .format = rhi::Format::Rg16Snorm,
+                               .offset = TangentOffset});
+  layout.attributes.push_back({.slot = 3,
+                               .binding = MeshVertexLayout::AttributeStream,
+                               .format = meshLayout.texCoordFormat,
+                               .offset = TexCoordOffset});
+  layout.attributes.push_back({.slot = 4,
+                               .binding = MeshVertexLayout::AttributeStream,
+                               .format = meshLayout.texCoordFormat,
+                               .offset = TexCoordOffset + texCoordSize});
+
+  return layout;
+}
+
+rhi::PipelineVertexInputLayout
+createSkinnedMeshVertexLayout(const MeshVertexLayout &meshLayout) {
+  auto layout = createMeshVertexLayout(meshLayout);
+
+  layout.bindings.push_back({.binding = MeshVertexLayout::SkinStream,
+                             .stride = MeshVertexLayout::SkinStride,
+                             .inputRate = rhi::VertexInputRate::Vertex});
+  layout.attributes.push_back({.slot = 5,
+                               .binding = MeshVertexLayout::SkinStream,
+                               .format = rhi::Format::Rgba16Uint,
+                               .offset = 0});
+  layout.attributes.push_back({.slot = 6,
+                               .binding = MeshVertexLayout::SkinStream,
+                               .format = rhi::Format::Rgba16Unorm,
+                               .offset = 4 * sizeof(u16)});
+
+  return layout;
+}
+
+} // namespace quoll
@@ -4,75 +4,161 @@
 
 namespace quoll {
 
-namespace mesh_vertex_layout_detail {
-
-template <class TType> static rhi::Format getFormat() {
-  if constexpr (std::is_same_v<TType, glm::vec2>) {
-    return rhi::Format::Rg32Float;
-  }
-
-  if constexpr (std::is_same_v<TType, glm::vec3>) {
-    return rhi::Format::Rgb32Float;
-  }
-
-  if constexpr (std::is_same_v<TType, glm::vec4>) {
-    return rhi::Format::Rgba32Float;
-  }
-
-  if constexpr (std::is_same_v<TType, glm::uvec4>) {
-    return rhi::Format::Rgba32Uint;
-  }
-
-  static_assert("Format not defined");
-}
-
-template <typename... TTypes>
-static constexpr void
-createBindings(std::vector<rhi::PipelineVertexInputBinding> &bindings) {
-  (bindings.push_back({.binding = static_cast<u32>(bindings.size()),
-                       .stride = sizeof(TTypes),
-                       .inputRate = rhi::VertexInputRate::Vertex}),
-   ...);
-}
-
-template <typename... TTypes>
-static constexpr void
-createAttributes(std::vector<rhi::PipelineVertexInputAttribute> &attributes) {
-  (attributes.push_back({.slot = static_cast<u32>(attributes.size()),
-                         .binding = static_cast<u32>(attributes.size()),
-                         .format = getFormat<TTypes>(),
-                         .offset = 0}),
-   ...);
-}
-
-} // namespace mesh_vertex_layout_detail
-
-template <typename... TTypes>
-static constexpr rhi::PipelineVertexInputLayout createMeshVertexLayoutFrom() {
-  rhi::PipelineVertexInputLayout layout{};
-
-  mesh_vertex_layout_detail::createBindings<TTypes...>(layout.bindings);
-  mesh_vertex_layout_detail::createAttributes<TTypes...>(layout.attributes);
-
-  return layout;
-}
-
-static rhi::PipelineVertexInputLayout createMeshPositionLayout() {
-  return createMeshVertexLayoutFrom<glm::vec3>();
-}
-
-static rhi::PipelineVertexInputLayout createMeshVertexLayout() {
-  return createMeshVertexLayoutFrom<glm::vec3, glm::vec3, glm::vec4, glm::vec2,
-                                    glm::vec2>();
-}
-
-static rhi::PipelineVertexInputLayout createSkinnedMeshVertexLayout() {
-  return createMeshVertexLayoutFrom<glm::vec3, glm::vec3, glm::vec4, glm::vec2,
-                                    glm::vec2, glm::uvec4, glm::vec4>();
-}
-
-static rhi::PipelineVertexInputLayout createSkinnedMeshPositionLayout() {
-  return createMeshVertexLayoutFrom<glm::vec3, glm::uvec4, glm::vec4>();
-}
+struct MeshAsset;
+struct BaseGeometryAsset;
+
+/**
+ * @brief Vertex layout of mesh draw data
+ *
+ * Positions are stored in their own stream; so,
+ * depth only passes do not fetch other attributes.
+ * Normals, tangents, and texture coordinates are
+ * interleaved in the attribute stream. Normals and
+ * tangents are octahedral encoded in two snorm16
+ * components; sign of bitangent is stored in the
+ * sign of the second tangent component. Joints and
+ * weights of skinned meshes are interleaved in the
+ * skin stream as uint16 and unorm16 components.
+ *
+ * Format of texture coordinates is chosen per mesh
+ * when mesh is loaded.
+ */
+struct MeshVertexLayout {
+  static constexpr u32 PositionStream = 0;
+  static constexpr u32 AttributeStream = 1;
+  static constexpr u32 SkinStream = 2;
+
+  static constexpr u32 PositionStride = sizeof(glm::vec3);
+  static constexpr u32 SkinStride = 8 * sizeof(u16);
+
+  /**
+   * Number of layout variants
+   */
+  static constexpr usize NumVariants = 2;
+
+  /**
+   * Largest texture coordinate that
+   * is stored as half float
+   */
+  static constexpr f32 MaxHalfTexCoord = 2.0f;
+
+  /**
+   * Format of texture coordinates
+   *
+   * Rg16Float or Rg32Float
+   */
+  rhi::Format texCoordFormat = rhi::Format::Rg32Float;
+
+  /**
+   * @brief Choose vertex layout of mesh
+   *
+   * Half float texture coordinates are chosen
+   * if they are precise enough for all vertices.
+   *
+   * @param mesh Mesh asset
+   * @return Vertex layout
+   */
+  static MeshVertexLayout choose(const MeshAsset &mesh);
+
+  /**
+   * @brief Get layout from variant index
+   *
+   * @param variant Variant index
+   * @return Vertex layout
+   */
+  static MeshVertexLayout fromVariant(usize variant);
+
+  /**
+   * @brief Get variant index
+   *
+   * Meshes with the same variant
+   * can share pipelines
+   *
+   * @return Variant index
+   */
+  usize getVariant() const;
+
+  /**
+   * @brief Get stride of attribute stream
+   *
+   * @return Attribute stride
+   */
+  u32 getAttributeStride() const;
+
+  /**
+   * @brief Write positions of geometry
+   *
+   * @param geometry Geometry asset
+   * @param data Destination data
+   */
+  static void writePositions(const BaseGeometryAsset &geometry, u8 *data);
+
+  /**
+   * @brief Write interleaved attributes of geometry
+   *
+   * Missing attributes are filled with defaults
+   *
+   * @param geometry Geometry asset
+   * @param data Destination data
+   */
+  void writeAttributes(const BaseGeometryAsset &geometry, u8 *data) const;
+
+  /**
+   * @brief Write interleaved joints and weights of geometry
+   *
+   * Missing joints and weights are filled with zeroes
+   *
+   * @param geometry Geometry asset
+   * @param data Destination data
+   */
+  static void writeSkin(const BaseGeometryAsset &geometry, u8 *data);
+
+  bool operator==(const MeshVertexLayout &) const = default;
+};
+
+/**
+ * @brief Encode unit vector in octahedral coordinates
+ *
+ * @param vector Unit vector
+ * @return Octahedral coordinates in [-1, 1] range
+ */
+glm::vec2 encodeOctahedral(const glm::vec3 &vector);
+
+/**
+ * @brief Decode unit vector from octahedral coordinates
+ *
+ * @param encoded Octahedral coordinates
+ * @return Unit vector
+ */
+glm::vec3 decodeOctahedral(const glm::vec2 &encoded);
+
+/**
+ * @brief Encode tangent in octahedral coordinates
+ *
+ * Second component is remapped to (0, 1] range
+ * and negated if bitangent sign is negative
+ *
+ * @param tangent Tangent with bitangent sign in w
+ * @return Encoded tangent
+ */
+glm::vec2 encodeOctahedralTangent(const glm::vec4 &tangent);
+
+/**
+ * @brief Decode tangent from octahedral coordinates
+ *
+ * @param encoded Encoded tangent
+ * @return Tangent with bitangent sign in w
+ */
+glm::vec4 decodeOctahedralTangent(const glm::vec2 &encoded);
+
+rhi::PipelineVertexInputLayout createMeshPositionLayout();
+
+rhi::PipelineVertexInputLayout createSkinnedMeshPositionLayout();
+
+rhi::PipelineVertexInputLayout
+createMeshVertexLayout(const MeshVertexLayout &layout);
+
+rhi::PipelineVertexInputLayout
+createSkinnedMeshVertexLayout(const MeshVertexLayout &layout);
 
 } // namespace quoll
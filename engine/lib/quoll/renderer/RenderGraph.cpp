@@ -53,26 +53,127 @@ RenderGraph::RGTexture RenderGraph::import(rhi::TextureHandle handle) {
   return RGTexture(mRegistry, textureIndex);
 }
 
+void RenderGraph::addOutput(RGTexture texture) {
+  mOutputs.insert(getRootTextureIndex(texture.getIndex()));
+}
+
 namespace {
 
-void topologicalSort(const std::vector<RenderGraphPass> &inputs, usize index,
-                     std::vector<bool> &visited,
+void topologicalSort(usize index, std::vector<bool> &visited,
                      const std::vector<std::set<usize>> &adjacencyList,
-                     std::vector<RenderGraphPass> &output) {
+                     std::vector<usize> &output) {
   visited.at(index) = true;
 
   for (const usize x : adjacencyList.at(index)) {
     if (!visited.at(x)) {
-      topologicalSort(inputs, x, visited, adjacencyList, output);
+      topologicalSort(x, visited, adjacencyList, output);
     }
   }
 
-  output.push_back(inputs.at(index));
+  output.push_back(index);
 }
 
+u32 getFormatSize(rhi::Format format) {
+  switch (format) {
+  case rhi::Format::Depth16Unorm:
+    return 2;
+  case rhi::Format::Rgba8Unorm:
+  case rhi::Format::Rgba8Srgb:
+  case rhi::Format::Bgra8Srgb:
+  case rhi::Format::Rg16Snorm:
+  case rhi::Format::Rg16Float:
+  case rhi::Format::Depth32Float:
+    return 4;
+  case rhi::Format::Rgba16Float:
+  case rhi::Format::Rgba16Unorm:
+  case rhi::Format::Rgba16Uint:
+  case rhi::Format::Rg32Float:
+  // Stencil is padded to 32 bits by most devices
+  case rhi::Format::Depth32FloatStencil8Uint:
+    return 8;
+  case rhi::Format::Rgb32Float:
+    return 12;
+  case rhi::Format::Rgba32Float:
+  case rhi::Format::Rgba32Uint:
+    return 16;
+  default:
+    return 0;
+  }
+}
+
+/**
+ * @brief Get memory size of texture
+ *
+ * Size is an estimate that does not
+ * include alignment and padding
+ *
+ * @param description Texture description
+ * @return Memory size in bytes
+ */
+usize getTextureMemorySize(const rhi::TextureDescription &description) {
+  usize size = 0;
+  for (u32 level = 0; level < description.mipLevelCount; ++level) {
+    size += static_cast<usize>(std::max(description.width >> level, 1u)) *
+            std::max(description.height >> level, 1u) *
+            std::max(description.depth >> level, 1u);
+  }
+
+  return size * description.layerCount * description.samples *
+         getFormatSize(description.format);
+}
+
+/**
+ * @brief Check if two textures can share device texture
+ *
+ * @param a First texture description
+ * @param b Second texture description
+ * @retval true Textures can be aliased
+ * @retval false Textures cannot be aliased
+ */
+bool isAliasable(const rhi::TextureDescription &a,
+                 const rhi::TextureDescription &b) {
+  return a.type == b.type && a.usage == b.usage && a.format == b.format &&
+         a.width == b.width && a.height == b.height && a.depth == b.depth &&
+         a.layerCount == b.layerCount && a.mipLevelCount == b.mipLevelCount &&
+         a.samples == b.samples;
+}
+
+/**
+ * @brief Synchronization state of render graph resource
+ *
+ * @tparam TDependency Sync dependency
+ */
+template <class TDependency> struct RGSyncState {
+  /**
+   * Last access of resource
+   *
+   * Accesses of merged reads are combined
+   */
+  std::optional<TDependency> dependency;
+
+  /**
+   * Compiled pass of the last barrier
+   */
+  usize barrierPass = 0;
+
+  /**
+   * Index of the last barrier in its pass
+   */
+  usize barrierIndex = 0;
+
+  /**
+   * Last access is a read
+   */
+  bool read = false;
+};
+
 } // namespace
 
 void RenderGraph::buildResources(RenderStorage &storage) {
+  QUOLL_PROFILE_EVENT("RenderGraph::buildResources");
+
+  aliasTextures(storage);
+
   // Create all real handles for render graph if they do not exist
   const auto &textures = mRegistry.getRealResources<rhi::TextureHandle>();
   for (usize i = 0; i < textures.size(); ++i) {
@@ -85,12 +186,24 @@ void RenderGraph::buildResources(RenderStorage &storage) {
 
   auto *device = storage.getDevice();
 
+  mMemoryStats = {};
+  std::set<rhi::TextureHandle> createdTextures;
+
   for (usize i = 0; i < textures.size(); ++i) {
     auto handle = mRegistry.get<rhi::TextureHandle>(i);
     const auto &desc = mRegistry.getDescription<rhi::TextureHandle>(i);
 
     if (const auto *textureDesc = std::get_if<rhi::TextureDescription>(&desc)) {
-      device->createTexture(*textureDesc, handle);
+      const auto size = getTextureMemorySize(*textureDesc);
+      mMemoryStats.numTransientTextures++;
+      mMemoryStats.peakMemory += size;
+
+      // Aliased textures share the same device texture
+      if (createdTextures.insert(handle).second) {
+        device->createTexture(*textureDesc, handle);
+        mMemoryStats.numDeviceTextures++;
+        mMemoryStats.aliasedPeakMemory += size;
+      }
     } else if (const auto *viewDesc =
                    std::get_if<RGTextureViewDescription>(&desc)) {
       rhi::TextureViewDescription description{};
@@ -105,6 +218,135 @@ void RenderGraph::buildResources(RenderStorage &storage) {
 
     mRegistry.callResourceReady<rhi::TextureHandle>(i, storage);
   }
+
+  LOG_DEBUG("Render graph transient memory: "
+            << mMemoryStats.peakMemory << " bytes without aliasing, "
+            << mMemoryStats.aliasedPeakMemory << " bytes with aliasing (Graph: "
+            << mName << ")");
+}
+
+usize RenderGraph::getRootTextureIndex(usize index) {
+  const auto desc = mRegistry.getDescription<rhi::TextureHandle>(index);
+  if (const auto *viewDesc = std::get_if<RGTextureViewDescription>(&desc)) {
+    return getRootTextureIndex(viewDesc->textureIndex);
+  }
+
+  return index;
+}
+
+std::vector<RenderGraph::RGTextureLifetime>
+RenderGraph::getTextureLifetimes() {
+  static constexpr usize NotUsed = std::numeric_limits<usize>::max();
+
+  const auto numTextures =
+      mRegistry.getRealResources<rhi::TextureHandle>().size();
+
+  std::vector<RGTextureLifetime> lifetimes(numTextures);
+  std::vector<usize> lastWrites(numTextures, NotUsed);
+  std::vector<usize> lastReads(numTextures, NotUsed);
+
+  // Uses of views extend lifetime of the texture they view
+  auto use = [this, &lifetimes](usize index, usize passIndex) {
+    const auto root = getRootTextureIndex(index);
+    auto &lifetime = lifetimes.at(root);
+    lifetime.first = std::min(lifetime.first, passIndex);
+    lifetime.last = std::max(lifetime.last, passIndex);
+    return root;
+  };
+
+  for (usize i = 0; i < mCompiledPasses.size(); ++i) {
+    const auto &pass = mCompiledPasses.at(i);
+    for (const auto &output : pass.getTextureOutputs()) {
+      lastWrites.at(use(output.texture.getIndex(), i)) = i;
+    }
+
+    for (const auto &input : pass.getTextureInputs()) {
+      lastReads.at(use(input.texture.getIndex(), i)) = i;
+    }
+  }
+
+  // Outputs and textures that are not read after they
+  // are written are used outside of the graph; so, they
+  // must stay intact until the end of the frame
+  for (usize i = 0; i < numTextures; ++i) {
+    if (mOutputs.contains(i) ||
+        (lastWrites.at(i) != NotUsed &&
+         (lastReads.at(i) == NotUsed ||
+          lastWrites.at(i) >= lastReads.at(i)))) {
+      lifetimes.at(i).last = mCompiledPasses.size();
+    }
+  }
+
+  return lifetimes;
+}
+
+void RenderGraph::aliasTextures(RenderStorage &storage) {
+  QUOLL_PROFILE_EVENT("RenderGraph::aliasTextures");
+
+  const auto lifetimes = getTextureLifetimes();
+
+  std::vector<usize> aliasable;
+  for (usize i = 0; i < lifetimes.size(); ++i) {
+    const auto &desc = mRegistry.getDescription<rhi::TextureHandle>(i);
+    if (mRegistry.getResourceState<rhi::TextureHandle>(i) ==
+            RGResourceState::Transient &&
+        std::holds_alternative<rhi::TextureDescription>(desc) &&
+        lifetimes.at(i).first <= lifetimes.at(i).last) {
+      aliasable.push_back(i);
+    }
+  }
+
+  std::stable_sort(aliasable.begin(), aliasable.end(),
+                   [&lifetimes](usize a, usize b) {
+                     return lifetimes.at(a).first < lifetimes.at(b).first;
+                   });
+
+  struct DeviceTexture {
+    usize index = 0;
+
+    rhi::TextureDescription description;
+
+    rhi::TextureHandle handle = rhi::TextureHandle::Null;
+
+    usize last = 0;
+  };
+
+  // Textures are visited in the order of their first use;
+  // a device texture is reused if all the textures that
+  // use it are not used anymore
+  mTextureAliases.resize(lifetimes.size());
+  for (usize i = 0; i < mTextureAliases.size(); ++i) {
+    mTextureAliases.at(i) = i;
+  }
+
+  std::vector<DeviceTexture> deviceTextures;
+  for (auto index : aliasable) {
+    const auto &lifetime = lifetimes.at(index);
+    const auto description = std::get<rhi::TextureDescription>(
+        mRegistry.getDescription<rhi::TextureHandle>(index));
+
+    auto it = std::find_if(
+        deviceTextures.begin(), deviceTextures.end(),
+        [&lifetime, &description](const DeviceTexture &deviceTexture) {
+          return deviceTexture.last < lifetime.first &&
+                 isAliasable(deviceTexture.description, description);
+        });
+
+    if (it != deviceTextures.end()) {
+      mRegistry.set(index, it->handle);
+      mTextureAliases.at(index) = it->index;
+      it->last = lifetime.last;
+      continue;
+    }
+
+    auto handle = mRegistry.get<rhi::TextureHandle>(index);
+    if (handle == rhi::TextureHandle::Null) {
+      handle = storage.getNewTextureHandle();
+      mRegistry.set(index, handle);
+    }
+
+    deviceTextures.push_back({index, description, handle, lifetime.last});
+  }
 }
 
 void RenderGraph::compile() {
@@ -145,12 +387,12 @@ void RenderGraph::compile() {
 
   // Cache reads so we can easily access them
   // for creating the adjacency lsit
-  std::unordered_map<rhi::TextureHandle, std::vector<usize>> passTextureReads;
+  std::unordered_map<usize, std::vector<usize>> passTextureReads;
   std::unordered_map<rhi::BufferHandle, std::vector<usize>> passBufferReads;
   for (usize i = 0; i < passIndices.size(); ++i) {
     auto &pass = mPasses.at(passIndices.at(i));
     for (auto &resourceId : pass.getTextureInputs()) {
-      passTextureReads[resourceId.texture].push_back(i);
+      passTextureReads[resourceId.texture.getIndex()].push_back(i);
     }
 
     for (auto &resourceId : pass.getBufferInputs()) {
@@ -166,8 +408,9 @@ void RenderGraph::compile() {
   for (usize i = 0; i < passIndices.size(); ++i) {
     auto &pass = mPasses.at(passIndices.at(i));
     for (auto resourceId : pass.getTextureOutputs()) {
-      if (passTextureReads.find(resourceId.texture) != passTextureReads.end()) {
-        for (auto read : passTextureReads.at(resourceId.texture)) {
+      auto it = passTextureReads.find(resourceId.texture.getIndex());
+      if (it != passTextureReads.end()) {
+        for (auto read : it->second) {
           adjacencyList.at(i).insert(read);
         }
       }
@@ -182,44 +425,174 @@ void RenderGraph::compile() {
     }
   }
 
+  // Cull passes that do not contribute to the graph's
+  // results. A pass is used if it has side effects or
+  // writes to a texture that is read by a used pass
+  std::vector<std::vector<usize>> writers(passIndices.size());
+  for (usize i = 0; i < passIndices.size(); ++i) {
+    for (auto read : adjacencyList.at(i)) {
+      writers.at(read).push_back(i);
+    }
+  }
+
+  // Imported textures are used outside of the graph. If
+  // outputs are not added, textures that are not read by
+  // other passes are treated as outputs
+  auto isOutput = [this, &passTextureReads](usize passIndex,
+                                            usize textureIndex) {
+    auto root = getRootTextureIndex(textureIndex);
+    if (mOutputs.contains(root) ||
+        mRegistry.getResourceState<rhi::TextureHandle>(root) ==
+            RGResourceState::Real) {
+      return true;
+    }
+
+    if (!mOutputs.empty()) {
+      return false;
+    }
+
+    auto it = passTextureReads.find(textureIndex);
+    return it == passTextureReads.end() ||
+           std::all_of(it->second.begin(), it->second.end(),
+                       [passIndex](usize read) { return read == passIndex; });
+  };
+
+  // Effects of passes without texture outputs are not known;
+  // so, they are always used
+  auto hasSideEffects = [this, &passIndices, &isOutput](usize passIndex) {
+    const auto &pass = mPasses.at(passIndices.at(passIndex));
+    return pass.getTextureOutputs().empty() ||
+           !pass.getBufferOutputs().empty() ||
+           std::any_of(pass.getTextureOutputs().begin(),
+                       pass.getTextureOutputs().end(),
+                       [passIndex, &isOutput](const RenderTargetData &output) {
+                         return isOutput(passIndex, output.texture.getIndex());
+                       });
+  };
+
+  std::vector<bool> used(passIndices.size(), false);
+  std::vector<usize> usedQueue;
+  for (usize i = 0; i < passIndices.size(); ++i) {
+    if (hasSideEffects(i)) {
+      used.at(i) = true;
+      usedQueue.push_back(i);
+    }
+  }
+
+  while (!usedQueue.empty()) {
+    auto index = usedQueue.back();
+    usedQueue.pop_back();
+
+    for (auto writer : writers.at(index)) {
+      if (!used.at(writer)) {
+        used.at(writer) = true;
+        usedQueue.push_back(writer);
+      }
+    }
+  }
+
   // Topological sort based on DFS
-  std::vector<RenderGraphPass> compiledPasses;
-  compiledPasses.reserve(passIndices.size());
+  std::vector<usize> sortedIndices;
+  sortedIndices.reserve(passIndices.size());
   std::vector<bool> visited(passIndices.size(), false);
 
+  for (usize i = 0; i < passIndices.size(); ++i) {
+    if (!used.at(i)) {
+      LOG_DEBUG("Pass is culled during compilation because its outputs are "
+                "never used: "
+                << mPasses.at(passIndices.at(i)).getName()
+                << " (Graph: " << mName << ")");
+      visited.at(i) = true;
+    }
+  }
+
   for (usize i = passIndices.size(); i-- > 0;) {
     if (!visited.at(i)) {
-      topologicalSort(mPasses, i, visited, adjacencyList, compiledPasses);
+      topologicalSort(i, visited, adjacencyList, sortedIndices);
     }
   }
 
-  std::reverse(compiledPasses.begin(), compiledPasses.end());
+  std::vector<RenderGraphPass> compiledPasses;
+  compiledPasses.reserve(sortedIndices.size());
+  for (auto it = sortedIndices.rbegin(); it != sortedIndices.rend(); ++it) {
+    compiledPasses.push_back(mPasses.at(passIndices.at(*it)));
+  }
+
   mCompiledPasses = std::move(compiledPasses);
 }
 
 void RenderGraph::buildBarriers() {
   QUOLL_PROFILE_EVENT("RenderGraph::buildBarriers");
 
-  std::unordered_map<rhi::TextureHandle, rhi::ImageLayout>
-      textureAttachmentLayouts;
-  std::unordered_map<rhi::TextureHandle, RenderGraphTextureSyncDependency>
-      textureDependencies;
-  std::unordered_map<rhi::BufferHandle, RenderGraphBufferSyncDependency>
-      bufferDependencies;
+  const auto numTextures =
+      mRegistry.getRealResources<rhi::TextureHandle>().size();
 
-  for (auto &pass : mCompiledPasses) {
-    std::vector<rhi::ImageBarrier> imageBarriers{};
-    std::vector<rhi::BufferBarrier> bufferBarriers{};
+  // Views share sync state and attachment layout of the
+  // texture they view. Aliased textures share sync state
+  // of their device texture; so, first write through
+  // a view waits for the previous user of the memory
+  std::vector<usize> rootIndices(numTextures);
+  for (usize i = 0; i < numTextures; ++i) {
+    rootIndices.at(i) = getRootTextureIndex(i);
+  }
+
+  std::vector<RGSyncState<RenderGraphTextureSyncDependency>> textureStates(
+      numTextures);
+  std::vector<std::optional<rhi::ImageLayout>> textureAttachmentLayouts(
+      numTextures);
+
+  auto getTextureState = [this, &rootIndices, &textureStates](
+                             usize index) -> auto & {
+    return textureStates.at(mTextureAliases.at(rootIndices.at(index)));
+  };
+
+  using BufferSyncState = RGSyncState<RenderGraphBufferSyncDependency>;
+
+  // Graphs only use a handful of buffers
+  std::vector<std::pair<rhi::BufferHandle, BufferSyncState>> bufferStates;
+
+  auto getBufferState = [&bufferStates](
+                            rhi::BufferHandle handle) -> BufferSyncState & {
+    auto it = std::find_if(
+        bufferStates.begin(), bufferStates.end(),
+        [handle](const auto &state) { return state.first == handle; });
+    if (it == bufferStates.end()) {
+      return bufferStates.emplace_back(handle, BufferSyncState{}).second;
+    }
+
+    return it->second;
+  };
+
+  // Merges buffer access into the last barrier of the buffer
+  auto mergeBufferAccess =
+      [this](BufferSyncState &state,
+             const RenderGraphBufferSyncDependency &dependency) {
+        auto &bufferBarrier =
+            mCompiledPasses.at(state.barrierPass)
+                .mDependencies.bufferBarriers.at(state.barrierIndex);
+        bufferBarrier.dstStage |= dependency.stage;
+        bufferBarrier.dstAccess |= dependency.access;
+        state.dependency->stage |= dependency.stage;
+        state.dependency->access |= dependency.access;
+      };
+
+  for (usize passIndex = 0; passIndex < mCompiledPasses.size(); ++passIndex) {
+    auto &pass = mCompiledPasses.at(passIndex);
+    auto &imageBarriers = pass.mDependencies.imageBarriers;
+    auto &bufferBarriers = pass.mDependencies.bufferBarriers;
+    imageBarriers.clear();
+    bufferBarriers.clear();
 
     for (usize index = 0; index < pass.getTextureOutputs().size(); ++index) {
       auto &output = pass.getTextureOutputs().at(index);
+      auto textureIndex = output.texture.getIndex();
       auto handle = output.texture.getHandle();
 
       auto newDependency = RenderGraphSyncDependency::getTextureWrite(
           pass.getType(), pass.getAttachments().at(index).type);
 
-      const auto &description = mRegistry.getDescription<rhi::TextureHandle>(
-          output.texture.getIndex());
+      const auto &description =
+          mRegistry.getDescription<rhi::TextureHandle>(textureIndex);
 
       u32 baseMipLevel = 0;
       u32 mipLevelCount = 1;
@@ -241,21 +614,28 @@ void RenderGraph::buildBarriers() {
       imageBarrier.levelCount = mipLevelCount;
       imageBarrier.dstStage = newDependency.stage;
 
-      auto it = textureDependencies.find(handle);
-      if (it == textureDependencies.end()) {
+      auto &state = getTextureState(textureIndex);
+      if (!state.dependency.has_value()) {
         imageBarrier.srcStage = rhi::PipelineStage::None;
         imageBarrier.srcAccess = rhi::Access::None;
         imageBarrier.srcLayout = rhi::ImageLayout::Undefined;
       } else {
-        auto oldDependency = it->second;
+        auto oldDependency = state.dependency.value();
 
         imageBarrier.srcStage = oldDependency.stage;
         imageBarrier.srcAccess = oldDependency.access;
         imageBarrier.srcLayout = oldDependency.layout;
+
+        // Contents of aliased texture that is previously used
+        // by another resource are discarded on first write
+        if (!textureAttachmentLayouts.at(rootIndices.at(textureIndex))
+                 .has_value()) {
+          imageBarrier.srcLayout = rhi::ImageLayout::Undefined;
+        }
       }
 
       imageBarriers.push_back(imageBarrier);
-      textureDependencies.insert_or_assign(handle, newDependency);
+      state = {newDependency, passIndex, imageBarriers.size() - 1, false};
     }
 
     for (usize index = 0; index < pass.getTextureInputs().size(); ++index) {
@@ -265,10 +645,24 @@ void RenderGraph::buildBarriers() {
       auto newDependency =
           RenderGraphSyncDependency::getTextureRead(pass.getType());
 
-      QuollAssert(textureDependencies.find(handle) != textureDependencies.end(),
+      auto &state = getTextureState(input.texture.getIndex());
+      QuollAssert(state.dependency.has_value(),
                   "Cannot read from unwritten texture");
 
-      auto oldDependency = textureDependencies.at(handle);
+      auto oldDependency = state.dependency.value();
+
+      // Reads do not depend on each other; so, later reads
+      // are merged into the barrier that made texture readable
+      if (state.read && oldDependency.layout == newDependency.layout) {
+        auto &imageBarrier = mCompiledPasses.at(state.barrierPass)
+                                 .mDependencies.imageBarriers.at(
+                                     state.barrierIndex);
+        imageBarrier.dstStage |= newDependency.stage;
+        imageBarrier.dstAccess |= newDependency.access;
+        state.dependency->stage |= newDependency.stage;
+        state.dependency->access |= newDependency.access;
+        continue;
+      }
 
       rhi::ImageBarrier imageBarrier{};
       imageBarrier.texture = handle;
@@ -280,7 +674,7 @@ void RenderGraph::buildBarriers() {
       imageBarrier.dstStage = newDependency.stage;
       imageBarriers.push_back(imageBarrier);
 
-      textureDependencies.insert_or_assign(handle, newDependency);
+      state = {newDependency, passIndex, imageBarriers.size() - 1, true};
     }
 
     for (auto &output : pass.getBufferOutputs()) {
@@ -289,24 +683,30 @@ void RenderGraph::buildBarriers() {
       auto newDependency =
           RenderGraphSyncDependency::getBufferWrite(pass.getType());
 
+      auto &state = getBufferState(handle);
+
+      // Accesses in the same pass share one barrier
+      if (state.dependency.has_value() && state.barrierPass == passIndex) {
+        mergeBufferAccess(state, newDependency);
+        state.read = false;
+        continue;
+      }
+
       rhi::BufferBarrier bufferBarrier{};
       bufferBarrier.buffer = handle;
       bufferBarrier.dstAccess = newDependency.access;
       bufferBarrier.dstStage = newDependency.stage;
 
-      auto it = bufferDependencies.find(handle);
-      if (it == bufferDependencies.end()) {
+      if (!state.dependency.has_value()) {
         bufferBarrier.srcStage = rhi::PipelineStage::None;
         bufferBarrier.srcAccess = rhi::Access::None;
       } else {
-        auto oldDependency = it->second;
-
-        bufferBarrier.srcStage = oldDependency.stage;
-        bufferBarrier.srcAccess = oldDependency.access;
+        bufferBarrier.srcStage = state.dependency->stage;
+        bufferBarrier.srcAccess = state.dependency->access;
       }
 
       bufferBarriers.push_back(bufferBarrier);
-      bufferDependencies.insert_or_assign(handle, newDependency);
+      state = {newDependency, passIndex, bufferBarriers.size() - 1, false};
     }
 
     for (auto &input : pass.getBufferInputs()) {
@@ -315,7 +715,16 @@ void RenderGraph::buildBarriers() {
       auto newDependency =
           RenderGraphSyncDependency::getBufferRead(pass.getType(), input.usage);
 
-      auto oldDependency = bufferDependencies.at(handle);
+      auto &state = getBufferState(handle);
+      QuollAssert(state.dependency.has_value(),
+                  "Cannot read from unwritten buffer");
+
+      auto oldDependency = state.dependency.value();
+
+      if (state.read || state.barrierPass == passIndex) {
+        mergeBufferAccess(state, newDependency);
+        continue;
+      }
 
       rhi::BufferBarrier bufferBarrier{};
       bufferBarrier.buffer = handle;
@@ -325,22 +734,20 @@ void RenderGraph::buildBarriers() {
       bufferBarrier.dstStage = newDependency.stage;
       bufferBarriers.push_back(bufferBarrier);
 
-      bufferDependencies.insert_or_assign(handle, newDependency);
+      state = {newDependency, passIndex, bufferBarriers.size() - 1, true};
     }
 
-    pass.mDependencies.imageBarriers = imageBarriers;
-    pass.mDependencies.bufferBarriers = bufferBarriers;
-
     // Attachments
     for (usize i = 0; i < pass.mTextureOutputs.size(); ++i) {
       auto &output = pass.mTextureOutputs.at(i);
       auto &attachment = pass.mAttachments.at(i);
-      if (textureAttachmentLayouts.find(output.texture) ==
-          textureAttachmentLayouts.end()) {
+      auto root = rootIndices.at(output.texture.getIndex());
+      auto &layout = textureAttachmentLayouts.at(root);
+      if (!layout.has_value()) {
         output.srcLayout = rhi::ImageLayout::Undefined;
         attachment.loadOp = rhi::AttachmentLoadOp::Clear;
       } else {
-        output.srcLayout = textureAttachmentLayouts.at(output.texture);
+        output.srcLayout = layout.value();
         attachment.loadOp = rhi::AttachmentLoadOp::Load;
       }
 
@@ -353,8 +760,7 @@ void RenderGraph::buildBarriers() {
         output.dstLayout = rhi::ImageLayout::DepthStencilAttachmentOptimal;
       }
 
-      textureAttachmentLayouts.insert_or_assign(output.texture,
-                                                output.dstLayout);
+      layout = output.dstLayout;
     }
   }
 }
@@ -495,9 +901,15 @@ void RenderGraph::execute(rhi::RenderCommandList &commandList, u32 frameIndex) {
 
     mCompiledPassSpans.at(i).begin(commandList);
 
-    commandList.pipelineBarrier(pass.mDependencies.memoryBarriers,
-                                pass.mDependencies.imageBarriers,
-                                pass.mDependencies.bufferBarriers);
+    // All barriers of the pass are recorded in one call
+    const auto &dependencies = pass.mDependencies;
+    if (!dependencies.memoryBarriers.empty() ||
+        !dependencies.imageBarriers.empty() ||
+        !dependencies.bufferBarriers.empty()) {
+      commandList.pipelineBarrier(pass.mDependencies.memoryBarriers,
+                                  pass.mDependencies.imageBarriers,
+                                  pass.mDependencies.bufferBarriers);
+    }
 
     if (pass.getType() == RenderGraphPassType::Compute) {
       pass.execute(commandList, frameIndex);
@@ -516,9 +928,8 @@ void RenderGraph::execute(rhi::RenderCommandList &commandList, u32 frameIndex) {
 }
 
 void RenderGraph::build(RenderStorage &storage) {
-  buildResources(storage);
-
   compile();
+  buildResources(storage);
   buildBarriers();
   buildPasses(storage);
   buildTimestamps(storage.getMetricsCollector());
@@ -541,12 +952,16 @@ void RenderGraph::destroy(RenderStorage &storage) {
     }
   }
 
+  // Aliased textures share the same handle
+  std::set<rhi::TextureHandle> destroyedTextures;
   for (usize index = 0;
        index < mRegistry.getRealResources<rhi::TextureHandle>().size();
        ++index) {
+    auto handle = mRegistry.get<rhi::TextureHandle>(index);
     if (mRegistry.getResourceState<rhi::TextureHandle>(index) ==
-        RGResourceState::Transient) {
-      storage.destroyTexture(mRegistry.get<rhi::TextureHandle>(index));
+            RGResourceState::Transient &&
+        destroyedTextures.insert(handle).second) {
+      storage.destroyTexture(handle);
     }
   }
 
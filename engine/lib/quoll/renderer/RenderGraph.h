@@ -14,6 +14,34 @@ class MetricsCollector;
 
 enum class GraphDirty { None, PassChanges, SizeUpdate };
 
+/**
+ * @brief Transient memory stats of render graph
+ */
+struct RenderGraphMemoryStats {
+  /**
+   * Number of transient textures
+   */
+  usize numTransientTextures = 0;
+
+  /**
+   * Number of device textures that
+   * back transient textures
+   */
+  usize numDeviceTextures = 0;
+
+  /**
+   * Peak transient memory if every transient
+   * texture has its own device texture
+   */
+  usize peakMemory = 0;
+
+  /**
+   * Peak transient memory after textures
+   * with disjoint lifetimes are aliased
+   */
+  usize aliasedPeakMemory = 0;
+};
+
 class RenderGraph {
   using RGTexture = RenderGraphResource<rhi::TextureHandle>;
   using RGTextureCreator = std::function<rhi::TextureDescription(u32, u32)>;
@@ -24,6 +52,16 @@ class RenderGraph {
 
   enum class RGResourceType { Texture, Buffer };
 
+  /**
+   * Compiled pass indices of first and
+   * last use of a texture
+   */
+  struct RGTextureLifetime {
+    usize first = std::numeric_limits<usize>::max();
+
+    usize last = 0;
+  };
+
 public:
   RenderGraph(StringView name);
 
@@ -39,6 +77,19 @@ public:
 
   RGTexture import(rhi::TextureHandle handle);
 
+  /**
+   * @brief Mark texture as output of the graph
+   *
+   * Outputs are used outside of the graph; so,
+   * passes that write to them are never culled
+   * and their memory is never aliased. If no
+   * outputs are added, textures that are not
+   * read by other passes are treated as outputs.
+   *
+   * @param texture Render graph texture
+   */
+  void addOutput(RGTexture texture);
+
   void execute(rhi::RenderCommandList &commandList, u32 frameIndex);
 
   void build(RenderStorage &storage);
@@ -53,9 +104,24 @@ public:
 
   inline const String &getName() const { return mName; }
 
+  /**
+   * @brief Get transient memory stats
+   *
+   * @return Transient memory stats
+   */
+  inline const RenderGraphMemoryStats &getMemoryStats() const {
+    return mMemoryStats;
+  }
+
 private:
   void buildResources(RenderStorage &storage);
 
+  std::vector<RGTextureLifetime> getTextureLifetimes();
+
+  void aliasTextures(RenderStorage &storage);
+
+  usize getRootTextureIndex(usize index);
+
   void compile();
 
   void buildBarriers();
@@ -75,6 +141,16 @@ private:
   std::vector<RenderGraphPass> mPasses;
   std::vector<RenderGraphPass> mCompiledPasses;
   std::vector<GpuSpan> mCompiledPassSpans;
+
+  std::set<usize> mOutputs;
+
+  /**
+   * Index of texture whose device
+   * texture is shared by each texture
+   */
+  std::vector<usize> mTextureAliases;
+
+  RenderGraphMemoryStats mMemoryStats;
 };
 
 } // namespace quoll
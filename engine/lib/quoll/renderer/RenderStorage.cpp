@@ -111,6 +111,11 @@ rhi::ShaderHandle RenderStorage::getShader(const String &name) {
 }
 
 void RenderStorage::addToDescriptor(rhi::TextureHandle handle) {
+  addToDescriptor(handle, handle);
+}
+
+void RenderStorage::addToDescriptor(rhi::TextureHandle handle,
+                                    rhi::TextureHandle slot) {
   std::array<rhi::TextureHandle, 1> textures{handle};
 
   auto usage = mDevice->getTextureDescription(handle).usage;
@@ -118,13 +123,13 @@ void RenderStorage::addToDescriptor(rhi::TextureHandle handle) {
   if (BitwiseEnumContains(usage, rhi::TextureUsage::Sampled)) {
     mGlobalTexturesDescriptor.write(0, textures,
                                     rhi::DescriptorType::SampledImage,
-                                    rhi::castHandleToUint(handle));
+                                    rhi::castHandleToUint(slot));
   }
 
   if (BitwiseEnumContains(usage, rhi::TextureUsage::Storage)) {
     mGlobalTexturesDescriptor.write(2, textures,
                                     rhi::DescriptorType::StorageImage,
-                                    rhi::castHandleToUint(handle));
+                                    rhi::castHandleToUint(slot));
   }
 }
 
@@ -151,6 +156,10 @@ RenderStorage::createBuffer(const rhi::BufferDescription &description) {
   return mDevice->createBuffer(description);
 }
 
+void RenderStorage::destroyBuffer(rhi::BufferHandle handle) {
+  mDevice->destroyBuffer(handle);
+}
+
 rhi::PipelineHandle RenderStorage::addPipeline(
     const rhi::GraphicsPipelineDescription &description) {
   mPipelineDescriptions.push_back(description);
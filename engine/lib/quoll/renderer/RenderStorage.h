@@ -39,6 +39,17 @@ public:
 
   void addToDescriptor(rhi::TextureHandle handle);
 
+  /**
+   * @brief Add texture to descriptor slot of another texture
+   *
+   * Used for showing placeholders in place
+   * of textures whose data is not uploaded yet
+   *
+   * @param handle Texture that is added
+   * @param slot Texture whose slot is written
+   */
+  void addToDescriptor(rhi::TextureHandle handle, rhi::TextureHandle slot);
+
   void addToDescriptor(rhi::SamplerHandle handle);
 
   rhi::TextureHandle getNewTextureHandle();
@@ -49,6 +60,8 @@ public:
 
   rhi::Buffer createBuffer(const rhi::BufferDescription &description);
 
+  void destroyBuffer(rhi::BufferHandle handle);
+
   inline const rhi::Descriptor &getGlobalTexturesDescriptor() const {
     return mGlobalTexturesDescriptor;
   }
@@ -30,6 +30,8 @@ void Renderer::rebuildIfSettingsChanged() {
   mGraph.destroy(mRenderStorage);
   mGraph = RenderGraph("Main");
   auto res = mBuilderFn(mGraph, mOptions);
+  mGraph.addOutput(res.sceneTexture);
+  mGraph.addOutput(res.finalTexture);
   mGraph.build(mRenderStorage);
   mSceneTexture = res.sceneTexture;
   mFinalTexture = res.finalTexture;
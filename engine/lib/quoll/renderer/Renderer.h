@@ -50,6 +50,18 @@ public:
 
   constexpr debug::DebugPanel *getDebugPanel() { return &mDebugPanel; }
 
+  inline void setCullingStats(const FrustumCullingStats *stats) {
+    mDebugPanel.setCullingStats(stats);
+  }
+
+  inline void setUploadStats(const MeshInstanceUploadStats *stats) {
+    mDebugPanel.setUploadStats(stats);
+  }
+
+  inline void setResidencyStats(const RendererResidencyStats *stats) {
+    mDebugPanel.setResidencyStats(stats);
+  }
+
 private:
   RenderStorage &mRenderStorage;
 
@@ -1,20 +1,22 @@
 #include "quoll/core/Base.h"
+#include "quoll/core/Profiler.h"
+#include "quoll/rhi/RenderDevice.h"
 #include "quoll/rhi/TextureDescription.h"
 #include "MaterialPBR.h"
 #include "RenderStorage.h"
 #include "RendererAssetRegistry.h"
-#include "TextureUtils.h"
 
 namespace quoll {
 
 RendererAssetRegistry::RendererAssetRegistry(RenderStorage &storage)
-    : mStorage(storage) {}
+    : mStorage(storage), mTextureUploads(storage) {}
 
 rhi::TextureHandle
 RendererAssetRegistry::get(const AssetRef<TextureAsset> &asset) {
   auto it = mTextures.find(asset.handle());
   if (it != mTextures.end()) {
-    return it->second;
+    it->second.lastUsed.store(mFrame, std::memory_order_relaxed);
+    return it->second.resource;
   }
 
   const auto &texture = asset.get();
@@ -33,12 +35,12 @@ RendererAssetRegistry::get(const AssetRef<TextureAsset> &asset) {
   description.format = texture.format;
   description.debugName = asset.meta().name;
 
-  auto handle = mStorage.createTexture(description);
-  TextureUtils::copyDataToTexture(
-      mStorage.getDevice(), texture.data.data(), handle,
-      rhi::ImageLayout::ShaderReadOnlyOptimal, texture.layers, texture.levels);
+  auto handle = mStorage.createTexture(description, false);
+  mTextureUploads.enqueue(handle, texture.data.data(),
+                          rhi::ImageLayout::ShaderReadOnlyOptimal,
+                          texture.layers, texture.levels);
 
-  mTextures.insert_or_assign(asset.handle(), handle);
+  insert(mTextures, asset, handle, texture.data.size());
 
   return handle;
 }
@@ -46,7 +48,8 @@ RendererAssetRegistry::get(const AssetRef<TextureAsset> &asset) {
 Material *RendererAssetRegistry::get(const AssetRef<MaterialAsset> &asset) {
   auto it = mMaterials.find(asset.handle());
   if (it != mMaterials.end()) {
-    return it->second.get();
+    it->second.lastUsed.store(mFrame, std::memory_order_relaxed);
+    return it->second.resource.get();
   }
 
   auto getTextureFromRegistry = [this](const AssetRef<TextureAsset> &texture) {
@@ -84,8 +87,7 @@ Material *RendererAssetRegistry::get(const AssetRef<MaterialAsset> &asset) {
 
   auto *deviceObject = new MaterialPBR(asset.meta().name, properties, mStorage);
 
-  mMaterials.insert_or_assign(asset.handle(),
-                              std::unique_ptr<Material>(deviceObject));
+  insert(mMaterials, asset, std::unique_ptr<Material>(deviceObject), 0);
 
   return deviceObject;
 }
@@ -94,65 +96,69 @@ const MeshDrawData &
 RendererAssetRegistry::get(const AssetRef<MeshAsset> &asset) {
   auto it = mMeshBuffers.find(asset.handle());
   if (it != mMeshBuffers.end()) {
-    return it->second;
+    it->second.lastUsed.store(mFrame, std::memory_order_relaxed);
+    return it->second.resource;
   }
 
   const auto &mesh = asset.get();
-
-  usize ibSize = 0;
-  for (auto &g : mesh.geometries) {
-    ibSize += g.indices.size() * sizeof(u32);
-  }
+  const auto &layout = mesh.vertexLayout;
 
   MeshDrawData drawData{};
+  drawData.vertexLayout = layout;
 
+  usize numVertices = 0;
+  usize numIndices = 0;
+  bool skinned = false;
   for (auto &g : mesh.geometries) {
     drawData.geometries.push_back(
         {.numVertices = static_cast<u32>(g.positions.size()),
-         .numIndices = static_cast<u32>(g.indices.size())});
-  }
+         .numIndices = static_cast<u32>(g.indices.size()),
+         .bounds = g.bounds});
 
-// NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
-#define CreateBuffer(FieldName, Type)                                          \
-  {                                                                            \
-    usize vbSize = 0;                                                          \
-    for (auto &g : mesh.geometries) {                                          \
-      const usize vertexSize = g.FieldName.size();                             \
-      vbSize += vertexSize * sizeof(Type);                                     \
-    }                                                                          \
-                                                                               \
-    if (vbSize > 0) {                                                          \
-      rhi::BufferDescription description;                                      \
-      description.usage = rhi::BufferUsage::Vertex;                            \
-      description.size = vbSize;                                               \
-      description.data = nullptr;                                              \
-      description.debugName = asset.meta().name + " " #FieldName;              \
-      auto buffer = mStorage.createBuffer(description);                        \
-      auto *data = static_cast<Type *>(buffer.map());                          \
-      drawData.vertexBufferOffsets.push_back(0);                               \
-      usize offset = 0;                                                        \
-      for (auto &g : mesh.geometries) {                                        \
-        memcpy(data + offset, g.FieldName.data(),                              \
-               g.FieldName.size() * sizeof(Type));                             \
-        offset += g.FieldName.size();                                          \
-      }                                                                        \
-      buffer.unmap();                                                          \
-      drawData.vertexBuffers.push_back(buffer.getHandle());                    \
-    }                                                                          \
+    numVertices += g.positions.size();
+    numIndices += g.indices.size();
+    skinned = skinned || !g.joints.empty();
   }
 
-  CreateBuffer(positions, glm::vec3);
-  CreateBuffer(normals, glm::vec3);
-  CreateBuffer(tangents, glm::vec4);
-  CreateBuffer(texCoords0, glm::vec2);
-  CreateBuffer(texCoords1, glm::vec2);
-  CreateBuffer(joints, glm::uvec4);
-  CreateBuffer(weights, glm::vec4);
+  usize size = 0;
+
+  auto createVertexStream = [&](usize stride, StringView name,
+                                auto &&writeGeometry) {
+    rhi::BufferDescription description;
+    description.usage = rhi::BufferUsage::Vertex;
+    description.size = numVertices * stride;
+    description.data = nullptr;
+    description.debugName = asset.meta().name + " " + String(name);
+    auto buffer = mStorage.createBuffer(description);
+
+    auto *data = static_cast<u8 *>(buffer.map());
+    for (auto &g : mesh.geometries) {
+      writeGeometry(g, data);
+      data += g.positions.size() * stride;
+    }
+    buffer.unmap();
+
+    drawData.vertexBuffers.push_back(buffer.getHandle());
+    drawData.vertexBufferOffsets.push_back(0);
+    size += description.size;
+  };
+
+  createVertexStream(MeshVertexLayout::PositionStride, "positions",
+                     MeshVertexLayout::writePositions);
+  createVertexStream(layout.getAttributeStride(), "attributes",
+                     [&layout](const BaseGeometryAsset &g, u8 *data) {
+                       layout.writeAttributes(g, data);
+                     });
+
+  if (skinned) {
+    createVertexStream(MeshVertexLayout::SkinStride, "skin",
+                       MeshVertexLayout::writeSkin);
+  }
 
   {
     rhi::BufferDescription description;
     description.usage = rhi::BufferUsage::Index;
-    description.size = ibSize;
+    description.size = numIndices * sizeof(u32);
     description.data = nullptr;
     description.debugName = asset.meta().name + " indices";
 
@@ -168,18 +174,40 @@ RendererAssetRegistry::get(const AssetRef<MeshAsset> &asset) {
     buffer.unmap();
 
     drawData.indexBuffer = buffer.getHandle();
+    size += description.size;
   }
 
-  mMeshBuffers.insert_or_assign(asset.handle(), std::move(drawData));
+  return insert(mMeshBuffers, asset, std::move(drawData), size).resource;
+}
+
+const Material *
+RendererAssetRegistry::find(const AssetRef<MaterialAsset> &asset) const {
+  auto it = mMaterials.find(asset.handle());
+  if (it == mMaterials.end()) {
+    return nullptr;
+  }
+
+  it->second.lastUsed.store(mFrame, std::memory_order_relaxed);
+  return it->second.resource.get();
+}
+
+const MeshDrawData *
+RendererAssetRegistry::find(const AssetRef<MeshAsset> &asset) const {
+  auto it = mMeshBuffers.find(asset.handle());
+  if (it == mMeshBuffers.end()) {
+    return nullptr;
+  }
 
-  return mMeshBuffers.at(asset.handle());
+  it->second.lastUsed.store(mFrame, std::memory_order_relaxed);
+  return &it->second.resource;
 }
 
 rhi::TextureHandle
 RendererAssetRegistry::get(const AssetRef<FontAsset> &asset) {
   auto it = mFontAtlases.find(asset.handle());
   if (it != mFontAtlases.end()) {
-    return it->second;
+    it->second.lastUsed.store(mFrame, std::memory_order_relaxed);
+    return it->second.resource;
   }
 
   const auto &font = asset.get();
@@ -193,15 +221,173 @@ RendererAssetRegistry::get(const AssetRef<FontAsset> &asset) {
   description.format = rhi::Format::Rgba8Unorm;
   description.debugName = asset.meta().name;
 
-  auto handle = mStorage.createTexture(description);
-  mFontAtlases.insert_or_assign(asset.handle(), handle);
+  auto handle = mStorage.createTexture(description, false);
+  insert(mFontAtlases, asset, handle, font.atlasBytes.size());
 
-  TextureUtils::copyDataToTexture(
-      mStorage.getDevice(), font.atlasBytes.data(), handle,
-      rhi::ImageLayout::ShaderReadOnlyOptimal, 1,
-      {{0, font.size, font.atlasDimensions.x, font.atlasDimensions.y}});
+  mTextureUploads.enqueue(
+      handle, font.atlasBytes.data(), rhi::ImageLayout::ShaderReadOnlyOptimal,
+      1, {{0, font.size, font.atlasDimensions.x, font.atlasDimensions.y}});
 
   return handle;
 }
 
+void RendererAssetRegistry::update(rhi::RenderCommandList &commandList,
+                                   u32 frameIndex) {
+  QUOLL_PROFILE_EVENT("RendererAssetRegistry::update");
+
+  destroyRetired();
+  evict();
+  mTextureUploads.record(commandList, frameIndex);
+
+  mFrame++;
+}
+
+void RendererAssetRegistry::setMemoryBudget(usize budget) {
+  mStats.memoryBudget = budget;
+}
+
+template <class TAssetData, class TResource>
+RendererAssetRegistry::Entry<TAssetData, TResource> &
+RendererAssetRegistry::insert(EntryMap<TAssetData, TResource> &entries,
+                              const AssetRef<TAssetData> &asset,
+                              TResource resource, usize size) {
+  // Entries are not movable because of the atomic
+  auto &entry = entries.try_emplace(asset.handle()).first->second;
+  entry.resource = std::move(resource);
+  entry.size = size;
+  entry.map = asset.map();
+  entry.lastUsed.store(mFrame, std::memory_order_relaxed);
+
+  mStats.memoryUsage += size;
+  mStats.numResident++;
+
+  return entry;
+}
+
+void RendererAssetRegistry::evict() {
+  if (mStats.memoryUsage <= mStats.memoryBudget) {
+    return;
+  }
+
+  enum class Kind { Texture, Material, Mesh, Font };
+
+  struct Candidate {
+    u64 lastUsed = 0;
+    Kind kind = Kind::Texture;
+    AssetHandleType handle = 0;
+  };
+
+  std::vector<Candidate> candidates;
+
+  // Resources that are used in the current frame or
+  // whose assets are still referenced are never evicted
+  auto collect = [this, &candidates](const auto &entries, Kind kind) {
+    for (const auto &[handle, entry] : entries) {
+      const auto lastUsed = entry.lastUsed.load(std::memory_order_relaxed);
+      const bool referenced = entry.map && entry.map->contains(handle) &&
+                              entry.map->getRefCount(handle) > 0;
+
+      if (!referenced && lastUsed != mFrame) {
+        candidates.push_back({lastUsed, kind, handle.getRawId()});
+      }
+    }
+  };
+
+  collect(mTextures, Kind::Texture);
+  collect(mMaterials, Kind::Material);
+  collect(mMeshBuffers, Kind::Mesh);
+  collect(mFontAtlases, Kind::Font);
+
+  std::sort(candidates.begin(), candidates.end(),
+            [](const Candidate &a, const Candidate &b) {
+              return a.lastUsed < b.lastUsed;
+            });
+
+  auto erase = [this](auto &entries, auto handle) {
+    auto it = entries.find(handle);
+    mStats.memoryUsage -= it->second.size;
+    mStats.numResident--;
+    mStats.numEvicted++;
+
+    auto resource = std::move(it->second.resource);
+    entries.erase(it);
+    return resource;
+  };
+
+  for (const auto &candidate : candidates) {
+    if (mStats.memoryUsage <= mStats.memoryBudget) {
+      break;
+    }
+
+    switch (candidate.kind) {
+    case Kind::Texture:
+    case Kind::Font: {
+      auto texture =
+          candidate.kind == Kind::Texture
+              ? erase(mTextures, AssetHandle<TextureAsset>(candidate.handle))
+              : erase(mFontAtlases, AssetHandle<FontAsset>(candidate.handle));
+      mTextureUploads.cancel(texture);
+      retire(texture);
+      break;
+    }
+    case Kind::Material: {
+      auto material =
+          erase(mMaterials, AssetHandle<MaterialAsset>(candidate.handle));
+      if (material->getBuffer() != rhi::BufferHandle::Null) {
+        retire(material->getBuffer());
+      }
+      break;
+    }
+    case Kind::Mesh: {
+      auto drawData =
+          erase(mMeshBuffers, AssetHandle<MeshAsset>(candidate.handle));
+      for (auto buffer : drawData.vertexBuffers) {
+        retire(buffer);
+      }
+
+      if (drawData.indexBuffer != rhi::BufferHandle::Null) {
+        retire(drawData.indexBuffer);
+      }
+      break;
+    }
+    }
+  }
+}
+
+void RendererAssetRegistry::destroyRetired() {
+  // Frames in flight can still use evicted resources
+  // until all frame indices are recorded again
+  auto isRetired = [this](const auto &retired) {
+    return retired.frame + rhi::RenderDevice::NumFrames <= mFrame;
+  };
+
+  std::erase_if(mRetiredTextures, [&](const RetiredTexture &retired) {
+    if (isRetired(retired)) {
+      mStorage.destroyTexture(retired.handle);
+      return true;
+    }
+    return false;
+  });
+
+  std::erase_if(mRetiredBuffers, [&](const RetiredBuffer &retired) {
+    if (isRetired(retired)) {
+      mStorage.destroyBuffer(retired.handle);
+      return true;
+    }
+    return false;
+  });
+
+  mStats.numRetired = mRetiredTextures.size() + mRetiredBuffers.size();
+}
+
+void RendererAssetRegistry::retire(rhi::TextureHandle handle) {
+  mRetiredTextures.push_back({mFrame, handle});
+  mStats.numRetired++;
+}
+
+void RendererAssetRegistry::retire(rhi::BufferHandle handle) {
+  mRetiredBuffers.push_back({mFrame, handle});
+  mStats.numRetired++;
+}
+
 } // namespace quoll
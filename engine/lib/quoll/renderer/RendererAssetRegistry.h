@@ -7,15 +7,107 @@
 #include "MeshAsset.h"
 #include "MeshDrawData.h"
 #include "TextureAsset.h"
+#include "TextureUploadQueue.h"
 
 namespace quoll {
 
 class RenderStorage;
 
+/**
+ * @brief Residency stats of renderer assets
+ */
+struct RendererResidencyStats {
+  /**
+   * Memory budget of device resources
+   */
+  usize memoryBudget = 0;
+
+  /**
+   * Memory used by device resources
+   */
+  usize memoryUsage = 0;
+
+  /**
+   * Number of resident assets
+   */
+  usize numResident = 0;
+
+  /**
+   * Number of evicted assets
+   */
+  usize numEvicted = 0;
+
+  /**
+   * Number of device resources waiting
+   * to be destroyed
+   */
+  usize numRetired = 0;
+};
+
 class RendererAssetRegistry {
+  /**
+   * @brief Device resource of an asset
+   *
+   * @tparam TAssetData Asset data
+   * @tparam TResource Device resource
+   */
+  template <class TAssetData, class TResource> struct Entry {
+    TResource resource{};
+
+    /**
+     * Size of device memory
+     */
+    usize size = 0;
+
+    /**
+     * Asset map that counts asset references
+     */
+    const AssetMap<TAssetData> *map = nullptr;
+
+    /**
+     * Last frame the resource is used in
+     *
+     * Updated by lookups that can run on
+     * multiple threads at the same time
+     */
+    mutable std::atomic<u64> lastUsed{0};
+  };
+
+  template <class TAssetData, class TResource>
+  using EntryMap = std::unordered_map<AssetHandle<TAssetData>,
+                                      Entry<TAssetData, TResource>>;
+
+  struct RetiredTexture {
+    u64 frame = 0;
+
+    rhi::TextureHandle handle = rhi::TextureHandle::Null;
+  };
+
+  struct RetiredBuffer {
+    u64 frame = 0;
+
+    rhi::BufferHandle handle = rhi::BufferHandle::Null;
+  };
+
+public:
+  /**
+   * Default memory budget of device resources
+   */
+  static constexpr usize DefaultMemoryBudget = 1024ull * 1024 * 1024;
+
 public:
   RendererAssetRegistry(RenderStorage &storage);
 
+  /**
+   * @brief Get texture
+   *
+   * Texture data is uploaded asynchronously. Placeholder
+   * texture is shown in place of the texture until
+   * its upload is recorded.
+   *
+   * @param asset Texture asset
+   * @return Texture handle
+   */
   rhi::TextureHandle get(const AssetRef<TextureAsset> &asset);
 
   Material *get(const AssetRef<MaterialAsset> &asset);
@@ -24,14 +116,99 @@ public:
 
   rhi::TextureHandle get(const AssetRef<FontAsset> &asset);
 
+  /**
+   * @brief Find material without creating it
+   *
+   * Does not modify the registry; so, it can
+   * be called from multiple threads at the same time
+   *
+   * @param asset Material asset
+   * @return Material or null if material is not created yet
+   */
+  const Material *find(const AssetRef<MaterialAsset> &asset) const;
+
+  /**
+   * @brief Find mesh draw data without creating it
+   *
+   * Does not modify the registry; so, it can
+   * be called from multiple threads at the same time
+   *
+   * @param asset Mesh asset
+   * @return Draw data or null if mesh is not uploaded yet
+   */
+  const MeshDrawData *find(const AssetRef<MeshAsset> &asset) const;
+
+  /**
+   * @brief Update registry for the frame
+   *
+   * Destroys evicted resources that are not used
+   * by frames in flight anymore, evicts least recently
+   * used resources of unreferenced assets while memory
+   * usage is over budget, and records queued texture
+   * uploads. Called once per frame after frame data is
+   * updated and before the frame's render passes
+   * are recorded.
+   *
+   * @param commandList Frame command list
+   * @param frameIndex Frame index
+   */
+  void update(rhi::RenderCommandList &commandList, u32 frameIndex);
+
+  /**
+   * @brief Set memory budget
+   *
+   * Budget is soft. Resources of referenced
+   * assets are never evicted.
+   *
+   * @param budget Memory budget in bytes
+   */
+  void setMemoryBudget(usize budget);
+
+  /**
+   * @brief Get residency stats
+   *
+   * @return Residency stats
+   */
+  inline const RendererResidencyStats &getResidencyStats() const {
+    return mStats;
+  }
+
+  /**
+   * @brief Get texture upload queue
+   *
+   * @return Texture upload queue
+   */
+  inline TextureUploadQueue &getTextureUploads() { return mTextureUploads; }
+
+private:
+  template <class TAssetData, class TResource>
+  Entry<TAssetData, TResource> &
+  insert(EntryMap<TAssetData, TResource> &entries,
+         const AssetRef<TAssetData> &asset, TResource resource, usize size);
+
+  void evict();
+
+  void destroyRetired();
+
+  void retire(rhi::TextureHandle handle);
+
+  void retire(rhi::BufferHandle handle);
+
 private:
   RenderStorage &mStorage;
 
-  std::unordered_map<AssetHandle<TextureAsset>, rhi::TextureHandle> mTextures;
-  std::unordered_map<AssetHandle<MaterialAsset>, std::unique_ptr<Material>>
-      mMaterials;
-  std::unordered_map<AssetHandle<MeshAsset>, MeshDrawData> mMeshBuffers;
-  std::unordered_map<AssetHandle<FontAsset>, rhi::TextureHandle> mFontAtlases;
+  TextureUploadQueue mTextureUploads;
+
+  EntryMap<TextureAsset, rhi::TextureHandle> mTextures;
+  EntryMap<MaterialAsset, std::unique_ptr<Material>> mMaterials;
+  EntryMap<MeshAsset, MeshDrawData> mMeshBuffers;
+  EntryMap<FontAsset, rhi::TextureHandle> mFontAtlases;
+
+  u64 mFrame = 1;
+  std::vector<RetiredTexture> mRetiredTextures;
+  std::vector<RetiredBuffer> mRetiredBuffers;
+
+  RendererResidencyStats mStats{.memoryBudget = DefaultMemoryBudget};
 };
 
 } // namespace quoll
@@ -20,6 +20,19 @@ void renderTableRow(StringView header, StringView value) {
 RendererDebugPanel::RendererDebugPanel(rhi::RenderDevice *device)
     : mDevice(device) {}
 
+void RendererDebugPanel::setCullingStats(const FrustumCullingStats *stats) {
+  mCullingStats = stats;
+}
+
+void RendererDebugPanel::setUploadStats(const MeshInstanceUploadStats *stats) {
+  mUploadStats = stats;
+}
+
+void RendererDebugPanel::setResidencyStats(
+    const RendererResidencyStats *stats) {
+  mResidencyStats = stats;
+}
+
 void RendererDebugPanel::onRenderMenu() {
   ImGui::MenuItem("Physical Device Information", nullptr,
                   &mPhysicalDeviceInfoOpen);
@@ -111,6 +124,42 @@ void RendererDebugPanel::renderUsageMetrics() {
           std::to_string(
               deviceStats.getResourceMetrics()->getDescriptorsCount()));
 
+      // Culling
+      if (mCullingStats) {
+        renderTableRow("Number of visible mesh instances",
+                       std::to_string(mCullingStats->visibleInstances));
+        renderTableRow("Number of culled mesh instances",
+                       std::to_string(mCullingStats->culledInstances));
+        renderTableRow("Number of visible geometries",
+                       std::to_string(mCullingStats->visibleGeometries));
+        renderTableRow("Number of culled geometries",
+                       std::to_string(mCullingStats->culledGeometries));
+      }
+
+      // Mesh instance uploads
+      if (mUploadStats) {
+        renderTableRow("Number of mesh instances",
+                       std::to_string(mUploadStats->numInstances));
+        renderTableRow("Number of uploaded mesh instances",
+                       std::to_string(mUploadStats->uploadedInstances));
+        renderTableRow("Uploaded mesh instance bytes",
+                       std::to_string(mUploadStats->uploadedBytes));
+      }
+
+      // Asset residency
+      if (mResidencyStats) {
+        renderTableRow("Asset memory budget",
+                       getSizeString(mResidencyStats->memoryBudget));
+        renderTableRow("Asset memory usage",
+                       getSizeString(mResidencyStats->memoryUsage));
+        renderTableRow("Number of resident assets",
+                       std::to_string(mResidencyStats->numResident));
+        renderTableRow("Number of evicted assets",
+                       std::to_string(mResidencyStats->numEvicted));
+        renderTableRow("Number of retired resources",
+                       std::to_string(mResidencyStats->numRetired));
+      }
+
       ImGui::EndTable();
     }
 
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "quoll/profiler/DebugPanel.h"
+#include "FrustumCulling.h"
+#include "MeshInstanceTable.h"
+#include "RendererAssetRegistry.h"
 
 namespace quoll::rhi {
 
@@ -18,6 +21,27 @@ public:
 
   void onRender() override;
 
+  /**
+   * @brief Set culling stats to display
+   *
+   * @param stats Culling stats of scene renderer
+   */
+  void setCullingStats(const FrustumCullingStats *stats);
+
+  /**
+   * @brief Set mesh instance upload stats to display
+   *
+   * @param stats Upload stats of scene renderer
+   */
+  void setUploadStats(const MeshInstanceUploadStats *stats);
+
+  /**
+   * @brief Set residency stats to display
+   *
+   * @param stats Residency stats of renderer asset registry
+   */
+  void setResidencyStats(const RendererResidencyStats *stats);
+
 private:
   void renderPhysicalDeviceInfo();
 
@@ -25,6 +49,9 @@ private:
 
 private:
   rhi::RenderDevice *mDevice;
+  const FrustumCullingStats *mCullingStats = nullptr;
+  const MeshInstanceUploadStats *mUploadStats = nullptr;
+  const RendererResidencyStats *mResidencyStats = nullptr;
 
   bool mPhysicalDeviceInfoOpen = false;
   bool mUsageMetricsOpen = false;
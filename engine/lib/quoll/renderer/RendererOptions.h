@@ -3,7 +3,24 @@
 namespace quoll {
 
 struct RendererOptions {
+  static constexpr usize DefaultInstanceCapacity = 1024;
+
   glm::uvec2 framebufferSize;
+
+  /**
+   * Initial number of instances that
+   * frame buffers are allocated for
+   *
+   * Buffers grow when more instances
+   * are rendered
+   */
+  usize instanceCapacity = DefaultInstanceCapacity;
+
+  /**
+   * Shrink frame buffers when
+   * most of them is unused
+   */
+  bool shrinkBuffers = true;
 };
 
 } // namespace quoll
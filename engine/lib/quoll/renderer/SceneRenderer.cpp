@@ -4,6 +4,7 @@
 #include "quoll/asset/AssetRegistry.h"
 #include "quoll/scene/EnvironmentLighting.h"
 #include "quoll/scene/EnvironmentSkybox.h"
+#include "quoll/scene/SpatialIndex.h"
 #include "quoll/scene/Sprite.h"
 #include "quoll/skeleton/Skeleton.h"
 #include "quoll/text/Text.h"
@@ -18,13 +19,39 @@
 
 namespace quoll {
 
+namespace {
+
+/**
+ * @brief Draw range of mesh draw commands
+ *
+ * @param commandList Render command list
+ * @param frameData Frame data
+ * @param draw Draw range
+ */
+void drawMeshes(rhi::RenderCommandList &commandList,
+                const SceneRendererFrameData &frameData,
+                const SceneRendererFrameData::DrawRange &draw) {
+  commandList.drawIndexedIndirect(frameData.getDrawCommandsBufferHandle(),
+                                  draw.firstDraw * sizeof(MeshDrawCommand),
+                                  draw.numDraws, sizeof(MeshDrawCommand));
+}
+
+} // namespace
+
 SceneRenderer::SceneRenderer(AssetRegistry &assetRegistry,
                              RenderStorage &renderStorage,
-                             RendererAssetRegistry &rendererAssetRegistry)
+                             RendererAssetRegistry &rendererAssetRegistry,
+                             const RendererOptions &options)
     : mAssetRegistry(assetRegistry), mRenderStorage(renderStorage),
-      mFrameData{SceneRendererFrameData(renderStorage),
-                 SceneRendererFrameData(renderStorage)},
-      mRendererAssetRegistry(rendererAssetRegistry) {
+      mFrameData{SceneRendererFrameData(renderStorage,
+                                        options.instanceCapacity,
+                                        options.shrinkBuffers),
+                 SceneRendererFrameData(renderStorage,
+                                        options.instanceCapacity,
+                                        options.shrinkBuffers)},
+      mRendererAssetRegistry(rendererAssetRegistry),
+      mMeshGatherBuffers(Engine::getThreadPool()),
+      mSkinnedMeshGatherBuffers(Engine::getThreadPool()) {
 
   auto shadersPath = Engine::getShadersPath();
 
@@ -175,17 +202,21 @@ SceneRenderPassData SceneRenderer::attach(RenderGraph &graph,
     struct ShadowDrawParams {
       rhi::DeviceAddress meshTransforms;
       rhi::DeviceAddress skinnedMeshTransforms;
-      rhi::DeviceAddress skeletonTransforms;
+      rhi::DeviceAddress skinnedMeshJoints;
+      rhi::DeviceAddress joints;
       rhi::DeviceAddress shadows;
     };
 
     usize shadowDrawOffset = 0;
     for (auto &frameData : mFrameData) {
       shadowDrawOffset =
-          frameData.getBindlessParams().addRange(ShadowDrawParams{
-              frameData.getMeshTransformsBuffer(),
-              frameData.getSkinnedMeshTransformsBuffer(),
-              frameData.getSkeletonsBuffer(), frameData.getShadowMapsBuffer()});
+          frameData.getBindlessParams().addDynamicRange([&frameData] {
+            return ShadowDrawParams{frameData.getMeshTransformsBuffer(),
+                                    frameData.getSkinnedMeshTransformsBuffer(),
+                                    frameData.getSkinnedMeshJointsBuffer(),
+                                    frameData.getJointPaletteBuffer(),
+                                    frameData.getShadowMapsBuffer()};
+          });
     }
 
     auto &pass = graph.addGraphicsPass("shadowPass");
@@ -240,7 +271,8 @@ SceneRenderPassData SceneRenderer::attach(RenderGraph &graph,
           commandList.pushConstants(pipeline, rhi::ShaderStage::Vertex, 0,
                                     sizeof(u32), &index);
 
-          renderShadowsMesh(commandList, pipeline, frameIndex);
+          renderShadowsMesh(commandList, pipeline, frameIndex,
+                            static_cast<u32>(index));
         }
       }
 
@@ -257,7 +289,8 @@ SceneRenderPassData SceneRenderer::attach(RenderGraph &graph,
           commandList.pushConstants(pipeline, rhi::ShaderStage::Vertex, 0,
                                     sizeof(u32), &index);
 
-          renderShadowsSkinnedMesh(commandList, skinnedPipeline, frameIndex);
+          renderShadowsSkinnedMesh(commandList, skinnedPipeline, frameIndex,
+                                   static_cast<u32>(index));
         }
       }
     });
@@ -270,7 +303,8 @@ SceneRenderPassData SceneRenderer::attach(RenderGraph &graph,
       rhi::DeviceAddress meshMaterials;
       rhi::DeviceAddress skinnedMeshTransforms;
       rhi::DeviceAddress skinnedMeshMaterials;
-      rhi::DeviceAddress skeletonTransforms;
+      rhi::DeviceAddress skinnedMeshJoints;
+      rhi::DeviceAddress joints;
       rhi::DeviceAddress camera;
       rhi::DeviceAddress scene;
       rhi::DeviceAddress directionalLights;
@@ -281,16 +315,23 @@ SceneRenderPassData SceneRenderer::attach(RenderGraph &graph,
 
     usize pbrOffset = 0;
     for (auto &frameData : mFrameData) {
-      pbrOffset = frameData.getBindlessParams().addRange(MeshDrawParams{
-          frameData.getFlattenedMaterialsBuffer(),
-          frameData.getMeshTransformsBuffer(),
-          frameData.getMeshMaterialsBuffer(),
-          frameData.getSkinnedMeshTransformsBuffer(),
-          frameData.getSkinnedMeshMaterialsBuffer(),
-          frameData.getSkeletonsBuffer(), frameData.getCameraBuffer(),
-          frameData.getSceneBuffer(), frameData.getDirectionalLightsBuffer(),
-          frameData.getPointLightsBuffer(), frameData.getShadowMapsBuffer(),
-          mRenderStorage.getDefaultSampler()});
+      pbrOffset =
+          frameData.getBindlessParams().addDynamicRange([&frameData, this] {
+            return MeshDrawParams{
+                frameData.getFlattenedMaterialsBuffer(),
+                frameData.getMeshTransformsBuffer(),
+                frameData.getMeshMaterialsBuffer(),
+                frameData.getSkinnedMeshTransformsBuffer(),
+                frameData.getSkinnedMeshMaterialsBuffer(),
+                frameData.getSkinnedMeshJointsBuffer(),
+                frameData.getJointPaletteBuffer(),
+                frameData.getCameraBuffer(),
+                frameData.getSceneBuffer(),
+                frameData.getDirectionalLightsBuffer(),
+                frameData.getPointLightsBuffer(),
+                frameData.getShadowMapsBuffer(),
+                mRenderStorage.getDefaultSampler()};
+          });
     }
 
     auto &pass = graph.addGraphicsPass("meshPass");
@@ -300,44 +341,59 @@ SceneRenderPassData SceneRenderer::attach(RenderGraph &graph,
                rhi::DepthStencilClear{1.0, 0});
     pass.write(sceneColorResolved, AttachmentType::Resolve, mClearColor);
 
-    auto pipeline = mRenderStorage.addPipeline(rhi::GraphicsPipelineDescription{
-        mRenderStorage.getShader("__engine.geometry.default.vertex"),
-        mRenderStorage.getShader("__engine.pbr.default.fragment"),
-        createMeshVertexLayout(),
-        rhi::PipelineInputAssembly{rhi::PrimitiveTopology::TriangleList},
-        rhi::PipelineRasterizer{rhi::PolygonMode::Fill, rhi::CullMode::None,
-                                rhi::FrontFace::Clockwise},
-        rhi::PipelineColorBlend{{rhi::PipelineColorBlendAttachment{}}},
-        {},
-        rhi::PipelineMultisample{0},
-        "mesh"});
-
-    auto skinnedPipeline =
-        mRenderStorage.addPipeline(rhi::GraphicsPipelineDescription{
-            mRenderStorage.getShader("__engine.geometry.skinned.vertex"),
-            mRenderStorage.getShader("__engine.pbr.default.fragment"),
-            createSkinnedMeshVertexLayout(),
-            rhi::PipelineInputAssembly{rhi::PrimitiveTopology::TriangleList},
-            rhi::PipelineRasterizer{rhi::PolygonMode::Fill, rhi::CullMode::None,
-                                    rhi::FrontFace::Clockwise},
-            rhi::PipelineColorBlend{{rhi::PipelineColorBlendAttachment{}}},
-            {},
-            rhi::PipelineMultisample{0},
-            "skinned mesh"});
-
-    pass.addPipeline(pipeline);
-    pass.addPipeline(skinnedPipeline);
+    // Meshes with different vertex layouts are
+    // drawn with their own pipelines
+    std::array<rhi::PipelineHandle, MeshVertexLayout::NumVariants> pipelines{};
+    std::array<rhi::PipelineHandle, MeshVertexLayout::NumVariants>
+        skinnedPipelines{};
+
+    for (usize variant = 0; variant < MeshVertexLayout::NumVariants;
+         ++variant) {
+      const auto layout = MeshVertexLayout::fromVariant(variant);
+
+      pipelines.at(variant) =
+          mRenderStorage.addPipeline(rhi::GraphicsPipelineDescription{
+              mRenderStorage.getShader("__engine.geometry.default.vertex"),
+              mRenderStorage.getShader("__engine.pbr.default.fragment"),
+              createMeshVertexLayout(layout),
+              rhi::PipelineInputAssembly{rhi::PrimitiveTopology::TriangleList},
+              rhi::PipelineRasterizer{rhi::PolygonMode::Fill,
+                                      rhi::CullMode::None,
+                                      rhi::FrontFace::Clockwise},
+              rhi::PipelineColorBlend{{rhi::PipelineColorBlendAttachment{}}},
+              {},
+              rhi::PipelineMultisample{0},
+              "mesh"});
+
+      skinnedPipelines.at(variant) =
+          mRenderStorage.addPipeline(rhi::GraphicsPipelineDescription{
+              mRenderStorage.getShader("__engine.geometry.skinned.vertex"),
+              mRenderStorage.getShader("__engine.pbr.default.fragment"),
+              createSkinnedMeshVertexLayout(layout),
+              rhi::PipelineInputAssembly{rhi::PrimitiveTopology::TriangleList},
+              rhi::PipelineRasterizer{rhi::PolygonMode::Fill,
+                                      rhi::CullMode::None,
+                                      rhi::FrontFace::Clockwise},
+              rhi::PipelineColorBlend{{rhi::PipelineColorBlendAttachment{}}},
+              {},
+              rhi::PipelineMultisample{0},
+              "skinned mesh"});
+
+      pass.addPipeline(pipelines.at(variant));
+      pass.addPipeline(skinnedPipelines.at(variant));
+    }
 
-    pass.setExecutor([this, pipeline, skinnedPipeline, pbrOffset, shadowmap](
-                         rhi::RenderCommandList &commandList, u32 frameIndex) {
+    pass.setExecutor([this, pipelines, skinnedPipelines, pbrOffset,
+                      shadowmap](rhi::RenderCommandList &commandList,
+                                 u32 frameIndex) {
       auto &frameData = mFrameData.at(frameIndex);
 
-      commandList.bindPipeline(pipeline);
-
       std::array<u32, 1> offsets{static_cast<u32>(pbrOffset)};
-      {
+      for (usize variant = 0; variant < MeshVertexLayout::NumVariants;
+           ++variant) {
         QUOLL_PROFILE_EVENT("meshPass::meshes");
 
+        auto pipeline = pipelines.at(variant);
         commandList.bindPipeline(pipeline);
         commandList.bindDescriptor(
             pipeline, 0, mRenderStorage.getGlobalTexturesDescriptor());
@@ -345,12 +401,14 @@ SceneRenderPassData SceneRenderer::attach(RenderGraph &graph,
             pipeline, 1, frameData.getBindlessParams().getDescriptor(),
             offsets);
 
-        render(commandList, pipeline, frameIndex);
+        render(commandList, pipeline, frameIndex, variant);
       }
 
-      {
+      for (usize variant = 0; variant < MeshVertexLayout::NumVariants;
+           ++variant) {
         QUOLL_PROFILE_EVENT("meshPass::skinnedMeshes");
 
+        auto skinnedPipeline = skinnedPipelines.at(variant);
         commandList.bindPipeline(skinnedPipeline);
         commandList.bindDescriptor(
             skinnedPipeline, 0, mRenderStorage.getGlobalTexturesDescriptor());
@@ -358,7 +416,7 @@ SceneRenderPassData SceneRenderer::attach(RenderGraph &graph,
             skinnedPipeline, 1, frameData.getBindlessParams().getDescriptor(),
             offsets);
 
-        renderSkinned(commandList, skinnedPipeline, frameIndex);
+        renderSkinned(commandList, skinnedPipeline, frameIndex, variant);
       }
     });
   } // mesh pass
@@ -393,10 +451,13 @@ SceneRenderPassData SceneRenderer::attach(RenderGraph &graph,
 
     usize spriteOffset = 0;
     for (auto &frameData : mFrameData) {
-      spriteOffset = frameData.getBindlessParams().addRange(SpriteDrawParams{
-          frameData.getCameraBuffer(), frameData.getSpriteTransformsBuffer(),
-          frameData.getSpriteTexturesBuffer(),
-          mRenderStorage.getDefaultSampler()});
+      spriteOffset =
+          frameData.getBindlessParams().addDynamicRange([&frameData, this] {
+            return SpriteDrawParams{frameData.getCameraBuffer(),
+                                    frameData.getSpriteTransformsBuffer(),
+                                    frameData.getSpriteTexturesBuffer(),
+                                    mRenderStorage.getDefaultSampler()};
+          });
     }
 
     pass.setExecutor([pipeline, spriteOffset, this](
@@ -718,9 +779,11 @@ void SceneRenderer::attachText(RenderGraph &graph,
 
   usize textOffset = 0;
   for (auto &frameData : mFrameData) {
-    textOffset = frameData.getBindlessParams().addRange(TextDrawParams{
-        frameData.getTextTransformsBuffer(), frameData.getCameraBuffer(),
-        frameData.getGlyphsBuffer()});
+    textOffset = frameData.getBindlessParams().addDynamicRange([&frameData] {
+      return TextDrawParams{frameData.getTextTransformsBuffer(),
+                            frameData.getCameraBuffer(),
+                            frameData.getGlyphsBuffer()};
+    });
   }
 
   auto &pass = graph.addGraphicsPass("textPass");
@@ -766,7 +829,8 @@ void SceneRenderer::attachText(RenderGraph &graph,
 }
 
 void SceneRenderer::updateFrameData(EntityDatabase &entityDatabase,
-                                    Entity camera, u32 frameIndex) {
+                                    Entity camera, u32 frameIndex,
+                                    const SpatialIndex *spatialIndex) {
   QuollAssert(entityDatabase.has<Camera>(camera),
               "Entity does not have a camera");
 
@@ -791,37 +855,129 @@ void SceneRenderer::updateFrameData(EntityDatabase &entityDatabase,
     }
   }
 
-  // Meshes
-  for (auto [entity, world, mesh, renderer] :
-       entityDatabase.view<WorldTransform, Mesh, MeshRenderer>()) {
-    if (!mesh.asset)
-      continue;
+  // Directional lights
+  for (auto [entity, light] : entityDatabase.view<DirectionalLight>()) {
+    if (entityDatabase.has<CascadedShadowMap>(entity)) {
+      frameData.addLight(light, entityDatabase.get<CascadedShadowMap>(entity));
+    } else {
+      frameData.addLight(light);
+    }
+  };
+
+  // Point lights
+  for (auto [entity, light, world] :
+       entityDatabase.view<PointLight, WorldTransform>()) {
+    frameData.addLight(light, world);
+  };
 
-    std::vector<rhi::DeviceAddress> materials;
-    for (auto material : renderer.materials) {
-      materials.push_back(mRendererAssetRegistry.get(material)->getAddress());
+  // Shadow maps are created with lights; so,
+  // lights are added before meshes are culled
+  const auto frustums = frameData.getViewFrustums();
+  mCullingStats = {};
+
+  // Meshes
+  // Meshes that are not visible in any view keep
+  // their instance slots without being updated
+  gatherMeshes(entityDatabase, frustums, spatialIndex);
+  for (auto &buffer : mMeshGatherBuffers) {
+    for (auto entity : buffer.culled) {
+      frameData.keepMesh(entity);
     }
 
-    frameData.addMesh(mesh.asset.handle(),
-                      mRendererAssetRegistry.get(mesh.asset), entity,
-                      world.worldTransform, materials);
+    for (const auto &instance : buffer.instances) {
+      auto visibility = std::span(buffer.visibility)
+                            .subspan(instance.boundsStart,
+                                     instance.drawData->geometries.size());
+      if (!recordCullingStats(visibility)) {
+        frameData.keepMesh(instance.entity);
+        continue;
+      }
+
+      frameData.addMesh(
+          instance.handle, *instance.drawData, instance.entity,
+          *instance.transform,
+          std::span(buffer.materials)
+              .subspan(instance.materialStart, instance.materialCount),
+          visibility);
+    }
   }
 
   // Skinned Meshes
-  for (auto [entity, skeleton, world, mesh, renderer] :
-       entityDatabase
-           .view<Skeleton, WorldTransform, Mesh, SkinnedMeshRenderer>()) {
-    if (!mesh.asset)
-      continue;
+  //
+  // Skeletons live in the same entity as their
+  // meshes; so, joint palettes are keyed by mesh
+  // entity and kept together with the mesh
+  for (auto &buffer : mSkinnedMeshGatherBuffers) {
+    for (auto entity : buffer.culled) {
+      frameData.keepSkinnedMesh(entity);
+      frameData.keepSkeleton(entity);
+    }
+
+    for (const auto &instance : buffer.instances) {
+      auto visibility = std::span(buffer.visibility)
+                            .subspan(instance.boundsStart,
+                                     instance.drawData->geometries.size());
+      if (!recordCullingStats(visibility)) {
+        frameData.keepSkinnedMesh(instance.entity);
+        frameData.keepSkeleton(instance.entity);
+        continue;
+      }
 
-    std::vector<rhi::DeviceAddress> materials;
-    for (const auto &material : renderer.materials) {
-      materials.push_back(mRendererAssetRegistry.get(material)->getAddress());
+      auto joints = frameData.addSkeleton(instance.entity, *instance.skeleton);
+      frameData.addSkinnedMesh(
+          instance.handle, *instance.drawData, instance.entity,
+          *instance.transform, joints,
+          std::span(buffer.materials)
+              .subspan(instance.materialStart, instance.materialCount),
+          visibility);
     }
+  }
+
+  // Creating render data is not thread safe;
+  // so, meshes with missing render data are
+  // added after gathering and are not culled
+  for (auto &buffer : mMeshGatherBuffers) {
+    for (auto entity : buffer.pending) {
+      const auto &world = entityDatabase.get<WorldTransform>(entity);
+      const auto &mesh = entityDatabase.get<Mesh>(entity);
+      const auto &renderer = entityDatabase.get<MeshRenderer>(entity);
+
+      std::vector<rhi::DeviceAddress> materials;
+      for (auto material : renderer.materials) {
+        materials.push_back(mRendererAssetRegistry.get(material)->getAddress());
+      }
+
+      const auto &drawData = mRendererAssetRegistry.get(mesh.asset);
+      const std::vector<u32> visibility(drawData.geometries.size(), AllViews);
+      recordCullingStats(visibility);
 
-    frameData.addSkinnedMesh(
-        mesh.asset.handle(), mRendererAssetRegistry.get(mesh.asset), entity,
-        world.worldTransform, skeleton.jointFinalTransforms, materials);
+      frameData.addMesh(mesh.asset.handle(), drawData, entity,
+                        world.worldTransform, materials, visibility);
+    }
+  }
+
+  for (auto &buffer : mSkinnedMeshGatherBuffers) {
+    for (auto entity : buffer.pending) {
+      const auto &skeleton = entityDatabase.get<Skeleton>(entity);
+      const auto &world = entityDatabase.get<WorldTransform>(entity);
+      const auto &mesh = entityDatabase.get<Mesh>(entity);
+      const auto &renderer = entityDatabase.get<SkinnedMeshRenderer>(entity);
+
+      std::vector<rhi::DeviceAddress> materials;
+      for (const auto &material : renderer.materials) {
+        materials.push_back(mRendererAssetRegistry.get(material)->getAddress());
+      }
+
+      const auto &drawData = mRendererAssetRegistry.get(mesh.asset);
+      const std::vector<u32> visibility(drawData.geometries.size(), AllViews);
+      recordCullingStats(visibility);
+
+      auto joints =
+          frameData.addSkeleton(entity, skeleton.jointFinalTransforms);
+      frameData.addSkinnedMesh(mesh.asset.handle(), drawData, entity,
+                               world.worldTransform, joints, materials,
+                               visibility);
+    }
   }
 
   // Texts
@@ -861,21 +1017,6 @@ void SceneRenderer::updateFrameData(EntityDatabase &entityDatabase,
                       world.worldTransform);
   }
 
-  // Directional lights
-  for (auto [entity, light] : entityDatabase.view<DirectionalLight>()) {
-    if (entityDatabase.has<CascadedShadowMap>(entity)) {
-      frameData.addLight(light, entityDatabase.get<CascadedShadowMap>(entity));
-    } else {
-      frameData.addLight(light);
-    }
-  };
-
-  // Point lights
-  for (auto [entity, light, world] :
-       entityDatabase.view<PointLight, WorldTransform>()) {
-    frameData.addLight(light, world);
-  };
-
   // Environments
   for (auto [entity, environment] : entityDatabase.view<EnvironmentSkybox>()) {
     rhi::TextureHandle irradianceMap{0};
@@ -904,119 +1045,265 @@ void SceneRenderer::updateFrameData(EntityDatabase &entityDatabase,
   }
 
   frameData.updateBuffers();
+  mUploadStats = frameData.getUploadStats();
 }
 
-void SceneRenderer::render(rhi::RenderCommandList &commandList,
-                           rhi::PipelineHandle pipeline, u32 frameIndex) {
-  auto &frameData = mFrameData.at(frameIndex);
+void SceneRenderer::gatherMeshes(EntityDatabase &entityDatabase,
+                                 std::span<const Frustum> frustums,
+                                 const SpatialIndex *spatialIndex) {
+  QUOLL_PROFILE_EVENT("SceneRenderer::gatherMeshes");
+  auto &threadPool = Engine::getThreadPool();
+
+  for (auto *buffers : {&mMeshGatherBuffers, &mSkinnedMeshGatherBuffers}) {
+    for (auto &buffer : *buffers) {
+      buffer.instances.clear();
+      buffer.materials.clear();
+      buffer.bounds.clear();
+      buffer.pending.clear();
+      buffer.culled.clear();
+    }
+  }
 
-  u32 instanceStart = 0;
-  for (auto &[handle, meshData] : frameData.getMeshGroups()) {
-    const u32 numInstances = static_cast<u32>(meshData.transforms.size());
+  if (spatialIndex) {
+    cullEntities(*spatialIndex, frustums);
+  }
 
-    commandList.bindVertexBuffers(meshData.drawData->vertexBuffers,
-                                  meshData.drawData->vertexBufferOffsets);
-    commandList.bindIndexBuffer(meshData.drawData->indexBuffer,
-                                rhi::IndexType::Uint32);
-    renderGeometries(commandList, pipeline, meshData.drawData, instanceStart,
-                     numInstances);
-    instanceStart += numInstances;
+  entityDatabase.view<WorldTransform, Mesh, MeshRenderer>().parallelForEach(
+      threadPool, [this, spatialIndex](Entity entity, WorldTransform &world,
+                                       Mesh &mesh, MeshRenderer &renderer) {
+        if (!mesh.asset)
+          return;
+
+        auto &buffer = mMeshGatherBuffers.get();
+        if (spatialIndex && isEntityCulled(*spatialIndex, entity)) {
+          buffer.culled.push_back(entity);
+          return;
+        }
+
+        gatherMeshInstance(buffer, entity, mesh.asset, world.worldTransform,
+                           renderer.materials, nullptr);
+      });
+
+  entityDatabase.view<Skeleton, WorldTransform, Mesh, SkinnedMeshRenderer>()
+      .parallelForEach(
+          threadPool, [this, spatialIndex](Entity entity, Skeleton &skeleton,
+                                           WorldTransform &world, Mesh &mesh,
+                                           SkinnedMeshRenderer &renderer) {
+            if (!mesh.asset)
+              return;
+
+            auto &buffer = mSkinnedMeshGatherBuffers.get();
+            if (spatialIndex && isEntityCulled(*spatialIndex, entity)) {
+              buffer.culled.push_back(entity);
+              return;
+            }
+
+            gatherMeshInstance(buffer, entity, mesh.asset,
+                               world.worldTransform, renderer.materials,
+                               &skeleton.jointFinalTransforms);
+          });
+
+  for (auto *buffers : {&mMeshGatherBuffers, &mSkinnedMeshGatherBuffers}) {
+    for (auto &buffer : *buffers) {
+      mCullingStats.culledInstances += static_cast<u32>(buffer.culled.size());
+    }
+  }
+
+  {
+    QUOLL_PROFILE_EVENT("SceneRenderer::cullMeshes");
+    for (auto *buffers : {&mMeshGatherBuffers, &mSkinnedMeshGatherBuffers}) {
+      for (auto &buffer : *buffers) {
+        buffer.visibility.resize(buffer.bounds.size());
+        FrustumCulling::cull(buffer.bounds, frustums, buffer.visibility);
+      }
+    }
   }
 }
 
-void SceneRenderer::renderSkinned(rhi::RenderCommandList &commandList,
-                                  rhi::PipelineHandle pipeline,
-                                  u32 frameIndex) {
-  auto &frameData = mFrameData.at(frameIndex);
+void SceneRenderer::cullEntities(const SpatialIndex &spatialIndex,
+                                 std::span<const Frustum> frustums) {
+  QUOLL_PROFILE_EVENT("SceneRenderer::cullEntities");
+  std::fill(mEntityViews.begin(), mEntityViews.end(), 0);
 
-  u32 instanceStart = 0;
+  for (usize i = 0; i < frustums.size(); ++i) {
+    mVisibleEntities.clear();
+    spatialIndex.queryFrustum(frustums[i], mVisibleEntities);
 
-  for (auto &[handle, meshData] : frameData.getSkinnedMeshGroups()) {
-    const u32 numInstances = static_cast<u32>(meshData.transforms.size());
+    for (auto entity : mVisibleEntities) {
+      const auto index = getEntityIndex(entity);
+      if (index >= mEntityViews.size()) {
+        mEntityViews.resize((index + 1) * 2, 0);
+      }
 
-    commandList.bindVertexBuffers(meshData.drawData->vertexBuffers,
-                                  meshData.drawData->vertexBufferOffsets);
-    commandList.bindIndexBuffer(meshData.drawData->indexBuffer,
-                                rhi::IndexType::Uint32);
+      mEntityViews[index] |= 1u << i;
+    }
+  }
+}
 
-    renderGeometries(commandList, pipeline, meshData.drawData, instanceStart,
-                     numInstances);
-    instanceStart += numInstances;
+bool SceneRenderer::isEntityCulled(const SpatialIndex &spatialIndex,
+                                   Entity entity) const {
+  // Entities that are not indexed yet
+  // are culled per geometry
+  if (!spatialIndex.contains(entity)) {
+    return false;
   }
+
+  const auto index = getEntityIndex(entity);
+  return index >= mEntityViews.size() || mEntityViews[index] == 0;
 }
 
-void SceneRenderer::renderGeometries(rhi::RenderCommandList &commandList,
-                                     rhi::PipelineHandle pipeline,
-                                     const MeshDrawData *drawData,
-                                     u32 instanceStart, u32 numInstances) {
-  i32 vertexOffset = 0;
-  u32 indexOffset = 0;
-  for (usize g = 0; g < drawData->geometries.size(); ++g) {
-    auto &geometry = drawData->geometries.at(g);
-    auto index = static_cast<u32>(g);
+void SceneRenderer::gatherMeshInstance(
+    MeshGatherBuffer &buffer, Entity entity, const AssetRef<MeshAsset> &mesh,
+    const glm::mat4 &transform,
+    const std::vector<AssetRef<MaterialAsset>> &materials,
+    const std::vector<glm::mat4> *skeleton) {
+  const auto *drawData = mRendererAssetRegistry.find(mesh);
+  if (!drawData) {
+    buffer.pending.push_back(entity);
+    return;
+  }
 
+  const usize materialStart = buffer.materials.size();
+  for (const auto &material : materials) {
+    const auto *data = mRendererAssetRegistry.find(material);
+    if (!data) {
+      buffer.materials.resize(materialStart);
+      buffer.pending.push_back(entity);
+      return;
+    }
+
+    buffer.materials.push_back(data->getAddress());
+  }
+
+  const usize boundsStart = buffer.bounds.size();
+  for (const auto &geometry : drawData->geometries) {
+    if (skeleton) {
+      buffer.bounds.add(geometry.bounds, *skeleton, transform);
+    } else {
+      buffer.bounds.add(geometry.bounds, transform);
+    }
+  }
+
+  buffer.instances.push_back({entity, mesh.handle(), drawData, &transform,
+                              skeleton, materialStart, materials.size(),
+                              boundsStart});
+}
+
+bool SceneRenderer::recordCullingStats(std::span<const u32> visibility) {
+  u32 views = 0;
+  for (auto bits : visibility) {
+    views |= bits;
+    if ((bits & SceneRendererFrameData::CameraViewBit) != 0) {
+      mCullingStats.visibleGeometries++;
+    } else {
+      mCullingStats.culledGeometries++;
+    }
+  }
+
+  if ((views & SceneRendererFrameData::CameraViewBit) != 0) {
+    mCullingStats.visibleInstances++;
+  } else {
+    mCullingStats.culledInstances++;
+  }
+
+  return views != 0;
+}
+
+void SceneRenderer::render(rhi::RenderCommandList &commandList,
+                           rhi::PipelineHandle pipeline, u32 frameIndex,
+                           usize layoutVariant) {
+  auto &frameData = mFrameData.at(frameIndex);
+
+  renderGeometries(commandList, pipeline, frameData,
+                   frameData.getMeshGroups(), frameData.getMeshDraws(0),
+                   layoutVariant);
+}
+
+void SceneRenderer::renderSkinned(rhi::RenderCommandList &commandList,
+                                  rhi::PipelineHandle pipeline, u32 frameIndex,
+                                  usize layoutVariant) {
+  auto &frameData = mFrameData.at(frameIndex);
+
+  renderGeometries(commandList, pipeline, frameData,
+                   frameData.getSkinnedMeshGroups(),
+                   frameData.getSkinnedMeshDraws(0), layoutVariant);
+}
+
+void SceneRenderer::renderGeometries(
+    rhi::RenderCommandList &commandList, rhi::PipelineHandle pipeline,
+    const SceneRendererFrameData &frameData,
+    const std::vector<SceneRendererFrameData::MeshGroup> &groups,
+    std::span<const SceneRendererFrameData::DrawRange> draws,
+    usize layoutVariant) {
+  struct MeshPushConstants {
+    rhi::DeviceAddress drawCommands;
+    u32 firstDraw;
+    u32 pad0;
+  };
+
+  for (usize i = 0; i < draws.size(); ++i) {
+    const auto &group = groups.at(i);
+    const auto &draw = draws[i];
+    if (draw.numDraws == 0 ||
+        group.drawData->vertexLayout.getVariant() != layoutVariant) {
+      continue;
+    }
+
+    commandList.bindVertexBuffers(group.drawData->vertexBuffers,
+                                  group.drawData->vertexBufferOffsets);
+    commandList.bindIndexBuffer(group.drawData->indexBuffer,
+                                rhi::IndexType::Uint32);
+
+    MeshPushConstants pushConstants{frameData.getDrawCommandsBuffer(),
+                                    draw.firstDraw, 0};
     commandList.pushConstants(pipeline, rhi::ShaderStage::Vertex, 0,
-                              sizeof(u32), &index);
+                              sizeof(MeshPushConstants), &pushConstants);
 
-    commandList.drawIndexed(geometry.numIndices, indexOffset, vertexOffset,
-                            numInstances, instanceStart);
-    vertexOffset += static_cast<i32>(geometry.numVertices);
-    indexOffset += geometry.numIndices;
+    drawMeshes(commandList, frameData, draw);
   }
 }
 
 void SceneRenderer::renderShadowsMesh(rhi::RenderCommandList &commandList,
                                       rhi::PipelineHandle pipeline,
-                                      u32 frameIndex) {
+                                      u32 frameIndex, u32 shadowMapIndex) {
   auto &frameData = mFrameData.at(frameIndex);
+  const auto &groups = frameData.getMeshGroups();
+  auto draws = frameData.getMeshDraws(shadowMapIndex + 1);
 
-  u32 instanceStart = 0;
-  for (auto &[handle, meshData] : frameData.getMeshGroups()) {
-    const u32 numInstances = static_cast<u32>(meshData.transforms.size());
+  for (usize i = 0; i < draws.size(); ++i) {
+    const auto &group = groups.at(i);
+    if (draws[i].numDraws == 0) {
+      continue;
+    }
 
     commandList.bindVertexBuffers(
-        MeshRenderUtils::getGeometryBuffers(meshData.drawData),
-        MeshRenderUtils::getGeometryBufferOffsets(meshData.drawData));
-    commandList.bindIndexBuffer(meshData.drawData->indexBuffer,
+        MeshRenderUtils::getGeometryBuffers(group.drawData),
+        MeshRenderUtils::getGeometryBufferOffsets(group.drawData));
+    commandList.bindIndexBuffer(group.drawData->indexBuffer,
                                 rhi::IndexType::Uint32);
-    renderShadowsGeometries(commandList, pipeline, meshData.drawData,
-                            instanceStart, numInstances);
-    instanceStart += numInstances;
+    drawMeshes(commandList, frameData, draws[i]);
   }
 }
 
 void SceneRenderer::renderShadowsSkinnedMesh(
     rhi::RenderCommandList &commandList, rhi::PipelineHandle pipeline,
-    u32 frameIndex) {
+    u32 frameIndex, u32 shadowMapIndex) {
   auto &frameData = mFrameData.at(frameIndex);
+  const auto &groups = frameData.getSkinnedMeshGroups();
+  auto draws = frameData.getSkinnedMeshDraws(shadowMapIndex + 1);
 
-  u32 instanceStart = 0;
-  for (auto &[handle, meshData] : frameData.getSkinnedMeshGroups()) {
-    const u32 numInstances = static_cast<u32>(meshData.transforms.size());
+  for (usize i = 0; i < draws.size(); ++i) {
+    const auto &group = groups.at(i);
+    if (draws[i].numDraws == 0) {
+      continue;
+    }
 
     commandList.bindVertexBuffers(
-        MeshRenderUtils::getSkinnedGeometryBuffers(meshData.drawData),
-        MeshRenderUtils::getSkinnedGeometryBufferOffsets(meshData.drawData));
-    commandList.bindIndexBuffer(meshData.drawData->indexBuffer,
+        MeshRenderUtils::getSkinnedGeometryBuffers(group.drawData),
+        MeshRenderUtils::getSkinnedGeometryBufferOffsets(group.drawData));
+    commandList.bindIndexBuffer(group.drawData->indexBuffer,
                                 rhi::IndexType::Uint32);
-    renderShadowsGeometries(commandList, pipeline, meshData.drawData,
-                            instanceStart, numInstances);
-    instanceStart += numInstances;
-  }
-}
-
-void SceneRenderer::renderShadowsGeometries(rhi::RenderCommandList &commandList,
-                                            rhi::PipelineHandle pipeline,
-                                            const MeshDrawData *drawData,
-                                            u32 instanceStart,
-                                            u32 numInstances) {
-  i32 vertexOffset = 0;
-  u32 indexOffset = 0;
-  for (const auto &geometry : drawData->geometries) {
-    commandList.drawIndexed(geometry.numIndices, indexOffset, vertexOffset,
-                            numInstances, instanceStart);
-    vertexOffset += static_cast<i32>(geometry.numVertices);
-    indexOffset += geometry.numIndices;
+    drawMeshes(commandList, frameData, draws[i]);
   }
 }
 
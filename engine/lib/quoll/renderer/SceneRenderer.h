@@ -1,8 +1,11 @@
 #pragma once
 
+#include "quoll/core/ThreadLocal.h"
+#include "quoll/asset/AssetRef.h"
 #include "quoll/renderer/RenderGraph.h"
 #include "quoll/renderer/RendererOptions.h"
 #include "quoll/rhi/RenderCommandList.h"
+#include "MaterialAsset.h"
 #include "SceneRendererFrameData.h"
 
 namespace quoll {
@@ -10,6 +13,7 @@ namespace quoll {
 class AssetRegistry;
 class RenderStorage;
 class RendererAssetRegistry;
+class SpatialIndex;
 struct MeshDrawData;
 
 struct SceneRenderPassData {
@@ -27,9 +31,65 @@ struct SceneRenderPassData {
 class SceneRenderer {
   static constexpr glm::vec4 DefaultClearColor{0.0f, 0.0f, 0.0f, 1.0f};
 
+  static constexpr u32 AllViews = ~0u;
+
+  /**
+   * Mesh instance with resolved render data
+   */
+  struct MeshInstance {
+    Entity entity = Entity::Null;
+
+    AssetHandle<MeshAsset> handle;
+
+    const MeshDrawData *drawData = nullptr;
+
+    const glm::mat4 *transform = nullptr;
+
+    const std::vector<glm::mat4> *skeleton = nullptr;
+
+    usize materialStart = 0;
+
+    usize materialCount = 0;
+
+    /**
+     * Index of bounds of first geometry
+     */
+    usize boundsStart = 0;
+  };
+
+  /**
+   * Mesh instances gathered by one thread
+   */
+  struct MeshGatherBuffer {
+    std::vector<MeshInstance> instances;
+
+    std::vector<rhi::DeviceAddress> materials;
+
+    /**
+     * World space bounds of every geometry
+     * of every instance
+     */
+    CullingBounds bounds;
+
+    std::vector<u32> visibility;
+
+    /**
+     * Entities with render data that is
+     * not created yet
+     */
+    std::vector<Entity> pending;
+
+    /**
+     * Entities that are culled
+     * by the spatial index
+     */
+    std::vector<Entity> culled;
+  };
+
 public:
   SceneRenderer(AssetRegistry &assetRegistry, RenderStorage &renderStorage,
-                RendererAssetRegistry &rendererAssetRegistry);
+                RendererAssetRegistry &rendererAssetRegistry,
+                const RendererOptions &options = {});
 
   void setClearColor(const glm::vec4 &clearColor);
 
@@ -38,41 +98,90 @@ public:
 
   void attachText(RenderGraph &graph, const SceneRenderPassData &passData);
 
+  /**
+   * @brief Update frame data
+   *
+   * Entities that are in the spatial index
+   * and outside of all views are not gathered.
+   *
+   * @param entityDatabase Entity database
+   * @param camera Camera entity
+   * @param frameIndex Frame index
+   * @param spatialIndex Spatial index of the scene
+   */
   void updateFrameData(EntityDatabase &entityDatabase, Entity camera,
-                       u32 frameIndex);
+                       u32 frameIndex,
+                       const SpatialIndex *spatialIndex = nullptr);
 
   inline const std::array<SceneRendererFrameData, 2> &getFrameData() {
     return mFrameData;
   }
 
+  inline const FrustumCullingStats &getCullingStats() const {
+    return mCullingStats;
+  }
+
+  /**
+   * @brief Get mesh instance upload stats of last frame
+   *
+   * @return Upload stats
+   */
+  inline const MeshInstanceUploadStats &getUploadStats() const {
+    return mUploadStats;
+  }
+
 private:
   void render(rhi::RenderCommandList &commandList, rhi::PipelineHandle pipeline,
-              u32 frameIndex);
+              u32 frameIndex, usize layoutVariant);
 
   void renderSkinned(rhi::RenderCommandList &commandList,
-                     rhi::PipelineHandle pipeline, u32 frameIndex);
+                     rhi::PipelineHandle pipeline, u32 frameIndex,
+                     usize layoutVariant);
 
-  void renderGeometries(rhi::RenderCommandList &commandList,
-                        rhi::PipelineHandle pipeline,
-                        const MeshDrawData *drawData, u32 instanceStart,
-                        u32 numInstances);
+  void renderGeometries(
+      rhi::RenderCommandList &commandList, rhi::PipelineHandle pipeline,
+      const SceneRendererFrameData &frameData,
+      const std::vector<SceneRendererFrameData::MeshGroup> &groups,
+      std::span<const SceneRendererFrameData::DrawRange> draws,
+      usize layoutVariant);
 
   void renderShadowsMesh(rhi::RenderCommandList &commandList,
-                         rhi::PipelineHandle pipeline, u32 frameIndex);
+                         rhi::PipelineHandle pipeline, u32 frameIndex,
+                         u32 shadowMapIndex);
 
   void renderShadowsSkinnedMesh(rhi::RenderCommandList &commandList,
-                                rhi::PipelineHandle pipeline, u32 frameIndex);
-
-  void renderShadowsGeometries(rhi::RenderCommandList &commandList,
-                               rhi::PipelineHandle pipeline,
-                               const MeshDrawData *drawData, u32 instanceStart,
-                               u32 numInstances);
+                                rhi::PipelineHandle pipeline, u32 frameIndex,
+                                u32 shadowMapIndex);
 
   void renderText(rhi::RenderCommandList &commandList,
                   rhi::PipelineHandle pipeline, u32 frameIndex);
 
   void generateBrdfLut();
 
+  void gatherMeshes(EntityDatabase &entityDatabase,
+                    std::span<const Frustum> frustums,
+                    const SpatialIndex *spatialIndex);
+
+  void cullEntities(const SpatialIndex &spatialIndex,
+                    std::span<const Frustum> frustums);
+
+  bool isEntityCulled(const SpatialIndex &spatialIndex, Entity entity) const;
+
+  void gatherMeshInstance(MeshGatherBuffer &buffer, Entity entity,
+                          const AssetRef<MeshAsset> &mesh,
+                          const glm::mat4 &transform,
+                          const std::vector<AssetRef<MaterialAsset>> &materials,
+                          const std::vector<glm::mat4> *skeleton);
+
+  /**
+   * @brief Add instance visibility to culling stats
+   *
+   * @param visibility View bits of instance geometries
+   * @retval true Instance is visible in at least one view
+   * @retval false Instance is not visible in any view
+   */
+  bool recordCullingStats(std::span<const u32> visibility);
+
   inline u32 getFramebufferSamples() const { return mMaxSampleCounts; }
 
 private:
@@ -83,6 +192,19 @@ private:
 
   std::array<SceneRendererFrameData, rhi::RenderDevice::NumFrames> mFrameData;
 
+  ThreadLocal<MeshGatherBuffer> mMeshGatherBuffers;
+  ThreadLocal<MeshGatherBuffer> mSkinnedMeshGatherBuffers;
+
+  FrustumCullingStats mCullingStats;
+  MeshInstanceUploadStats mUploadStats;
+
+  /**
+   * Visible views of every entity in the
+   * spatial index; indexed by entity
+   */
+  std::vector<u32> mEntityViews;
+  std::vector<Entity> mVisibleEntities;
+
   rhi::SamplerHandle mBloomSampler;
 
   u32 mMaxSampleCounts = 1;
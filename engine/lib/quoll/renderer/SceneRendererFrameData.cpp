@@ -8,8 +8,13 @@
 
 namespace quoll {
 
+static_assert(SceneRendererFrameData::MaxShadowMaps + 1 <=
+                  FrustumCulling::MaxFrustums,
+              "Camera and all shadow maps must fit in visibility bits");
+
 SceneRendererFrameData::SceneRendererFrameData(RenderStorage &renderStorage,
-                                               usize reservedSpace)
+                                               usize reservedSpace,
+                                               bool shrinkBuffers)
     : mReservedSpace(reservedSpace),
       mBindlessParams(renderStorage.getDevice()
                           ->getDeviceInformation()
@@ -26,76 +31,43 @@ SceneRendererFrameData::SceneRendererFrameData(RenderStorage &renderStorage,
 
   rhi::BufferDescription defaultDesc{};
   defaultDesc.usage = rhi::BufferUsage::Storage;
-  defaultDesc.size = mReservedSpace * sizeof(glm::mat4);
   defaultDesc.mapped = true;
 
-  {
-    auto desc = defaultDesc;
-    desc.debugName = "Flat materials";
-    desc.size = mReservedSpace * sizeof(rhi::DeviceAddress);
-    mFlatMaterialsBuffer = renderStorage.createBuffer(desc);
-  }
-
-  {
-    auto desc = defaultDesc;
-    desc.debugName = "Mesh transforms";
-    mMeshTransformsBuffer = renderStorage.createBuffer(desc);
-  }
-
-  {
-    auto desc = defaultDesc;
-    desc.debugName = "Mesh material ranges";
-    desc.size = mReservedSpace * sizeof(MaterialRange);
-    mMeshMaterialsBuffer = renderStorage.createBuffer(desc);
-  }
-
-  {
-    auto desc = defaultDesc;
-    desc.debugName = "Skinned mesh transforms";
-    mSkinnedMeshTransformsBuffer = renderStorage.createBuffer(desc);
-  }
-
-  {
-    auto desc = defaultDesc;
-    desc.debugName = "Skinned mesh material ranges";
-    desc.size = mReservedSpace * sizeof(MaterialRange);
-    mSkinnedMeshMaterialsBuffer = renderStorage.createBuffer(desc);
-  }
-
-  {
-    auto desc = defaultDesc;
-    desc.size = mReservedSpace * MaxNumJoints * sizeof(glm::mat4);
-    desc.debugName = "Skeletons";
-
-    mSkeletonsBuffer = renderStorage.createBuffer(desc);
-  }
-
-  {
-    auto desc = defaultDesc;
-    desc.debugName = "Text transforms";
-    mTextTransformsBuffer = renderStorage.createBuffer(desc);
-  }
-
-  {
-    auto desc = defaultDesc;
-    desc.debugName = "Sprite transforms";
-    mSpriteTransformsBuffer = renderStorage.createBuffer(desc);
-  }
-
-  {
-    auto desc = defaultDesc;
-    desc.size = mReservedSpace * sizeof(glm::uvec4);
-    desc.debugName = "Sprite textures";
-    mSpriteTexturesBuffer = renderStorage.createBuffer(desc);
-  }
-
-  {
-    auto desc = defaultDesc;
-    desc.size = mReservedSpace * sizeof(GlyphData);
-    desc.debugName = "Text glyphs";
-
-    mTextGlyphsBuffer = renderStorage.createBuffer(desc);
-  }
+  auto createGrowableBuffer =
+      [&](const String &debugName, usize itemSize,
+          rhi::BufferUsage usage = rhi::BufferUsage::Storage) {
+        auto desc = defaultDesc;
+        desc.usage = usage;
+        desc.debugName = debugName;
+        return GrowableBuffer(renderStorage, desc, itemSize, mReservedSpace,
+                              shrinkBuffers);
+      };
+
+  mFlatMaterialsBuffer =
+      createGrowableBuffer("Flat materials", sizeof(rhi::DeviceAddress));
+  mMeshTransformsBuffer =
+      createGrowableBuffer("Mesh transforms", sizeof(glm::mat4));
+  mMeshMaterialsBuffer =
+      createGrowableBuffer("Mesh material ranges", sizeof(MaterialRange));
+  mSkinnedMeshTransformsBuffer =
+      createGrowableBuffer("Skinned mesh transforms", sizeof(glm::mat4));
+  mSkinnedMeshMaterialsBuffer = createGrowableBuffer(
+      "Skinned mesh material ranges", sizeof(MaterialRange));
+  mSkinnedMeshJointsBuffer =
+      createGrowableBuffer("Skinned mesh joint ranges", sizeof(JointRange));
+  mJointPaletteBuffer =
+      createGrowableBuffer("Joint palette", sizeof(glm::mat4));
+  mTextTransformsBuffer =
+      createGrowableBuffer("Text transforms", sizeof(glm::mat4));
+  mTextGlyphsBuffer = createGrowableBuffer("Text glyphs", sizeof(GlyphData));
+  mSpriteTransformsBuffer =
+      createGrowableBuffer("Sprite transforms", sizeof(glm::mat4));
+  mSpriteTexturesBuffer =
+      createGrowableBuffer("Sprite textures", sizeof(glm::uvec4));
+
+  mDrawCommandsBuffer =
+      createGrowableBuffer("Mesh draw commands", sizeof(MeshDrawCommand),
+                           rhi::BufferUsage::Indirect);
 
   {
     auto desc = defaultDesc;
@@ -151,57 +123,74 @@ SceneRendererFrameData::SceneRendererFrameData(RenderStorage &renderStorage,
 
 void SceneRendererFrameData::updateBuffers() {
   QUOLL_PROFILE_EVENT("SceneRendererFrameData::updateBuffer");
-  mFlatMaterialsBuffer.update(mFlatMaterials.data(),
-                              mFlatMaterials.size() *
-                                  sizeof(rhi::DeviceAddress));
-  {
-    usize offset = 0;
-    auto *bufferData = static_cast<glm::mat4 *>(mMeshTransformsBuffer.map());
-    for (auto &[_, data] : mMeshGroups) {
-      memcpy(bufferData + offset, data.transforms.data(),
-             data.transforms.size() * sizeof(glm::mat4));
-      offset += data.transforms.size();
-    }
-  }
 
-  {
-    usize offset = 0;
-    auto *bufferData = static_cast<MaterialRange *>(mMeshMaterialsBuffer.map());
-    for (auto &[_, data] : mMeshGroups) {
-      memcpy(bufferData + offset, data.materialRanges.data(),
-             data.materialRanges.size() * sizeof(MaterialRange));
-      offset += data.materialRanges.size();
-    }
+  // Frame data is updated after the frame that
+  // used it has finished; so, buffers that were
+  // replaced in that frame are no longer used
+  for (auto *buffer : getGrowableBuffers()) {
+    buffer->collectGarbage();
   }
 
+  bool recreated = false;
   {
-    usize transformsOffset = 0;
-    auto *transformsBuffer =
-        static_cast<glm::mat4 *>(mSkinnedMeshTransformsBuffer.map());
-
-    usize skeletonsOffset = 0;
-    auto *skeletonsBuffer = static_cast<glm::mat4 *>(mSkeletonsBuffer.map());
-    for (auto &[_, data] : mSkinnedMeshGroups) {
-      memcpy(transformsBuffer + transformsOffset, data.transforms.data(),
-             data.transforms.size() * sizeof(glm::mat4));
-      transformsOffset += data.transforms.size();
-
-      memcpy(skeletonsBuffer + skeletonsOffset, data.skeletons.get(),
-             data.lastSkeleton * MaxNumJoints * sizeof(glm::mat4));
-      skeletonsOffset += data.lastSkeleton * MaxNumJoints;
-    }
+    mMeshInstances.end();
+    mSkinnedMeshInstances.end();
+    mJointPalette.end();
+
+    // Flat materials start with the default material
+    // followed by materials of meshes and skinned meshes
+    mMeshInstances.setMaterialBase(1);
+    mSkinnedMeshInstances.setMaterialBase(
+        1 + static_cast<u32>(mMeshInstances.getMaterialCapacity()));
+
+    const usize numMaterials = 1 + mMeshInstances.getMaterialCapacity() +
+                               mSkinnedMeshInstances.getMaterialCapacity();
+    const usize numMeshes = mMeshInstances.getCapacity();
+    const usize numSkinnedMeshes = mSkinnedMeshInstances.getCapacity();
+
+    recreated |= mFlatMaterialsBuffer.reserve(numMaterials);
+    recreated |= mMeshTransformsBuffer.reserve(numMeshes);
+    recreated |= mMeshMaterialsBuffer.reserve(numMeshes);
+    recreated |= mSkinnedMeshTransformsBuffer.reserve(numSkinnedMeshes);
+    recreated |= mSkinnedMeshMaterialsBuffer.reserve(numSkinnedMeshes);
+    recreated |= mSkinnedMeshJointsBuffer.reserve(numSkinnedMeshes);
+    recreated |= mJointPaletteBuffer.reserve(mJointPalette.getCapacity());
+
+    auto *materials =
+        static_cast<rhi::DeviceAddress *>(mFlatMaterialsBuffer.map());
+    materials[0] = mDefaultMaterial;
+
+    mUploadStats.numInstances = static_cast<u32>(
+        mMeshInstances.size() + mSkinnedMeshInstances.size());
+    mUploadStats.uploadedInstances = static_cast<u32>(
+        mMeshInstances.getNumChanged() +
+        mSkinnedMeshInstances.getNumChanged());
+    mUploadStats.uploadedBytes = sizeof(rhi::DeviceAddress);
+
+    mUploadStats.uploadedBytes += mMeshInstances.upload(
+        {static_cast<glm::mat4 *>(mMeshTransformsBuffer.map()),
+         static_cast<MaterialRange *>(mMeshMaterialsBuffer.map()),
+         materials + 1, nullptr});
+
+    mUploadStats.uploadedBytes += mSkinnedMeshInstances.upload(
+        {static_cast<glm::mat4 *>(mSkinnedMeshTransformsBuffer.map()),
+         static_cast<MaterialRange *>(mSkinnedMeshMaterialsBuffer.map()),
+         materials + 1 + mMeshInstances.getMaterialCapacity(),
+         static_cast<JointRange *>(mSkinnedMeshJointsBuffer.map())});
+
+    mUploadStats.uploadedBytes += mJointPalette.upload(
+        static_cast<glm::mat4 *>(mJointPaletteBuffer.map()));
   }
 
-  {
-    usize offset = 0;
-    auto *bufferData =
-        static_cast<MaterialRange *>(mSkinnedMeshMaterialsBuffer.map());
-    for (auto &[_, data] : mSkinnedMeshGroups) {
-      memcpy(bufferData + offset, data.materialRanges.data(),
-             data.materialRanges.size() * sizeof(MaterialRange));
-      offset += data.materialRanges.size();
-    }
-  }
+  buildDrawCommands();
+  recreated |= mDrawCommandsBuffer.reserve(mDrawCommands.size());
+  mDrawCommandsBuffer.update(mDrawCommands.data(),
+                             mDrawCommands.size() * sizeof(MeshDrawCommand));
+
+  recreated |= mTextTransformsBuffer.reserve(mTextTransforms.size());
+  recreated |= mTextGlyphsBuffer.reserve(mTextGlyphs.size());
+  recreated |= mSpriteTransformsBuffer.reserve(mSpriteTransforms.size());
+  recreated |= mSpriteTexturesBuffer.reserve(mSpriteTextures.size());
 
   mTextTransformsBuffer.update(mTextTransforms.data(),
                                mTextTransforms.size() * sizeof(glm::mat4));
@@ -222,72 +211,126 @@ void SceneRendererFrameData::updateBuffers() {
                                mSpriteTextures.size() * sizeof(u32));
   mSpriteTransformsBuffer.update(mSpriteTransforms.data(),
                                  mSpriteTransforms.size() * sizeof(glm::mat4));
+
+  // Draw parameters store addresses of recreated buffers
+  if (recreated) {
+    mBindlessParams.update();
+  }
 }
 
 void SceneRendererFrameData::setDefaultMaterial(rhi::DeviceAddress material) {
-  mFlatMaterials.at(0) = material;
+  mDefaultMaterial = material;
 }
 
 void SceneRendererFrameData::addMesh(
     AssetHandle<MeshAsset> handle, const MeshDrawData &meshDrawData,
     quoll::Entity entity, const glm::mat4 &transform,
-    const std::vector<rhi::DeviceAddress> &materials) {
-  const u32 start = static_cast<u32>(mFlatMaterials.size());
-  for (const auto &material : materials) {
-    mFlatMaterials.push_back(material);
-  }
-  auto newMaterialSize = static_cast<u32>(mFlatMaterials.size());
-  const u32 end = newMaterialSize == start ? 0 : newMaterialSize - 1;
-
-  if (mMeshGroups.find(handle) == mMeshGroups.end()) {
-    mMeshGroups.insert_or_assign(handle, MeshData{});
-  }
-
-  mMeshGroups.at(handle).entities.push_back(entity);
-  mMeshGroups.at(handle).transforms.push_back(transform);
-  mMeshGroups.at(handle).materialRanges.push_back({start, end});
-  mMeshGroups.at(handle).drawData = &meshDrawData;
+    std::span<const rhi::DeviceAddress> materials,
+    std::span<const u32> visibility) {
+  mMeshInstances.set(entity, handle, meshDrawData, transform, materials, {},
+                     visibility);
 }
 
 void SceneRendererFrameData::addSkinnedMesh(
     AssetHandle<MeshAsset> handle, const MeshDrawData &meshDrawData,
     Entity entity, const glm::mat4 &transform,
-    const std::vector<glm::mat4> &skeleton,
-    const std::vector<rhi::DeviceAddress> &materials) {
-  const u32 start = static_cast<u32>(mFlatMaterials.size());
-  for (const auto &material : materials) {
-    mFlatMaterials.push_back(material);
+    const JointRange &joints, std::span<const rhi::DeviceAddress> materials,
+    std::span<const u32> visibility) {
+  mSkinnedMeshInstances.set(entity, handle, meshDrawData, transform,
+                            materials, joints, visibility);
+}
+
+JointRange
+SceneRendererFrameData::addSkeleton(Entity entity,
+                                    std::span<const glm::mat4> joints) {
+  return mJointPalette.set(entity, joints);
+}
+
+bool SceneRendererFrameData::keepSkeleton(Entity entity) {
+  return mJointPalette.keep(entity);
+}
+
+bool SceneRendererFrameData::keepMesh(Entity entity) {
+  return mMeshInstances.keep(entity);
+}
+
+bool SceneRendererFrameData::keepSkinnedMesh(Entity entity) {
+  return mSkinnedMeshInstances.keep(entity);
+}
+
+std::span<const SceneRendererFrameData::DrawRange>
+SceneRendererFrameData::getMeshDraws(usize viewIndex) const {
+  const usize numGroups = getMeshGroups().size();
+  if (mMeshDraws.size() < (viewIndex + 1) * numGroups) {
+    return {};
   }
-  const u32 newMaterialSize = static_cast<u32>(mFlatMaterials.size());
-  const u32 end = newMaterialSize == start ? 0 : newMaterialSize - 1;
 
-  if (mSkinnedMeshGroups.find(handle) == mSkinnedMeshGroups.end()) {
-    mSkinnedMeshGroups.insert({handle, SkinnedMeshData{}});
+  return std::span(mMeshDraws).subspan(viewIndex * numGroups, numGroups);
+}
+
+std::span<const SceneRendererFrameData::DrawRange>
+SceneRendererFrameData::getSkinnedMeshDraws(usize viewIndex) const {
+  const usize numGroups = getSkinnedMeshGroups().size();
+  if (mSkinnedMeshDraws.size() < (viewIndex + 1) * numGroups) {
+    return {};
   }
 
-  auto &group = mSkinnedMeshGroups.at(handle);
+  return std::span(mSkinnedMeshDraws)
+      .subspan(viewIndex * numGroups, numGroups);
+}
 
-  group.entities.push_back(entity);
-  group.transforms.push_back(transform);
-  group.materialRanges.push_back({start, end});
-  group.drawData = &meshDrawData;
+void SceneRendererFrameData::buildDrawCommands() {
+  QUOLL_PROFILE_EVENT("SceneRendererFrameData::buildDrawCommands");
+
+  // Commands of every view are stored in the same
+  // buffer. View 0 is the camera and the rest are
+  // shadow maps in the same order as frustums
+  const usize numViews = mShadowMaps.size() + 1;
+  mDrawCommands.clear();
+
+  auto addDraws = [this](const std::vector<MeshGroup> &groups,
+                         std::vector<DrawRange> &draws, u32 viewMask) {
+    for (const auto &group : groups) {
+      const auto firstDraw = static_cast<u32>(mDrawCommands.size());
+      MeshRenderUtils::addVisibleDrawCommands(mDrawCommands, group.drawData,
+                                              group.firstSlot,
+                                              group.visibility, viewMask);
+      draws.push_back(
+          {firstDraw, static_cast<u32>(mDrawCommands.size()) - firstDraw});
+    }
+  };
 
-  const usize currentOffset = group.lastSkeleton * MaxNumJoints;
-  const usize newSize = currentOffset + MaxNumJoints;
+  mMeshDraws.clear();
+  mSkinnedMeshDraws.clear();
+  for (usize view = 0; view < numViews; ++view) {
+    const u32 viewMask =
+        view == 0 ? CameraViewBit
+                  : getShadowMapViewBit(static_cast<u32>(view - 1));
+    addDraws(getMeshGroups(), mMeshDraws, viewMask);
+    addDraws(getSkinnedMeshGroups(), mSkinnedMeshDraws, viewMask);
+  }
+}
+
+std::array<GrowableBuffer *, SceneRendererFrameData::NumGrowableBuffers>
+SceneRendererFrameData::getGrowableBuffers() {
+  return {&mFlatMaterialsBuffer,        &mMeshTransformsBuffer,
+          &mMeshMaterialsBuffer,        &mSkinnedMeshTransformsBuffer,
+          &mSkinnedMeshMaterialsBuffer, &mSkinnedMeshJointsBuffer,
+          &mJointPaletteBuffer,         &mDrawCommandsBuffer,
+          &mTextTransformsBuffer,       &mTextGlyphsBuffer,
+          &mSpriteTransformsBuffer,     &mSpriteTexturesBuffer};
+}
 
-  // Resize skeletons if new skeleton does not fit
-  if (group.skeletonCapacity < newSize) {
-    group.skeletonCapacity = newSize * 2;
-    auto *newVector = new glm::mat4[group.skeletonCapacity];
+std::vector<Frustum> SceneRendererFrameData::getViewFrustums() const {
+  std::vector<Frustum> frustums;
+  frustums.reserve(mShadowMaps.size() + 1);
 
-    memcpy(newVector, group.skeletons.get(), currentOffset * sizeof(glm::mat4));
-    group.skeletons.reset(newVector);
+  frustums.push_back(Frustum::fromMatrix(mCameraData.projectionViewMatrix));
+  for (const auto &shadowMap : mShadowMaps) {
+    frustums.push_back(Frustum::fromMatrix(shadowMap.shadowMatrix));
   }
 
-  auto *currentSkeleton = group.skeletons.get() + currentOffset;
-  const usize dataSize = std::min(skeleton.size(), MaxNumJoints);
-  memcpy(currentSkeleton, skeleton.data(), dataSize * sizeof(glm::mat4));
-  group.lastSkeleton++;
+  return frustums;
 }
 
 void SceneRendererFrameData::setBrdfLookupTable(rhi::TextureHandle brdfLut) {
@@ -513,11 +556,9 @@ void SceneRendererFrameData::clear() {
   mSkyboxData.color = {};
   mSkyboxData.data.x = 0;
 
-  mLastSkeleton = 0;
-  mFlatMaterials.clear();
-  mFlatMaterials.resize(1);
-  mMeshGroups.clear();
-  mSkinnedMeshGroups.clear();
+  mMeshInstances.begin();
+  mSkinnedMeshInstances.begin();
+  mJointPalette.begin();
 }
 
 } // namespace quoll
@@ -5,6 +5,7 @@
 #include "quoll/entity/EntityDatabase.h"
 #include "quoll/renderer/BindlessDrawParameters.h"
 #include "quoll/renderer/Material.h"
+#include "quoll/renderer/RendererOptions.h"
 #include "quoll/rhi/RenderDevice.h"
 #include "quoll/scene/Camera.h"
 #include "quoll/scene/CascadedShadowMap.h"
@@ -12,8 +13,12 @@
 #include "quoll/scene/PerspectiveLens.h"
 #include "quoll/scene/PointLight.h"
 #include "quoll/scene/WorldTransform.h"
+#include "FrustumCulling.h"
+#include "GrowableBuffer.h"
 #include "MeshAsset.h"
 #include "MeshDrawData.h"
+#include "MeshInstanceTable.h"
+#include "MeshRenderUtils.h"
 
 namespace quoll {
 
@@ -25,14 +30,25 @@ namespace quoll {
  */
 class SceneRendererFrameData {
 public:
-  static constexpr usize DefaultReservedSpace = 10000;
+  static constexpr usize DefaultReservedSpace =
+      RendererOptions::DefaultInstanceCapacity;
 
-  static constexpr usize MaxNumJoints = 32;
+  /**
+   * Number of buffers that grow with frame data
+   */
+  static constexpr usize NumGrowableBuffers = 12;
 
   static constexpr usize MaxNumLights = 256;
 
   static constexpr usize MaxShadowMaps = 16;
 
+  /**
+   * Visibility bit of camera
+   *
+   * Shadow map N uses the next bits
+   */
+  static constexpr u32 CameraViewBit = 1;
+
   struct DirectionalLightData {
     /**
      * Light data
@@ -143,29 +159,17 @@ public:
     glm::vec4 color;
   };
 
-  struct MaterialRange {
-    u32 start = 0;
-
-    u32 end = 0;
-  };
-
-  struct MeshData {
-
-    std::vector<glm::mat4> transforms;
-
-    std::vector<MaterialRange> materialRanges;
-
-    std::vector<Entity> entities;
-
-    const MeshDrawData *drawData = nullptr;
-  };
+  using MaterialRange = MeshInstanceTable::MaterialRange;
 
-  struct SkinnedMeshData : public MeshData {
-    std::unique_ptr<glm::mat4> skeletons;
+  using MeshGroup = MeshInstanceTable::Group;
 
-    usize lastSkeleton = 0;
+  /**
+   * @brief Range of indirect draw commands
+   */
+  struct DrawRange {
+    u32 firstDraw = 0;
 
-    usize skeletonCapacity = 0;
+    u32 numDraws = 0;
   };
 
   struct GlyphData {
@@ -184,22 +188,99 @@ public:
 
 public:
   SceneRendererFrameData(RenderStorage &renderStorage,
-                         usize reservedSpace = DefaultReservedSpace);
-
+                         usize reservedSpace = DefaultReservedSpace,
+                         bool shrinkBuffers = true);
+
+  /**
+   * @brief Update buffers
+   *
+   * Removes meshes that are not added since
+   * last clear and uploads mesh instances
+   * that are changed
+   */
   void updateBuffers();
 
   inline const std::vector<Entity> &getSpriteEntities() const {
     return mSpriteEntities;
   }
 
-  inline const std::unordered_map<AssetHandle<MeshAsset>, MeshData> &
-  getMeshGroups() const {
-    return mMeshGroups;
+  /**
+   * @brief Get mesh groups sorted by mesh handle
+   *
+   * @return Mesh groups
+   */
+  inline const std::vector<MeshGroup> &getMeshGroups() const {
+    return mMeshInstances.getGroups();
+  }
+
+  /**
+   * @brief Get skinned mesh groups sorted by mesh handle
+   *
+   * @return Skinned mesh groups
+   */
+  inline const std::vector<MeshGroup> &getSkinnedMeshGroups() const {
+    return mSkinnedMeshInstances.getGroups();
+  }
+
+  /**
+   * @brief Get number of mesh instance slots
+   *
+   * @return Number of slots in all mesh groups
+   */
+  inline usize getMeshCapacity() const { return mMeshInstances.getCapacity(); }
+
+  /**
+   * @brief Get number of skinned mesh instance slots
+   *
+   * @return Number of slots in all skinned mesh groups
+   */
+  inline usize getSkinnedMeshCapacity() const {
+    return mSkinnedMeshInstances.getCapacity();
+  }
+
+  /**
+   * @brief Get number of instances that fit in mesh buffers
+   *
+   * @return Capacity of mesh transforms buffer
+   */
+  inline usize getMeshBufferCapacity() const {
+    return mMeshTransformsBuffer.getCapacity();
+  }
+
+  /**
+   * @brief Get draw ranges of mesh groups in a view
+   *
+   * Ranges are built when buffers are updated
+   *
+   * @param viewIndex View index
+   * @return Draw range of every mesh group
+   */
+  std::span<const DrawRange> getMeshDraws(usize viewIndex) const;
+
+  /**
+   * @brief Get draw ranges of skinned mesh groups in a view
+   *
+   * @param viewIndex View index
+   * @return Draw range of every skinned mesh group
+   */
+  std::span<const DrawRange> getSkinnedMeshDraws(usize viewIndex) const;
+
+  /**
+   * @brief Get indirect draw commands of all views
+   *
+   * @return Mesh draw commands
+   */
+  inline const std::vector<MeshDrawCommand> &getDrawCommands() const {
+    return mDrawCommands;
   }
 
-  inline const std::unordered_map<AssetHandle<MeshAsset>, SkinnedMeshData> &
-  getSkinnedMeshGroups() const {
-    return mSkinnedMeshGroups;
+  /**
+   * @brief Get upload statistics of last update
+   *
+   * @return Mesh instance upload statistics
+   */
+  inline const MeshInstanceUploadStats &getUploadStats() const {
+    return mUploadStats;
   }
 
   inline const std::vector<TextItem> &getTexts() const { return mTexts; }
@@ -216,17 +297,81 @@ public:
 
   inline const usize getNumShadowMaps() const { return mShadowMaps.size(); }
 
+  /**
+   * @brief Get visibility bit of shadow map
+   *
+   * @param index Shadow map index
+   * @return Visibility bit
+   */
+  static constexpr u32 getShadowMapViewBit(u32 index) {
+    return CameraViewBit << (index + 1);
+  }
+
+  /**
+   * @brief Get frustums of all views
+   *
+   * First frustum belongs to the camera and
+   * the rest belong to shadow maps in order.
+   *
+   * @return View frustums
+   */
+  std::vector<Frustum> getViewFrustums() const;
+
   void setDefaultMaterial(rhi::DeviceAddress material);
 
   void addMesh(AssetHandle<MeshAsset> handle, const MeshDrawData &meshBuffers,
                quoll::Entity entity, const glm::mat4 &transform,
-               const std::vector<rhi::DeviceAddress> &materials);
+               std::span<const rhi::DeviceAddress> materials,
+               std::span<const u32> visibility);
+
+  /**
+   * @brief Add skeleton to joint palette
+   *
+   * Joints are stored once per frame; so, all
+   * meshes that are skinned to the skeleton
+   * share the returned joint range
+   *
+   * @param entity Skeleton entity
+   * @param joints Joint transforms
+   * @return Joint range in joint palette
+   */
+  JointRange addSkeleton(Entity entity, std::span<const glm::mat4> joints);
+
+  /**
+   * @brief Keep skeleton of meshes that are not visible
+   *
+   * @param entity Skeleton entity
+   * @retval true Skeleton is kept
+   * @retval false Skeleton was not added before
+   */
+  bool keepSkeleton(Entity entity);
 
   void addSkinnedMesh(AssetHandle<MeshAsset> handle,
                       const MeshDrawData &meshBuffers, Entity entity,
-                      const glm::mat4 &transform,
-                      const std::vector<glm::mat4> &skeleton,
-                      const std::vector<rhi::DeviceAddress> &materials);
+                      const glm::mat4 &transform, const JointRange &joints,
+                      std::span<const rhi::DeviceAddress> materials,
+                      std::span<const u32> visibility);
+
+  /**
+   * @brief Keep mesh that is not visible in any view
+   *
+   * Mesh keeps its instance slot without
+   * being drawn or uploaded
+   *
+   * @param entity Entity
+   * @retval true Mesh is kept
+   * @retval false Mesh was not added before
+   */
+  bool keepMesh(Entity entity);
+
+  /**
+   * @brief Keep skinned mesh that is not visible in any view
+   *
+   * @param entity Entity
+   * @retval true Skinned mesh is kept
+   * @retval false Skinned mesh was not added before
+   */
+  bool keepSkinnedMesh(Entity entity);
 
   void setBrdfLookupTable(rhi::TextureHandle brdfLut);
 
@@ -257,6 +402,13 @@ public:
 
   void setShadowMapTexture(rhi::TextureHandle shadowmap);
 
+  /**
+   * @brief Clear frame data
+   *
+   * Mesh instances are kept until buffers
+   * are updated; so, meshes that are added
+   * again keep their instance slots
+   */
   void clear();
 
   inline usize getReservedSpace() const { return mReservedSpace; }
@@ -283,6 +435,10 @@ public:
     return mMeshTransformsBuffer.getAddress();
   }
 
+  inline rhi::BufferHandle getMeshTransformsBufferHandle() const {
+    return mMeshTransformsBuffer.getHandle();
+  }
+
   inline rhi::DeviceAddress getMeshMaterialsBuffer() const {
     return mMeshMaterialsBuffer.getAddress();
   }
@@ -299,10 +455,16 @@ public:
     return mTextTransformsBuffer.getAddress();
   }
 
-  inline rhi::DeviceAddress getSkeletonsBuffer() const {
-    return mSkeletonsBuffer.getAddress();
+  inline rhi::DeviceAddress getSkinnedMeshJointsBuffer() const {
+    return mSkinnedMeshJointsBuffer.getAddress();
+  }
+
+  inline rhi::DeviceAddress getJointPaletteBuffer() const {
+    return mJointPaletteBuffer.getAddress();
   }
 
+  inline const JointPalette &getJointPalette() const { return mJointPalette; }
+
   inline rhi::DeviceAddress getCameraBuffer() const {
     return mCameraBuffer.getAddress();
   }
@@ -327,6 +489,14 @@ public:
     return mSkyboxBuffer.getAddress();
   }
 
+  inline rhi::DeviceAddress getDrawCommandsBuffer() const {
+    return mDrawCommandsBuffer.getAddress();
+  }
+
+  inline rhi::BufferHandle getDrawCommandsBufferHandle() const {
+    return mDrawCommandsBuffer.getHandle();
+  }
+
   inline rhi::DeviceAddress getGlyphsBuffer() const {
     return mTextGlyphsBuffer.getAddress();
   }
@@ -335,6 +505,10 @@ private:
   void addCascadedShadowMaps(const DirectionalLight &light,
                              const CascadedShadowMap &shadowMap);
 
+  void buildDrawCommands();
+
+  std::array<GrowableBuffer *, NumGrowableBuffers> getGrowableBuffers();
+
 private:
   std::vector<DirectionalLightData> mDirectionalLights;
   std::vector<PointLightData> mPointLights;
@@ -344,19 +518,24 @@ private:
   Camera mCameraData;
   PerspectiveLens mCameraLens;
 
-  usize mLastSkeleton = 0;
-
-  std::vector<rhi::DeviceAddress> mFlatMaterials;
-  rhi::Buffer mFlatMaterialsBuffer;
-
-  rhi::Buffer mMeshTransformsBuffer;
-  rhi::Buffer mSkinnedMeshTransformsBuffer;
-  rhi::Buffer mSkeletonsBuffer;
-  rhi::Buffer mMeshMaterialsBuffer;
-  rhi::Buffer mSkinnedMeshMaterialsBuffer;
-  std::unordered_map<AssetHandle<MeshAsset>, MeshData> mMeshGroups;
-  std::unordered_map<AssetHandle<MeshAsset>, SkinnedMeshData>
-      mSkinnedMeshGroups;
+  rhi::DeviceAddress mDefaultMaterial = rhi::DeviceAddress::Null;
+  GrowableBuffer mFlatMaterialsBuffer;
+
+  GrowableBuffer mMeshTransformsBuffer;
+  GrowableBuffer mSkinnedMeshTransformsBuffer;
+  GrowableBuffer mSkinnedMeshJointsBuffer;
+  GrowableBuffer mJointPaletteBuffer;
+  GrowableBuffer mMeshMaterialsBuffer;
+  GrowableBuffer mSkinnedMeshMaterialsBuffer;
+  MeshInstanceTable mMeshInstances;
+  MeshInstanceTable mSkinnedMeshInstances;
+  JointPalette mJointPalette;
+  MeshInstanceUploadStats mUploadStats;
+
+  std::vector<MeshDrawCommand> mDrawCommands;
+  std::vector<DrawRange> mMeshDraws;
+  std::vector<DrawRange> mSkinnedMeshDraws;
+  GrowableBuffer mDrawCommandsBuffer;
 
   rhi::Buffer mSceneBuffer;
   rhi::Buffer mDirectionalLightsBuffer;
@@ -368,16 +547,16 @@ private:
   std::vector<glm::mat4> mSpriteTransforms;
   std::vector<rhi::TextureHandle> mSpriteTextures;
   std::vector<Entity> mSpriteEntities;
-  rhi::Buffer mSpriteTransformsBuffer;
-  rhi::Buffer mSpriteTexturesBuffer;
+  GrowableBuffer mSpriteTransformsBuffer;
+  GrowableBuffer mSpriteTexturesBuffer;
 
   std::vector<TextItem> mTexts;
   std::vector<glm::mat4> mTextTransforms;
   std::vector<Entity> mTextEntities;
   std::vector<GlyphData> mTextGlyphs;
 
-  rhi::Buffer mTextTransformsBuffer;
-  rhi::Buffer mTextGlyphsBuffer;
+  GrowableBuffer mTextTransformsBuffer;
+  GrowableBuffer mTextGlyphsBuffer;
 
   usize mReservedSpace = 0;
 
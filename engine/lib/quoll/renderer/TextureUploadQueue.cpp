@@ -0,0 +1,238 @@
+#include "quoll/core/Base.h"
+#include "quoll/core/Profiler.h"
+#include "quoll/rhi/TextureDescription.h"
+#include "RenderStorage.h"
+#include "TextureUploadQueue.h"
+#include "TextureUtils.h"
+
+namespace quoll {
+
+TextureUploadQueue::TextureUploadQueue(RenderStorage &renderStorage,
+                                       usize stagingSize)
+    : mRenderStorage(renderStorage), mStagingSize(stagingSize) {
+  rhi::BufferDescription description{};
+  description.usage = rhi::BufferUsage::TransferSource;
+  description.size = mStagingSize;
+  description.mapped = true;
+  description.debugName = "Texture upload staging";
+  mStagingBuffer = mRenderStorage.createBuffer(description);
+  mStagingData = static_cast<u8 *>(mStagingBuffer.map());
+
+  mPlaceholder = createPlaceholder(rhi::TextureType::Standard);
+  mPlaceholderCubemap = createPlaceholder(rhi::TextureType::Cubemap);
+}
+
+TextureUploadQueue::~TextureUploadQueue() {
+  mStagingBuffer.unmap();
+  mRenderStorage.destroyBuffer(mStagingBuffer.getHandle());
+}
+
+void TextureUploadQueue::enqueue(
+    rhi::TextureHandle texture, const void *data, rhi::ImageLayout layout,
+    u32 layers, const std::vector<TextureAssetMipLevel> &levels) {
+  auto *device = mRenderStorage.getDevice();
+
+  Upload upload{};
+  upload.texture = texture;
+  upload.layout = layout;
+  upload.layers = layers;
+  upload.levels = levels;
+  upload.size = TextureUtils::getBufferSizeFromLevels(levels);
+
+  if (upload.size > mStagingSize) {
+    TextureUtils::copyDataToTexture(device, data, texture, layout, layers,
+                                    levels);
+    mRenderStorage.addToDescriptor(texture);
+    return;
+  }
+
+  mRenderStorage.addToDescriptor(
+      getPlaceholder(device->getTextureDescription(texture).type), texture);
+
+  // Uploads that are waiting for staging memory are
+  // always at the end of the queue. New uploads are
+  // staged only if there are no waiting uploads; so,
+  // large uploads are not starved by smaller ones
+  const bool canStage = mQueue.empty() || mQueue.back().staged;
+  if (!canStage || !stage(upload, data)) {
+    const auto *bytes = static_cast<const u8 *>(data);
+    upload.data.assign(bytes, bytes + upload.size);
+  }
+
+  mQueue.push_back(std::move(upload));
+}
+
+void TextureUploadQueue::record(rhi::RenderCommandList &commandList,
+                                u32 frameIndex) {
+  QUOLL_PROFILE_EVENT("TextureUploadQueue::record");
+
+  // Previous copies of the frame are finished
+  auto &frameStagingSize = mFrameStagingSizes.at(frameIndex);
+  mStagingUsed -= frameStagingSize;
+  frameStagingSize = 0;
+
+  for (auto &upload : mQueue) {
+    if (!upload.staged && !stage(upload, upload.data.data())) {
+      break;
+    }
+
+    upload.data = {};
+  }
+
+  frameStagingSize = mStagingFrameSize;
+  mStagingFrameSize = 0;
+
+  std::vector<rhi::ImageBarrier> preBarriers;
+  std::vector<rhi::ImageBarrier> postBarriers;
+  std::vector<rhi::CopyRegion> copies;
+  usize numRecorded = 0;
+  for (; numRecorded < mQueue.size() && mQueue.at(numRecorded).staged;
+       ++numRecorded) {
+    const auto &upload = mQueue.at(numRecorded);
+
+    rhi::ImageBarrier barrier{};
+    barrier.baseLevel = 0;
+    barrier.levelCount = static_cast<u32>(upload.levels.size());
+    barrier.srcAccess = rhi::Access::None;
+    barrier.dstAccess = rhi::Access::TransferWrite;
+    barrier.srcLayout = rhi::ImageLayout::Undefined;
+    barrier.dstLayout = rhi::ImageLayout::TransferDestinationOptimal;
+    barrier.srcStage = rhi::PipelineStage::None;
+    barrier.dstStage = rhi::PipelineStage::Transfer;
+    barrier.texture = upload.texture;
+    preBarriers.push_back(barrier);
+
+    barrier.srcAccess = rhi::Access::TransferWrite;
+    barrier.dstAccess = rhi::Access::None;
+    barrier.srcLayout = rhi::ImageLayout::TransferDestinationOptimal;
+    barrier.dstLayout = upload.layout;
+    barrier.srcStage = rhi::PipelineStage::Transfer;
+    barrier.dstStage = rhi::PipelineStage::AllCommands;
+    postBarriers.push_back(barrier);
+  }
+
+  if (numRecorded == 0) {
+    return;
+  }
+
+  commandList.pipelineBarrier({}, preBarriers, {});
+
+  for (usize i = 0; i < numRecorded; ++i) {
+    const auto &upload = mQueue.at(i);
+
+    copies.resize(upload.levels.size());
+    for (usize level = 0; level < copies.size(); ++level) {
+      auto &copy = copies.at(level);
+      const auto &mipLevel = upload.levels.at(level);
+
+      copy.bufferOffset =
+          static_cast<u32>(upload.stagingOffset + mipLevel.offset);
+      copy.imageBaseArrayLayer = 0;
+      copy.imageLayerCount = upload.layers;
+      copy.imageExtent = {mipLevel.width, mipLevel.height, 1};
+      copy.imageOffset = {0, 0, 0};
+      copy.imageLevel = static_cast<u32>(level);
+    }
+
+    commandList.copyBufferToTexture(mStagingBuffer.getHandle(),
+                                    upload.texture, copies);
+  }
+
+  commandList.pipelineBarrier({}, postBarriers, {});
+
+  for (usize i = 0; i < numRecorded; ++i) {
+    mRenderStorage.addToDescriptor(mQueue.at(i).texture);
+  }
+
+  mQueue.erase(mQueue.begin(),
+               mQueue.begin() + static_cast<std::ptrdiff_t>(numRecorded));
+}
+
+void TextureUploadQueue::cancel(rhi::TextureHandle texture) {
+  auto it = std::find_if(
+      mQueue.begin(), mQueue.end(),
+      [texture](const Upload &upload) { return upload.texture == texture; });
+
+  if (it != mQueue.end()) {
+    mQueue.erase(it);
+  }
+}
+
+bool TextureUploadQueue::isResident(rhi::TextureHandle texture) const {
+  return std::none_of(mQueue.begin(), mQueue.end(),
+                      [texture](const Upload &upload) {
+                        return upload.texture == texture;
+                      });
+}
+
+rhi::TextureHandle
+TextureUploadQueue::getPlaceholder(rhi::TextureType type) const {
+  return type == rhi::TextureType::Cubemap ? mPlaceholderCubemap
+                                           : mPlaceholder;
+}
+
+bool TextureUploadQueue::stage(Upload &upload, const void *data) {
+  auto offset = allocateStaging(upload.size);
+  if (!offset.has_value()) {
+    return false;
+  }
+
+  memcpy(mStagingData + offset.value(), data, upload.size);
+  upload.stagingOffset = offset.value();
+  upload.staged = true;
+  return true;
+}
+
+std::optional<usize> TextureUploadQueue::allocateStaging(usize size) {
+  size = (size + StagingAlignment - 1) & ~(StagingAlignment - 1);
+
+  // Space at the end of the buffer is skipped
+  // if data does not fit there and is freed
+  // together with the allocation
+  usize offset = mStagingHead;
+  usize skipped = 0;
+  if (offset + size > mStagingSize) {
+    skipped = mStagingSize - offset;
+    offset = 0;
+  }
+
+  if (mStagingUsed + skipped + size > mStagingSize) {
+    return std::nullopt;
+  }
+
+  mStagingHead = offset + size;
+  mStagingUsed += skipped + size;
+  mStagingFrameSize += skipped + size;
+  return offset;
+}
+
+rhi::TextureHandle
+TextureUploadQueue::createPlaceholder(rhi::TextureType type) {
+  static constexpr u32 White = 0xFFFFFFFF;
+  const u32 layers = type == rhi::TextureType::Cubemap ? 6 : 1;
+
+  rhi::TextureDescription description{};
+  description.type = type;
+  description.width = 1;
+  description.height = 1;
+  description.layerCount = layers;
+  description.usage = rhi::TextureUsage::Color |
+                      rhi::TextureUsage::TransferDestination |
+                      rhi::TextureUsage::Sampled;
+  description.format = rhi::Format::Rgba8Unorm;
+  description.debugName = type == rhi::TextureType::Cubemap
+                              ? "Placeholder cubemap"
+                              : "Placeholder texture";
+
+  auto texture = mRenderStorage.createTexture(description);
+
+  std::vector<u32> data(layers, White);
+  TextureUtils::copyDataToTexture(
+      mRenderStorage.getDevice(), data.data(), texture,
+      rhi::ImageLayout::ShaderReadOnlyOptimal, layers,
+      {{0, data.size() * sizeof(u32), 1, 1}});
+
+  return texture;
+}
+
+} // namespace quoll
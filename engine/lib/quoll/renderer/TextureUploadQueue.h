@@ -0,0 +1,169 @@
+#pragma once
+
+#include "quoll/rhi/Buffer.h"
+#include "quoll/rhi/RenderCommandList.h"
+#include "quoll/rhi/RenderDevice.h"
+#include "TextureAsset.h"
+
+namespace quoll {
+
+class RenderStorage;
+
+/**
+ * @brief Queue of texture uploads
+ *
+ * Texture data is copied to a persistently mapped
+ * staging ring buffer and copies to textures are
+ * recorded in the frame command list once per
+ * frame; so, uploads never wait for the device.
+ *
+ * Staging memory of a frame is reused when the
+ * same frame index is recorded again. Render device
+ * waits for the previous submission of the frame
+ * index before starting it; so, its copies have
+ * finished by then.
+ *
+ * Until a texture is uploaded, its descriptor slot
+ * points to a placeholder texture of the same type.
+ */
+class TextureUploadQueue : NoCopyMove {
+  /**
+   * Alignment of texture data in staging buffer
+   */
+  static constexpr usize StagingAlignment = 16;
+
+  struct Upload {
+    rhi::TextureHandle texture = rhi::TextureHandle::Null;
+
+    rhi::ImageLayout layout = rhi::ImageLayout::Undefined;
+
+    u32 layers = 0;
+
+    std::vector<TextureAssetMipLevel> levels;
+
+    usize size = 0;
+
+    usize stagingOffset = 0;
+
+    bool staged = false;
+
+    std::vector<u8> data;
+  };
+
+public:
+  /**
+   * Default staging buffer size
+   */
+  static constexpr usize DefaultStagingSize = 64ull * 1024 * 1024;
+
+public:
+  /**
+   * @brief Create texture upload queue
+   *
+   * @param renderStorage Render storage
+   * @param stagingSize Staging buffer size
+   */
+  TextureUploadQueue(RenderStorage &renderStorage,
+                     usize stagingSize = DefaultStagingSize);
+
+  /**
+   * @brief Destroy texture upload queue
+   */
+  ~TextureUploadQueue();
+
+  /**
+   * @brief Enqueue texture upload
+   *
+   * Texture must be created without adding
+   * it to descriptor. Textures that do not fit
+   * in the staging buffer are uploaded immediately.
+   *
+   * @param texture Destination texture
+   * @param data Texture data
+   * @param layout Texture layout after upload
+   * @param layers Number of texture layers
+   * @param levels Texture mip levels
+   */
+  void enqueue(rhi::TextureHandle texture, const void *data,
+               rhi::ImageLayout layout, u32 layers,
+               const std::vector<TextureAssetMipLevel> &levels);
+
+  /**
+   * @brief Record queued uploads
+   *
+   * Uploads are recorded in enqueue order
+   * until the staging buffer is full. Rest of
+   * the uploads are recorded in next frames.
+   *
+   * @param commandList Frame command list
+   * @param frameIndex Frame index
+   */
+  void record(rhi::RenderCommandList &commandList, u32 frameIndex);
+
+  /**
+   * @brief Cancel queued upload of texture
+   *
+   * Staging memory of a staged upload is
+   * released with the rest of the frame.
+   *
+   * @param texture Texture
+   */
+  void cancel(rhi::TextureHandle texture);
+
+  /**
+   * @brief Check if texture is uploaded
+   *
+   * @param texture Texture
+   * @retval true Texture is uploaded or not queued
+   * @retval false Texture is waiting for upload
+   */
+  bool isResident(rhi::TextureHandle texture) const;
+
+  /**
+   * @brief Get number of queued uploads
+   *
+   * @return Number of queued uploads
+   */
+  inline usize getNumQueued() const { return mQueue.size(); }
+
+  /**
+   * @brief Get used staging memory
+   *
+   * @return Staging memory of frames in flight
+   *         and queued uploads
+   */
+  inline usize getStagingUsage() const { return mStagingUsed; }
+
+  /**
+   * @brief Get placeholder texture
+   *
+   * @param type Texture type
+   * @return Placeholder texture
+   */
+  rhi::TextureHandle getPlaceholder(rhi::TextureType type) const;
+
+private:
+  bool stage(Upload &upload, const void *data);
+
+  std::optional<usize> allocateStaging(usize size);
+
+  rhi::TextureHandle createPlaceholder(rhi::TextureType type);
+
+private:
+  RenderStorage &mRenderStorage;
+
+  rhi::Buffer mStagingBuffer;
+  u8 *mStagingData = nullptr;
+  usize mStagingSize = 0;
+  usize mStagingHead = 0;
+  usize mStagingUsed = 0;
+  usize mStagingFrameSize = 0;
+  std::array<usize, rhi::RenderDevice::NumFrames> mFrameStagingSizes{};
+
+  std::deque<Upload> mQueue;
+
+  rhi::TextureHandle mPlaceholder = rhi::TextureHandle::Null;
+  rhi::TextureHandle mPlaceholderCubemap = rhi::TextureHandle::Null;
+};
+
+} // namespace quoll
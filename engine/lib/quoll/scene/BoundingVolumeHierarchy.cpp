@@ -0,0 +1,681 @@
+#include "quoll/core/Base.h"
+#include "BoundingVolumeHierarchy.h"
+
+namespace quoll {
+
+namespace {
+
+static constexpr usize NumBins = 16;
+
+const BoundingBox EmptyBox{glm::vec3(std::numeric_limits<f32>::max()),
+                           glm::vec3(std::numeric_limits<f32>::lowest())};
+
+BoundingBox enlarge(const BoundingBox &bounds) {
+  return {bounds.min - glm::vec3(BoundingVolumeHierarchy::Margin),
+          bounds.max + glm::vec3(BoundingVolumeHierarchy::Margin)};
+}
+
+glm::vec3 getCenter(const BoundingBox &bounds) {
+  return (bounds.min + bounds.max) * 0.5f;
+}
+
+enum class Containment { Outside, Intersects, Inside };
+
+Containment classify(const Frustum &frustum, const BoundingBox &bounds) {
+  const glm::vec3 center = getCenter(bounds);
+  const glm::vec3 extent = (bounds.max - bounds.min) * 0.5f;
+
+  bool inside = true;
+  for (const auto &plane : frustum.planes) {
+    const glm::vec3 normal(plane);
+    const f32 distance = glm::dot(normal, center) + plane.w;
+    const f32 radius = glm::dot(glm::abs(normal), extent);
+
+    if (distance + radius < 0.0f) {
+      return Containment::Outside;
+    }
+
+    if (distance - radius < 0.0f) {
+      inside = false;
+    }
+  }
+
+  return inside ? Containment::Inside : Containment::Intersects;
+}
+
+/**
+ * @brief Intersect ray with box using slab test
+ *
+ * @param bounds Bounding box
+ * @param origin Ray origin
+ * @param inverseDirection Inverse of ray direction
+ * @param maxDistance Maximum distance
+ * @param distance Distance to entry point
+ * @param axis Axis of the entered slab
+ * @retval true Ray intersects box
+ * @retval false Ray does not intersect box
+ */
+bool intersectRay(const BoundingBox &bounds, const glm::vec3 &origin,
+                  const glm::vec3 &inverseDirection, f32 maxDistance,
+                  f32 &distance, glm::length_t &axis) {
+  const glm::vec3 t0 = (bounds.min - origin) * inverseDirection;
+  const glm::vec3 t1 = (bounds.max - origin) * inverseDirection;
+  const glm::vec3 tNear = glm::min(t0, t1);
+  const glm::vec3 tFar = glm::max(t0, t1);
+
+  axis = 0;
+  f32 enter = tNear.x;
+  if (tNear.y > enter) {
+    enter = tNear.y;
+    axis = 1;
+  }
+  if (tNear.z > enter) {
+    enter = tNear.z;
+    axis = 2;
+  }
+
+  const f32 exit = std::min(tFar.x, std::min(tFar.y, tFar.z));
+  if (enter > exit || exit < 0.0f || enter > maxDistance) {
+    return false;
+  }
+
+  distance = std::max(enter, 0.0f);
+  return true;
+}
+
+f32 getDistance(const BoundingBox &bounds, const glm::vec3 &point) {
+  const glm::vec3 closest = glm::clamp(point, bounds.min, bounds.max);
+  return glm::length(point - closest);
+}
+
+} // namespace
+
+void BoundingVolumeHierarchy::insert(Entity entity, const BoundingBox &bounds) {
+  QuollAssert(!contains(entity), "Entity already exists in hierarchy");
+
+  const u32 leaf = allocateNode();
+  auto &node = mNodes.at(leaf);
+  node.object = bounds;
+  node.bounds = enlarge(bounds);
+  node.entity = entity;
+
+  getLeafSlot(entity) = leaf;
+  insertLeaf(leaf);
+  mNumLeaves++;
+}
+
+bool BoundingVolumeHierarchy::update(Entity entity, const BoundingBox &bounds) {
+  QuollAssert(contains(entity), "Entity does not exist in hierarchy");
+
+  const u32 leaf = mLeaves.at(getEntityIndex(entity));
+  auto &node = mNodes.at(leaf);
+  node.object = bounds;
+  node.entity = entity;
+
+  if (node.bounds.contains(bounds)) {
+    return false;
+  }
+
+  node.bounds = enlarge(bounds);
+  refit(node.parent);
+  return true;
+}
+
+void BoundingVolumeHierarchy::remove(Entity entity) {
+  QuollAssert(contains(entity), "Entity does not exist in hierarchy");
+
+  auto &slot = getLeafSlot(entity);
+  removeLeaf(slot);
+  freeNode(slot);
+  slot = NullNode;
+  mNumLeaves--;
+}
+
+bool BoundingVolumeHierarchy::contains(Entity entity) const {
+  const auto index = getEntityIndex(entity);
+  return index < mLeaves.size() && mLeaves[index] != NullNode;
+}
+
+const BoundingBox &BoundingVolumeHierarchy::getBounds(Entity entity) const {
+  QuollAssert(contains(entity), "Entity does not exist in hierarchy");
+  return mNodes.at(mLeaves.at(getEntityIndex(entity))).object;
+}
+
+Entity BoundingVolumeHierarchy::getEntity(Entity entity) const {
+  QuollAssert(contains(entity), "Entity does not exist in hierarchy");
+  return mNodes.at(mLeaves.at(getEntityIndex(entity))).entity;
+}
+
+void BoundingVolumeHierarchy::build(std::span<const Entry> entries) {
+  clear();
+  if (entries.empty()) {
+    return;
+  }
+
+  mNodes.reserve(entries.size() * 2 - 1);
+
+  // Leaves and centers are partitioned together;
+  // so, a permutation of both is partitioned
+  std::vector<u32> leaves(entries.size());
+  std::vector<glm::vec3> centers(entries.size());
+  std::vector<usize> order(entries.size());
+  for (usize i = 0; i < entries.size(); ++i) {
+    const auto &entry = entries[i];
+    QuollAssert(!contains(entry.entity), "Entity already exists in hierarchy");
+
+    const u32 leaf = allocateNode();
+    auto &node = mNodes.at(leaf);
+    node.object = entry.bounds;
+    node.bounds = enlarge(entry.bounds);
+    node.entity = entry.entity;
+
+    getLeafSlot(entry.entity) = leaf;
+    leaves.at(i) = leaf;
+    centers.at(i) = getCenter(entry.bounds);
+    order.at(i) = i;
+  }
+  mNumLeaves = entries.size();
+
+  struct Task {
+    usize begin = 0;
+    usize end = 0;
+    u32 parent = NullNode;
+    bool left = false;
+  };
+
+  std::vector<Task> tasks{{0, entries.size(), NullNode, false}};
+  while (!tasks.empty()) {
+    const Task task = tasks.back();
+    tasks.pop_back();
+
+    u32 index = NullNode;
+    if (task.end - task.begin == 1) {
+      index = leaves.at(order.at(task.begin));
+    } else {
+      index = allocateNode();
+
+      BoundingBox bounds = EmptyBox;
+      BoundingBox centerBounds = EmptyBox;
+      for (usize i = task.begin; i < task.end; ++i) {
+        const usize item = order[i];
+        bounds = bounds.merge(mNodes[leaves[item]].bounds);
+        centerBounds = centerBounds.merge({centers[item], centers[item]});
+      }
+      mNodes.at(index).bounds = bounds;
+
+      const glm::vec3 size = centerBounds.max - centerBounds.min;
+      glm::length_t axis = 0;
+      if (size.y > size[axis]) {
+        axis = 1;
+      }
+      if (size.z > size[axis]) {
+        axis = 2;
+      }
+
+      const f32 extent = size[axis];
+      const f32 origin = centerBounds.min[axis];
+      auto getBin = [&centers, axis, extent, origin](usize item) {
+        const f32 offset = (centers[item][axis] - origin) / extent;
+        return std::min(static_cast<usize>(offset * NumBins), NumBins - 1);
+      };
+
+      usize middle = task.begin;
+      if (extent > 0.0f) {
+        std::array<BoundingBox, NumBins> binBounds{};
+        std::array<usize, NumBins> binCounts{};
+        binBounds.fill(EmptyBox);
+
+        for (usize i = task.begin; i < task.end; ++i) {
+          const usize bin = getBin(order[i]);
+          const auto &leafBounds = mNodes[leaves[order[i]]].bounds;
+          binBounds[bin] = binBounds[bin].merge(leafBounds);
+          binCounts[bin]++;
+        }
+
+        // Cost of splitting after bin is the area
+        // of each side multiplied by its count
+        std::array<f32, NumBins> rightCosts{};
+        std::array<usize, NumBins> rightCounts{};
+        BoundingBox right = EmptyBox;
+        usize rightCount = 0;
+        for (usize bin = NumBins - 1; bin > 0; --bin) {
+          right = right.merge(binBounds[bin]);
+          rightCount += binCounts[bin];
+          rightCounts[bin] = rightCount;
+          rightCosts[bin] =
+              right.getSurfaceArea() * static_cast<f32>(rightCount);
+        }
+
+        f32 bestCost = std::numeric_limits<f32>::max();
+        usize bestSplit = 0;
+        BoundingBox left = EmptyBox;
+        usize leftCount = 0;
+        for (usize bin = 1; bin < NumBins; ++bin) {
+          left = left.merge(binBounds[bin - 1]);
+          leftCount += binCounts[bin - 1];
+          if (leftCount == 0 || rightCounts[bin] == 0) {
+            continue;
+          }
+
+          const f32 cost = left.getSurfaceArea() * static_cast<f32>(leftCount) +
+                           rightCosts[bin];
+          if (cost < bestCost) {
+            bestCost = cost;
+            bestSplit = bin;
+          }
+        }
+
+        auto it = std::partition(
+            order.begin() + static_cast<std::ptrdiff_t>(task.begin),
+            order.begin() + static_cast<std::ptrdiff_t>(task.end),
+            [&getBin, bestSplit](usize item) {
+              return getBin(item) < bestSplit;
+            });
+        middle = static_cast<usize>(it - order.begin());
+      }
+
+      // All centers are in the same bin or at the
+      // same position; so, split by count instead
+      if (middle == task.begin || middle == task.end) {
+        middle = task.begin + (task.end - task.begin) / 2;
+        std::nth_element(
+            order.begin() + static_cast<std::ptrdiff_t>(task.begin),
+            order.begin() + static_cast<std::ptrdiff_t>(middle),
+            order.begin() + static_cast<std::ptrdiff_t>(task.end),
+            [&centers, axis](usize a, usize b) {
+              return centers[a][axis] < centers[b][axis];
+            });
+      }
+
+      tasks.push_back({middle, task.end, index, false});
+      tasks.push_back({task.begin, middle, index, true});
+    }
+
+    auto &node = mNodes.at(index);
+    node.parent = task.parent;
+    if (task.parent == NullNode) {
+      mRoot = index;
+    } else if (task.left) {
+      mNodes.at(task.parent).left = index;
+    } else {
+      mNodes.at(task.parent).right = index;
+    }
+  }
+}
+
+void BoundingVolumeHierarchy::clear() {
+  mNodes.clear();
+  mFreeNodes.clear();
+  mRoot = NullNode;
+  mNumLeaves = 0;
+  std::fill(mLeaves.begin(), mLeaves.end(), NullNode);
+}
+
+std::vector<BoundingVolumeHierarchy::Entry>
+BoundingVolumeHierarchy::getEntries() const {
+  std::vector<Entry> entries;
+  entries.reserve(mNumLeaves);
+
+  for (usize i = 0; i < mLeaves.size(); ++i) {
+    if (mLeaves[i] != NullNode) {
+      const auto &node = mNodes[mLeaves[i]];
+      entries.push_back({node.entity, node.object});
+    }
+  }
+
+  return entries;
+}
+
+void BoundingVolumeHierarchy::queryOverlap(
+    const BoundingBox &bounds, std::vector<Entity> &entities) const {
+  if (mRoot == NullNode) {
+    return;
+  }
+
+  std::vector<u32> stack{mRoot};
+  while (!stack.empty()) {
+    const auto &node = mNodes[stack.back()];
+    stack.pop_back();
+
+    if (!node.bounds.overlaps(bounds)) {
+      continue;
+    }
+
+    if (node.isLeaf()) {
+      if (node.object.overlaps(bounds)) {
+        entities.push_back(node.entity);
+      }
+    } else {
+      stack.push_back(node.left);
+      stack.push_back(node.right);
+    }
+  }
+}
+
+void BoundingVolumeHierarchy::queryFrustum(
+    const Frustum &frustum, std::vector<Entity> &entities) const {
+  if (mRoot == NullNode) {
+    return;
+  }
+
+  // Subtrees that are fully inside the frustum
+  // are added without testing their children
+  std::vector<std::pair<u32, bool>> stack{{mRoot, false}};
+  while (!stack.empty()) {
+    const auto [index, inside] = stack.back();
+    stack.pop_back();
+    const auto &node = mNodes[index];
+
+    Containment containment = Containment::Inside;
+    if (!inside) {
+      containment =
+          classify(frustum, node.isLeaf() ? node.object : node.bounds);
+      if (containment == Containment::Outside) {
+        continue;
+      }
+    }
+
+    if (node.isLeaf()) {
+      entities.push_back(node.entity);
+    } else {
+      const bool childrenInside = containment == Containment::Inside;
+      stack.push_back({node.left, childrenInside});
+      stack.push_back({node.right, childrenInside});
+    }
+  }
+}
+
+bool BoundingVolumeHierarchy::raycast(const glm::vec3 &origin,
+                                      const glm::vec3 &direction,
+                                      f32 maxDistance,
+                                      CollisionHit &hit) const {
+  if (mRoot == NullNode) {
+    return false;
+  }
+
+  const glm::vec3 inverseDirection = glm::vec3(1.0f) / direction;
+
+  f32 closest = maxDistance;
+  bool found = false;
+
+  f32 distance = 0.0f;
+  glm::length_t axis = 0;
+  if (!intersectRay(mNodes[mRoot].bounds, origin, inverseDirection, closest,
+                    distance, axis)) {
+    return false;
+  }
+
+  std::vector<std::pair<u32, f32>> stack{{mRoot, distance}};
+  while (!stack.empty()) {
+    const auto [index, entry] = stack.back();
+    stack.pop_back();
+
+    // Closer hit is found after node is added
+    if (entry > closest) {
+      continue;
+    }
+
+    const auto &node = mNodes[index];
+    if (node.isLeaf()) {
+      if (intersectRay(node.object, origin, inverseDirection, closest,
+                       distance, axis)) {
+        closest = distance;
+        found = true;
+
+        hit.entity = node.entity;
+        hit.distance = distance;
+        hit.normal = glm::vec3(0.0f);
+        hit.normal[axis] = direction[axis] > 0.0f ? -1.0f : 1.0f;
+      }
+      continue;
+    }
+
+    f32 leftDistance = 0.0f;
+    f32 rightDistance = 0.0f;
+    const bool hitLeft =
+        intersectRay(mNodes[node.left].bounds, origin, inverseDirection,
+                     closest, leftDistance, axis);
+    const bool hitRight =
+        intersectRay(mNodes[node.right].bounds, origin, inverseDirection,
+                     closest, rightDistance, axis);
+
+    // Closer child is visited first
+    if (hitLeft && hitRight) {
+      if (leftDistance < rightDistance) {
+        stack.push_back({node.right, rightDistance});
+        stack.push_back({node.left, leftDistance});
+      } else {
+        stack.push_back({node.left, leftDistance});
+        stack.push_back({node.right, rightDistance});
+      }
+    } else if (hitLeft) {
+      stack.push_back({node.left, leftDistance});
+    } else if (hitRight) {
+      stack.push_back({node.right, rightDistance});
+    }
+  }
+
+  return found;
+}
+
+bool BoundingVolumeHierarchy::findNearest(const glm::vec3 &point,
+                                          f32 maxDistance,
+                                          CollisionHit &hit) const {
+  if (mRoot == NullNode) {
+    return false;
+  }
+
+  f32 closest = maxDistance;
+  bool found = false;
+
+  std::vector<std::pair<u32, f32>> stack{
+      {mRoot, getDistance(mNodes[mRoot].bounds, point)}};
+  while (!stack.empty()) {
+    const auto [index, nodeDistance] = stack.back();
+    stack.pop_back();
+
+    if (nodeDistance > closest) {
+      continue;
+    }
+
+    const auto &node = mNodes[index];
+    if (node.isLeaf()) {
+      const f32 distance = getDistance(node.object, point);
+      if (distance <= closest) {
+        closest = distance;
+        found = true;
+
+        const glm::vec3 surface =
+            glm::clamp(point, node.object.min, node.object.max);
+        hit.entity = node.entity;
+        hit.distance = distance;
+        hit.normal = distance > 0.0f ? (point - surface) / distance
+                                     : glm::vec3(0.0f);
+      }
+      continue;
+    }
+
+    const f32 leftDistance = getDistance(mNodes[node.left].bounds, point);
+    const f32 rightDistance = getDistance(mNodes[node.right].bounds, point);
+
+    // Closer child is visited first
+    if (leftDistance < rightDistance) {
+      stack.push_back({node.right, rightDistance});
+      stack.push_back({node.left, leftDistance});
+    } else {
+      stack.push_back({node.left, leftDistance});
+      stack.push_back({node.right, rightDistance});
+    }
+  }
+
+  return found;
+}
+
+f32 BoundingVolumeHierarchy::getCost() const {
+  if (mRoot == NullNode || mNodes[mRoot].isLeaf()) {
+    return 0.0f;
+  }
+
+  const f32 rootArea = mNodes[mRoot].bounds.getSurfaceArea();
+  if (rootArea <= 0.0f) {
+    return 0.0f;
+  }
+
+  f32 area = 0.0f;
+  std::vector<u32> stack{mRoot};
+  while (!stack.empty()) {
+    const auto &node = mNodes[stack.back()];
+    stack.pop_back();
+
+    if (!node.isLeaf()) {
+      area += node.bounds.getSurfaceArea();
+      stack.push_back(node.left);
+      stack.push_back(node.right);
+    }
+  }
+
+  return area / rootArea;
+}
+
+u32 BoundingVolumeHierarchy::allocateNode() {
+  if (!mFreeNodes.empty()) {
+    const u32 index = mFreeNodes.back();
+    mFreeNodes.pop_back();
+    return index;
+  }
+
+  mNodes.emplace_back();
+  return static_cast<u32>(mNodes.size() - 1);
+}
+
+void BoundingVolumeHierarchy::freeNode(u32 index) {
+  mNodes.at(index) = {};
+  mFreeNodes.push_back(index);
+}
+
+void BoundingVolumeHierarchy::insertLeaf(u32 leaf) {
+  if (mRoot == NullNode) {
+    mRoot = leaf;
+    mNodes.at(leaf).parent = NullNode;
+    return;
+  }
+
+  // Find sibling that increases the surface
+  // area of the tree the least
+  const BoundingBox bounds = mNodes.at(leaf).bounds;
+  u32 index = mRoot;
+  while (!mNodes[index].isLeaf()) {
+    const auto &node = mNodes[index];
+
+    const f32 area = node.bounds.getSurfaceArea();
+    const f32 combinedArea = node.bounds.merge(bounds).getSurfaceArea();
+
+    // Cost of creating a new parent for this node
+    const f32 cost = 2.0f * combinedArea;
+
+    // Cost of pushing the leaf further down
+    // the tree enlarges this node
+    const f32 inheritedCost = 2.0f * (combinedArea - area);
+
+    auto getChildCost = [this, &bounds, inheritedCost](u32 child) {
+      const auto &childNode = mNodes[child];
+      const f32 mergedArea = childNode.bounds.merge(bounds).getSurfaceArea();
+      if (childNode.isLeaf()) {
+        return mergedArea + inheritedCost;
+      }
+
+      return mergedArea - childNode.bounds.getSurfaceArea() + inheritedCost;
+    };
+
+    const f32 leftCost = getChildCost(node.left);
+    const f32 rightCost = getChildCost(node.right);
+
+    if (cost < leftCost && cost < rightCost) {
+      break;
+    }
+
+    index = leftCost < rightCost ? node.left : node.right;
+  }
+
+  const u32 sibling = index;
+  const u32 oldParent = mNodes[sibling].parent;
+  const u32 newParent = allocateNode();
+
+  auto &parent = mNodes.at(newParent);
+  parent.parent = oldParent;
+  parent.bounds = mNodes[sibling].bounds.merge(bounds);
+  parent.left = sibling;
+  parent.right = leaf;
+
+  mNodes[sibling].parent = newParent;
+  mNodes[leaf].parent = newParent;
+
+  if (oldParent == NullNode) {
+    mRoot = newParent;
+  } else {
+    auto &oldParentNode = mNodes[oldParent];
+    if (oldParentNode.left == sibling) {
+      oldParentNode.left = newParent;
+    } else {
+      oldParentNode.right = newParent;
+    }
+  }
+
+  refit(oldParent);
+}
+
+void BoundingVolumeHierarchy::removeLeaf(u32 leaf) {
+  if (leaf == mRoot) {
+    mRoot = NullNode;
+    return;
+  }
+
+  const u32 parent = mNodes[leaf].parent;
+  const u32 grandParent = mNodes[parent].parent;
+  const u32 sibling = mNodes[parent].left == leaf ? mNodes[parent].right
+                                                  : mNodes[parent].left;
+
+  // Sibling takes place of the parent
+  mNodes[sibling].parent = grandParent;
+  if (grandParent == NullNode) {
+    mRoot = sibling;
+  } else {
+    auto &grandParentNode = mNodes[grandParent];
+    if (grandParentNode.left == parent) {
+      grandParentNode.left = sibling;
+    } else {
+      grandParentNode.right = sibling;
+    }
+  }
+
+  freeNode(parent);
+  refit(grandParent);
+}
+
+void BoundingVolumeHierarchy::refit(u32 index) {
+  while (index != NullNode) {
+    auto &node = mNodes[index];
+    const BoundingBox bounds =
+        mNodes[node.left].bounds.merge(mNodes[node.right].bounds);
+
+    // Ancestors do not change if this node
+    // does not change
+    if (bounds.min == node.bounds.min && bounds.max == node.bounds.max) {
+      return;
+    }
+
+    node.bounds = bounds;
+    index = node.parent;
+  }
+}
+
+u32 &BoundingVolumeHierarchy::getLeafSlot(Entity entity) {
+  const auto index = getEntityIndex(entity);
+  if (index >= mLeaves.size()) {
+    mLeaves.resize((index + 1) * 2, NullNode);
+  }
+
+  return mLeaves[index];
+}
+
+} // namespace quoll
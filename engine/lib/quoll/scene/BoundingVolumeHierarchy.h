@@ -0,0 +1,253 @@
+#pragma once
+
+#include "quoll/entity/Entity.h"
+#include "quoll/physics/CollisionHit.h"
+#include "quoll/renderer/BoundingBox.h"
+#include "quoll/renderer/FrustumCulling.h"
+
+namespace quoll {
+
+/**
+ * @brief Dynamic bounding volume hierarchy
+ *
+ * Binary tree of bounding boxes where every
+ * leaf stores one entity. Leaves store enlarged
+ * boxes; so, small movements do not change the
+ * tree. Larger movements refit the boxes of all
+ * ancestors without changing tree structure.
+ * Tree quality degrades over time and is restored
+ * by rebuilding the tree with surface area heuristic.
+ */
+class BoundingVolumeHierarchy {
+public:
+  static constexpr u32 NullNode = std::numeric_limits<u32>::max();
+
+  /**
+   * Distance that leaf boxes are enlarged by
+   * in every direction
+   */
+  static constexpr f32 Margin = 0.1f;
+
+  /**
+   * @brief Tree node
+   */
+  struct Node {
+    /**
+     * Bounds of all objects in the subtree
+     *
+     * Enlarged by margin for leaves
+     */
+    BoundingBox bounds;
+
+    /**
+     * Bounds of leaf object
+     */
+    BoundingBox object;
+
+    u32 parent = NullNode;
+
+    u32 left = NullNode;
+
+    u32 right = NullNode;
+
+    Entity entity = Entity::Null;
+
+    /**
+     * @brief Check if node is leaf
+     *
+     * @retval true Node is leaf
+     * @retval false Node has children
+     */
+    inline bool isLeaf() const { return left == NullNode; }
+  };
+
+  /**
+   * @brief Entity with bounds
+   */
+  struct Entry {
+    Entity entity = Entity::Null;
+
+    BoundingBox bounds;
+  };
+
+public:
+  /**
+   * @brief Insert entity
+   *
+   * @param entity Entity
+   * @param bounds World space bounds
+   */
+  void insert(Entity entity, const BoundingBox &bounds);
+
+  /**
+   * @brief Update bounds of entity
+   *
+   * Leaves are found by entity index; so,
+   * the stored handle is replaced with the
+   * handle of the entity that recycled the index
+   *
+   * @param entity Entity
+   * @param bounds World space bounds
+   * @retval true Ancestor bounds are refitted
+   * @retval false Bounds are inside enlarged leaf box
+   */
+  bool update(Entity entity, const BoundingBox &bounds);
+
+  /**
+   * @brief Remove entity
+   *
+   * @param entity Entity
+   */
+  void remove(Entity entity);
+
+  /**
+   * @brief Check if entity exists in tree
+   *
+   * @param entity Entity
+   * @retval true Entity exists
+   * @retval false Entity does not exist
+   */
+  bool contains(Entity entity) const;
+
+  /**
+   * @brief Get bounds of entity
+   *
+   * @param entity Entity
+   * @return World space bounds
+   */
+  const BoundingBox &getBounds(Entity entity) const;
+
+  /**
+   * @brief Get stored handle of entity
+   *
+   * @param entity Entity
+   * @return Handle that is stored for
+   *         the index of the entity
+   */
+  Entity getEntity(Entity entity) const;
+
+  /**
+   * @brief Build tree from entries
+   *
+   * Removes all existing entities and builds
+   * tree from top to bottom. Splits are chosen
+   * with binned surface area heuristic.
+   *
+   * @param entries Entities with bounds
+   */
+  void build(std::span<const Entry> entries);
+
+  /**
+   * @brief Remove all entities
+   */
+  void clear();
+
+  /**
+   * @brief Get all entities with their bounds
+   *
+   * @return Entities with bounds
+   */
+  std::vector<Entry> getEntries() const;
+
+  /**
+   * @brief Find entities that overlap box
+   *
+   * @param bounds Bounding box
+   * @param entities Found entities are appended here
+   */
+  void queryOverlap(const BoundingBox &bounds,
+                    std::vector<Entity> &entities) const;
+
+  /**
+   * @brief Find entities inside or intersecting frustum
+   *
+   * @param frustum Frustum
+   * @param entities Found entities are appended here
+   */
+  void queryFrustum(const Frustum &frustum,
+                    std::vector<Entity> &entities) const;
+
+  /**
+   * @brief Find closest entity that intersects ray
+   *
+   * @param origin Ray origin
+   * @param direction Normalized ray direction
+   * @param maxDistance Maximum distance
+   * @param hit Closest hit
+   * @retval true Ray hit an entity
+   * @retval false Ray did not hit any entity
+   */
+  bool raycast(const glm::vec3 &origin, const glm::vec3 &direction,
+               f32 maxDistance, CollisionHit &hit) const;
+
+  /**
+   * @brief Find entity that is closest to point
+   *
+   * Distance is zero if point is inside bounds
+   * of entity.
+   *
+   * @param point Point
+   * @param maxDistance Maximum distance
+   * @param hit Closest entity
+   * @retval true Entity is found
+   * @retval false No entity within distance
+   */
+  bool findNearest(const glm::vec3 &point, f32 maxDistance,
+                   CollisionHit &hit) const;
+
+  /**
+   * @brief Get number of entities
+   *
+   * @return Number of entities
+   */
+  inline usize size() const { return mNumLeaves; }
+
+  /**
+   * @brief Get root node
+   *
+   * @return Root node index
+   */
+  inline u32 getRoot() const { return mRoot; }
+
+  /**
+   * @brief Get node
+   *
+   * @param index Node index
+   * @return Node
+   */
+  inline const Node &getNode(u32 index) const { return mNodes.at(index); }
+
+  /**
+   * @brief Get surface area heuristic cost
+   *
+   * Sum of surface areas of internal nodes
+   * relative to the root. Lower cost means
+   * fewer nodes are visited by queries.
+   *
+   * @return Tree cost
+   */
+  f32 getCost() const;
+
+private:
+  u32 allocateNode();
+
+  void freeNode(u32 index);
+
+  void insertLeaf(u32 leaf);
+
+  void removeLeaf(u32 leaf);
+
+  void refit(u32 index);
+
+  u32 &getLeafSlot(Entity entity);
+
+private:
+  std::vector<Node> mNodes;
+  std::vector<u32> mFreeNodes;
+  u32 mRoot = NullNode;
+  usize mNumLeaves = 0;
+
+  std::vector<u32> mLeaves;
+};
+
+} // namespace quoll
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "quoll/core/DirtyFlag.h"
+
 namespace quoll {
 
 struct LocalTransform {
@@ -8,6 +10,15 @@ struct LocalTransform {
   glm::quat localRotation{1.0f, 0.0f, 0.0f, 0.0f};
 
   glm::vec3 localScale{1.0f};
+
+  /**
+   * Raised when transform is changed
+   *
+   * Transforms that are modified in place must
+   * mark this flag in order to be picked up by
+   * the scene updater
+   */
+  DirtyFlag dirty;
 };
 
 } // namespace quoll
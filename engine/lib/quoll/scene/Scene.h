@@ -1,6 +1,7 @@
 #pragma once
 
 #include "quoll/entity/EntityDatabase.h"
+#include "SpatialIndex.h"
 
 namespace quoll {
 
@@ -26,6 +27,11 @@ struct Scene {
    * environments in the scene
    */
   Entity dummyEnvironment = Entity::Null;
+
+  /**
+   * Spatial index of entities with meshes
+   */
+  SpatialIndex spatialIndex;
 };
 
 } // namespace quoll
@@ -1,4 +1,5 @@
 #include "quoll/core/Base.h"
+#include "quoll/core/Engine.h"
 #include "quoll/core/Profiler.h"
 #include "quoll/entity/EntityDatabase.h"
 #include "quoll/scene/Camera.h"
@@ -6,6 +7,7 @@
 #include "quoll/scene/LocalTransform.h"
 #include "quoll/scene/Parent.h"
 #include "quoll/scene/PerspectiveLens.h"
+#include "quoll/scene/TransformKernel.h"
 #include "quoll/scene/WorldTransform.h"
 #include "quoll/skeleton/JointAttachment.h"
 #include "quoll/skeleton/Skeleton.h"
@@ -21,51 +23,247 @@ void SceneUpdater::update(SystemView &view) {
   updateLights(view);
 }
 
+bool SceneUpdater::updateHierarchyOrder(EntityDatabase &entityDatabase) {
+  QUOLL_PROFILE_EVENT("SceneUpdater::updateHierarchyOrder");
+  static constexpr u32 UnknownDepth = std::numeric_limits<u32>::max();
+  static constexpr u32 VisitingDepth = UnknownDepth - 1;
+
+  // Parent relations did not change since
+  // the order was last computed
+  auto version = entityDatabase.getComponentVersion<Parent>();
+  if (version == mHierarchyVersion) {
+    return false;
+  }
+  mHierarchyVersion = version;
+
+  auto getDepth = [this](Entity entity) -> u32 & {
+    auto index = getEntityIndex(entity);
+    if (index >= mDepths.size()) {
+      mDepths.resize((index + 1) * 2, UnknownDepth);
+    }
+    return mDepths[index];
+  };
+
+  std::fill(mDepths.begin(), mDepths.end(), UnknownDepth);
+
+  // Depth of root entities is zero and depth of
+  // every child is one more than its parent.
+  // Depths are cached while walking up the hierarchy,
+  // so every entity is only visited once
+  u32 maxDepth = 0;
+  for (auto [entity, parent] : entityDatabase.view<Parent>()) {
+    Entity current = entity;
+    while (entityDatabase.has<Parent>(current) &&
+           getDepth(current) == UnknownDepth) {
+      getDepth(current) = VisitingDepth;
+      mDepthStack.push_back(current);
+      current = entityDatabase.get<Parent>(current).parent;
+    }
+
+    u32 depth = entityDatabase.has<Parent>(current) ? getDepth(current) : 0;
+
+    // Entity that is revisited during the walk is its
+    // own ancestor; so, cycle is broken by ignoring
+    // parent of the revisited entity and making it a root
+    Entity cycleRoot = Entity::Null;
+    if (depth == VisitingDepth) {
+      Engine::getLogger().warning()
+          << "Entity " << static_cast<u32>(current)
+          << " is its own ancestor. Its parent is ignored";
+      cycleRoot = current;
+      depth = 0;
+    }
+    while (!mDepthStack.empty()) {
+      depth = mDepthStack.back() == cycleRoot ? 0 : depth + 1;
+      getDepth(mDepthStack.back()) = depth;
+      mDepthStack.pop_back();
+    }
+
+    maxDepth = std::max(maxDepth, getDepth(entity));
+  }
+
+  // Counting sort by depth
+  std::vector<usize> offsets(maxDepth + 2, 0);
+  for (auto [entity, parent] : entityDatabase.view<Parent>()) {
+    offsets[getDepth(entity) + 1]++;
+  }
+
+  for (usize i = 1; i < offsets.size(); ++i) {
+    offsets[i] += offsets[i - 1];
+  }
+
+  // Only entities that break a parent cycle
+  // have zero depth; so, their parent is ignored
+  mHierarchyOrder.resize(entityDatabase.getEntityCountForComponent<Parent>());
+  for (auto [entity, parent] : entityDatabase.view<Parent>()) {
+    const u32 depth = getDepth(entity);
+    mHierarchyOrder[offsets[depth]++] = {
+        entity, depth == 0 ? Entity::Null : parent.parent};
+  }
+
+  return true;
+}
+
 void SceneUpdater::updateTransforms(SystemView &view) {
   QUOLL_PROFILE_EVENT("SceneUpdater::updateTransforms");
 
   auto &entityDatabase = view.scene->entityDatabase;
+  mNumUpdatedTransforms = 0;
+  mUpdatedEntities.clear();
+  mFrame++;
+
+  // Parents are always updated before their
+  // children, so every child reads world transform
+  // of its parent from the current frame
+  bool forceUpdate = updateHierarchyOrder(entityDatabase);
+
+  // World transforms that are added or removed
+  // since last update are not calculated yet
+  auto worldVersion = entityDatabase.getComponentVersion<WorldTransform>();
+  if (worldVersion != mWorldTransformVersion) {
+    mWorldTransformVersion = worldVersion;
+    forceUpdate = true;
+  }
+
+  auto markChanged = [this](Entity entity) {
+    auto index = getEntityIndex(entity);
+    if (index >= mChangedFrames.size()) {
+      mChangedFrames.resize((index + 1) * 2, 0);
+    }
+    mChangedFrames[index] = mFrame;
+    mNumUpdatedTransforms++;
+    mUpdatedEntities.push_back(entity);
+  };
+
+  auto isChanged = [this](Entity entity) {
+    auto index = getEntityIndex(entity);
+    return index < mChangedFrames.size() && mChangedFrames[index] == mFrame;
+  };
+
+  auto &batch = mTransformBatch;
+  batch.positions.clear();
+  batch.rotations.clear();
+  batch.scales.clear();
+  batch.targets.clear();
+
+  // Local transforms are collected in hierarchy
+  // order and computed together after all changed
+  // entities are found
+  auto addToBatch = [&batch](LocalTransform &local, WorldTransform &world,
+                             const WorldTransform *parent,
+                             const glm::mat4 *joint, u32 depth) {
+    batch.positions.push_back(local.localPosition);
+    batch.rotations.push_back(local.localRotation);
+    batch.scales.push_back(local.localScale);
+    batch.targets.push_back({&world, parent, joint, depth});
+    local.dirty.clear();
+  };
+
   for (auto [entity, local, world] :
-       entityDatabase.view<LocalTransform, WorldTransform>()) {
-    // TODO: Add exclusive loop
-    if (entityDatabase.has<Parent>(entity))
+       entityDatabase.view<LocalTransform, WorldTransform>()
+           .exclude<Parent>()) {
+    if (!forceUpdate && !local.dirty.isDirty()) {
       continue;
+    }
 
-    const glm::mat4 identity{1.0f};
-    const glm::mat4 localTransform =
-        glm::translate(identity, local.localPosition) *
-        glm::toMat4(local.localRotation) *
-        glm::scale(identity, local.localScale);
-
-    world.worldTransform = localTransform;
+    addToBatch(local, world, nullptr, nullptr, 0);
+    markChanged(entity);
   }
 
-  for (auto [entity, local, world, parent] :
-       entityDatabase.view<LocalTransform, WorldTransform, Parent>()) {
-    auto &parentTransform = entityDatabase.get<WorldTransform>(parent.parent);
+  for (auto [entity, parent] : mHierarchyOrder) {
+    if (!entityDatabase.has<LocalTransform>(entity) ||
+        !entityDatabase.has<WorldTransform>(entity)) {
+      continue;
+    }
 
-    const glm::mat4 identity{1.0f};
-    const glm::mat4 localTransform =
-        glm::translate(identity, local.localPosition) *
-        glm::toMat4(local.localRotation) *
-        glm::scale(identity, local.localScale);
+    auto &local = entityDatabase.get<LocalTransform>(entity);
+    auto &world = entityDatabase.get<WorldTransform>(entity);
+
+    if (parent == Entity::Null) {
+      if (forceUpdate || local.dirty.isDirty()) {
+        addToBatch(local, world, nullptr, nullptr, 0);
+        markChanged(entity);
+      }
+      continue;
+    }
+
+    const auto &parentWorld = entityDatabase.get<WorldTransform>(parent);
 
     i16 jointId = -1;
     if (entityDatabase.has<JointAttachment>(entity) &&
-        entityDatabase.has<Skeleton>(parent.parent)) {
+        entityDatabase.has<Skeleton>(parent)) {
       jointId = entityDatabase.get<JointAttachment>(entity).joint;
     }
 
-    if (jointId >= 0 && static_cast<usize>(jointId) <
-                            entityDatabase.get<Skeleton>(parent.parent)
-                                .jointWorldTransforms.size()) {
-      const auto &jointTransform = entityDatabase.get<Skeleton>(parent.parent)
-                                       .jointWorldTransforms.at(jointId);
-      world.worldTransform =
-          parentTransform.worldTransform * jointTransform * localTransform;
-    } else {
-      world.worldTransform = parentTransform.worldTransform * localTransform;
+    const bool attachedToJoint =
+        jointId >= 0 &&
+        static_cast<usize>(jointId) <
+            entityDatabase.get<Skeleton>(parent).jointWorldTransforms.size();
+
+    // Joint transforms are not change tracked;
+    // so, joint attachments are always updated
+    if (!forceUpdate && !attachedToJoint && !local.dirty.isDirty() &&
+        !isChanged(parent)) {
+      continue;
     }
+
+    const glm::mat4 *jointTransform =
+        attachedToJoint
+            ? &entityDatabase.get<Skeleton>(parent).jointWorldTransforms.at(
+                  jointId)
+            : nullptr;
+
+    addToBatch(local, world, &parentWorld, jointTransform,
+               mDepths[getEntityIndex(entity)]);
+    markChanged(entity);
+  }
+
+  computeWorldTransforms();
+}
+
+void SceneUpdater::computeWorldTransforms() {
+  QUOLL_PROFILE_EVENT("SceneUpdater::computeWorldTransforms");
+
+  auto &batch = mTransformBatch;
+  const usize count = batch.targets.size();
+
+  batch.transforms.resize(count);
+  TransformKernel::compose(batch.positions, batch.rotations, batch.scales,
+                           batch.transforms);
+
+  // Batch is sorted by depth and entities with
+  // the same depth do not depend on each other;
+  // so, every depth is multiplied by the world
+  // transforms of their parents at once
+  usize start = 0;
+  while (start < count) {
+    const u32 depth = batch.targets[start].depth;
+    usize end = start + 1;
+    while (end < count && batch.targets[end].depth == depth) {
+      end++;
+    }
+
+    std::span<glm::mat4> transforms(batch.transforms.data() + start,
+                                    end - start);
+
+    if (depth > 0) {
+      batch.parentTransforms.resize(end - start);
+      for (usize i = start; i < end; ++i) {
+        const auto &target = batch.targets[i];
+        batch.parentTransforms[i - start] =
+            target.joint ? target.parent->worldTransform * *target.joint
+                         : target.parent->worldTransform;
+      }
+
+      TransformKernel::multiply(batch.parentTransforms, transforms,
+                                transforms);
+    }
+
+    for (usize i = start; i < end; ++i) {
+      batch.targets[i].world->worldTransform = batch.transforms[i];
+    }
+
+    start = end;
   }
 }
 
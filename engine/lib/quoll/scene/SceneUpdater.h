@@ -5,17 +5,101 @@
 namespace quoll {
 
 struct SystemView;
+class EntityDatabase;
+struct WorldTransform;
 
 class SceneUpdater {
+  /**
+   * Entity with parent in hierarchy order
+   *
+   * Parent is null for entities that
+   * break a parent cycle
+   */
+  struct HierarchyNode {
+    Entity entity = Entity::Null;
+
+    Entity parent = Entity::Null;
+  };
+
+  /**
+   * World transform that is computed
+   * from a batched local transform
+   */
+  struct TransformTarget {
+    WorldTransform *world = nullptr;
+
+    const WorldTransform *parent = nullptr;
+
+    const glm::mat4 *joint = nullptr;
+
+    u32 depth = 0;
+  };
+
+  /**
+   * Changed local transforms in hierarchy order
+   */
+  struct TransformBatch {
+    std::vector<glm::vec3> positions;
+
+    std::vector<glm::quat> rotations;
+
+    std::vector<glm::vec3> scales;
+
+    std::vector<glm::mat4> transforms;
+
+    std::vector<glm::mat4> parentTransforms;
+
+    std::vector<TransformTarget> targets;
+  };
+
 public:
   void update(SystemView &view);
 
+  /**
+   * @brief Get number of updated transforms
+   *
+   * @return Number of world transforms that
+   *         were recomputed in the last update
+   */
+  inline usize getNumUpdatedTransforms() const {
+    return mNumUpdatedTransforms;
+  }
+
+  /**
+   * @brief Get entities with updated transforms
+   *
+   * @return Entities whose world transforms
+   *         were recomputed in the last update
+   */
+  inline const std::vector<Entity> &getUpdatedEntities() const {
+    return mUpdatedEntities;
+  }
+
 private:
+  bool updateHierarchyOrder(EntityDatabase &entityDatabase);
+
   void updateTransforms(SystemView &view);
 
+  void computeWorldTransforms();
+
   void updateCameras(SystemView &view);
 
   void updateLights(SystemView &view);
+
+private:
+  std::vector<HierarchyNode> mHierarchyOrder;
+  u64 mHierarchyVersion = 0;
+
+  std::vector<u32> mDepths;
+  std::vector<Entity> mDepthStack;
+
+  u64 mWorldTransformVersion = 0;
+  u32 mFrame = 0;
+  std::vector<u32> mChangedFrames;
+  usize mNumUpdatedTransforms = 0;
+  std::vector<Entity> mUpdatedEntities;
+
+  TransformBatch mTransformBatch;
 };
 
 } // namespace quoll
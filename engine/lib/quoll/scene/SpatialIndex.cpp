@@ -0,0 +1,122 @@
+#include "quoll/core/Base.h"
+#include "quoll/core/Profiler.h"
+#include "quoll/core/ThreadPool.h"
+#include "SpatialIndex.h"
+
+namespace quoll {
+
+void SpatialIndex::set(Entity entity, const BoundingBox &bounds) {
+  if (mHierarchy.contains(entity)) {
+    if (mHierarchy.update(entity, bounds)) {
+      mNumRefits++;
+    }
+  } else {
+    mHierarchy.insert(entity, bounds);
+  }
+
+  markChanged(entity);
+}
+
+void SpatialIndex::remove(Entity entity) {
+  if (!mHierarchy.contains(entity)) {
+    return;
+  }
+
+  mHierarchy.remove(entity);
+  markChanged(entity);
+}
+
+std::vector<Entity> SpatialIndex::getEntities() const {
+  std::vector<Entity> entities;
+  entities.reserve(mHierarchy.size());
+  for (const auto &entry : mHierarchy.getEntries()) {
+    entities.push_back(entry.entity);
+  }
+
+  return entities;
+}
+
+void SpatialIndex::update(ThreadPool &threadPool) {
+  if (mRebuild && mRebuild->done.load(std::memory_order_acquire)) {
+    finishRebuild();
+  }
+
+  const auto threshold = static_cast<usize>(
+      static_cast<f32>(mHierarchy.size()) * RebuildRatio);
+  if (mNumRefits > 0 && mNumRefits >= threshold) {
+    rebuild(threadPool);
+  }
+}
+
+void SpatialIndex::rebuild(ThreadPool &threadPool) {
+  if (mRebuild) {
+    return;
+  }
+
+  auto rebuild = std::make_shared<Rebuild>();
+  rebuild->entries = mHierarchy.getEntries();
+
+  mRebuild = rebuild;
+  mNumRefits = 0;
+
+  threadPool.submit([rebuild]() {
+    QUOLL_PROFILE_EVENT("SpatialIndex::rebuild");
+    rebuild->hierarchy.build(rebuild->entries);
+    rebuild->done.store(true, std::memory_order_release);
+  });
+
+  // Job runs immediately if there
+  // are no worker threads
+  if (rebuild->done.load(std::memory_order_acquire)) {
+    finishRebuild();
+  }
+}
+
+void SpatialIndex::markChanged(Entity entity) {
+  if (!mRebuild) {
+    return;
+  }
+
+  const auto index = getEntityIndex(entity);
+  if (index >= mChangedFlags.size()) {
+    mChangedFlags.resize((index + 1) * 2, false);
+  }
+
+  if (!mChangedFlags[index]) {
+    mChangedFlags[index] = true;
+    mChangedDuringRebuild.push_back(entity);
+  }
+}
+
+void SpatialIndex::finishRebuild() {
+  QUOLL_PROFILE_EVENT("SpatialIndex::finishRebuild");
+  auto &hierarchy = mRebuild->hierarchy;
+
+  // Rebuilt hierarchy has bounds from when
+  // the rebuild started; so, changes that
+  // happened since then are applied to it.
+  // Changes are recorded once per index and
+  // the index can be recycled since then; so,
+  // handles are taken from current hierarchy
+  for (auto changed : mChangedDuringRebuild) {
+    mChangedFlags[getEntityIndex(changed)] = false;
+
+    if (mHierarchy.contains(changed)) {
+      const auto entity = mHierarchy.getEntity(changed);
+      const auto &bounds = mHierarchy.getBounds(entity);
+      if (hierarchy.contains(entity)) {
+        hierarchy.update(entity, bounds);
+      } else {
+        hierarchy.insert(entity, bounds);
+      }
+    } else if (hierarchy.contains(changed)) {
+      hierarchy.remove(changed);
+    }
+  }
+  mChangedDuringRebuild.clear();
+
+  mHierarchy = std::move(hierarchy);
+  mRebuild = nullptr;
+}
+
+} // namespace quoll
@@ -0,0 +1,194 @@
+#pragma once
+
+#include "BoundingVolumeHierarchy.h"
+
+namespace quoll {
+
+class ThreadPool;
+
+/**
+ * @brief Spatial index of scene entities
+ *
+ * Keeps entity bounds in a dynamic bounding
+ * volume hierarchy. Changed bounds are refitted
+ * immediately and the hierarchy is rebuilt in the
+ * background when enough of it has been refitted.
+ * Queries always use the current hierarchy; so,
+ * results are up to date while a rebuild is running.
+ */
+class SpatialIndex {
+  /**
+   * Hierarchy that is built in the background
+   *
+   * Shared with the rebuild job; so, job does
+   * not outlive its data if index is destroyed
+   */
+  struct Rebuild {
+    std::vector<BoundingVolumeHierarchy::Entry> entries;
+
+    BoundingVolumeHierarchy hierarchy;
+
+    std::atomic<bool> done{false};
+  };
+
+public:
+  /**
+   * Rebuild is started when the number of
+   * refits since the last build reaches
+   * this ratio of entities
+   */
+  static constexpr f32 RebuildRatio = 0.25f;
+
+public:
+  /**
+   * @brief Set bounds of entity
+   *
+   * Adds entity if it does not exist
+   *
+   * @param entity Entity
+   * @param bounds World space bounds
+   */
+  void set(Entity entity, const BoundingBox &bounds);
+
+  /**
+   * @brief Remove entity
+   *
+   * @param entity Entity
+   */
+  void remove(Entity entity);
+
+  /**
+   * @brief Check if entity exists in index
+   *
+   * @param entity Entity
+   * @retval true Entity exists
+   * @retval false Entity does not exist
+   */
+  inline bool contains(Entity entity) const {
+    return mHierarchy.contains(entity);
+  }
+
+  /**
+   * @brief Get all entities in index
+   *
+   * @return Entities
+   */
+  std::vector<Entity> getEntities() const;
+
+  /**
+   * @brief Get number of entities
+   *
+   * @return Number of entities
+   */
+  inline usize size() const { return mHierarchy.size(); }
+
+  /**
+   * @brief Finish and start background rebuilds
+   *
+   * Replaces hierarchy with the rebuilt one when
+   * the rebuild is finished and starts a new rebuild
+   * when hierarchy is refitted too many times.
+   *
+   * @param threadPool Thread pool
+   */
+  void update(ThreadPool &threadPool);
+
+  /**
+   * @brief Rebuild hierarchy in the background
+   *
+   * Does nothing if rebuild is already running
+   *
+   * @param threadPool Thread pool
+   */
+  void rebuild(ThreadPool &threadPool);
+
+  /**
+   * @brief Check if rebuild is running
+   *
+   * @retval true Rebuild is running
+   * @retval false Rebuild is not running
+   */
+  inline bool isRebuilding() const { return mRebuild != nullptr; }
+
+  /**
+   * @brief Get number of refits since last build
+   *
+   * @return Number of refits
+   */
+  inline usize getNumRefits() const { return mNumRefits; }
+
+  /**
+   * @brief Get hierarchy
+   *
+   * @return Bounding volume hierarchy
+   */
+  inline const BoundingVolumeHierarchy &getHierarchy() const {
+    return mHierarchy;
+  }
+
+  /**
+   * @brief Find entities that overlap box
+   *
+   * @param bounds Bounding box
+   * @param entities Found entities are appended here
+   */
+  inline void queryOverlap(const BoundingBox &bounds,
+                           std::vector<Entity> &entities) const {
+    mHierarchy.queryOverlap(bounds, entities);
+  }
+
+  /**
+   * @brief Find entities inside or intersecting frustum
+   *
+   * @param frustum Frustum
+   * @param entities Found entities are appended here
+   */
+  inline void queryFrustum(const Frustum &frustum,
+                           std::vector<Entity> &entities) const {
+    mHierarchy.queryFrustum(frustum, entities);
+  }
+
+  /**
+   * @brief Find closest entity that intersects ray
+   *
+   * @param origin Ray origin
+   * @param direction Normalized ray direction
+   * @param maxDistance Maximum distance
+   * @param hit Closest hit
+   * @retval true Ray hit an entity
+   * @retval false Ray did not hit any entity
+   */
+  inline bool raycast(const glm::vec3 &origin, const glm::vec3 &direction,
+                      f32 maxDistance, CollisionHit &hit) const {
+    return mHierarchy.raycast(origin, direction, maxDistance, hit);
+  }
+
+  /**
+   * @brief Find entity that is closest to point
+   *
+   * @param point Point
+   * @param maxDistance Maximum distance
+   * @param hit Closest entity
+   * @retval true Entity is found
+   * @retval false No entity within distance
+   */
+  inline bool findNearest(const glm::vec3 &point, f32 maxDistance,
+                          CollisionHit &hit) const {
+    return mHierarchy.findNearest(point, maxDistance, hit);
+  }
+
+private:
+  void markChanged(Entity entity);
+
+  void finishRebuild();
+
+private:
+  BoundingVolumeHierarchy mHierarchy;
+  usize mNumRefits = 0;
+
+  std::shared_ptr<Rebuild> mRebuild;
+  std::vector<Entity> mChangedDuringRebuild;
+  std::vector<bool> mChangedFlags;
+};
+
+} // namespace quoll
@@ -0,0 +1,63 @@
+#include "quoll/core/Base.h"
+#include "SpatialIndex.h"
+#include "SpatialIndexLuaTable.h"
+
+namespace quoll {
+
+SpatialIndexLuaTable::SpatialIndexLuaTable(ScriptGlobals scriptGlobals)
+    : mScriptGlobals(scriptGlobals) {}
+
+std::tuple<bool, sol_maybe<CollisionHit>>
+SpatialIndexLuaTable::raycast(f32 x, f32 y, f32 z, f32 dx, f32 dy, f32 dz,
+                              f32 maxDistance) {
+  const glm::vec3 direction{dx, dy, dz};
+  const f32 length = glm::length(direction);
+  if (length == 0.0f) {
+    return {false, sol::nil};
+  }
+
+  CollisionHit hit{};
+  if (mScriptGlobals.spatialIndex.raycast({x, y, z}, direction / length,
+                                          maxDistance, hit)) {
+    return {true, hit};
+  }
+
+  return {false, sol::nil};
+}
+
+std::tuple<bool, sol_maybe<CollisionHit>>
+SpatialIndexLuaTable::findNearest(f32 x, f32 y, f32 z, f32 maxDistance) {
+  CollisionHit hit{};
+  if (mScriptGlobals.spatialIndex.findNearest({x, y, z}, maxDistance, hit)) {
+    return {true, hit};
+  }
+
+  return {false, sol::nil};
+}
+
+sol::as_table_t<std::vector<EntityLuaTable>>
+SpatialIndexLuaTable::queryBox(f32 minX, f32 minY, f32 minZ, f32 maxX,
+                               f32 maxY, f32 maxZ) {
+  std::vector<Entity> entities;
+  mScriptGlobals.spatialIndex.queryOverlap(
+      {{minX, minY, minZ}, {maxX, maxY, maxZ}}, entities);
+
+  std::vector<EntityLuaTable> tables;
+  tables.reserve(entities.size());
+  for (auto entity : entities) {
+    tables.emplace_back(entity, mScriptGlobals);
+  }
+
+  return sol::as_table(std::move(tables));
+}
+
+void SpatialIndexLuaTable::create(sol::state_view state) {
+  auto usertype =
+      state.new_usertype<SpatialIndexLuaTable>("Spatial", sol::no_constructor);
+
+  usertype["raycast"] = &SpatialIndexLuaTable::raycast;
+  usertype["findNearest"] = &SpatialIndexLuaTable::findNearest;
+  usertype["queryBox"] = &SpatialIndexLuaTable::queryBox;
+}
+
+} // namespace quoll
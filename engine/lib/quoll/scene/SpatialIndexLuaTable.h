@@ -0,0 +1,27 @@
+#pragma once
+
+#include "quoll/entity/EntityLuaTable.h"
+
+namespace quoll {
+
+class SpatialIndexLuaTable {
+public:
+  SpatialIndexLuaTable(ScriptGlobals scriptGlobals);
+
+  std::tuple<bool, sol_maybe<CollisionHit>> raycast(f32 x, f32 y, f32 z,
+                                                    f32 dx, f32 dy, f32 dz,
+                                                    f32 maxDistance);
+
+  std::tuple<bool, sol_maybe<CollisionHit>> findNearest(f32 x, f32 y, f32 z,
+                                                        f32 maxDistance);
+
+  sol::as_table_t<std::vector<EntityLuaTable>>
+  queryBox(f32 minX, f32 minY, f32 minZ, f32 maxX, f32 maxY, f32 maxZ);
+
+  static void create(sol::state_view state);
+
+private:
+  ScriptGlobals mScriptGlobals;
+};
+
+} // namespace quoll
@@ -0,0 +1,109 @@
+#include "quoll/core/Base.h"
+#include "quoll/core/Engine.h"
+#include "quoll/core/Profiler.h"
+#include "quoll/entity/EntityDatabase.h"
+#include "quoll/renderer/Mesh.h"
+#include "quoll/scene/WorldTransform.h"
+#include "quoll/skeleton/Skeleton.h"
+#include "quoll/system/SystemView.h"
+#include "SpatialIndexUpdater.h"
+
+namespace quoll {
+
+void SpatialIndexUpdater::update(SystemView &view,
+                                 std::span<const Entity> updatedEntities) {
+  QUOLL_PROFILE_EVENT("SpatialIndexUpdater::update");
+  auto &entityDatabase = view.scene->entityDatabase;
+
+  const auto meshVersion = entityDatabase.getComponentVersion<Mesh>();
+  const auto worldVersion =
+      entityDatabase.getComponentVersion<WorldTransform>();
+
+  if (meshVersion != mMeshVersion || worldVersion != mWorldTransformVersion) {
+    mMeshVersion = meshVersion;
+    mWorldTransformVersion = worldVersion;
+    updateAll(view);
+  } else {
+    // Mesh assets that were not loaded
+    // in previous updates
+    std::swap(mPending, mStillPending);
+    mPending.clear();
+    for (auto entity : mStillPending) {
+      updateEntity(view, entity);
+    }
+
+    for (auto entity : updatedEntities) {
+      if (entityDatabase.has<Mesh>(entity)) {
+        updateEntity(view, entity);
+      }
+    }
+
+    // Joint transforms are not change tracked
+    for (auto [entity, skeleton, world, mesh] :
+         entityDatabase.view<Skeleton, WorldTransform, Mesh>()) {
+      updateEntity(view, entity);
+    }
+  }
+
+  view.scene->spatialIndex.update(Engine::getThreadPool());
+}
+
+void SpatialIndexUpdater::updateAll(SystemView &view) {
+  QUOLL_PROFILE_EVENT("SpatialIndexUpdater::updateAll");
+  auto &entityDatabase = view.scene->entityDatabase;
+  auto &spatialIndex = view.scene->spatialIndex;
+
+  for (auto entity : spatialIndex.getEntities()) {
+    if (!entityDatabase.exists(entity) || !entityDatabase.has<Mesh>(entity) ||
+        !entityDatabase.has<WorldTransform>(entity)) {
+      spatialIndex.remove(entity);
+    }
+  }
+
+  mPending.clear();
+  for (auto [entity, world, mesh] :
+       entityDatabase.view<WorldTransform, Mesh>()) {
+    updateEntity(view, entity);
+  }
+}
+
+void SpatialIndexUpdater::updateEntity(SystemView &view, Entity entity) {
+  auto &entityDatabase = view.scene->entityDatabase;
+  auto &spatialIndex = view.scene->spatialIndex;
+
+  if (!entityDatabase.exists(entity) || !entityDatabase.has<Mesh>(entity) ||
+      !entityDatabase.has<WorldTransform>(entity)) {
+    return;
+  }
+
+  const auto &mesh = entityDatabase.get<Mesh>(entity);
+  if (!mesh.asset || mesh.asset->geometries.empty()) {
+    mPending.push_back(entity);
+    return;
+  }
+
+  const auto &geometries = mesh.asset->geometries;
+  BoundingBox bounds = geometries.front().bounds;
+  for (const auto &geometry : geometries) {
+    bounds = bounds.merge(geometry.bounds);
+  }
+
+  // Skinned vertices are inside the union
+  // of bounds moved by every joint
+  if (entityDatabase.has<Skeleton>(entity)) {
+    const auto &joints =
+        entityDatabase.get<Skeleton>(entity).jointFinalTransforms;
+    if (!joints.empty()) {
+      BoundingBox skinned = bounds.transform(joints.front());
+      for (const auto &joint : joints) {
+        skinned = skinned.merge(bounds.transform(joint));
+      }
+      bounds = skinned;
+    }
+  }
+
+  const auto &world = entityDatabase.get<WorldTransform>(entity);
+  spatialIndex.set(entity, bounds.transform(world.worldTransform));
+}
+
+} // namespace quoll
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "quoll/entity/Entity.h"
+
+namespace quoll {
+
+struct SystemView;
+
+/**
+ * @brief Spatial index updater
+ *
+ * Keeps bounds of entities with meshes
+ * in the spatial index of the scene.
+ */
+class SpatialIndexUpdater {
+public:
+  /**
+   * @brief Update spatial index
+   *
+   * Only updates bounds of entities whose world
+   * transforms are updated unless meshes or
+   * world transforms are added or removed.
+   * Skinned meshes are updated every time.
+   *
+   * @param view System view
+   * @param updatedEntities Entities with updated world transforms
+   */
+  void update(SystemView &view, std::span<const Entity> updatedEntities);
+
+private:
+  void updateAll(SystemView &view);
+
+  void updateEntity(SystemView &view, Entity entity);
+
+private:
+  u64 mMeshVersion = 0;
+  u64 mWorldTransformVersion = 0;
+
+  std::vector<Entity> mPending;
+  std::vector<Entity> mStillPending;
+};
+
+} // namespace quoll
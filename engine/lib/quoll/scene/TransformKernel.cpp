@@ -0,0 +1,495 @@
+#include "quoll/core/Base.h"
+#include "TransformKernel.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define QUOLL_TRANSFORM_KERNEL_X86
+#include <immintrin.h>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define QUOLL_TARGET_AVX2
+#else
+#define QUOLL_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+#endif
+
+namespace quoll {
+
+namespace {
+
+using ComposeFn = void (*)(const glm::vec3 *, const glm::quat *,
+                           const glm::vec3 *, glm::mat4 *, usize);
+
+using MultiplyFn = void (*)(const glm::mat4 *, const glm::mat4 *, glm::mat4 *,
+                            usize);
+
+void composeScalar(const glm::vec3 *positions, const glm::quat *rotations,
+                   const glm::vec3 *scales, glm::mat4 *transforms,
+                   usize start, usize end) {
+  for (usize i = start; i < end; ++i) {
+    const auto &q = rotations[i];
+    const auto &s = scales[i];
+
+    const f32 xx = q.x * q.x;
+    const f32 yy = q.y * q.y;
+    const f32 zz = q.z * q.z;
+    const f32 xy = q.x * q.y;
+    const f32 xz = q.x * q.z;
+    const f32 yz = q.y * q.z;
+    const f32 wx = q.w * q.x;
+    const f32 wy = q.w * q.y;
+    const f32 wz = q.w * q.z;
+
+    auto &m = transforms[i];
+    m[0] = glm::vec4(1.0f - 2.0f * (yy + zz), 2.0f * (xy + wz),
+                     2.0f * (xz - wy), 0.0f) *
+           s.x;
+    m[1] = glm::vec4(2.0f * (xy - wz), 1.0f - 2.0f * (xx + zz),
+                     2.0f * (yz + wx), 0.0f) *
+           s.y;
+    m[2] = glm::vec4(2.0f * (xz + wy), 2.0f * (yz - wx),
+                     1.0f - 2.0f * (xx + yy), 0.0f) *
+           s.z;
+    m[3] = glm::vec4(positions[i], 1.0f);
+  }
+}
+
+void composeScalar(const glm::vec3 *positions, const glm::quat *rotations,
+                   const glm::vec3 *scales, glm::mat4 *transforms,
+                   usize count) {
+  composeScalar(positions, rotations, scales, transforms, 0, count);
+}
+
+void multiplyScalar(const glm::mat4 *lhs, const glm::mat4 *rhs,
+                    glm::mat4 *result, usize start, usize end) {
+  for (usize i = start; i < end; ++i) {
+    result[i] = lhs[i] * rhs[i];
+  }
+}
+
+void multiplyScalar(const glm::mat4 *lhs, const glm::mat4 *rhs,
+                    glm::mat4 *result, usize count) {
+  multiplyScalar(lhs, rhs, result, 0, count);
+}
+
+/**
+ * @brief Get number of elements that can be loaded as vec4
+ *
+ * Vec3 arrays are loaded four floats at a time,
+ * which reads the first float of the next element.
+ * Last element is never part of a full batch,
+ * so that the load never reads past the array.
+ *
+ * @param count Number of elements
+ * @param width Batch width
+ * @return Number of elements processed in full batches
+ */
+usize getBatchedCount(usize count, usize width) {
+  return count == 0 ? 0 : ((count - 1) / width) * width;
+}
+
+#ifdef QUOLL_TRANSFORM_KERNEL_X86
+
+/**
+ * @brief Calculate (1 - 2 * (a + b)) * scale
+ */
+__m128 diagonalSSE(__m128 a, __m128 b, __m128 scale) {
+  const __m128 value = _mm_mul_ps(_mm_set1_ps(2.0f), _mm_add_ps(a, b));
+  return _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(1.0f), value), scale);
+}
+
+/**
+ * @brief Calculate 2 * (a + b) * scale
+ */
+__m128 sumSSE(__m128 a, __m128 b, __m128 scale) {
+  const __m128 value = _mm_mul_ps(_mm_set1_ps(2.0f), _mm_add_ps(a, b));
+  return _mm_mul_ps(value, scale);
+}
+
+/**
+ * @brief Calculate 2 * (a - b) * scale
+ */
+__m128 differenceSSE(__m128 a, __m128 b, __m128 scale) {
+  const __m128 value = _mm_mul_ps(_mm_set1_ps(2.0f), _mm_sub_ps(a, b));
+  return _mm_mul_ps(value, scale);
+}
+
+void composeSSE(const glm::vec3 *positions, const glm::quat *rotations,
+                const glm::vec3 *scales, glm::mat4 *transforms, usize count) {
+  static constexpr usize Width = 4;
+  const usize batchedCount = getBatchedCount(count, Width);
+
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 zero = _mm_setzero_ps();
+
+  for (usize i = 0; i < batchedCount; i += Width) {
+    __m128 qx = _mm_loadu_ps(&rotations[i + 0].x);
+    __m128 qy = _mm_loadu_ps(&rotations[i + 1].x);
+    __m128 qz = _mm_loadu_ps(&rotations[i + 2].x);
+    __m128 qw = _mm_loadu_ps(&rotations[i + 3].x);
+    _MM_TRANSPOSE4_PS(qx, qy, qz, qw);
+
+    __m128 px = _mm_loadu_ps(&positions[i + 0].x);
+    __m128 py = _mm_loadu_ps(&positions[i + 1].x);
+    __m128 pz = _mm_loadu_ps(&positions[i + 2].x);
+    __m128 pw = _mm_loadu_ps(&positions[i + 3].x);
+    _MM_TRANSPOSE4_PS(px, py, pz, pw);
+
+    __m128 sx = _mm_loadu_ps(&scales[i + 0].x);
+    __m128 sy = _mm_loadu_ps(&scales[i + 1].x);
+    __m128 sz = _mm_loadu_ps(&scales[i + 2].x);
+    __m128 sw = _mm_loadu_ps(&scales[i + 3].x);
+    _MM_TRANSPOSE4_PS(sx, sy, sz, sw);
+
+    const __m128 xx = _mm_mul_ps(qx, qx);
+    const __m128 yy = _mm_mul_ps(qy, qy);
+    const __m128 zz = _mm_mul_ps(qz, qz);
+    const __m128 xy = _mm_mul_ps(qx, qy);
+    const __m128 xz = _mm_mul_ps(qx, qz);
+    const __m128 yz = _mm_mul_ps(qy, qz);
+    const __m128 wx = _mm_mul_ps(qw, qx);
+    const __m128 wy = _mm_mul_ps(qw, qy);
+    const __m128 wz = _mm_mul_ps(qw, qz);
+
+    // Rows are matrix elements and
+    // columns are transforms
+    __m128 c00 = diagonalSSE(yy, zz, sx);
+    __m128 c01 = sumSSE(xy, wz, sx);
+    __m128 c02 = differenceSSE(xz, wy, sx);
+    __m128 c03 = zero;
+
+    __m128 c10 = differenceSSE(xy, wz, sy);
+    __m128 c11 = diagonalSSE(xx, zz, sy);
+    __m128 c12 = sumSSE(yz, wx, sy);
+    __m128 c13 = zero;
+
+    __m128 c20 = sumSSE(xz, wy, sz);
+    __m128 c21 = differenceSSE(yz, wx, sz);
+    __m128 c22 = diagonalSSE(xx, yy, sz);
+    __m128 c23 = zero;
+
+    __m128 c33 = one;
+
+    _MM_TRANSPOSE4_PS(c00, c01, c02, c03);
+    _MM_TRANSPOSE4_PS(c10, c11, c12, c13);
+    _MM_TRANSPOSE4_PS(c20, c21, c22, c23);
+    _MM_TRANSPOSE4_PS(px, py, pz, c33);
+
+    const __m128 columns[4][4] = {{c00, c10, c20, px},
+                                  {c01, c11, c21, py},
+                                  {c02, c12, c22, pz},
+                                  {c03, c13, c23, c33}};
+
+    for (usize j = 0; j < Width; ++j) {
+      f32 *out = glm::value_ptr(transforms[i + j]);
+      _mm_storeu_ps(out + 0, columns[j][0]);
+      _mm_storeu_ps(out + 4, columns[j][1]);
+      _mm_storeu_ps(out + 8, columns[j][2]);
+      _mm_storeu_ps(out + 12, columns[j][3]);
+    }
+  }
+
+  composeScalar(positions, rotations, scales, transforms, batchedCount, count);
+}
+
+void multiplySSE(const glm::mat4 *lhs, const glm::mat4 *rhs, glm::mat4 *result,
+                 usize count) {
+  for (usize i = 0; i < count; ++i) {
+    const f32 *a = glm::value_ptr(lhs[i]);
+    const f32 *b = glm::value_ptr(rhs[i]);
+    f32 *out = glm::value_ptr(result[i]);
+
+    const __m128 a0 = _mm_loadu_ps(a + 0);
+    const __m128 a1 = _mm_loadu_ps(a + 4);
+    const __m128 a2 = _mm_loadu_ps(a + 8);
+    const __m128 a3 = _mm_loadu_ps(a + 12);
+
+    for (usize j = 0; j < 4; ++j) {
+      const __m128 column = _mm_loadu_ps(b + j * 4);
+
+      const __m128 x = _mm_shuffle_ps(column, column, _MM_SHUFFLE(0, 0, 0, 0));
+      const __m128 y = _mm_shuffle_ps(column, column, _MM_SHUFFLE(1, 1, 1, 1));
+      const __m128 z = _mm_shuffle_ps(column, column, _MM_SHUFFLE(2, 2, 2, 2));
+      const __m128 w = _mm_shuffle_ps(column, column, _MM_SHUFFLE(3, 3, 3, 3));
+
+      __m128 value = _mm_mul_ps(a0, x);
+      value = _mm_add_ps(value, _mm_mul_ps(a1, y));
+      value = _mm_add_ps(value, _mm_mul_ps(a2, z));
+      value = _mm_add_ps(value, _mm_mul_ps(a3, w));
+
+      _mm_storeu_ps(out + j * 4, value);
+    }
+  }
+}
+
+/**
+ * @brief Transpose 4x4 blocks in both 128-bit lanes
+ */
+QUOLL_TARGET_AVX2 void transposeAVX2(__m256 &r0, __m256 &r1, __m256 &r2,
+                                     __m256 &r3) {
+  const __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+  const __m256 t1 = _mm256_unpacklo_ps(r2, r3);
+  const __m256 t2 = _mm256_unpackhi_ps(r0, r1);
+  const __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+
+  r0 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0));
+  r1 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2));
+  r2 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0));
+  r3 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2));
+}
+
+/**
+ * @brief Load element i and i + 4 into lanes
+ */
+QUOLL_TARGET_AVX2 __m256 loadLanesAVX2(const f32 *low, const f32 *high) {
+  return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(low)),
+                              _mm_loadu_ps(high), 1);
+}
+
+/**
+ * @brief Calculate (1 - 2 * (a + b)) * scale
+ */
+QUOLL_TARGET_AVX2 __m256 diagonalAVX2(__m256 a, __m256 b, __m256 scale) {
+  const __m256 value = _mm256_mul_ps(_mm256_set1_ps(2.0f), _mm256_add_ps(a, b));
+  return _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(1.0f), value), scale);
+}
+
+/**
+ * @brief Calculate 2 * (a + b) * scale
+ */
+QUOLL_TARGET_AVX2 __m256 sumAVX2(__m256 a, __m256 b, __m256 scale) {
+  const __m256 value = _mm256_mul_ps(_mm256_set1_ps(2.0f), _mm256_add_ps(a, b));
+  return _mm256_mul_ps(value, scale);
+}
+
+/**
+ * @brief Calculate 2 * (a - b) * scale
+ */
+QUOLL_TARGET_AVX2 __m256 differenceAVX2(__m256 a, __m256 b, __m256 scale) {
+  const __m256 value = _mm256_mul_ps(_mm256_set1_ps(2.0f), _mm256_sub_ps(a, b));
+  return _mm256_mul_ps(value, scale);
+}
+
+QUOLL_TARGET_AVX2 void composeAVX2(const glm::vec3 *positions,
+                                   const glm::quat *rotations,
+                                   const glm::vec3 *scales,
+                                   glm::mat4 *transforms, usize count) {
+  static constexpr usize Width = 8;
+  static constexpr usize Half = Width / 2;
+  const usize batchedCount = getBatchedCount(count, Width);
+
+  const __m256 one = _mm256_set1_ps(1.0f);
+  const __m256 zero = _mm256_setzero_ps();
+
+  // Every 128-bit lane holds four transforms;
+  // lower lane holds transforms [0, 4) and
+  // upper lane holds transforms [4, 8)
+  for (usize i = 0; i < batchedCount; i += Width) {
+    __m256 q[4];
+    __m256 p[4];
+    __m256 s[4];
+    for (usize j = 0; j < Half; ++j) {
+      q[j] = loadLanesAVX2(&rotations[i + j].x, &rotations[i + j + Half].x);
+      p[j] = loadLanesAVX2(&positions[i + j].x, &positions[i + j + Half].x);
+      s[j] = loadLanesAVX2(&scales[i + j].x, &scales[i + j + Half].x);
+    }
+
+    transposeAVX2(q[0], q[1], q[2], q[3]);
+    transposeAVX2(p[0], p[1], p[2], p[3]);
+    transposeAVX2(s[0], s[1], s[2], s[3]);
+
+    const __m256 &qx = q[0];
+    const __m256 &qy = q[1];
+    const __m256 &qz = q[2];
+    const __m256 &qw = q[3];
+
+    const __m256 xx = _mm256_mul_ps(qx, qx);
+    const __m256 yy = _mm256_mul_ps(qy, qy);
+    const __m256 zz = _mm256_mul_ps(qz, qz);
+    const __m256 xy = _mm256_mul_ps(qx, qy);
+    const __m256 xz = _mm256_mul_ps(qx, qz);
+    const __m256 yz = _mm256_mul_ps(qy, qz);
+    const __m256 wx = _mm256_mul_ps(qw, qx);
+    const __m256 wy = _mm256_mul_ps(qw, qy);
+    const __m256 wz = _mm256_mul_ps(qw, qz);
+
+    __m256 c[4][4] = {{diagonalAVX2(yy, zz, s[0]), sumAVX2(xy, wz, s[0]),
+                       differenceAVX2(xz, wy, s[0]), zero},
+                      {differenceAVX2(xy, wz, s[1]), diagonalAVX2(xx, zz, s[1]),
+                       sumAVX2(yz, wx, s[1]), zero},
+                      {sumAVX2(xz, wy, s[2]), differenceAVX2(yz, wx, s[2]),
+                       diagonalAVX2(xx, yy, s[2]), zero},
+                      {p[0], p[1], p[2], one}};
+
+    for (auto &column : c) {
+      transposeAVX2(column[0], column[1], column[2], column[3]);
+    }
+
+    for (usize j = 0; j < Half; ++j) {
+      f32 *low = glm::value_ptr(transforms[i + j]);
+      f32 *high = glm::value_ptr(transforms[i + j + Half]);
+      for (usize k = 0; k < 4; ++k) {
+        _mm_storeu_ps(low + k * 4, _mm256_castps256_ps128(c[k][j]));
+        _mm_storeu_ps(high + k * 4, _mm256_extractf128_ps(c[k][j], 1));
+      }
+    }
+  }
+
+  composeScalar(positions, rotations, scales, transforms, batchedCount, count);
+}
+
+QUOLL_TARGET_AVX2 void multiplyAVX2(const glm::mat4 *lhs, const glm::mat4 *rhs,
+                                    glm::mat4 *result, usize count) {
+  for (usize i = 0; i < count; ++i) {
+    const f32 *a = glm::value_ptr(lhs[i]);
+    const f32 *b = glm::value_ptr(rhs[i]);
+    f32 *out = glm::value_ptr(result[i]);
+
+    // Both lanes hold the same lhs column
+    const __m256 a0 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(a));
+    const __m256 a1 =
+        _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(a + 4));
+    const __m256 a2 =
+        _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(a + 8));
+    const __m256 a3 =
+        _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(a + 12));
+
+    // Two rhs columns are processed at a time
+    for (usize j = 0; j < 4; j += 2) {
+      const __m256 columns = _mm256_loadu_ps(b + j * 4);
+
+      const __m256 x = _mm256_permute_ps(columns, _MM_SHUFFLE(0, 0, 0, 0));
+      const __m256 y = _mm256_permute_ps(columns, _MM_SHUFFLE(1, 1, 1, 1));
+      const __m256 z = _mm256_permute_ps(columns, _MM_SHUFFLE(2, 2, 2, 2));
+      const __m256 w = _mm256_permute_ps(columns, _MM_SHUFFLE(3, 3, 3, 3));
+
+      __m256 value = _mm256_mul_ps(a0, x);
+      value = _mm256_add_ps(value, _mm256_mul_ps(a1, y));
+      value = _mm256_add_ps(value, _mm256_mul_ps(a2, z));
+      value = _mm256_add_ps(value, _mm256_mul_ps(a3, w));
+
+      _mm256_storeu_ps(out + j * 4, value);
+    }
+  }
+}
+
+bool isAVX2Supported() {
+#if defined(_MSC_VER) && !defined(__clang__)
+  static constexpr int OsxsaveBit = 1 << 27;
+  static constexpr int Avx2Bit = 1 << 5;
+  static constexpr u64 YmmStateMask = 0x6;
+
+  int info[4]{};
+  __cpuid(info, 1);
+  if ((info[2] & OsxsaveBit) == 0) {
+    return false;
+  }
+
+  // Operating system must preserve YMM registers
+  if ((_xgetbv(0) & YmmStateMask) != YmmStateMask) {
+    return false;
+  }
+
+  __cpuidex(info, 7, 0);
+  return (info[1] & Avx2Bit) != 0;
+#else
+  return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif
+
+struct Kernels {
+  TransformKernelInstructionSet instructionSet =
+      TransformKernelInstructionSet::Scalar;
+
+  ComposeFn compose = composeScalar;
+
+  MultiplyFn multiply = multiplyScalar;
+};
+
+Kernels createKernels(TransformKernelInstructionSet instructionSet) {
+  switch (instructionSet) {
+#ifdef QUOLL_TRANSFORM_KERNEL_X86
+  case TransformKernelInstructionSet::AVX2:
+    return {instructionSet, composeAVX2, multiplyAVX2};
+  case TransformKernelInstructionSet::SSE:
+    return {instructionSet, composeSSE, multiplySSE};
+#endif
+  default:
+    return {};
+  }
+}
+
+Kernels &getKernels() {
+  static Kernels kernels = [] {
+    if (TransformKernel::isSupported(TransformKernelInstructionSet::AVX2)) {
+      return createKernels(TransformKernelInstructionSet::AVX2);
+    }
+
+    if (TransformKernel::isSupported(TransformKernelInstructionSet::SSE)) {
+      return createKernels(TransformKernelInstructionSet::SSE);
+    }
+
+    return createKernels(TransformKernelInstructionSet::Scalar);
+  }();
+
+  return kernels;
+}
+
+} // namespace
+
+void TransformKernel::compose(std::span<const glm::vec3> positions,
+                              std::span<const glm::quat> rotations,
+                              std::span<const glm::vec3> scales,
+                              std::span<glm::mat4> transforms) {
+  QuollAssert(positions.size() == transforms.size() &&
+                  rotations.size() == transforms.size() &&
+                  scales.size() == transforms.size(),
+              "Transform spans must have the same size");
+
+  getKernels().compose(positions.data(), rotations.data(), scales.data(),
+                       transforms.data(), transforms.size());
+}
+
+void TransformKernel::multiply(std::span<const glm::mat4> lhs,
+                               std::span<const glm::mat4> rhs,
+                               std::span<glm::mat4> result) {
+  QuollAssert(lhs.size() == result.size() && rhs.size() == result.size(),
+              "Matrix spans must have the same size");
+
+  getKernels().multiply(lhs.data(), rhs.data(), result.data(), result.size());
+}
+
+TransformKernelInstructionSet TransformKernel::getInstructionSet() {
+  return getKernels().instructionSet;
+}
+
+bool TransformKernel::isSupported(
+    TransformKernelInstructionSet instructionSet) {
+  switch (instructionSet) {
+  case TransformKernelInstructionSet::Scalar:
+    return true;
+#ifdef QUOLL_TRANSFORM_KERNEL_X86
+  case TransformKernelInstructionSet::SSE:
+    // SSE2 is part of x86-64
+    return true;
+  case TransformKernelInstructionSet::AVX2: {
+    static const bool Supported = isAVX2Supported();
+    return Supported;
+  }
+#endif
+  default:
+    return false;
+  }
+}
+
+void TransformKernel::setInstructionSet(
+    TransformKernelInstructionSet instructionSet) {
+  QuollAssert(isSupported(instructionSet),
+              "Instruction set is not supported by the CPU");
+  getKernels() = createKernels(instructionSet);
+}
+
+} // namespace quoll
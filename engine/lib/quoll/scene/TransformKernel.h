@@ -0,0 +1,84 @@
+#pragma once
+
+namespace quoll {
+
+/**
+ * @brief Instruction set used by transform kernels
+ */
+enum class TransformKernelInstructionSet { Scalar, SSE, AVX2 };
+
+/**
+ * @brief Batched transform matrix kernels
+ *
+ * Converts batches of position, rotation, and
+ * scale into affine matrices and multiplies
+ * batches of matrices. Fastest instruction set
+ * that is supported by the CPU is selected
+ * on first use.
+ *
+ * Kernels do not use fused multiply-add; so,
+ * every instruction set produces the same
+ * results as equivalent glm operations.
+ */
+class TransformKernel {
+public:
+  /**
+   * @brief Compose transform matrices
+   *
+   * Result is equal to translate * rotate * scale.
+   * All spans must have the same size.
+   *
+   * @param positions Positions
+   * @param rotations Rotations
+   * @param scales Scales
+   * @param transforms Output transform matrices
+   */
+  static void compose(std::span<const glm::vec3> positions,
+                      std::span<const glm::quat> rotations,
+                      std::span<const glm::vec3> scales,
+                      std::span<glm::mat4> transforms);
+
+  /**
+   * @brief Multiply transform matrices
+   *
+   * Calculates result[i] = lhs[i] * rhs[i].
+   * All spans must have the same size. Result
+   * can be the same span as one of the inputs.
+   *
+   * @param lhs Left hand side matrices
+   * @param rhs Right hand side matrices
+   * @param result Output matrices
+   */
+  static void multiply(std::span<const glm::mat4> lhs,
+                       std::span<const glm::mat4> rhs,
+                       std::span<glm::mat4> result);
+
+  /**
+   * @brief Get active instruction set
+   *
+   * @return Active instruction set
+   */
+  static TransformKernelInstructionSet getInstructionSet();
+
+  /**
+   * @brief Check if instruction set is supported
+   *
+   * @param instructionSet Instruction set
+   * @retval true Instruction set is supported by the CPU
+   * @retval false Instruction set is not supported by the CPU
+   */
+  static bool isSupported(TransformKernelInstructionSet instructionSet);
+
+  /**
+   * @brief Set active instruction set
+   *
+   * Used for testing and benchmarking specific
+   * kernels. Must not be called while kernels
+   * are running in other threads.
+   *
+   * @param instructionSet Supported instruction set
+   */
+  static void setInstructionSet(TransformKernelInstructionSet instructionSet);
+};
+
+} // namespace quoll
@@ -15,8 +15,9 @@ std::reference_wrapper<glm::vec3> TransformLuaTable::getPosition() {
 }
 
 void TransformLuaTable::setPosition(glm::vec3 position) {
-  mScriptGlobals.entityDatabase.get<LocalTransform>(mEntity).localPosition =
-      position;
+  auto &transform = mScriptGlobals.entityDatabase.get<LocalTransform>(mEntity);
+  transform.localPosition = position;
+  transform.dirty.mark();
 }
 
 std::reference_wrapper<glm::quat> TransformLuaTable::getRotation() {
@@ -25,8 +26,9 @@ std::reference_wrapper<glm::quat> TransformLuaTable::getRotation() {
 }
 
 void TransformLuaTable::setRotation(glm::quat rotation) {
-  mScriptGlobals.entityDatabase.get<LocalTransform>(mEntity).localRotation =
-      rotation;
+  auto &transform = mScriptGlobals.entityDatabase.get<LocalTransform>(mEntity);
+  transform.localRotation = rotation;
+  transform.dirty.mark();
 }
 
 std::reference_wrapper<glm::vec3> TransformLuaTable::getScale() {
@@ -34,7 +36,9 @@ std::reference_wrapper<glm::vec3> TransformLuaTable::getScale() {
 }
 
 void TransformLuaTable::setScale(glm::vec3 scale) {
-  mScriptGlobals.entityDatabase.get<LocalTransform>(mEntity).localScale = scale;
+  auto &transform = mScriptGlobals.entityDatabase.get<LocalTransform>(mEntity);
+  transform.localScale = scale;
+  transform.dirty.mark();
 }
 
 void TransformLuaTable::deleteThis() {
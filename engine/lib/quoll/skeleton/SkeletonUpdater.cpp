@@ -1,6 +1,8 @@
 #include "quoll/core/Base.h"
+#include "quoll/core/Engine.h"
 #include "quoll/core/Profiler.h"
 #include "quoll/entity/EntityDatabase.h"
+#include "quoll/scene/TransformKernel.h"
 #include "quoll/system/SystemView.h"
 #include "Skeleton.h"
 #include "SkeletonUpdater.h"
@@ -9,9 +11,18 @@ namespace quoll {
 
 namespace {
 
-void updateSkeletonAssets(SystemView &view) {
+void updateSkeletonAssets(SystemView &view,
+                          EntityStorageSparseSetChangeCursor &cursor) {
   auto &entityDatabase = view.scene->entityDatabase;
-  for (auto [entity, ref] : entityDatabase.view<SkeletonAssetRef>()) {
+
+  // Only asset refs that are set since the last
+  // update are checked. Cursor is not moved if
+  // an asset is not loaded yet; so, the ref
+  // is checked again in the next update
+  const auto lastCursor = cursor;
+  const u64 since = entityDatabase.readChanges<SkeletonAssetRef>(cursor);
+  for (auto [entity, ref] : entityDatabase.view<SkeletonAssetRef>()
+                                .changedSince<SkeletonAssetRef>(since)) {
     if (entityDatabase.has<SkeletonCurrentAsset>(entity) &&
         entityDatabase.get<SkeletonCurrentAsset>(entity).handle ==
             ref.asset.handle()) {
@@ -19,6 +30,7 @@ void updateSkeletonAssets(SystemView &view) {
     }
 
     if (!ref.asset) {
+      cursor = lastCursor;
       continue;
     }
 
@@ -39,38 +51,38 @@ void updateSkeletonAssets(SystemView &view) {
   }
 }
 
-void updateSkeletons(SystemView &view) {
-  QUOLL_PROFILE_EVENT("SkeletonUpdater::update");
+void updateSkeleton(Skeleton &skeleton) {
+  const usize numJoints = skeleton.numJoints;
+  std::span<glm::mat4> worldTransforms(skeleton.jointWorldTransforms.data(),
+                                       numJoints);
 
-  auto &entityDatabase = view.scene->entityDatabase;
-  for (auto [entity, skeleton] : entityDatabase.view<Skeleton>()) {
-
-    {
-      const glm::mat4 identity{1.0f};
-      skeleton.jointWorldTransforms.at(0) =
-          glm::translate(identity, skeleton.jointLocalPositions.at(0)) *
-          glm::toMat4(skeleton.jointLocalRotations.at(0)) *
-          glm::scale(identity, skeleton.jointLocalScales.at(0));
-    }
+  TransformKernel::compose(
+      std::span(skeleton.jointLocalPositions).first(numJoints),
+      std::span(skeleton.jointLocalRotations).first(numJoints),
+      std::span(skeleton.jointLocalScales).first(numJoints), worldTransforms);
 
-    for (u32 i = 1; i < skeleton.numJoints; ++i) {
-      const glm::mat4 identity{1.0f};
-      auto localTransform =
-          glm::translate(identity, skeleton.jointLocalPositions.at(i)) *
-          glm::toMat4(skeleton.jointLocalRotations.at(i)) *
-          glm::scale(identity, skeleton.jointLocalScales.at(i));
+  // Parent joints are always stored before their children
+  for (usize i = 1; i < numJoints; ++i) {
+    const auto &parentWorld = worldTransforms[skeleton.jointParents.at(i)];
+    worldTransforms[i] = parentWorld * worldTransforms[i];
+  }
 
-      const auto &parentWorld =
-          skeleton.jointWorldTransforms.at(skeleton.jointParents.at(i));
-      skeleton.jointWorldTransforms.at(i) = parentWorld * localTransform;
-    }
+  TransformKernel::multiply(
+      worldTransforms,
+      std::span(skeleton.jointInverseBindMatrices).first(numJoints),
+      std::span(skeleton.jointFinalTransforms).first(numJoints));
+}
 
-    for (usize i = 0; i < skeleton.numJoints; ++i) {
-      skeleton.jointFinalTransforms.at(i) =
-          skeleton.jointWorldTransforms.at(i) *
-          skeleton.jointInverseBindMatrices.at(i);
-    }
-  }
+void updateSkeletons(SystemView &view) {
+  QUOLL_PROFILE_EVENT("SkeletonUpdater::update");
+  static constexpr usize ChunkSize = 16;
+
+  // Skeletons are independent from each other
+  auto &entityDatabase = view.scene->entityDatabase;
+  entityDatabase.view<Skeleton>().parallelForEach(
+      Engine::getThreadPool(),
+      [](Entity entity, Skeleton &skeleton) { updateSkeleton(skeleton); },
+      ChunkSize);
 }
 
 void updateDebugBones(SystemView &view) {
@@ -94,7 +106,7 @@ void updateDebugBones(SystemView &view) {
 void SkeletonUpdater::update(SystemView &view) {
   QUOLL_PROFILE_EVENT("SkeletonUpdater::update");
 
-  updateSkeletonAssets(view);
+  updateSkeletonAssets(view, mSkeletonAssetChanges);
   updateSkeletons(view);
   updateDebugBones(view);
 }
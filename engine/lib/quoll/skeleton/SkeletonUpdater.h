@@ -1,5 +1,7 @@
 #pragma once
 
+#include "quoll/entity/EntityStorageSparseSetChangeCursor.h"
+
 namespace quoll {
 
 struct SystemView;
@@ -7,6 +9,9 @@ struct SystemView;
 class SkeletonUpdater {
 public:
   void update(SystemView &view);
+
+private:
+  EntityStorageSparseSetChangeCursor mSkeletonAssetChanges;
 };
 
 } // namespace quoll
@@ -0,0 +1,39 @@
+#include "quoll/core/Base.h"
+#include "SystemAccess.h"
+
+namespace quoll {
+
+namespace {
+
+bool intersects(const std::vector<usize> &lhs, const std::vector<usize> &rhs) {
+  for (auto id : lhs) {
+    if (std::find(rhs.begin(), rhs.end(), id) != rhs.end()) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+} // namespace
+
+bool SystemAccess::conflicts(const SystemAccess &other) const {
+  if (mExclusive || other.mExclusive) {
+    return true;
+  }
+
+  return intersects(mWrites, other.mWrites) ||
+         intersects(mWrites, other.mReads) || intersects(mReads, other.mWrites);
+}
+
+void SystemAccess::writeGroup(usize id) {
+  mWrites.push_back(id);
+
+  for (auto groupedId : EntityDatabase::getGroupedComponentIds(id)) {
+    if (groupedId != id) {
+      mWrites.push_back(groupedId);
+    }
+  }
+}
+
+} // namespace quoll
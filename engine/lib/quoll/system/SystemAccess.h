@@ -0,0 +1,101 @@
+#pragma once
+
+#include "quoll/entity/EntityDatabase.h"
+
+namespace quoll {
+
+/**
+ * @brief Component access of a system
+ *
+ * Systems that only read the same components
+ * can run concurrently. Systems that write
+ * components that another system reads or writes
+ * conflict with each other and are serialized.
+ *
+ * Setting a component that an entity already has
+ * counts as writing it. Adding or removing a
+ * component is a structural change that also moves
+ * entries of all components in its group; so, it
+ * counts as writing the component and all grouped
+ * components. Component masks of entities are
+ * updated atomically and do not conflict.
+ * Scene data that is not stored in
+ * components (e.g spatial index) is declared by
+ * its type. Systems that create or delete entities,
+ * or call into code with unknown access (e.g
+ * scripts), must be marked as exclusive.
+ */
+class SystemAccess {
+public:
+  /**
+   * @brief Add read components
+   *
+   * @tparam TComponents Component types
+   * @return This access
+   */
+  template <class... TComponents> SystemAccess &read() {
+    (mReads.push_back(EntityDatabase::getComponentId<TComponents>()), ...);
+    return *this;
+  }
+
+  /**
+   * @brief Add written components
+   *
+   * @tparam TComponents Component types
+   * @return This access
+   */
+  template <class... TComponents> SystemAccess &write() {
+    (mWrites.push_back(EntityDatabase::getComponentId<TComponents>()), ...);
+    return *this;
+  }
+
+  /**
+   * @brief Add components that are added or removed
+   *
+   * Components and all components that are
+   * grouped with them are written
+   *
+   * @tparam TComponents Component types
+   * @return This access
+   */
+  template <class... TComponents> SystemAccess &structural() {
+    (writeGroup(EntityDatabase::getComponentId<TComponents>()), ...);
+    return *this;
+  }
+
+  /**
+   * @brief Mark access as exclusive
+   *
+   * Exclusive systems conflict with all systems
+   *
+   * @return This access
+   */
+  inline SystemAccess &exclusive() {
+    mExclusive = true;
+    return *this;
+  }
+
+  /**
+   * @brief Check if access conflicts with other access
+   *
+   * @param other Other access
+   * @retval true Accesses conflict
+   * @retval false Accesses do not conflict
+   */
+  bool conflicts(const SystemAccess &other) const;
+
+private:
+  /**
+   * @brief Add written component and its group
+   *
+   * @param id Component id
+   */
+  void writeGroup(usize id);
+
+private:
+  std::vector<usize> mReads;
+  std::vector<usize> mWrites;
+  bool mExclusive = false;
+};
+
+} // namespace quoll
@@ -0,0 +1,100 @@
+#include "quoll/core/Base.h"
+#include "quoll/core/Profiler.h"
+#include "SystemScheduler.h"
+
+namespace quoll {
+
+SystemScheduler::SystemScheduler(ThreadPool &threadPool)
+    : mThreadPool(threadPool) {}
+
+void SystemScheduler::add(StringView name, const SystemAccess &access,
+                          SystemFn &&fn) {
+  usize index = mSystems.size();
+
+  System system{String(name), access, std::move(fn)};
+  for (usize i = 0; i < mSystems.size(); ++i) {
+    if (mSystems.at(i).access.conflicts(access)) {
+      mSystems.at(i).dependents.push_back(index);
+      system.numDependencies++;
+    }
+  }
+
+  mSystems.push_back(std::move(system));
+  mPendingDependencies.reset(new std::atomic<usize>[mSystems.size()]);
+}
+
+void SystemScheduler::run(f32 dt, SystemView &view) {
+  QUOLL_PROFILE_EVENT("SystemScheduler::run");
+
+  // Running systems one by one in the calling
+  // thread is faster when there is nothing to
+  // run them concurrently on
+  if (mThreadPool.getNumThreads() == 0) {
+    for (auto &system : mSystems) {
+      QUOLL_PROFILE_EVENT("SystemScheduler::runSystem");
+      QUOLL_PROFILE_TAG("system", system.name.c_str());
+      system.fn(dt, view);
+    }
+    return;
+  }
+
+  for (usize i = 0; i < mSystems.size(); ++i) {
+    mPendingDependencies[i].store(mSystems.at(i).numDependencies,
+                                  std::memory_order_relaxed);
+  }
+
+  {
+    std::lock_guard lock(mMutex);
+    mNumRemaining = mSystems.size();
+  }
+
+  for (usize i = 0; i < mSystems.size(); ++i) {
+    if (mSystems.at(i).numDependencies == 0) {
+      mThreadPool.submit([this, i, dt, &view] { runSystem(i, dt, view); });
+    }
+  }
+
+  std::unique_lock lock(mMutex);
+  mFinished.wait(lock, [this] { return mNumRemaining == 0; });
+}
+
+void SystemScheduler::runSystem(usize index, f32 dt, SystemView &view) {
+  std::optional<usize> next = index;
+  while (next.has_value()) {
+    auto &system = mSystems.at(next.value());
+    next.reset();
+
+    {
+      QUOLL_PROFILE_EVENT("SystemScheduler::runSystem");
+      QUOLL_PROFILE_TAG("system", system.name.c_str());
+      system.fn(dt, view);
+    }
+
+    // First dependent that becomes ready continues
+    // in this thread and the rest are submitted
+    // to the pool
+    for (auto dependent : system.dependents) {
+      if (mPendingDependencies[dependent].fetch_sub(
+              1, std::memory_order_acq_rel) != 1) {
+        continue;
+      }
+
+      if (!next.has_value()) {
+        next = dependent;
+      } else {
+        mThreadPool.submit(
+            [this, dependent, dt, &view] { runSystem(dependent, dt, view); });
+      }
+    }
+
+    {
+      std::lock_guard lock(mMutex);
+      mNumRemaining--;
+      if (mNumRemaining == 0) {
+        mFinished.notify_all();
+      }
+    }
+  }
+}
+
+} // namespace quoll
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "quoll/core/ThreadPool.h"
+#include "SystemAccess.h"
+
+namespace quoll {
+
+struct SystemView;
+
+/**
+ * @brief System scheduler
+ *
+ * Runs systems on a thread pool based on
+ * their component access. Systems that conflict
+ * run in the order they are added; other systems
+ * run concurrently. Results are therefore the same
+ * as running all systems in the order they are added.
+ */
+class SystemScheduler : NoCopyMove {
+public:
+  /**
+   * System function
+   */
+  using SystemFn = std::function<void(f32, SystemView &)>;
+
+public:
+  /**
+   * @brief Create system scheduler
+   *
+   * @param threadPool Thread pool
+   */
+  SystemScheduler(ThreadPool &threadPool);
+
+  /**
+   * @brief Add system
+   *
+   * System depends on all previously added
+   * systems that it conflicts with
+   *
+   * @param name System name
+   * @param access Component access
+   * @param fn System function
+   */
+  void add(StringView name, const SystemAccess &access, SystemFn &&fn);
+
+  /**
+   * @brief Run all systems
+   *
+   * Blocks until all systems are finished
+   *
+   * @param dt Time delta
+   * @param view System view
+   */
+  void run(f32 dt, SystemView &view);
+
+  /**
+   * @brief Get number of systems
+   *
+   * @return Number of systems
+   */
+  inline usize getNumSystems() const { return mSystems.size(); }
+
+  /**
+   * @brief Get number of dependencies of system
+   *
+   * @param index System index
+   * @return Number of systems that must finish
+   *         before this system starts
+   */
+  inline usize getNumDependencies(usize index) const {
+    return mSystems.at(index).numDependencies;
+  }
+
+private:
+  void runSystem(usize index, f32 dt, SystemView &view);
+
+private:
+  struct System {
+    String name;
+
+    SystemAccess access;
+
+    SystemFn fn;
+
+    std::vector<usize> dependents;
+
+    usize numDependencies = 0;
+  };
+
+  ThreadPool &mThreadPool;
+  std::vector<System> mSystems;
+  std::unique_ptr<std::atomic<usize>[]> mPendingDependencies;
+
+  std::mutex mMutex;
+  std::condition_variable mFinished;
+  usize mNumRemaining = 0;
+};
+
+} // namespace quoll
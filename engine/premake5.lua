@@ -62,8 +62,8 @@ project "QuollEngineTest"
     }
 
     files {
-        "tests/**.cpp",
-        "tests/**.h"
+        "tests/quoll-tests/**.cpp",
+        "tests/quoll-tests/**.h"
     }
 
     linkDependenciesWith{"QuollEngine", "QuollRHIMock", "QuollRHICore"}
@@ -73,3 +73,25 @@ project "QuollEngineTest"
         "{COPYDIR} ../../engine/tests/fixtures %{cfg.buildtarget.directory}/fixtures"
     }
 
+project "QuollEngineBenchmark"
+    basedir "../workspace/engine-benchmark"
+    kind "ConsoleApp"
+
+    configurations {
+        "Release", "Profile"
+    }
+
+    includedirs {
+        "../engine/tests",
+        "../engine/lib",
+        "../rhi/mock/include"
+    }
+
+    files {
+        "tests/quoll-benchmarks/**.cpp",
+        "tests/quoll-benchmarks/**.h"
+    }
+
+    linkTracy{}
+    linkDependenciesWith{"QuollEngine", "QuollRHIMock", "QuollRHICore"}
+    linkGoogleBenchmark{}
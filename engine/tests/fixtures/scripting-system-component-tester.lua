@@ -312,6 +312,14 @@ function animatorTrigger()
    entity.animator:trigger("Move")
 end
 
+function animatorSetParameter()
+   entity.animator:setParameter("speed", 0.75)
+end
+
+function animatorSetLayerWeight()
+   entity.animator:setLayerWeight("upper", 0.25)
+end
+
 function animatorPropertiesValid()
    expectNear(entity.animator.normalizedTime, 0.4)
    expectEq(entity.animator.currentState.name, "StateB")
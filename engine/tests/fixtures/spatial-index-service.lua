@@ -0,0 +1,29 @@
+local spatial = game:get("Spatial")
+
+raycastOutput = nil
+raycastDistance = nil
+raycastEntityName = nil
+function raycast()
+    raycastOutput, hit = spatial:raycast(0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 100.0)
+
+    if raycastOutput then
+        raycastDistance = hit.distance
+        raycastEntityName = hit.entity.name
+    end
+end
+
+nearestOutput = nil
+nearestEntityName = nil
+function findNearest()
+    nearestOutput, hit = spatial:findNearest(0.0, 20.0, 0.0, 100.0)
+
+    if nearestOutput then
+        nearestEntityName = hit.entity.name
+    end
+end
+
+numEntitiesInBox = nil
+function queryBox()
+    local entities = spatial:queryBox(-1.0, -1.0, -1.0, 15.0, 1.0, 1.0)
+    numEntitiesInBox = #entities
+end
@@ -0,0 +1,66 @@
+#include "quoll/core/Base.h"
+#include "quoll/animation/AnimationAsset.h"
+#include "quoll/animation/KeyframeInterpolator.h"
+#include <benchmark/benchmark.h>
+
+namespace {
+
+/**
+ * @brief Create linear sequence with uniform keyframes
+ *
+ * @param numKeyframes Number of keyframes
+ * @return Keyframe sequence
+ */
+quoll::KeyframeSequenceAsset createSequence(usize numKeyframes) {
+  quoll::KeyframeSequenceAsset sequence;
+  sequence.target = quoll::KeyframeSequenceAssetTarget::Position;
+  sequence.interpolation = quoll::KeyframeSequenceAssetInterpolation::Linear;
+
+  for (usize i = 0; i < numKeyframes; ++i) {
+    const f32 time = static_cast<f32>(i) / static_cast<f32>(numKeyframes - 1);
+    sequence.keyframeTimes.push_back(time);
+    sequence.keyframeValues.push_back(glm::vec4(time));
+  }
+
+  return sequence;
+}
+
+// Samples the clip from start to end in
+// fixed time steps, similar to playback
+static constexpr usize NumSamples = 1000;
+
+} // namespace
+
+static void BM_KeyframeInterpolator_Sample(benchmark::State &state) {
+  auto sequence = createSequence(static_cast<usize>(state.range(0)));
+
+  for (auto _ : state) {
+    for (usize i = 0; i < NumSamples; ++i) {
+      const f32 time = static_cast<f32>(i) / NumSamples;
+      benchmark::DoNotOptimize(
+          quoll::KeyframeInterpolator::interpolateVec3(sequence, time));
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * NumSamples);
+}
+BENCHMARK(BM_KeyframeInterpolator_Sample)->Arg(10)->Arg(1000)->Arg(100000);
+
+static void BM_KeyframeInterpolator_SampleWithCursor(benchmark::State &state) {
+  auto sequence = createSequence(static_cast<usize>(state.range(0)));
+
+  usize cursor = 0;
+  for (auto _ : state) {
+    for (usize i = 0; i < NumSamples; ++i) {
+      const f32 time = static_cast<f32>(i) / NumSamples;
+      benchmark::DoNotOptimize(
+          quoll::KeyframeInterpolator::interpolateVec3(sequence, time, cursor));
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * NumSamples);
+}
+BENCHMARK(BM_KeyframeInterpolator_SampleWithCursor)
+    ->Arg(10)
+    ->Arg(1000)
+    ->Arg(100000);
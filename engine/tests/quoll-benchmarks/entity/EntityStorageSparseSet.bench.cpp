@@ -0,0 +1,264 @@
+#include "quoll/core/Base.h"
+#include "quoll/entity/EntityStorageSparseSet.h"
+#include "quoll/renderer/Mesh.h"
+#include "quoll/renderer/SkinnedMeshRenderer.h"
+#include "quoll/scene/LocalTransform.h"
+#include "quoll/scene/Parent.h"
+#include "quoll/scene/WorldTransform.h"
+#include "quoll/skeleton/Skeleton.h"
+#include <benchmark/benchmark.h>
+
+namespace {
+
+class BenchmarkEntityStorage : public quoll::EntityStorageSparseSet {
+public:
+  BenchmarkEntityStorage(bool grouped = false) {
+    reg<quoll::LocalTransform>();
+    reg<quoll::WorldTransform>();
+    reg<quoll::Parent>();
+    reg<quoll::Mesh>();
+    reg<quoll::Skeleton>();
+    reg<quoll::SkinnedMeshRenderer>();
+
+    if (grouped) {
+      group<quoll::LocalTransform, quoll::WorldTransform>();
+      group<quoll::Skeleton, quoll::SkinnedMeshRenderer>();
+    }
+  }
+};
+
+void createTransforms(BenchmarkEntityStorage &storage, usize count) {
+  for (usize i = 0; i < count; ++i) {
+    auto entity = storage.create();
+    quoll::LocalTransform transform{};
+    transform.localPosition = glm::vec3(static_cast<f32>(i));
+    storage.set(entity, transform);
+    storage.set<quoll::WorldTransform>(entity, {});
+  }
+}
+
+/**
+ * @brief Create entities with components in random order
+ *
+ * Every other entity is skinned and every
+ * fourth entity has no world transform. Components
+ * are added in random order to avoid sorted pools.
+ *
+ * @param storage Storage
+ * @param count Number of entities
+ */
+void createScene(BenchmarkEntityStorage &storage, usize count) {
+  std::vector<quoll::Entity> entities(count);
+  for (auto &entity : entities) {
+    entity = storage.create();
+  }
+
+  std::shuffle(entities.begin(), entities.end(), std::mt19937{1});
+  for (usize i = 0; i < count; ++i) {
+    storage.set<quoll::LocalTransform>(entities.at(i), {});
+    storage.set<quoll::Mesh>(entities.at(count - i - 1), {});
+  }
+
+  std::shuffle(entities.begin(), entities.end(), std::mt19937{2});
+  for (usize i = 0; i < count; ++i) {
+    if ((i % 4) != 0) {
+      storage.set<quoll::WorldTransform>(entities.at(i), {});
+    }
+
+    if ((i % 2) == 0) {
+      storage.set<quoll::SkinnedMeshRenderer>(entities.at(i), {});
+    }
+  }
+
+  std::shuffle(entities.begin(), entities.end(), std::mt19937{3});
+  for (usize i = 0; i < count; ++i) {
+    if (storage.has<quoll::SkinnedMeshRenderer>(entities.at(i))) {
+      quoll::Skeleton skeleton{};
+      skeleton.jointFinalTransforms.resize(1, glm::mat4{1.0f});
+      storage.set(entities.at(i), skeleton);
+    }
+  }
+}
+
+} // namespace
+
+static void BM_EntityStorageSparseSet_Create(benchmark::State &state) {
+  const auto count = static_cast<usize>(state.range(0));
+  for (auto _ : state) {
+    BenchmarkEntityStorage storage;
+    for (usize i = 0; i < count; ++i) {
+      benchmark::DoNotOptimize(storage.create());
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_EntityStorageSparseSet_Create)->Range(1 << 10, 1 << 17);
+
+static void BM_EntityStorageSparseSet_Set(benchmark::State &state) {
+  const auto count = static_cast<usize>(state.range(0));
+  for (auto _ : state) {
+    state.PauseTiming();
+    BenchmarkEntityStorage storage;
+    std::vector<quoll::Entity> entities(count);
+    for (auto &entity : entities) {
+      entity = storage.create();
+    }
+    state.ResumeTiming();
+
+    for (auto entity : entities) {
+      storage.set<quoll::LocalTransform>(entity, {});
+      storage.set<quoll::WorldTransform>(entity, {});
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_EntityStorageSparseSet_Set)->Range(1 << 10, 1 << 17);
+
+static void BM_EntityStorageSparseSet_Get(benchmark::State &state) {
+  const auto count = static_cast<usize>(state.range(0));
+  BenchmarkEntityStorage storage;
+  createTransforms(storage, count);
+
+  std::vector<quoll::Entity> entities;
+  entities.reserve(count);
+  for (auto [entity, local] : storage.view<quoll::LocalTransform>()) {
+    entities.push_back(entity);
+  }
+
+  for (auto _ : state) {
+    for (auto entity : entities) {
+      benchmark::DoNotOptimize(
+          storage.get<quoll::LocalTransform>(entity).localPosition);
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_EntityStorageSparseSet_Get)->Range(1 << 10, 1 << 17);
+
+static void BM_EntityStorageSparseSet_Iterate(benchmark::State &state) {
+  const auto count = static_cast<usize>(state.range(0));
+  BenchmarkEntityStorage storage;
+  createTransforms(storage, count);
+
+  for (auto _ : state) {
+    for (auto [entity, local, world] :
+         storage.view<quoll::LocalTransform, quoll::WorldTransform>()) {
+      world.worldTransform[3] = glm::vec4(local.localPosition, 1.0f);
+    }
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_EntityStorageSparseSet_Iterate)->Range(1 << 10, 1 << 17);
+
+/**
+ * Range is the total number of threads
+ * including the calling thread
+ */
+static void BM_EntityStorageSparseSet_ParallelForEach(benchmark::State &state) {
+  static constexpr usize Count = 1 << 16;
+  BenchmarkEntityStorage storage;
+  createTransforms(storage, Count);
+
+  quoll::ThreadPool threadPool(static_cast<u32>(state.range(0) - 1));
+
+  for (auto _ : state) {
+    storage.view<quoll::LocalTransform, quoll::WorldTransform>()
+        .parallelForEach(threadPool, [](quoll::Entity entity,
+                                        quoll::LocalTransform &local,
+                                        quoll::WorldTransform &world) {
+          const glm::mat4 identity{1.0f};
+          glm::mat4 transform =
+              glm::translate(identity, local.localPosition) *
+              glm::toMat4(local.localRotation) *
+              glm::scale(identity, local.localScale);
+
+          // Roughly the cost of updating a small skeleton
+          for (u32 i = 0; i < 16; ++i) {
+            transform = transform * transform;
+          }
+          world.worldTransform = transform;
+        });
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * Count);
+}
+BENCHMARK(BM_EntityStorageSparseSet_ParallelForEach)
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->UseRealTime();
+
+static void BM_EntityStorageSparseSet_Remove(benchmark::State &state) {
+  const auto count = static_cast<usize>(state.range(0));
+  for (auto _ : state) {
+    state.PauseTiming();
+    BenchmarkEntityStorage storage;
+    createTransforms(storage, count);
+
+    std::vector<quoll::Entity> entities;
+    entities.reserve(count);
+    for (auto [entity, local] : storage.view<quoll::LocalTransform>()) {
+      entities.push_back(entity);
+    }
+    state.ResumeTiming();
+
+    for (auto entity : entities) {
+      storage.remove<quoll::LocalTransform>(entity);
+      storage.remove<quoll::WorldTransform>(entity);
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_EntityStorageSparseSet_Remove)->Range(1 << 10, 1 << 17);
+
+/**
+ * Range is one if components are grouped
+ */
+static void BM_EntityStorageSparseSet_IterateTransforms(
+    benchmark::State &state) {
+  static constexpr usize Count = 1 << 16;
+  BenchmarkEntityStorage storage(state.range(0) == 1);
+  createScene(storage, Count);
+
+  for (auto _ : state) {
+    for (auto [entity, local, world] :
+         storage.view<quoll::LocalTransform, quoll::WorldTransform>()) {
+      world.worldTransform[3] = glm::vec4(local.localPosition, 1.0f);
+    }
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * Count);
+}
+BENCHMARK(BM_EntityStorageSparseSet_IterateTransforms)->Arg(0)->Arg(1);
+
+/**
+ * Range is one if components are grouped
+ */
+static void BM_EntityStorageSparseSet_IterateSkinnedMeshes(
+    benchmark::State &state) {
+  static constexpr usize Count = 1 << 16;
+  BenchmarkEntityStorage storage(state.range(0) == 1);
+  createScene(storage, Count);
+
+  for (auto _ : state) {
+    usize numJoints = 0;
+    for (auto [entity, skeleton, world, mesh, renderer] :
+         storage.view<quoll::Skeleton, quoll::WorldTransform, quoll::Mesh,
+                      quoll::SkinnedMeshRenderer>()) {
+      numJoints += skeleton.jointFinalTransforms.size();
+    }
+    benchmark::DoNotOptimize(numJoints);
+  }
+
+  state.SetItemsProcessed(state.iterations() * Count);
+}
+BENCHMARK(BM_EntityStorageSparseSet_IterateSkinnedMeshes)->Arg(0)->Arg(1);
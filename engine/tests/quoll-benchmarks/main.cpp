@@ -0,0 +1,18 @@
+#include "quoll/core/Base.h"
+#include "quoll/core/Engine.h"
+#include "quoll/logger/NoopLogTransport.h"
+#include <benchmark/benchmark.h>
+
+int main(int argc, char **argv) {
+  quoll::Engine::getLogger().setTransport(quoll::NoopLogTransport);
+  quoll::Engine::getUserLogger().setTransport(quoll::NoopLogTransport);
+
+  ::benchmark::Initialize(&argc, argv);
+  if (::benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+
+  ::benchmark::RunSpecifiedBenchmarks();
+  ::benchmark::Shutdown();
+  return 0;
+}
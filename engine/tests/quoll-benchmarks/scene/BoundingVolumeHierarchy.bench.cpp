@@ -0,0 +1,205 @@
+#include "quoll/core/Base.h"
+#include "quoll/scene/BoundingVolumeHierarchy.h"
+#include <benchmark/benchmark.h>
+
+namespace {
+
+static constexpr usize NumEntities = 100'000;
+
+static constexpr f32 WorldSize = 1000.0f;
+
+struct EntityData {
+  std::vector<quoll::BoundingVolumeHierarchy::Entry> entries;
+  std::vector<glm::vec3> velocities;
+
+  EntityData() : entries(NumEntities), velocities(NumEntities) {
+    std::mt19937 generator{1};
+    std::uniform_real_distribution<f32> position{-WorldSize, WorldSize};
+    std::uniform_real_distribution<f32> size{0.5f, 4.0f};
+    std::uniform_real_distribution<f32> velocity{-1.0f, 1.0f};
+
+    for (usize i = 0; i < NumEntities; ++i) {
+      glm::vec3 center{position(generator), position(generator),
+                       position(generator)};
+      glm::vec3 extent{size(generator), size(generator), size(generator)};
+
+      entries.at(i).entity = quoll::Entity{static_cast<u32>(i + 1)};
+      entries.at(i).bounds = {center - extent, center + extent};
+      velocities.at(i) = glm::vec3(velocity(generator), velocity(generator),
+                                   velocity(generator));
+    }
+  }
+
+  quoll::BoundingVolumeHierarchy createHierarchy() {
+    quoll::BoundingVolumeHierarchy hierarchy;
+    hierarchy.build(entries);
+    return hierarchy;
+  }
+};
+
+quoll::Frustum createFrustum() {
+  auto projection =
+      glm::perspective(glm::radians(70.0f), 16.0f / 9.0f, 0.1f, 500.0f);
+  return quoll::Frustum::fromMatrix(projection);
+}
+
+} // namespace
+
+static void BM_BoundingVolumeHierarchy_Build(benchmark::State &state) {
+  EntityData data;
+
+  for (auto _ : state) {
+    quoll::BoundingVolumeHierarchy hierarchy;
+    hierarchy.build(data.entries);
+    benchmark::DoNotOptimize(hierarchy.getRoot());
+  }
+
+  state.SetItemsProcessed(state.iterations() * NumEntities);
+}
+BENCHMARK(BM_BoundingVolumeHierarchy_Build)->Unit(benchmark::kMillisecond);
+
+static void BM_BoundingVolumeHierarchy_Insert(benchmark::State &state) {
+  EntityData data;
+
+  for (auto _ : state) {
+    quoll::BoundingVolumeHierarchy hierarchy;
+    for (const auto &entry : data.entries) {
+      hierarchy.insert(entry.entity, entry.bounds);
+    }
+    benchmark::DoNotOptimize(hierarchy.getRoot());
+  }
+
+  state.SetItemsProcessed(state.iterations() * NumEntities);
+}
+BENCHMARK(BM_BoundingVolumeHierarchy_Insert)->Unit(benchmark::kMillisecond);
+
+// Percentage of moving entities is passed
+// as argument; the rest are static
+static void BM_BoundingVolumeHierarchy_Update(benchmark::State &state) {
+  EntityData data;
+  auto hierarchy = data.createHierarchy();
+  const usize numMoving = NumEntities * state.range(0) / 100;
+
+  for (auto _ : state) {
+    for (usize i = 0; i < NumEntities; ++i) {
+      auto &entry = data.entries[i];
+      if (i < numMoving) {
+        entry.bounds.min += data.velocities[i];
+        entry.bounds.max += data.velocities[i];
+      }
+      hierarchy.update(entry.entity, entry.bounds);
+    }
+    benchmark::DoNotOptimize(hierarchy.getRoot());
+  }
+
+  state.counters["Cost"] = hierarchy.getCost();
+  state.SetItemsProcessed(state.iterations() * NumEntities);
+}
+BENCHMARK(BM_BoundingVolumeHierarchy_Update)
+    ->ArgName("MovingPercent")
+    ->Arg(0)
+    ->Arg(10)
+    ->Arg(100)
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_BoundingVolumeHierarchy_QueryFrustum(benchmark::State &state) {
+  EntityData data;
+  auto hierarchy = data.createHierarchy();
+  auto frustum = createFrustum();
+
+  std::vector<quoll::Entity> entities;
+  for (auto _ : state) {
+    entities.clear();
+    hierarchy.queryFrustum(frustum, entities);
+    benchmark::DoNotOptimize(entities.data());
+  }
+
+  state.counters["Visible"] = static_cast<f64>(entities.size());
+}
+BENCHMARK(BM_BoundingVolumeHierarchy_QueryFrustum)
+    ->Unit(benchmark::kMicrosecond);
+
+// Tests every entity with batched frustum culling
+static void
+BM_BoundingVolumeHierarchy_CullEveryEntity(benchmark::State &state) {
+  EntityData data;
+  auto frustum = createFrustum();
+
+  quoll::CullingBounds bounds;
+  for (const auto &entry : data.entries) {
+    bounds.add(entry.bounds, glm::mat4{1.0f});
+  }
+
+  std::vector<u32> visibility(bounds.size());
+  std::vector<quoll::Entity> entities;
+  for (auto _ : state) {
+    entities.clear();
+    quoll::FrustumCulling::cull(bounds, std::array{frustum}, visibility);
+    for (usize i = 0; i < visibility.size(); ++i) {
+      if (visibility[i]) {
+        entities.push_back(data.entries[i].entity);
+      }
+    }
+    benchmark::DoNotOptimize(entities.data());
+  }
+
+  state.counters["Visible"] = static_cast<f64>(entities.size());
+}
+BENCHMARK(BM_BoundingVolumeHierarchy_CullEveryEntity)
+    ->Unit(benchmark::kMicrosecond);
+
+static void BM_BoundingVolumeHierarchy_QueryOverlap(benchmark::State &state) {
+  EntityData data;
+  auto hierarchy = data.createHierarchy();
+  const glm::vec3 margin{10.0f};
+
+  std::vector<quoll::Entity> entities;
+  for (auto _ : state) {
+    for (usize i = 0; i < 1000; ++i) {
+      entities.clear();
+      const auto &bounds = data.entries[i].bounds;
+      hierarchy.queryOverlap({bounds.min - margin, bounds.max + margin},
+                             entities);
+      benchmark::DoNotOptimize(entities.data());
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * 1000);
+}
+BENCHMARK(BM_BoundingVolumeHierarchy_QueryOverlap)
+    ->Unit(benchmark::kMicrosecond);
+
+static void BM_BoundingVolumeHierarchy_Raycast(benchmark::State &state) {
+  EntityData data;
+  auto hierarchy = data.createHierarchy();
+
+  for (auto _ : state) {
+    for (usize i = 0; i < 1000; ++i) {
+      quoll::CollisionHit hit{};
+      const auto &velocity = data.velocities[i];
+      hierarchy.raycast(data.entries[i].bounds.max + glm::vec3(0.1f),
+                        glm::normalize(velocity), WorldSize, hit);
+      benchmark::DoNotOptimize(hit);
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * 1000);
+}
+BENCHMARK(BM_BoundingVolumeHierarchy_Raycast)->Unit(benchmark::kMicrosecond);
+
+static void BM_BoundingVolumeHierarchy_FindNearest(benchmark::State &state) {
+  EntityData data;
+  auto hierarchy = data.createHierarchy();
+
+  for (auto _ : state) {
+    for (usize i = 0; i < 1000; ++i) {
+      quoll::CollisionHit hit{};
+      hierarchy.findNearest(data.velocities[i] * WorldSize, WorldSize, hit);
+      benchmark::DoNotOptimize(hit);
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * 1000);
+}
+BENCHMARK(BM_BoundingVolumeHierarchy_FindNearest)
+    ->Unit(benchmark::kMicrosecond);
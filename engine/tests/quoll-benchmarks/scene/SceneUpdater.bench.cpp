@@ -0,0 +1,117 @@
+#include "quoll/core/Base.h"
+#include "quoll/entity/EntityDatabase.h"
+#include "quoll/scene/LocalTransform.h"
+#include "quoll/scene/Parent.h"
+#include "quoll/scene/Scene.h"
+#include "quoll/scene/SceneUpdater.h"
+#include "quoll/scene/WorldTransform.h"
+#include "quoll/system/SystemView.h"
+#include <benchmark/benchmark.h>
+#include <numeric>
+
+namespace {
+
+/**
+ * @brief Create scene hierarchy
+ *
+ * Creates binary trees where every node
+ * has at most two children. Parents are assigned
+ * in random order to avoid accidentally sorted pools.
+ *
+ * @param scene Scene
+ * @param count Number of nodes
+ * @param numTrees Number of trees
+ */
+void createHierarchy(quoll::Scene &scene, usize count, usize numTrees) {
+  auto &entityDatabase = scene.entityDatabase;
+
+  std::vector<quoll::Entity> entities(count);
+  for (auto &entity : entities) {
+    entity = entityDatabase.create();
+
+    quoll::LocalTransform transform{};
+    transform.localPosition = glm::vec3(1.0f, 0.0f, 0.0f);
+    entityDatabase.set(entity, transform);
+    entityDatabase.set<quoll::WorldTransform>(entity, {});
+  }
+
+  std::vector<usize> indices(count);
+  std::iota(indices.begin(), indices.end(), 0);
+  std::shuffle(indices.begin(), indices.end(), std::mt19937{1});
+
+  const usize treeSize = count / numTrees;
+  for (auto index : indices) {
+    usize indexInTree = index % treeSize;
+    if (indexInTree == 0) {
+      continue;
+    }
+
+    auto parent = entities.at(index - indexInTree + (indexInTree - 1) / 2);
+    entityDatabase.set<quoll::Parent>(entities.at(index), {parent});
+  }
+}
+
+} // namespace
+
+static void BM_SceneUpdater_UpdateTransforms(benchmark::State &state) {
+  quoll::Scene scene;
+  createHierarchy(scene, static_cast<usize>(state.range(0)), 100);
+
+  quoll::SystemView view{&scene};
+  quoll::SceneUpdater sceneUpdater;
+
+  for (auto _ : state) {
+    sceneUpdater.update(view);
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SceneUpdater_UpdateTransforms)->Arg(1000)->Arg(100000);
+
+static void BM_SceneUpdater_UpdateDirtyTransforms(benchmark::State &state) {
+  quoll::Scene scene;
+  createHierarchy(scene, static_cast<usize>(state.range(0)), 100);
+
+  quoll::SystemView view{&scene};
+  quoll::SceneUpdater sceneUpdater;
+
+  auto &entityDatabase = scene.entityDatabase;
+  for (auto _ : state) {
+    for (auto [entity, local] : entityDatabase.view<quoll::LocalTransform>()) {
+      local.dirty.mark();
+    }
+    sceneUpdater.update(view);
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SceneUpdater_UpdateDirtyTransforms)->Arg(1000)->Arg(100000);
+
+static void BM_SceneUpdater_UpdateTransformsAfterReparent(
+    benchmark::State &state) {
+  quoll::Scene scene;
+  createHierarchy(scene, static_cast<usize>(state.range(0)), 100);
+
+  quoll::SystemView view{&scene};
+  quoll::SceneUpdater sceneUpdater;
+
+  auto &entityDatabase = scene.entityDatabase;
+  quoll::Entity entity = quoll::Entity::Null;
+  quoll::Parent parent{};
+  for (auto [e, p] : entityDatabase.view<quoll::Parent>()) {
+    entity = e;
+    parent = p;
+    break;
+  }
+
+  for (auto _ : state) {
+    // Setting the same parent invalidates hierarchy order
+    entityDatabase.set(entity, parent);
+    sceneUpdater.update(view);
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SceneUpdater_UpdateTransformsAfterReparent)
+    ->Arg(1000)
+    ->Arg(100000);
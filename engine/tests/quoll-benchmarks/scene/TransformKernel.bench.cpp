@@ -0,0 +1,127 @@
+#include "quoll/core/Base.h"
+#include "quoll/scene/TransformKernel.h"
+#include <benchmark/benchmark.h>
+
+namespace {
+
+static constexpr usize NumTransforms = 1'000'000;
+
+struct TransformData {
+  std::vector<glm::vec3> positions;
+  std::vector<glm::quat> rotations;
+  std::vector<glm::vec3> scales;
+  std::vector<glm::mat4> parents;
+  std::vector<glm::mat4> transforms;
+
+  TransformData()
+      : positions(NumTransforms), rotations(NumTransforms),
+        scales(NumTransforms), parents(NumTransforms),
+        transforms(NumTransforms) {
+    std::mt19937 generator{1};
+    std::uniform_real_distribution<f32> distribution{-1.0f, 1.0f};
+    auto random = [&] { return distribution(generator); };
+
+    for (usize i = 0; i < NumTransforms; ++i) {
+      positions.at(i) = glm::vec3(random(), random(), random());
+      rotations.at(i) = glm::quat(random(), random(), random(), random());
+      scales.at(i) = glm::vec3(random(), random(), random());
+      parents.at(i) = glm::translate(glm::mat4{1.0f}, positions.at(i));
+    }
+  }
+};
+
+bool setInstructionSet(benchmark::State &state) {
+  auto instructionSet =
+      static_cast<quoll::TransformKernelInstructionSet>(state.range(0));
+  if (!quoll::TransformKernel::isSupported(instructionSet)) {
+    state.SkipWithError("Instruction set is not supported by the CPU");
+    return false;
+  }
+
+  quoll::TransformKernel::setInstructionSet(instructionSet);
+  return true;
+}
+
+void addInstructionSets(benchmark::internal::Benchmark *benchmark) {
+  benchmark->ArgName("InstructionSet")
+      ->Arg(static_cast<i64>(quoll::TransformKernelInstructionSet::Scalar))
+      ->Arg(static_cast<i64>(quoll::TransformKernelInstructionSet::SSE))
+      ->Arg(static_cast<i64>(quoll::TransformKernelInstructionSet::AVX2));
+}
+
+} // namespace
+
+static void BM_TransformKernel_ComposeWithGlm(benchmark::State &state) {
+  TransformData data;
+
+  for (auto _ : state) {
+    const glm::mat4 identity{1.0f};
+    for (usize i = 0; i < NumTransforms; ++i) {
+      data.transforms[i] = glm::translate(identity, data.positions[i]) *
+                           glm::toMat4(data.rotations[i]) *
+                           glm::scale(identity, data.scales[i]);
+    }
+    benchmark::DoNotOptimize(data.transforms.data());
+  }
+
+  state.SetItemsProcessed(state.iterations() * NumTransforms);
+}
+BENCHMARK(BM_TransformKernel_ComposeWithGlm)->Unit(benchmark::kMillisecond);
+
+static void BM_TransformKernel_Compose(benchmark::State &state) {
+  TransformData data;
+  if (!setInstructionSet(state)) {
+    return;
+  }
+
+  for (auto _ : state) {
+    quoll::TransformKernel::compose(data.positions, data.rotations,
+                                    data.scales, data.transforms);
+    benchmark::DoNotOptimize(data.transforms.data());
+  }
+
+  state.SetItemsProcessed(state.iterations() * NumTransforms);
+}
+BENCHMARK(BM_TransformKernel_Compose)
+    ->Apply(addInstructionSets)
+    ->Unit(benchmark::kMillisecond);
+
+static void
+BM_TransformKernel_ComposeAndMultiplyWithGlm(benchmark::State &state) {
+  TransformData data;
+
+  for (auto _ : state) {
+    const glm::mat4 identity{1.0f};
+    for (usize i = 0; i < NumTransforms; ++i) {
+      data.transforms[i] = data.parents[i] *
+                           (glm::translate(identity, data.positions[i]) *
+                            glm::toMat4(data.rotations[i]) *
+                            glm::scale(identity, data.scales[i]));
+    }
+    benchmark::DoNotOptimize(data.transforms.data());
+  }
+
+  state.SetItemsProcessed(state.iterations() * NumTransforms);
+}
+BENCHMARK(BM_TransformKernel_ComposeAndMultiplyWithGlm)
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_TransformKernel_ComposeAndMultiply(benchmark::State &state) {
+  TransformData data;
+  if (!setInstructionSet(state)) {
+    return;
+  }
+
+  for (auto _ : state) {
+    quoll::TransformKernel::compose(data.positions, data.rotations,
+                                    data.scales, data.transforms);
+    quoll::TransformKernel::multiply(data.parents, data.transforms,
+                                     data.transforms);
+    benchmark::DoNotOptimize(data.transforms.data());
+  }
+
+  state.SetItemsProcessed(state.iterations() * NumTransforms);
+}
+BENCHMARK(BM_TransformKernel_ComposeAndMultiply)
+    ->Apply(addInstructionSets)
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,79 @@
+#include "quoll/core/Base.h"
+#include "quoll/core/Profiler.h"
+#include "quoll/scene/Scene.h"
+#include "quoll/system/SystemScheduler.h"
+#include "quoll/system/SystemView.h"
+#include <benchmark/benchmark.h>
+
+namespace {
+
+static constexpr u32 NumSystems = 8;
+
+/**
+ * @brief Component that is only used by one system
+ *
+ * @tparam TIndex System index
+ */
+template <u32 TIndex> struct BenchmarkComponent {
+  glm::vec4 value{1.0f};
+};
+
+template <u32 TIndex>
+void addSystem(quoll::SystemScheduler &scheduler, quoll::Scene &scene,
+               usize count) {
+  using Component = BenchmarkComponent<TIndex>;
+
+  auto &entityDatabase = scene.entityDatabase;
+  entityDatabase.reg<Component>();
+  for (usize i = 0; i < count; ++i) {
+    entityDatabase.set<Component>(entityDatabase.create(), {});
+  }
+
+  scheduler.add("BenchmarkSystem", quoll::SystemAccess().write<Component>(),
+                [](f32 dt, quoll::SystemView &view) {
+                  for (auto [entity, component] :
+                       view.scene->entityDatabase.view<Component>()) {
+                    for (u32 i = 0; i < 16; ++i) {
+                      component.value =
+                          component.value * (1.0f - dt) + glm::vec4(dt);
+                    }
+                  }
+                });
+}
+
+template <u32... TIndices>
+void addSystems(quoll::SystemScheduler &scheduler, quoll::Scene &scene,
+                usize count, std::integer_sequence<u32, TIndices...>) {
+  (addSystem<TIndices>(scheduler, scene, count), ...);
+}
+
+} // namespace
+
+/**
+ * Runs independent systems on different number
+ * of worker threads. Run with profiler enabled
+ * to inspect how systems are spread across threads.
+ */
+static void BM_SystemScheduler_IndependentSystems(benchmark::State &state) {
+  quoll::Scene scene;
+  quoll::SystemView view{&scene};
+
+  quoll::ThreadPool threadPool(static_cast<u32>(state.range(0)));
+  quoll::SystemScheduler scheduler(threadPool);
+  addSystems(scheduler, scene, 10000,
+             std::make_integer_sequence<u32, NumSystems>{});
+
+  for (auto _ : state) {
+    scheduler.run(0.01f, view);
+    QUOLL_PROFILE_FRAME();
+  }
+
+  state.SetItemsProcessed(state.iterations() * NumSystems);
+}
+BENCHMARK(BM_SystemScheduler_IndependentSystems)
+    ->Arg(0)
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->UseRealTime();
@@ -0,0 +1,137 @@
+#include "quoll/core/Base.h"
+#include "quoll/animation/AnimationCompression.h"
+#include "quoll/animation/KeyframeInterpolator.h"
+#include "quoll-tests/Testing.h"
+
+using SequenceTarget = quoll::KeyframeSequenceAssetTarget;
+using SequenceInterpolation = quoll::KeyframeSequenceAssetInterpolation;
+using SequenceEncoding = quoll::KeyframeSequenceAssetEncoding;
+
+using Compression = quoll::AnimationCompression;
+using Interpolator = quoll::KeyframeInterpolator;
+
+class AnimationCompressionTest : public ::testing::Test {
+public:
+  quoll::KeyframeSequenceAsset createSequence(SequenceTarget target,
+                                              usize numKeyframes) {
+    quoll::KeyframeSequenceAsset sequence;
+    sequence.target = target;
+    sequence.interpolation = SequenceInterpolation::Linear;
+
+    for (usize i = 0; i < numKeyframes; ++i) {
+      const f32 time = static_cast<f32>(i) * 0.05f;
+      sequence.keyframeTimes.push_back(time);
+
+      if (target == SequenceTarget::Rotation) {
+        auto q = glm::angleAxis(time, glm::vec3(0.0f, 1.0f, 0.0f));
+        sequence.keyframeValues.push_back(glm::vec4(q.x, q.y, q.z, q.w));
+      } else {
+        sequence.keyframeValues.push_back(
+            glm::vec4(time * 2.0f, time * 0.5f + 1.0f, -time, 0.0f));
+      }
+    }
+
+    return sequence;
+  }
+
+  f32 getAngle(glm::quat a, glm::quat b) {
+    const f32 dot = a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+    return 2.0f * std::acos(std::min(std::abs(dot), 1.0f));
+  }
+};
+
+TEST_F(AnimationCompressionTest, StoresSingleValueIfSequenceIsConstant) {
+  auto sequence = createSequence(SequenceTarget::Position, 20);
+  for (auto &value : sequence.keyframeValues) {
+    value = glm::vec4(1.0f, 2.0f, 3.0f, 0.0f);
+  }
+
+  Compression::compress(sequence, 0.001f);
+
+  EXPECT_EQ(sequence.encoding, SequenceEncoding::Constant);
+  EXPECT_TRUE(sequence.keyframeTimes.empty());
+  EXPECT_TRUE(sequence.keyframeValues.empty());
+  EXPECT_EQ(Interpolator::interpolateVec3(sequence, 0.5f),
+            glm::vec3(1.0f, 2.0f, 3.0f));
+}
+
+TEST_F(AnimationCompressionTest, QuantizesPositionsWithinErrorBounds) {
+  static constexpr f32 MaxError = 0.001f;
+
+  auto raw = createSequence(SequenceTarget::Position, 40);
+  auto sequence = raw;
+  Compression::compress(sequence, MaxError);
+
+  EXPECT_EQ(sequence.encoding, SequenceEncoding::Uniform);
+  EXPECT_TRUE(sequence.keyframeTimes.empty());
+  EXPECT_LT(Compression::getSize(sequence), Compression::getSize(raw));
+
+  for (f32 time = 0.0f; time < 2.0f; time += 0.01f) {
+    auto expected = Interpolator::interpolateVec3(raw, time);
+    auto actual = Interpolator::interpolateVec3(sequence, time);
+    EXPECT_LE(glm::length(expected - actual), MaxError) << "Time " << time;
+  }
+}
+
+TEST_F(AnimationCompressionTest, QuantizesRotationsWithinErrorBounds) {
+  static constexpr f32 MaxError = 0.001f;
+
+  auto raw = createSequence(SequenceTarget::Rotation, 40);
+  auto sequence = raw;
+  Compression::compress(sequence, MaxError);
+
+  EXPECT_EQ(sequence.encoding, SequenceEncoding::Uniform);
+  EXPECT_LT(Compression::getSize(sequence), Compression::getSize(raw));
+
+  for (f32 time = 0.0f; time < 2.0f; time += 0.01f) {
+    auto expected = Interpolator::interpolateQuat(raw, time);
+    auto actual = Interpolator::interpolateQuat(sequence, time);
+    EXPECT_LE(getAngle(expected, actual), MaxError) << "Time " << time;
+  }
+}
+
+TEST_F(AnimationCompressionTest, KeepsStepSequencesUncompressed) {
+  auto sequence = createSequence(SequenceTarget::Position, 20);
+  sequence.interpolation = SequenceInterpolation::Step;
+
+  auto raw = sequence;
+  Compression::compress(sequence, 0.001f);
+
+  EXPECT_EQ(sequence.encoding, SequenceEncoding::Raw);
+  EXPECT_EQ(sequence.keyframeTimes, raw.keyframeTimes);
+  EXPECT_EQ(sequence.keyframeValues, raw.keyframeValues);
+}
+
+TEST_F(AnimationCompressionTest, KeepsSequenceUncompressedIfItDoesNotFit) {
+  // Two keyframes cannot be stored in less space
+  auto sequence = createSequence(SequenceTarget::Position, 2);
+  Compression::compress(sequence, 0.001f);
+
+  EXPECT_EQ(sequence.encoding, SequenceEncoding::Raw);
+  EXPECT_EQ(sequence.keyframeTimes.size(), 2);
+}
+
+TEST_F(AnimationCompressionTest,
+       ReturnsAnimationSizeBeforeAndAfterCompression) {
+  quoll::AnimationAsset animation;
+  animation.time = 2.0f;
+  animation.keyframes.push_back(createSequence(SequenceTarget::Position, 40));
+  animation.keyframes.push_back(createSequence(SequenceTarget::Rotation, 40));
+  animation.keyframes.push_back(createSequence(SequenceTarget::Scale, 40));
+
+  usize rawSize = 0;
+  for (const auto &sequence : animation.keyframes) {
+    rawSize += Compression::getSize(sequence);
+  }
+
+  auto stats = Compression::compress(animation, {});
+
+  usize compressedSize = 0;
+  for (const auto &sequence : animation.keyframes) {
+    compressedSize += Compression::getSize(sequence);
+  }
+
+  EXPECT_EQ(stats.rawSize, rawSize);
+  EXPECT_EQ(stats.compressedSize, compressedSize);
+  EXPECT_LT(stats.compressedSize, stats.rawSize);
+}
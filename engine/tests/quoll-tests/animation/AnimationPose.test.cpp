@@ -0,0 +1,126 @@
+#include "quoll/core/Base.h"
+#include "quoll/animation/AnimationPose.h"
+#include "quoll-tests/Testing.h"
+
+class AnimationPoseTest : public ::testing::Test {
+public:
+  quoll::AnimationPose createPose(usize size, glm::vec3 position,
+                                  glm::quat rotation, glm::vec3 scale) {
+    quoll::AnimationPose pose;
+    pose.positions.resize(size, position);
+    pose.rotations.resize(size, rotation);
+    pose.scales.resize(size, scale);
+    return pose;
+  }
+
+  void expectNear(glm::quat actual, glm::quat expected) {
+    const f32 dot = actual.x * expected.x + actual.y * expected.y +
+                    actual.z * expected.z + actual.w * expected.w;
+    EXPECT_NEAR(std::abs(dot), 1.0f, 0.0001f);
+  }
+
+  const glm::quat identity{1.0f, 0.0f, 0.0f, 0.0f};
+
+  // 90 degree rotation around Y axis
+  const glm::quat rotation{0.70710678f, 0.0f, 0.70710678f, 0.0f};
+};
+
+using AnimationPoseDeathTest = AnimationPoseTest;
+
+TEST_F(AnimationPoseTest, ResizeResizesAllComponents) {
+  quoll::AnimationPose pose;
+  pose.resize(5);
+
+  EXPECT_EQ(pose.size(), 5);
+  EXPECT_EQ(pose.positions.size(), 5);
+  EXPECT_EQ(pose.rotations.size(), 5);
+  EXPECT_EQ(pose.scales.size(), 5);
+}
+
+TEST_F(AnimationPoseTest, BlendWithFullWeightCopiesPose) {
+  auto pose = createPose(2, glm::vec3(0.0f), identity, glm::vec3(1.0f));
+  auto target = createPose(2, glm::vec3(2.0f), rotation, glm::vec3(3.0f));
+
+  pose.blend(target, 1.0f);
+
+  EXPECT_EQ(pose.positions, target.positions);
+  EXPECT_EQ(pose.rotations, target.rotations);
+  EXPECT_EQ(pose.scales, target.scales);
+}
+
+TEST_F(AnimationPoseTest, BlendInterpolatesPoseByWeight) {
+  auto pose = createPose(2, glm::vec3(0.0f), identity, glm::vec3(1.0f));
+  auto target = createPose(2, glm::vec3(2.0f), rotation, glm::vec3(3.0f));
+
+  pose.blend(target, 0.5f);
+
+  // 45 degree rotation around Y axis
+  const glm::quat halfRotation{0.92387953f, 0.0f, 0.38268343f, 0.0f};
+
+  for (usize i = 0; i < pose.size(); ++i) {
+    EXPECT_EQ(pose.positions.at(i), glm::vec3(1.0f));
+    expectNear(pose.rotations.at(i), halfRotation);
+    EXPECT_EQ(pose.scales.at(i), glm::vec3(2.0f));
+  }
+}
+
+TEST_F(AnimationPoseTest, BlendOnlyAffectsTargetsInMask) {
+  auto pose = createPose(3, glm::vec3(0.0f), identity, glm::vec3(1.0f));
+  auto target = createPose(3, glm::vec3(2.0f), rotation, glm::vec3(3.0f));
+
+  std::vector<f32> mask{1.0f, 0.5f};
+  pose.blend(target, 1.0f, mask);
+
+  EXPECT_EQ(pose.positions.at(0), glm::vec3(2.0f));
+  EXPECT_EQ(pose.positions.at(1), glm::vec3(1.0f));
+  EXPECT_EQ(pose.positions.at(2), glm::vec3(0.0f));
+
+  expectNear(pose.rotations.at(0), rotation);
+  EXPECT_EQ(pose.rotations.at(2), identity);
+
+  EXPECT_EQ(pose.scales.at(0), glm::vec3(3.0f));
+  EXPECT_EQ(pose.scales.at(1), glm::vec3(2.0f));
+  EXPECT_EQ(pose.scales.at(2), glm::vec3(1.0f));
+}
+
+TEST_F(AnimationPoseTest, AddAppliesDifferenceFromReferencePose) {
+  auto pose = createPose(2, glm::vec3(1.0f), rotation, glm::vec3(2.0f));
+  auto reference = createPose(2, glm::vec3(0.0f), identity, glm::vec3(1.0f));
+  auto additive = createPose(2, glm::vec3(0.5f), rotation, glm::vec3(1.5f));
+
+  std::vector<f32> mask{1.0f};
+  pose.add(additive, reference, 1.0f, mask);
+
+  EXPECT_EQ(pose.positions.at(0), glm::vec3(1.5f));
+  expectNear(pose.rotations.at(0), rotation * rotation);
+  EXPECT_EQ(pose.scales.at(0), glm::vec3(3.0f));
+
+  EXPECT_EQ(pose.positions.at(1), glm::vec3(1.0f));
+  EXPECT_EQ(pose.rotations.at(1), rotation);
+  EXPECT_EQ(pose.scales.at(1), glm::vec3(2.0f));
+}
+
+TEST_F(AnimationPoseTest, AddScalesDifferenceByWeight) {
+  auto pose = createPose(1, glm::vec3(1.0f), identity, glm::vec3(2.0f));
+  auto reference = createPose(1, glm::vec3(0.0f), identity, glm::vec3(1.0f));
+  auto additive = createPose(1, glm::vec3(1.0f), identity, glm::vec3(3.0f));
+
+  pose.add(additive, reference, 0.5f, {});
+
+  EXPECT_EQ(pose.positions.at(0), glm::vec3(1.5f));
+  EXPECT_EQ(pose.scales.at(0), glm::vec3(4.0f));
+}
+
+TEST_F(AnimationPoseDeathTest, BlendFailsIfPoseSizesAreDifferent) {
+  auto pose = createPose(2, glm::vec3(0.0f), identity, glm::vec3(1.0f));
+  auto target = createPose(3, glm::vec3(0.0f), identity, glm::vec3(1.0f));
+
+  EXPECT_DEATH(pose.blend(target, 0.5f), ".*");
+}
+
+TEST_F(AnimationPoseDeathTest, AddFailsIfPoseSizesAreDifferent) {
+  auto pose = createPose(2, glm::vec3(0.0f), identity, glm::vec3(1.0f));
+  auto target = createPose(3, glm::vec3(0.0f), identity, glm::vec3(1.0f));
+
+  EXPECT_DEATH(pose.add(target, pose, 0.5f, {}), ".*");
+}
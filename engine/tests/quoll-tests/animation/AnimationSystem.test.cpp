@@ -104,6 +104,48 @@ public:
 
     return createAsset(animation);
   }
+
+  quoll::AssetRef<quoll::AnimationAsset>
+  createPositionAnimation(glm::vec3 start, glm::vec3 end, f32 time = 1.0f,
+                          usize numJoints = 0) {
+    quoll::AnimationAsset animation;
+    animation.time = time;
+
+    quoll::KeyframeSequenceAsset sequence;
+    sequence.target = quoll::KeyframeSequenceAssetTarget::Position;
+    sequence.interpolation = quoll::KeyframeSequenceAssetInterpolation::Linear;
+    sequence.keyframeTimes = {0.0f, 1.0f};
+    sequence.keyframeValues = {glm::vec4(start, 0.0f), glm::vec4(end, 0.0f)};
+
+    if (numJoints == 0) {
+      animation.keyframes.push_back(sequence);
+    }
+
+    for (u32 i = 0; i < static_cast<u32>(numJoints); ++i) {
+      sequence.joint = i;
+      sequence.jointTarget = true;
+      animation.keyframes.push_back(sequence);
+    }
+
+    return createAsset(animation);
+  }
+
+  quoll::Entity
+  createWithAnimator(quoll::AssetRef<quoll::AnimatorAsset> animatorAsset) {
+    auto entity = entityDatabase.create();
+    entityDatabase.set<quoll::LocalTransform>(entity, {});
+    entityDatabase.set<quoll::AnimatorAssetRef>(entity, {animatorAsset});
+    return entity;
+  }
+
+  void setSkeleton(quoll::Entity entity, usize numJoints) {
+    quoll::Skeleton skeleton{};
+    skeleton.jointLocalPositions.resize(numJoints, glm::vec3{0.0f});
+    skeleton.jointLocalRotations.resize(numJoints,
+                                        glm::quat{1.0f, 0.0f, 0.0f, 0.0f});
+    skeleton.jointLocalScales.resize(numJoints, glm::vec3{1.0f});
+    entityDatabase.set(entity, skeleton);
+  }
 };
 
 using AnimationSystemDeathTest = AnimationSystemTest;
@@ -568,3 +610,137 @@ TEST_F(AnimationSystemTest, DoesNothingIfAnimationDoesNotExist) {
   system.prepare(view);
   system.update(0.5f, view);
 }
+
+TEST_F(AnimationSystemTest,
+       UpdateCrossFadesStatesIfTransitionHasDuration) {
+  auto from = createPositionAnimation(glm::vec3(0.0f), glm::vec3(0.0f));
+  auto to = createPositionAnimation(glm::vec3(2.0f), glm::vec3(2.0f));
+
+  quoll::AnimationState state0{.name = "From", .animation = from};
+  state0.transitions.push_back({"Move", 1, 1.0f});
+
+  quoll::AnimationState state1{.name = "To", .animation = to};
+
+  auto entity = createWithAnimator(
+      createAsset<quoll::AnimatorAsset>({.states = {state0, state1}}));
+  const auto &transform = entityDatabase.get<quoll::LocalTransform>(entity);
+
+  system.prepare(view);
+  system.update(0.0f, view);
+  EXPECT_EQ(transform.localPosition, glm::vec3(0.0f));
+
+  entityDatabase.set<quoll::AnimatorEvent>(entity, {"Move"});
+  system.update(0.5f, view);
+
+  {
+    const auto &animator = entityDatabase.get<quoll::Animator>(entity);
+    EXPECT_EQ(animator.currentState, 1);
+    EXPECT_EQ(animator.previousState, 0);
+    EXPECT_EQ(animator.transitionTime, 0.5f);
+    EXPECT_EQ(transform.localPosition, glm::vec3(1.0f));
+  }
+
+  system.update(0.5f, view);
+
+  {
+    const auto &animator = entityDatabase.get<quoll::Animator>(entity);
+    EXPECT_EQ(animator.currentState, 1);
+    EXPECT_EQ(animator.previousState, std::numeric_limits<usize>::max());
+    EXPECT_EQ(transform.localPosition, glm::vec3(2.0f));
+  }
+}
+
+TEST_F(AnimationSystemTest, UpdateBlendsAnimationsInBlendSpaceByParameter) {
+  auto walk = createPositionAnimation(glm::vec3(0.0f), glm::vec3(0.0f));
+  auto run = createPositionAnimation(glm::vec3(2.0f), glm::vec3(2.0f));
+
+  quoll::AnimationState state{.name = "Locomotion"};
+  state.blendSpace = {{walk, 0.0f}, {run, 1.0f}};
+  state.blendParameter = 0;
+
+  auto entity = createWithAnimator(createAsset<quoll::AnimatorAsset>(
+      {.states = {state}, .parameters = {{"speed", 0.25f}}}));
+  const auto &transform = entityDatabase.get<quoll::LocalTransform>(entity);
+
+  system.prepare(view);
+  auto &animator = entityDatabase.get<quoll::Animator>(entity);
+  ASSERT_EQ(animator.parameters, std::vector<f32>{0.25f});
+
+  system.update(0.0f, view);
+  EXPECT_EQ(transform.localPosition, glm::vec3(0.5f));
+
+  animator.parameters.at(0) = 5.0f;
+  system.update(0.0f, view);
+  EXPECT_EQ(transform.localPosition, glm::vec3(2.0f));
+
+  animator.parameters.at(0) = -5.0f;
+  system.update(0.0f, view);
+  EXPECT_EQ(transform.localPosition, glm::vec3(0.0f));
+}
+
+TEST_F(AnimationSystemTest, UpdateBlendsOverrideLayerUsingJointMask) {
+  auto base = createPositionAnimation(glm::vec3(1.0f), glm::vec3(1.0f), 1.0f,
+                                      3);
+  auto upper = createPositionAnimation(glm::vec3(3.0f), glm::vec3(3.0f),
+                                       1.0f, 3);
+
+  quoll::AnimationLayer layer{.name = "Upper", .animation = upper};
+  layer.jointMask = {0.0f, 0.5f};
+
+  auto entity = createWithAnimator(createAsset<quoll::AnimatorAsset>(
+      {.states = {{.name = "Base", .animation = base}}, .layers = {layer}}));
+  setSkeleton(entity, 3);
+
+  system.prepare(view);
+  system.update(0.0f, view);
+
+  const auto &skeleton = entityDatabase.get<quoll::Skeleton>(entity);
+  EXPECT_EQ(skeleton.jointLocalPositions.at(0), glm::vec3(1.0f));
+  EXPECT_EQ(skeleton.jointLocalPositions.at(1), glm::vec3(2.0f));
+  EXPECT_EQ(skeleton.jointLocalPositions.at(2), glm::vec3(1.0f));
+
+  auto &animator = entityDatabase.get<quoll::Animator>(entity);
+  animator.layerWeights.at(0) = 0.0f;
+  system.update(0.0f, view);
+
+  EXPECT_EQ(skeleton.jointLocalPositions.at(1), glm::vec3(1.0f));
+}
+
+TEST_F(AnimationSystemTest, UpdateAddsAdditiveLayerRelativeToItsFirstFrame) {
+  auto base = createPositionAnimation(glm::vec3(1.0f), glm::vec3(1.0f));
+  auto additive = createPositionAnimation(glm::vec3(4.0f), glm::vec3(6.0f));
+
+  quoll::AnimationLayer layer{.name = "Additive", .animation = additive};
+  layer.blendMode = quoll::AnimationLayerBlendMode::Additive;
+
+  auto entity = createWithAnimator(createAsset<quoll::AnimatorAsset>(
+      {.states = {{.name = "Base", .animation = base}}, .layers = {layer}}));
+  const auto &transform = entityDatabase.get<quoll::LocalTransform>(entity);
+
+  system.prepare(view);
+  system.update(0.5f, view);
+
+  const auto &animator = entityDatabase.get<quoll::Animator>(entity);
+  EXPECT_EQ(animator.layerNormalizedTimes.at(0), 0.5f);
+  EXPECT_EQ(transform.localPosition, glm::vec3(2.0f));
+}
+
+TEST_F(AnimationSystemTest, UpdateSamplesAnimationOnceIfItIsUsedMultipleTimes) {
+  auto animation = createPositionAnimation(glm::vec3(0.0f), glm::vec3(1.0f));
+
+  quoll::AnimationLayer layer{.name = "Layer", .animation = animation};
+
+  auto entity = createWithAnimator(createAsset<quoll::AnimatorAsset>(
+      {.states = {{.name = "Base",
+                   .animation = animation,
+                   .loopMode = quoll::AnimationLoopMode::Linear}},
+       .layers = {layer, layer}}));
+  const auto &transform = entityDatabase.get<quoll::LocalTransform>(entity);
+
+  system.prepare(view);
+  system.update(0.25f, view);
+
+  const auto &animator = entityDatabase.get<quoll::Animator>(entity);
+  EXPECT_EQ(animator.numSamples, 1);
+  EXPECT_EQ(transform.localPosition, glm::vec3(0.25f));
+}
@@ -14,6 +14,40 @@ TEST_F(AnimatorLuaTableTest, TriggerAddsAnimatorEventComponent) {
   EXPECT_EQ(entityDatabase.get<quoll::AnimatorEvent>(entity).eventName, "Move");
 }
 
+TEST_F(AnimatorLuaTableTest, SetParameterUpdatesAnimatorParameter) {
+  auto asset = createAsset<quoll::AnimatorAsset>(
+      {.states = {{.name = "StateA"}},
+       .parameters = {{"direction", 0.0f}, {"speed", 0.0f}}});
+
+  auto entity = entityDatabase.create();
+  quoll::Animator animator{};
+  animator.asset = asset;
+  animator.parameters = {0.5f, 0.0f};
+  entityDatabase.set(entity, animator);
+
+  call(entity, "animatorSetParameter");
+
+  EXPECT_EQ(entityDatabase.get<quoll::Animator>(entity).parameters,
+            std::vector<f32>({0.5f, 0.75f}));
+}
+
+TEST_F(AnimatorLuaTableTest, SetLayerWeightUpdatesAnimatorLayerWeight) {
+  auto asset = createAsset<quoll::AnimatorAsset>(
+      {.states = {{.name = "StateA"}},
+       .layers = {{.name = "lower"}, {.name = "upper"}}});
+
+  auto entity = entityDatabase.create();
+  quoll::Animator animator{};
+  animator.asset = asset;
+  animator.layerWeights = {1.0f, 1.0f};
+  entityDatabase.set(entity, animator);
+
+  call(entity, "animatorSetLayerWeight");
+
+  EXPECT_EQ(entityDatabase.get<quoll::Animator>(entity).layerWeights,
+            std::vector<f32>({1.0f, 0.25f}));
+}
+
 TEST_F(AnimatorLuaTableTest, PropertiesReturnAnimatorDataIfAnimatorExists) {
   quoll::AnimatorAsset animatorAsset{};
   animatorAsset.states.push_back({.name = "StateA"});
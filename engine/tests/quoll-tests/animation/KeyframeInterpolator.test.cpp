@@ -140,3 +140,67 @@ TEST_F(KeyframeInterpolatorTest,
   EXPECT_EQ(Interpolator::interpolateQuat(sequence, 1.0f), q3);
   EXPECT_EQ(Interpolator::interpolateQuat(sequence, 2.0f), q3);
 }
+
+TEST_F(KeyframeInterpolatorTest, MovesCursorToKeyframeAtOrBeforeTime) {
+  quoll::KeyframeSequenceAsset sequence;
+  sequence.target = SequenceTarget::Position;
+  sequence.interpolation = SequenceInterpolation::Step;
+  sequence.keyframeTimes = {0.0f, 0.25f, 0.5f, 0.75f, 1.0f};
+  sequence.keyframeValues = {glm::vec4(0.0f), glm::vec4(1.0f), glm::vec4(2.0f),
+                             glm::vec4(3.0f), glm::vec4(4.0f)};
+
+  usize cursor = 0;
+  EXPECT_EQ(Interpolator::interpolateVec3(sequence, 0.3f, cursor),
+            glm::vec3(1.0f));
+  EXPECT_EQ(cursor, 1);
+
+  EXPECT_EQ(Interpolator::interpolateVec3(sequence, 0.9f, cursor),
+            glm::vec3(3.0f));
+  EXPECT_EQ(cursor, 3);
+
+  EXPECT_EQ(Interpolator::interpolateVec3(sequence, 2.0f, cursor),
+            glm::vec3(4.0f));
+  EXPECT_EQ(cursor, 4);
+
+  // Looping back to the start
+  EXPECT_EQ(Interpolator::interpolateVec3(sequence, 0.1f, cursor),
+            glm::vec3(0.0f));
+  EXPECT_EQ(cursor, 0);
+}
+
+TEST_F(KeyframeInterpolatorTest,
+       InterpolationWithCursorMatchesInterpolationWithoutCursor) {
+  static constexpr usize NumKeyframes = 100;
+
+  std::mt19937 mt(3);
+  std::uniform_real_distribution<f32> dist(-0.1f, 1.1f);
+
+  for (auto interpolation :
+       {SequenceInterpolation::Step, SequenceInterpolation::Linear}) {
+    quoll::KeyframeSequenceAsset sequence;
+    sequence.target = SequenceTarget::Rotation;
+    sequence.interpolation = interpolation;
+    for (usize i = 0; i < NumKeyframes; ++i) {
+      sequence.keyframeTimes.push_back(static_cast<f32>(i) / NumKeyframes);
+      sequence.keyframeValues.push_back(quatToVec4(randomQuat(mt)));
+    }
+
+    // Duplicate times are allowed
+    sequence.keyframeTimes.at(50) = sequence.keyframeTimes.at(49);
+
+    usize monotonicCursor = 0;
+    for (f32 t = 0.0f; t <= 1.1f; t += 0.003f) {
+      EXPECT_EQ(Interpolator::interpolateQuat(sequence, t, monotonicCursor),
+                Interpolator::interpolateQuat(sequence, t));
+      EXPECT_EQ(Interpolator::interpolateVec3(sequence, t, monotonicCursor),
+                Interpolator::interpolateVec3(sequence, t));
+    }
+
+    usize randomCursor = 0;
+    for (usize i = 0; i < 1000; ++i) {
+      f32 t = dist(mt);
+      EXPECT_EQ(Interpolator::interpolateVec3(sequence, t, randomCursor),
+                Interpolator::interpolateVec3(sequence, t));
+    }
+  }
+}
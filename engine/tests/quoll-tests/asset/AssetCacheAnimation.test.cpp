@@ -3,6 +3,7 @@
 #include "quoll/asset/AssetCache.h"
 #include "quoll/asset/AssetFileHeader.h"
 #include "quoll/asset/InputBinaryStream.h"
+#include "quoll/asset/OutputBinaryStream.h"
 #include "quoll-tests/Testing.h"
 #include "quoll-tests/test-utils/AssetCacheTestBase.h"
 #include <random>
@@ -69,8 +70,9 @@ TEST_F(AssetCacheAnimationTest, CreatesAnimationFile) {
 
   quoll::AssetFileHeader header;
   file.read(header);
-  EXPECT_EQ(header.magic, header.MagicConstant);
+  EXPECT_EQ(header.magic, header.VersionedMagicConstant);
   EXPECT_EQ(header.type, quoll::AssetType::Animation);
+  EXPECT_EQ(header.version, 1);
 
   f32 time = 0.0f;
   u32 numKeyframes = 0;
@@ -88,18 +90,21 @@ TEST_F(AssetCacheAnimationTest, CreatesAnimationFile) {
     quoll::KeyframeSequenceAssetInterpolation interpolation{0};
     bool jointTarget = false;
     quoll::JointId joint = 0;
+    quoll::KeyframeSequenceAssetEncoding encoding{0};
     u32 numValues = 0;
 
     file.read(target);
     file.read(interpolation);
     file.read(jointTarget);
     file.read(joint);
+    file.read(encoding);
     file.read(numValues);
 
     EXPECT_EQ(target, keyframe.target);
     EXPECT_EQ(interpolation, keyframe.interpolation);
     EXPECT_EQ(jointTarget, keyframe.jointTarget);
     EXPECT_EQ(joint, keyframe.joint);
+    EXPECT_EQ(encoding, quoll::KeyframeSequenceAssetEncoding::Raw);
     EXPECT_EQ(numValues, static_cast<u32>(keyframe.keyframeValues.size()));
 
     std::vector<f32> times(numValues);
@@ -147,3 +152,119 @@ TEST_F(AssetCacheAnimationTest, LoadsAnimationAssetFromFile) {
     }
   }
 }
+
+TEST_F(AssetCacheAnimationTest, LoadsCompressedAnimationAssetFromFile) {
+  auto asset = createRandomizedAnimation();
+
+  auto &constant = asset.data.keyframes.at(0);
+  constant.encoding = quoll::KeyframeSequenceAssetEncoding::Constant;
+  constant.rangeMin = glm::vec4(1.0f, 2.0f, 3.0f, 4.0f);
+  constant.keyframeTimes.clear();
+  constant.keyframeValues.clear();
+
+  auto &uniform = asset.data.keyframes.at(1);
+  uniform.target = quoll::KeyframeSequenceAssetTarget::Position;
+  uniform.encoding = quoll::KeyframeSequenceAssetEncoding::Uniform;
+  uniform.startTime = 0.2f;
+  uniform.endTime = 0.8f;
+  uniform.rangeMin = glm::vec4(-1.0f, -2.0f, -3.0f, 0.0f);
+  uniform.rangeExtent = glm::vec4(2.0f, 4.0f, 6.0f, 0.0f);
+  uniform.numSamples = 3;
+  uniform.compressedValues = {0, 1, 2, 3, 4, 5, 6, 7, 8};
+  uniform.keyframeTimes.clear();
+  uniform.keyframeValues.clear();
+
+  auto filePath = cache.createFromData(asset);
+  auto res = requestAndWait<quoll::AnimationAsset>(asset.uuid);
+  ASSERT_TRUE(res);
+
+  auto animation = res.data();
+  const auto &actualConstant = animation->keyframes.at(0);
+  EXPECT_EQ(actualConstant.encoding,
+            quoll::KeyframeSequenceAssetEncoding::Constant);
+  EXPECT_EQ(actualConstant.rangeMin, constant.rangeMin);
+  EXPECT_TRUE(actualConstant.keyframeTimes.empty());
+
+  const auto &actualUniform = animation->keyframes.at(1);
+  EXPECT_EQ(actualUniform.encoding,
+            quoll::KeyframeSequenceAssetEncoding::Uniform);
+  EXPECT_EQ(actualUniform.startTime, uniform.startTime);
+  EXPECT_EQ(actualUniform.endTime, uniform.endTime);
+  EXPECT_EQ(actualUniform.rangeMin, uniform.rangeMin);
+  EXPECT_EQ(actualUniform.rangeExtent, uniform.rangeExtent);
+  EXPECT_EQ(actualUniform.numSamples, uniform.numSamples);
+  EXPECT_EQ(actualUniform.compressedValues, uniform.compressedValues);
+  EXPECT_TRUE(actualUniform.keyframeTimes.empty());
+}
+
+TEST_F(AssetCacheAnimationTest, LoadsAnimationFileWithoutVersion) {
+  auto asset = createRandomizedAnimation();
+  cache.createFromData(asset);
+
+  {
+    quoll::OutputBinaryStream file(cache.getPathFromUuid(asset.uuid));
+
+    quoll::AssetFileHeader header{};
+    header.magic = header.MagicConstant;
+    header.type = quoll::AssetType::Animation;
+    file.write(header);
+
+    file.write(asset.data.time);
+    const u32 numKeyframes = static_cast<u32>(asset.data.keyframes.size());
+    file.write(numKeyframes);
+
+    for (auto &keyframe : asset.data.keyframes) {
+      file.write(keyframe.target);
+      file.write(keyframe.interpolation);
+      file.write(keyframe.jointTarget);
+      file.write(keyframe.joint);
+      const u32 numValues = static_cast<u32>(keyframe.keyframeTimes.size());
+      file.write(numValues);
+      file.write(keyframe.keyframeTimes);
+      file.write(keyframe.keyframeValues);
+    }
+  }
+
+  auto res = requestAndWait<quoll::AnimationAsset>(asset.uuid);
+  ASSERT_TRUE(res);
+
+  auto animation = res.data();
+  ASSERT_EQ(animation->keyframes.size(), asset.data.keyframes.size());
+  for (usize i = 0; i < asset.data.keyframes.size(); ++i) {
+    auto &expectedKf = asset.data.keyframes.at(i);
+    auto &actualKf = animation->keyframes.at(i);
+
+    EXPECT_EQ(actualKf.encoding, quoll::KeyframeSequenceAssetEncoding::Raw);
+    EXPECT_EQ(expectedKf.joint, actualKf.joint);
+    EXPECT_EQ(expectedKf.keyframeTimes, actualKf.keyframeTimes);
+    EXPECT_EQ(expectedKf.keyframeValues, actualKf.keyframeValues);
+  }
+}
+
+TEST_F(AssetCacheAnimationTest, LoadAnimationFailsIfEncodingIsUnknown) {
+  auto asset = createRandomizedAnimation();
+  asset.data.keyframes.at(0).encoding =
+      static_cast<quoll::KeyframeSequenceAssetEncoding>(10);
+  cache.createFromData(asset);
+
+  auto res = requestAndWait<quoll::AnimationAsset>(asset.uuid);
+  EXPECT_FALSE(res);
+}
+
+TEST_F(AssetCacheAnimationTest, LoadAnimationFailsIfVersionIsNotSupported) {
+  auto asset = createRandomizedAnimation();
+  cache.createFromData(asset);
+
+  {
+    quoll::OutputBinaryStream file(cache.getPathFromUuid(asset.uuid));
+
+    quoll::AssetFileHeader header{};
+    header.magic = header.VersionedMagicConstant;
+    header.type = quoll::AssetType::Animation;
+    header.version = 2;
+    file.write(header);
+  }
+
+  auto res = requestAndWait<quoll::AnimationAsset>(asset.uuid);
+  EXPECT_FALSE(res);
+}
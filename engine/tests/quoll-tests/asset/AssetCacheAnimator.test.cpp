@@ -588,3 +588,148 @@ TEST_F(AssetCacheAnimatorTest,
   EXPECT_EQ(newAnimator.meta().type, quoll::AssetType::Animator);
   EXPECT_EQ(newAnimator.meta().name, "new-name");
 }
+
+TEST_F(AssetCacheAnimatorTest, LoadsBlendingDataOfAnimatorCreatedFromAsset) {
+  auto idle = createAsset<quoll::AnimationAsset>();
+  auto walk = createAsset<quoll::AnimationAsset>();
+  auto run = createAsset<quoll::AnimationAsset>();
+  auto wave = createAsset<quoll::AnimationAsset>();
+
+  quoll::AssetData<quoll::AnimatorAsset> asset{};
+  asset.name = "my-animator.animator";
+  asset.uuid = quoll::Uuid::generate();
+  asset.data.parameters = {{"direction", 0.0f}, {"speed", 0.5f}};
+
+  quoll::AnimationState stateIdle;
+  stateIdle.name = "idle";
+  stateIdle.animation = idle;
+  stateIdle.transitions.push_back({"MOVE", 1, 0.25f});
+
+  quoll::AnimationState stateMove;
+  stateMove.name = "move";
+  stateMove.blendSpace = {{walk, 0.0f}, {run, 1.0f}};
+  stateMove.blendParameter = 1;
+  stateMove.loopMode = quoll::AnimationLoopMode::Linear;
+  stateMove.transitions.push_back({"STOP", 0});
+
+  asset.data.states = {stateIdle, stateMove};
+
+  quoll::AnimationLayer layer{};
+  layer.name = "wave";
+  layer.animation = wave;
+  layer.weight = 0.5f;
+  layer.speed = 2.0f;
+  layer.blendMode = quoll::AnimationLayerBlendMode::Additive;
+  layer.jointMask = {0.0f, 1.0f, 0.5f};
+  asset.data.layers.push_back(layer);
+
+  ASSERT_TRUE(cache.createFromData(asset));
+
+  auto res = requestAndWait<quoll::AnimatorAsset>(asset.uuid);
+  ASSERT_TRUE(res);
+  EXPECT_FALSE(res.hasWarnings());
+
+  const auto &animator = res.data().get();
+
+  ASSERT_EQ(animator.parameters.size(), 2);
+  EXPECT_EQ(animator.parameters.at(0).name, "direction");
+  EXPECT_EQ(animator.parameters.at(0).value, 0.0f);
+  EXPECT_EQ(animator.parameters.at(1).name, "speed");
+  EXPECT_EQ(animator.parameters.at(1).value, 0.5f);
+
+  ASSERT_EQ(animator.states.size(), 2);
+  EXPECT_EQ(animator.states.at(0).transitions.at(0).duration, 0.25f);
+  EXPECT_EQ(animator.states.at(1).transitions.at(0).duration, 0.0f);
+
+  const auto &move = animator.states.at(1);
+  EXPECT_FALSE(move.animation);
+  EXPECT_EQ(move.blendParameter, 1);
+  EXPECT_EQ(move.loopMode, quoll::AnimationLoopMode::Linear);
+  ASSERT_EQ(move.blendSpace.size(), 2);
+  EXPECT_EQ(move.blendSpace.at(0).animation, walk);
+  EXPECT_EQ(move.blendSpace.at(0).position, 0.0f);
+  EXPECT_EQ(move.blendSpace.at(1).animation, run);
+  EXPECT_EQ(move.blendSpace.at(1).position, 1.0f);
+
+  ASSERT_EQ(animator.layers.size(), 1);
+  const auto &actualLayer = animator.layers.at(0);
+  EXPECT_EQ(actualLayer.name, "wave");
+  EXPECT_EQ(actualLayer.animation, wave);
+  EXPECT_EQ(actualLayer.weight, 0.5f);
+  EXPECT_EQ(actualLayer.speed, 2.0f);
+  EXPECT_EQ(actualLayer.blendMode, quoll::AnimationLayerBlendMode::Additive);
+  EXPECT_EQ(actualLayer.jointMask, layer.jointMask);
+}
+
+TEST_F(AssetCacheAnimatorTest, LoadAnimatorSortsBlendSpacePointsByPosition) {
+  auto walk = createAsset<quoll::AnimationAsset>();
+  auto run = createAsset<quoll::AnimationAsset>();
+
+  YAML::Node node;
+  node["version"] = "0.1";
+  node["type"] = "animator";
+
+  YAML::Node parameter;
+  parameter["name"] = "speed";
+  node["parameters"].push_back(parameter);
+
+  auto state = node["states"]["move"];
+  state["output"]["type"] = "blend";
+  state["output"]["parameter"] = "speed";
+
+  YAML::Node runPoint;
+  runPoint["animation"] = run.meta().uuid;
+  runPoint["position"] = 2.0f;
+  state["output"]["points"].push_back(runPoint);
+
+  YAML::Node walkPoint;
+  walkPoint["animation"] = walk.meta().uuid;
+  walkPoint["position"] = 1.0f;
+  state["output"]["points"].push_back(walkPoint);
+
+  std::ofstream stream(FilePath);
+  stream << node;
+  stream.close();
+
+  auto uuid = quoll::Uuid::generate();
+  ASSERT_TRUE(cache.createFromSource<quoll::AnimatorAsset>(FilePath, uuid));
+
+  auto res = requestAndWait<quoll::AnimatorAsset>(uuid);
+  ASSERT_TRUE(res);
+  EXPECT_FALSE(res.hasWarnings());
+
+  const auto &blendSpace = res.data()->states.at(0).blendSpace;
+  ASSERT_EQ(blendSpace.size(), 2);
+  EXPECT_EQ(blendSpace.at(0).animation, walk);
+  EXPECT_EQ(blendSpace.at(1).animation, run);
+}
+
+TEST_F(AssetCacheAnimatorTest,
+       LoadAnimatorIgnoresBlendSpaceIfParameterDoesNotExist) {
+  auto walk = createAsset<quoll::AnimationAsset>();
+
+  YAML::Node node;
+  node["version"] = "0.1";
+  node["type"] = "animator";
+
+  auto state = node["states"]["move"];
+  state["output"]["type"] = "blend";
+  state["output"]["parameter"] = "speed";
+
+  YAML::Node point;
+  point["animation"] = walk.meta().uuid;
+  point["position"] = 1.0f;
+  state["output"]["points"].push_back(point);
+
+  std::ofstream stream(FilePath);
+  stream << node;
+  stream.close();
+
+  auto uuid = quoll::Uuid::generate();
+  ASSERT_TRUE(cache.createFromSource<quoll::AnimatorAsset>(FilePath, uuid));
+
+  auto res = requestAndWait<quoll::AnimatorAsset>(uuid);
+  ASSERT_TRUE(res);
+  EXPECT_TRUE(res.hasWarnings());
+  EXPECT_TRUE(res.data()->states.at(0).blendSpace.empty());
+}
@@ -253,6 +253,11 @@ TEST_F(AssetCacheMeshTest, LoadsMeshFromFile) {
       auto actual = actualGeometry.indices.at(i);
       EXPECT_EQ(expected, actual);
     }
+
+    auto expectedBounds =
+        quoll::BoundingBox::fromPoints(expectedGeometry.positions);
+    EXPECT_EQ(actualGeometry.bounds.min, expectedBounds.min);
+    EXPECT_EQ(actualGeometry.bounds.max, expectedBounds.max);
   }
 }
 TEST_F(AssetCacheMeshTest, CreateMeshAssetWithSkinData) {
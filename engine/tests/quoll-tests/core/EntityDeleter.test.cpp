@@ -126,3 +126,34 @@ TEST_F(EntityDeleterTest, SetsSceneActiveCameraToDummyIfActiveCameraIsDeleted) {
 
   EXPECT_EQ(scene.activeCamera, scene.dummyCamera);
 }
+
+TEST_F(EntityDeleterTest, DeletesDeepHierarchies) {
+  static constexpr usize NumEntities = 10000;
+
+  auto sibling = scene.entityDatabase.create();
+  auto root = scene.entityDatabase.create();
+  auto parent = scene.entityDatabase.create();
+  scene.entityDatabase.set<quoll::Children>(parent, {{sibling, root}});
+  scene.entityDatabase.set<quoll::Parent>(sibling, {parent});
+  scene.entityDatabase.set<quoll::Parent>(root, {parent});
+  scene.entityDatabase.set<quoll::Delete>(root, {});
+
+  std::vector<quoll::Entity> entities{root};
+  for (usize i = 1; i < NumEntities; ++i) {
+    auto entity = scene.entityDatabase.create();
+    scene.entityDatabase.set<quoll::Parent>(entity, {entities.back()});
+    scene.entityDatabase.set<quoll::Children>(entities.back(), {{entity}});
+    entities.push_back(entity);
+  }
+
+  entityDeleter.update(view);
+
+  for (auto entity : entities) {
+    EXPECT_FALSE(scene.entityDatabase.exists(entity));
+  }
+
+  EXPECT_TRUE(scene.entityDatabase.exists(parent));
+  EXPECT_TRUE(scene.entityDatabase.exists(sibling));
+  EXPECT_EQ(scene.entityDatabase.get<quoll::Children>(parent).children,
+            std::vector<quoll::Entity>{sibling});
+}
@@ -0,0 +1,111 @@
+#include "quoll/core/Base.h"
+#include "quoll/core/ThreadLocal.h"
+#include "quoll/core/ThreadPool.h"
+#include "quoll-tests/Testing.h"
+
+TEST(ThreadPoolTest, RunsAllSubmittedJobsBeforeDestruction) {
+  std::atomic<u32> count{0};
+
+  {
+    quoll::ThreadPool threadPool(4);
+    EXPECT_EQ(threadPool.getNumThreads(), 4);
+
+    for (u32 i = 0; i < 100; ++i) {
+      threadPool.submit([&count] { count++; });
+    }
+  }
+
+  EXPECT_EQ(count, 100);
+}
+
+TEST(ThreadPoolTest, RunsJobInCallingThreadIfPoolHasNoThreads) {
+  quoll::ThreadPool threadPool(0);
+
+  std::thread::id jobThread;
+  threadPool.submit([&jobThread] { jobThread = std::this_thread::get_id(); });
+
+  EXPECT_EQ(jobThread, std::this_thread::get_id());
+}
+
+TEST(ThreadPoolTest, ParallelForRunsFunctionForEveryItemOnce) {
+  quoll::ThreadPool threadPool(4);
+
+  std::vector<std::atomic<u32>> visits(1001);
+  threadPool.parallelFor(visits.size(), 10, [&visits](usize start, usize end) {
+    EXPECT_LE(end - start, 10);
+    for (usize i = start; i < end; ++i) {
+      visits.at(i)++;
+    }
+  });
+
+  for (auto &count : visits) {
+    EXPECT_EQ(count, 1);
+  }
+}
+
+TEST(ThreadPoolTest, ParallelForRunsInCallingThreadIfRangeFitsInOneChunk) {
+  quoll::ThreadPool threadPool(4);
+
+  std::vector<std::thread::id> threads;
+  threadPool.parallelFor(10, 10, [&threads](usize start, usize end) {
+    threads.push_back(std::this_thread::get_id());
+  });
+
+  EXPECT_EQ(threads,
+            std::vector<std::thread::id>{std::this_thread::get_id()});
+}
+
+TEST(ThreadPoolTest, ParallelForCanBeCalledFromWorkerThreads) {
+  quoll::ThreadPool threadPool(2);
+
+  std::atomic<u32> count{0};
+  threadPool.parallelFor(4, 1, [&threadPool, &count](usize, usize) {
+    threadPool.parallelFor(100, 10, [&count](usize start, usize end) {
+      count += static_cast<u32>(end - start);
+    });
+  });
+
+  EXPECT_EQ(count, 400);
+}
+
+TEST(ThreadPoolTest, ReturnsZeroThreadIndexOutsideOfPool) {
+  quoll::ThreadPool threadPool(2);
+  EXPECT_EQ(threadPool.getThreadIndex(), 0);
+
+  std::atomic<u32> index{0};
+  std::atomic<bool> done{false};
+  threadPool.submit([&] {
+    index = threadPool.getThreadIndex();
+    done = true;
+  });
+
+  while (!done) {
+    std::this_thread::yield();
+  }
+
+  EXPECT_GE(index, 1);
+  EXPECT_LE(index, 2);
+}
+
+TEST(ThreadLocalTest, StoresValuePerThreadThatCanBeMerged) {
+  quoll::ThreadPool threadPool(4);
+  quoll::ThreadLocal<std::vector<usize>> values(threadPool);
+
+  threadPool.parallelFor(1000, 10, [&values](usize start, usize end) {
+    auto &value = values.get();
+    for (usize i = start; i < end; ++i) {
+      value.push_back(i);
+    }
+  });
+
+  std::vector<usize> merged;
+  for (auto &value : values) {
+    merged.insert(merged.end(), value.begin(), value.end());
+  }
+  std::sort(merged.begin(), merged.end());
+
+  ASSERT_EQ(merged.size(), 1000);
+  for (usize i = 0; i < merged.size(); ++i) {
+    EXPECT_EQ(merged.at(i), i);
+  }
+}
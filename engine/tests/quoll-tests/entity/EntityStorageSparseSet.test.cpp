@@ -199,6 +199,18 @@ TEST(EntityStorageSparseSetDeathTest,
   EXPECT_DEATH({ storage.remove<IntComponent>(entity); }, ".*");
 }
 
+TEST(EntityStorageSparseSetDeathTest,
+     DeleteThrowsErrorIfStaleEntityDoesNotOwnComponent) {
+  TestEntityStorage<IntComponent> storage;
+  auto stale = storage.create();
+  storage.deleteEntity(stale);
+
+  auto recycledEntity = storage.create();
+  storage.set<IntComponent>(recycledEntity, {6});
+
+  EXPECT_DEATH({ storage.remove<IntComponent>(stale); }, ".*");
+}
+
 TEST(EntityStorageSparseSetTest, DeletesComponentIfExists) {
   TestEntityStorage<IntComponent, FloatComponent> storage;
   auto entity = storage.create();
@@ -241,7 +253,10 @@ TEST(EntityStorageSparseSetTest, UseRecyclesEntity) {
   auto recycledEntity = storage.create();
   EXPECT_EQ(storage.getEntityCount(), 3);
   EXPECT_TRUE(storage.exists(recycledEntity));
-  EXPECT_EQ(recycledEntity, e2);
+  EXPECT_NE(recycledEntity, e2);
+  EXPECT_EQ(quoll::getEntityIndex(recycledEntity), quoll::getEntityIndex(e2));
+  EXPECT_EQ(quoll::getEntityGeneration(recycledEntity),
+            quoll::getEntityGeneration(e2) + 1);
   EXPECT_FALSE(storage.has<IntComponent>(recycledEntity));
   EXPECT_FALSE(storage.has<FloatComponent>(recycledEntity));
 
@@ -252,6 +267,58 @@ TEST(EntityStorageSparseSetTest, UseRecyclesEntity) {
   EXPECT_EQ(storage.get<IntComponent>(recycledEntity).value, 6);
 }
 
+TEST(EntityStorageSparseSetTest, RecyclesEntitiesInDeletionOrder) {
+  TestEntityStorage<IntComponent> storage;
+  auto e1 = storage.create();
+  auto e2 = storage.create();
+  auto e3 = storage.create();
+
+  storage.deleteEntity(e3);
+  storage.deleteEntity(e1);
+
+  EXPECT_EQ(quoll::getEntityIndex(storage.create()), quoll::getEntityIndex(e3));
+  EXPECT_EQ(quoll::getEntityIndex(storage.create()), quoll::getEntityIndex(e1));
+  EXPECT_EQ(quoll::getEntityIndex(storage.create()),
+            quoll::getEntityIndex(e3) + 1);
+  EXPECT_TRUE(storage.exists(e2));
+}
+
+TEST(EntityStorageSparseSetTest, StaleEntityDoesNotAliasRecycledEntity) {
+  TestEntityStorage<IntComponent> storage;
+  auto stale = storage.create();
+  storage.set<IntComponent>(stale, {5});
+  storage.deleteEntity(stale);
+
+  auto recycledEntity = storage.create();
+  storage.set<IntComponent>(recycledEntity, {6});
+
+  EXPECT_FALSE(storage.exists(stale));
+  EXPECT_FALSE(storage.has<IntComponent>(stale));
+  EXPECT_TRUE(storage.has<IntComponent>(recycledEntity));
+
+  storage.deleteEntity(stale);
+  EXPECT_TRUE(storage.exists(recycledEntity));
+  EXPECT_EQ(storage.get<IntComponent>(recycledEntity).value, 6);
+  EXPECT_EQ(storage.getEntityCount(), 1);
+}
+
+TEST(EntityStorageSparseSetTest, DoesNotRecycleIndexWithExhaustedGeneration) {
+  TestEntityStorage<IntComponent> storage;
+  auto entity = storage.create();
+  const auto index = quoll::getEntityIndex(entity);
+
+  for (u32 i = 0; i < quoll::MaxEntityGeneration; ++i) {
+    storage.deleteEntity(entity);
+    entity = storage.create();
+    EXPECT_EQ(quoll::getEntityIndex(entity), index);
+  }
+
+  EXPECT_EQ(quoll::getEntityGeneration(entity), quoll::MaxEntityGeneration);
+  storage.deleteEntity(entity);
+
+  EXPECT_NE(quoll::getEntityIndex(storage.create()), index);
+}
+
 TEST(EntityStorageSparseSetTest, DoesNotDeleteNonExistentEntity) {
   TestEntityStorage<IntComponent, FloatComponent> storage;
   storage.deleteEntity(quoll::Entity::Null);
@@ -299,6 +366,103 @@ TEST(EntityStorageSparseSetTest, DeletesEntityAndItsComponentsIfExists) {
   EXPECT_EQ(storage.getEntityCount(), 2);
 }
 
+TEST(EntityStorageSparseSetTest, DeletesEntitiesInBatch) {
+  TestEntityStorage<IntComponent, FloatComponent> storage;
+  std::vector<quoll::Entity> entities;
+  for (int i = 0; i < 10; ++i) {
+    auto entity = storage.create();
+    storage.set<IntComponent>(entity, {i});
+    if ((i % 3) == 0) {
+      storage.set<FloatComponent>(entity, {static_cast<f32>(i)});
+    }
+    entities.push_back(entity);
+  }
+
+  auto stale = storage.create();
+  storage.deleteEntity(stale);
+
+  auto observer = storage.observeRemove<IntComponent>();
+
+  // Duplicates and deleted entities are skipped
+  std::vector<quoll::Entity> deleteList{entities.at(9), entities.at(0),
+                                        entities.at(5), entities.at(0),
+                                        entities.at(8), stale};
+  storage.deleteEntities(deleteList);
+
+  EXPECT_EQ(storage.getEntityCount(), 6);
+  EXPECT_EQ(storage.getEntityCountForComponent<IntComponent>(), 6);
+  EXPECT_EQ(storage.getEntityCountForComponent<FloatComponent>(), 2);
+  EXPECT_EQ(observer.size(), 4);
+
+  for (int i = 0; i < 10; ++i) {
+    auto entity = entities.at(i);
+    const bool deleted = i == 0 || i == 5 || i == 8 || i == 9;
+    EXPECT_NE(storage.exists(entity), deleted);
+    EXPECT_NE(storage.has<IntComponent>(entity), deleted);
+
+    if (!deleted) {
+      EXPECT_EQ(storage.get<IntComponent>(entity).value, i);
+      EXPECT_EQ(storage.has<FloatComponent>(entity), (i % 3) == 0);
+    }
+  }
+
+  for (auto [entity, component] : storage.view<IntComponent>()) {
+    EXPECT_EQ(entity, entities.at(component.value));
+  }
+}
+
+TEST(EntityStorageSparseSetTest, DeletesComponentsOfRecycledEntity) {
+  TestEntityStorage<IntComponent, FloatComponent> storage;
+  auto entity = storage.create();
+  storage.set<IntComponent>(entity, {1});
+  storage.set<FloatComponent>(entity, {1.0f});
+  storage.remove<FloatComponent>(entity);
+  storage.deleteEntity(entity);
+
+  auto recycledEntity = storage.create();
+  storage.set<FloatComponent>(recycledEntity, {2.0f});
+  storage.deleteEntity(recycledEntity);
+
+  EXPECT_EQ(storage.getEntityCountForComponent<IntComponent>(), 0);
+  EXPECT_EQ(storage.getEntityCountForComponent<FloatComponent>(), 0);
+}
+
+TEST(EntityStorageSparseSetTest, DuplicatesEntitiesAndComponents) {
+  TestEntityStorage<IntComponent, StringComponent> storage;
+  auto e1 = storage.create();
+  auto e2 = storage.create();
+  storage.set<IntComponent>(e1, {10});
+  storage.set<StringComponent>(e1, {"e1"});
+  storage.set<StringComponent>(e2, {"e2"});
+
+  TestEntityStorage<IntComponent, StringComponent> duplicate;
+  storage.duplicate(duplicate);
+
+  storage.set<IntComponent>(e1, {20});
+  storage.deleteEntity(e2);
+
+  EXPECT_EQ(duplicate.getEntityCount(), 2);
+  EXPECT_TRUE(duplicate.exists(e2));
+  EXPECT_EQ(duplicate.get<IntComponent>(e1).value, 10);
+  EXPECT_EQ(duplicate.get<StringComponent>(e1).value, "e1");
+  EXPECT_FALSE(duplicate.has<IntComponent>(e2));
+  EXPECT_EQ(duplicate.get<StringComponent>(e2).value, "e2");
+}
+
+TEST(EntityStorageSparseSetTest, DuplicatedComponentPoolsHaveNewVersions) {
+  TestEntityStorage<IntComponent, StringComponent> storage;
+  auto e1 = storage.create();
+  storage.set<IntComponent>(e1, {10});
+
+  TestEntityStorage<IntComponent, StringComponent> duplicate;
+  storage.duplicate(duplicate);
+
+  EXPECT_NE(duplicate.getComponentVersion<IntComponent>(),
+            storage.getComponentVersion<IntComponent>());
+  EXPECT_NE(duplicate.getComponentVersion<StringComponent>(),
+            storage.getComponentVersion<StringComponent>());
+}
+
 TEST(EntityStorageSparseSetTest, IterateEntities) {
   TestEntityStorage<IntComponent, FloatComponent, StringComponent, Component1>
       storage;
@@ -361,6 +525,45 @@ TEST(EntityStorageSparseSetTest, IterateEntities) {
   }
 }
 
+TEST(EntityStorageSparseSetTest, IteratesEntitiesInParallel) {
+  TestEntityStorage<IntComponent, FloatComponent> storage;
+  quoll::ThreadPool threadPool(4);
+
+  std::vector<quoll::Entity> expected;
+  for (int i = 0; i < 1000; ++i) {
+    auto entity = storage.create();
+    storage.set<IntComponent>(entity, {i});
+
+    if (i % 3 == 0) {
+      storage.set<FloatComponent>(entity, {static_cast<f32>(i)});
+      expected.push_back(entity);
+    }
+  }
+
+  std::vector<std::atomic<u32>> visits(2000);
+  storage.view<IntComponent, FloatComponent>().parallelForEach(
+      threadPool,
+      [&visits](quoll::Entity entity, IntComponent &val1,
+                FloatComponent &val2) {
+        EXPECT_EQ(static_cast<f32>(val1.value), val2.value);
+        val1.value *= 2;
+        visits.at(static_cast<usize>(entity))++;
+      },
+      16);
+
+  for (auto entity : expected) {
+    EXPECT_EQ(visits.at(static_cast<usize>(entity)), 1);
+    EXPECT_EQ(storage.get<IntComponent>(entity).value,
+              static_cast<int>(storage.get<FloatComponent>(entity).value) * 2);
+  }
+
+  u32 totalVisits = 0;
+  for (auto &count : visits) {
+    totalVisits += count;
+  }
+  EXPECT_EQ(totalVisits, expected.size());
+}
+
 TEST(EntityStorageSparseSetTest, DestroysOneComponent) {
   TestEntityStorage<IntComponent, FloatComponent, StringComponent> storage;
   auto e1 = storage.create(); // 0
@@ -436,7 +639,7 @@ TEST(EntityStorageSparseSetTest, DeletesOnlyNeededComponents) {
 
   // This entity is going to fill up the space of old one
   auto newE1 = storage.create();
-  EXPECT_EQ(e1, newE1);
+  EXPECT_EQ(quoll::getEntityIndex(e1), quoll::getEntityIndex(newE1));
 
   // Set component for the entity
   storage.set<StringComponent>(newE1, {"Hello World"});
@@ -680,3 +883,379 @@ TEST(EntityStorageSparseSetTest, ClearingObserverClearsAllExistingData) {
     }
   }
 }
+
+/**
+ * @brief Check that group is packed
+ *
+ * Entities in the packed range of a group
+ * must have all grouped components and
+ * entities outside it must not.
+ *
+ * @param storage Storage
+ * @param expected Expected entities in group
+ */
+template <class TStorage>
+static void expectPackedGroup(TStorage &storage,
+                              const std::set<quoll::Entity> &expected) {
+  const auto groupSize = storage.template getGroupSize<IntComponent,
+                                                        FloatComponent>();
+  EXPECT_EQ(groupSize, expected.size());
+
+  usize index = 0;
+  for (auto [entity, value] : storage.template view<IntComponent>()) {
+    EXPECT_EQ(index < groupSize, expected.contains(entity));
+    index++;
+  }
+
+  index = 0;
+  for (auto [entity, value] : storage.template view<FloatComponent>()) {
+    EXPECT_EQ(index < groupSize, expected.contains(entity));
+    index++;
+  }
+
+  std::set<quoll::Entity> actual;
+  for (auto [entity, intValue, floatValue] :
+       storage.template view<IntComponent, FloatComponent>()) {
+    EXPECT_EQ(static_cast<f32>(intValue.value), floatValue.value);
+    actual.insert(entity);
+  }
+  EXPECT_EQ(actual, expected);
+}
+
+TEST(EntityStorageSparseSetTest, GroupsExistingEntities) {
+  TestEntityStorage<IntComponent, FloatComponent> storage;
+  std::set<quoll::Entity> expected;
+  for (int i = 0; i < 20; ++i) {
+    auto entity = storage.create();
+    if ((i % 3) != 0) {
+      storage.set<IntComponent>(entity, {i});
+    }
+    if ((i % 2) == 0) {
+      storage.set<FloatComponent>(entity, {static_cast<f32>(i)});
+    }
+    if ((i % 3) != 0 && (i % 2) == 0) {
+      expected.insert(entity);
+    }
+  }
+
+  storage.group<IntComponent, FloatComponent>();
+  expectPackedGroup(storage, expected);
+}
+
+TEST(EntityStorageSparseSetTest, KeepsGroupPackedWhenComponentsChange) {
+  TestEntityStorage<IntComponent, FloatComponent> storage;
+  storage.group<IntComponent, FloatComponent>();
+
+  std::vector<quoll::Entity> entities;
+  for (int i = 0; i < 50; ++i) {
+    entities.push_back(storage.create());
+  }
+
+  std::mt19937 random{5};
+  std::set<quoll::Entity> expected;
+  for (usize step = 0; step < 1000; ++step) {
+    const auto i = random() % entities.size();
+    auto entity = entities.at(i);
+    const auto value = static_cast<int>(i);
+
+    switch (random() % 5) {
+    case 0:
+      storage.set<IntComponent>(entity, {value});
+      break;
+    case 1:
+      storage.set<FloatComponent>(entity, {static_cast<f32>(value)});
+      break;
+    case 2:
+      if (storage.has<IntComponent>(entity)) {
+        storage.remove<IntComponent>(entity);
+      }
+      break;
+    case 3:
+      if (storage.has<FloatComponent>(entity)) {
+        storage.remove<FloatComponent>(entity);
+      }
+      break;
+    default:
+      storage.deleteEntity(entity);
+      entities.at(i) = storage.create();
+      break;
+    }
+
+    if (storage.has<IntComponent>(entity) &&
+        storage.has<FloatComponent>(entity)) {
+      expected.insert(entity);
+    } else {
+      expected.erase(entity);
+    }
+  }
+
+  expectPackedGroup(storage, expected);
+}
+
+TEST(EntityStorageSparseSetTest, RemovesDeletedEntitiesFromGroup) {
+  TestEntityStorage<IntComponent, FloatComponent, StringComponent> storage;
+  storage.group<IntComponent, FloatComponent>();
+
+  std::vector<quoll::Entity> entities;
+  for (int i = 0; i < 10; ++i) {
+    auto entity = storage.create();
+    storage.set<IntComponent>(entity, {i});
+    storage.set<FloatComponent>(entity, {static_cast<f32>(i)});
+    storage.set<StringComponent>(entity, {std::to_string(i)});
+    entities.push_back(entity);
+  }
+
+  std::vector<quoll::Entity> deleteList{entities.at(1), entities.at(9),
+                                        entities.at(4)};
+  storage.deleteEntities(deleteList);
+  storage.destroyComponents<StringComponent>();
+
+  std::set<quoll::Entity> expected(entities.begin(), entities.end());
+  for (auto entity : deleteList) {
+    expected.erase(entity);
+  }
+  expectPackedGroup(storage, expected);
+
+  storage.destroyComponents<FloatComponent>();
+  EXPECT_EQ((storage.getGroupSize<IntComponent, FloatComponent>()), 0);
+}
+
+TEST(EntityStorageSparseSetTest, ViewsGroupedAndOtherComponentsTogether) {
+  TestEntityStorage<IntComponent, FloatComponent, StringComponent> storage;
+  storage.group<IntComponent, FloatComponent>();
+
+  std::set<quoll::Entity> expected;
+  for (int i = 0; i < 10; ++i) {
+    auto entity = storage.create();
+    storage.set<IntComponent>(entity, {i});
+    storage.set<FloatComponent>(entity, {static_cast<f32>(i)});
+    if ((i % 2) == 0) {
+      storage.set<StringComponent>(entity, {std::to_string(i)});
+      expected.insert(entity);
+    }
+  }
+
+  std::set<quoll::Entity> actual;
+  for (auto [entity, str, intValue, floatValue] :
+       storage.view<StringComponent, IntComponent, FloatComponent>()) {
+    EXPECT_EQ(str.value, std::to_string(intValue.value));
+    EXPECT_EQ(static_cast<f32>(intValue.value), floatValue.value);
+    actual.insert(entity);
+  }
+
+  EXPECT_EQ(actual, expected);
+}
+
+TEST(EntityStorageSparseSetTest, DuplicatesGroups) {
+  TestEntityStorage<IntComponent, FloatComponent> storage;
+  storage.group<IntComponent, FloatComponent>();
+
+  auto e1 = storage.create();
+  storage.set<IntComponent>(e1, {1});
+  storage.set<FloatComponent>(e1, {1.0f});
+
+  TestEntityStorage<IntComponent, FloatComponent> duplicate;
+  storage.duplicate(duplicate);
+
+  auto e2 = duplicate.create();
+  duplicate.set<IntComponent>(e2, {2});
+  duplicate.set<FloatComponent>(e2, {2.0f});
+
+  expectPackedGroup(storage, {e1});
+  expectPackedGroup(duplicate, {e1, e2});
+}
+
+TEST(EntityStorageSparseSetDeathTest, GroupFailsIfComponentIsAlreadyGrouped) {
+  TestEntityStorage<IntComponent, FloatComponent, StringComponent> storage;
+  storage.group<IntComponent, FloatComponent>();
+
+  auto groupAgain = [&storage]() {
+    storage.group<StringComponent, FloatComponent>();
+  };
+  EXPECT_DEATH({ groupAgain(); }, ".*");
+}
+
+TEST(EntityStorageSparseSetTest, ViewExcludesEntitiesWithComponents) {
+  TestEntityStorage<IntComponent, FloatComponent, StringComponent> storage;
+  storage.group<IntComponent, FloatComponent>();
+
+  std::set<quoll::Entity> expected;
+  for (int i = 0; i < 12; ++i) {
+    auto entity = storage.create();
+    storage.set<IntComponent>(entity, {i});
+    if ((i % 2) == 0) {
+      storage.set<FloatComponent>(entity, {static_cast<f32>(i)});
+    }
+
+    if ((i % 3) == 0) {
+      storage.set<StringComponent>(entity, {std::to_string(i)});
+    }
+
+    if ((i % 2) != 0 && (i % 3) != 0) {
+      expected.insert(entity);
+    }
+  }
+
+  std::set<quoll::Entity> actual;
+  for (auto [entity, intValue] :
+       storage.view<IntComponent>()
+           .exclude<FloatComponent, StringComponent>()) {
+    EXPECT_NE(intValue.value % 2, 0);
+    EXPECT_NE(intValue.value % 3, 0);
+    actual.insert(entity);
+  }
+
+  EXPECT_EQ(actual, expected);
+}
+
+TEST(EntityStorageSparseSetTest, ViewReturnsComponentsChangedSinceVersion) {
+  TestEntityStorage<IntComponent, FloatComponent> storage;
+
+  std::vector<quoll::Entity> entities;
+  for (int i = 0; i < 5; ++i) {
+    auto entity = storage.create();
+    storage.set<IntComponent>(entity, {i});
+    storage.set<FloatComponent>(entity, {static_cast<f32>(i)});
+    entities.push_back(entity);
+  }
+
+  auto version = storage.getComponentVersion<IntComponent>();
+
+  // Nothing is changed
+  {
+    usize count = 0;
+    for (auto [entity, value] :
+         storage.view<IntComponent>().changedSince<IntComponent>(version)) {
+      count++;
+    }
+    EXPECT_EQ(count, 0);
+  }
+
+  auto added = storage.create();
+  storage.set<IntComponent>(added, {10});
+  storage.set<IntComponent>(entities.at(1), {20});
+  storage.set<FloatComponent>(entities.at(3), {30.0f});
+  storage.remove<IntComponent>(entities.at(0));
+
+  std::set<quoll::Entity> actual;
+  for (auto [entity, value] :
+       storage.view<IntComponent>().changedSince<IntComponent>(version)) {
+    actual.insert(entity);
+  }
+
+  EXPECT_EQ(actual, (std::set<quoll::Entity>{added, entities.at(1)}));
+
+  actual.clear();
+  for (auto [entity, intValue, floatValue] :
+       storage.view<IntComponent, FloatComponent>()
+           .changedSince<IntComponent>(version)) {
+    actual.insert(entity);
+  }
+
+  EXPECT_EQ(actual, (std::set<quoll::Entity>{entities.at(1)}));
+}
+
+TEST(EntityStorageSparseSetTest, ViewVisitsEveryChangedEntityOnce) {
+  TestEntityStorage<IntComponent, FloatComponent> storage;
+  storage.group<IntComponent, FloatComponent>();
+
+  std::vector<quoll::Entity> entities;
+  for (int i = 0; i < 100; ++i) {
+    auto entity = storage.create();
+    storage.set<IntComponent>(entity, {i});
+    storage.set<FloatComponent>(entity, {static_cast<f32>(i)});
+    entities.push_back(entity);
+  }
+
+  std::mt19937 random{5};
+  auto version = storage.getComponentVersion<IntComponent>();
+  std::set<quoll::Entity> expected;
+  for (usize step = 1; step <= 2000; ++step) {
+    // Few entities are changed, so that
+    // recorded changes are iterated
+    const auto i = random() % 10;
+    auto entity = entities.at(i);
+
+    switch (random() % 4) {
+    case 0:
+    case 1:
+      storage.set<IntComponent>(entity, {static_cast<int>(step)});
+      expected.insert(entity);
+      break;
+    case 2:
+      if (storage.has<IntComponent>(entity)) {
+        storage.remove<IntComponent>(entity);
+      }
+      expected.erase(entity);
+      break;
+    default:
+      storage.deleteEntity(entity);
+      expected.erase(entity);
+      entities.at(i) = storage.create();
+      storage.set<FloatComponent>(entities.at(i), {0.0f});
+      break;
+    }
+
+    if (step % 100 != 0) {
+      continue;
+    }
+
+    std::vector<quoll::Entity> actual;
+    for (auto [entity, value] :
+         storage.view<IntComponent>().changedSince<IntComponent>(version)) {
+      EXPECT_EQ(value.value, storage.get<IntComponent>(entity).value);
+      actual.push_back(entity);
+    }
+
+    std::vector<quoll::Entity> actualInGroup;
+    for (auto [entity, intValue, floatValue] :
+         storage.view<IntComponent, FloatComponent>()
+             .changedSince<IntComponent>(version)) {
+      actualInGroup.push_back(entity);
+    }
+
+    std::sort(actual.begin(), actual.end());
+    std::sort(actualInGroup.begin(), actualInGroup.end());
+    EXPECT_EQ(actual, std::vector(expected.begin(), expected.end()));
+    EXPECT_EQ(actualInGroup, actual);
+
+    version = storage.getComponentVersion<IntComponent>();
+    expected.clear();
+  }
+}
+
+TEST(EntityStorageSparseSetTest, ReadChangesMovesCursorToCurrentVersion) {
+  TestEntityStorage<IntComponent> storage;
+  quoll::EntityStorageSparseSetChangeCursor cursor;
+
+  auto e1 = storage.create();
+  storage.set<IntComponent>(e1, {1});
+
+  auto since = storage.readChanges<IntComponent>(cursor);
+  EXPECT_EQ(since, 0);
+  EXPECT_EQ(cursor.version, storage.getComponentVersion<IntComponent>());
+
+  usize count = 0;
+  for (auto [entity, value] :
+       storage.view<IntComponent>().changedSince<IntComponent>(since)) {
+    count++;
+  }
+  EXPECT_EQ(count, 1);
+
+  auto e2 = storage.create();
+  storage.set<IntComponent>(e2, {2});
+
+  since = storage.readChanges<IntComponent>(cursor);
+  std::vector<quoll::Entity> actual;
+  for (auto [entity, value] :
+       storage.view<IntComponent>().changedSince<IntComponent>(since)) {
+    actual.push_back(entity);
+  }
+  EXPECT_EQ(actual, std::vector<quoll::Entity>{e2});
+
+  // Cursors of other storages read all components
+  TestEntityStorage<IntComponent> duplicate;
+  storage.duplicate(duplicate);
+
+  EXPECT_EQ(duplicate.readChanges<IntComponent>(cursor), 0);
+}
@@ -0,0 +1,211 @@
+#include "quoll/core/Base.h"
+#include "quoll/profiler/MetricsCollector.h"
+#include "quoll/renderer/FrustumCulling.h"
+#include "quoll/renderer/MeshRenderUtils.h"
+#include "quoll/renderer/RenderStorage.h"
+#include "quoll/renderer/SceneRendererFrameData.h"
+#include "quoll/rhi-mock/MockCommandList.h"
+#include "quoll/rhi-mock/MockRenderDevice.h"
+#include "quoll-tests/Testing.h"
+
+class FrustumCullingTest : public ::testing::Test {
+public:
+  FrustumCullingTest() {
+    // Camera at origin that looks towards -Z
+    auto projection = glm::perspective(glm::radians(90.0f), 1.0f, 0.1f, 100.0f);
+    frustum = quoll::Frustum::fromMatrix(projection);
+  }
+
+  quoll::BoundingBox unitBox{glm::vec3(-0.5f), glm::vec3(0.5f)};
+
+  glm::mat4 at(glm::vec3 position) {
+    return glm::translate(glm::mat4{1.0f}, position);
+  }
+
+  quoll::Frustum frustum;
+};
+
+TEST_F(FrustumCullingTest, CreatesBoundingBoxFromPoints) {
+  std::vector<glm::vec3> points{glm::vec3(1.0f, -2.0f, 3.0f),
+                                glm::vec3(-1.0f, 4.0f, 0.5f),
+                                glm::vec3(0.0f, 0.0f, -5.0f)};
+
+  auto bounds = quoll::BoundingBox::fromPoints(points);
+
+  EXPECT_EQ(bounds.min, glm::vec3(-1.0f, -2.0f, -5.0f));
+  EXPECT_EQ(bounds.max, glm::vec3(1.0f, 4.0f, 3.0f));
+}
+
+TEST_F(FrustumCullingTest, AddsTransformedBounds) {
+  quoll::CullingBounds bounds;
+  bounds.add(unitBox,
+             glm::scale(at(glm::vec3(1.0f, 2.0f, 3.0f)), glm::vec3(2.0f)));
+
+  ASSERT_EQ(bounds.size(), 1);
+  EXPECT_EQ(bounds.centerX.at(0), 1.0f);
+  EXPECT_EQ(bounds.centerY.at(0), 2.0f);
+  EXPECT_EQ(bounds.centerZ.at(0), 3.0f);
+  EXPECT_EQ(bounds.extentX.at(0), 1.0f);
+  EXPECT_EQ(bounds.extentY.at(0), 1.0f);
+  EXPECT_EQ(bounds.extentZ.at(0), 1.0f);
+}
+
+TEST_F(FrustumCullingTest, AddsSkinnedBoundsThatEncloseAllJoints) {
+  std::vector<glm::mat4> joints{at(glm::vec3(-2.0f, 0.0f, 0.0f)),
+                                at(glm::vec3(4.0f, 0.0f, 0.0f))};
+
+  quoll::CullingBounds bounds;
+  bounds.add(unitBox, joints, glm::mat4{1.0f});
+
+  ASSERT_EQ(bounds.size(), 1);
+  EXPECT_EQ(bounds.centerX.at(0), 1.0f);
+  EXPECT_EQ(bounds.extentX.at(0), 3.5f);
+  EXPECT_EQ(bounds.extentY.at(0), 0.5f);
+}
+
+TEST_F(FrustumCullingTest, SetsVisibilityOfBoxesInsideFrustum) {
+  // Odd number of boxes to test partial batches
+  std::vector<glm::vec3> positions{
+      glm::vec3(0.0f, 0.0f, -5.0f),  glm::vec3(0.0f, 0.0f, 5.0f),
+      glm::vec3(50.0f, 0.0f, -5.0f), glm::vec3(4.0f, 0.0f, -5.0f),
+      glm::vec3(5.4f, 0.0f, -5.0f),  glm::vec3(0.0f, 0.0f, -200.0f),
+      glm::vec3(0.0f, -3.0f, -10.0f)};
+
+  std::vector<u32> expected{1, 0, 0, 1, 1, 0, 1};
+
+  quoll::CullingBounds bounds;
+  for (auto position : positions) {
+    bounds.add(unitBox, at(position));
+  }
+
+  std::vector<u32> visibility(bounds.size(), 0xFF);
+  quoll::FrustumCulling::cull(bounds, std::array{frustum}, visibility);
+
+  EXPECT_EQ(visibility, expected);
+}
+
+TEST_F(FrustumCullingTest, SetsVisibilityBitOfEveryFrustum) {
+  // Light volume around X = -10
+  auto shadowProjection = glm::ortho(-1.0f, 1.0f, -1.0f, 1.0f, 0.0f, 20.0f);
+  auto shadowFrustum = quoll::Frustum::fromMatrix(
+      shadowProjection * at(glm::vec3(10.0f, 0.0f, 0.0f)));
+
+  quoll::CullingBounds bounds;
+  bounds.add(unitBox, at(glm::vec3(0.0f, 0.0f, -5.0f)));
+  bounds.add(unitBox, at(glm::vec3(-10.0f, 0.0f, -5.0f)));
+  bounds.add(unitBox, at(glm::vec3(-10.0f, 0.0f, -12.0f)));
+  bounds.add(unitBox, at(glm::vec3(30.0f, 0.0f, 5.0f)));
+
+  std::vector<u32> visibility(bounds.size());
+  quoll::FrustumCulling::cull(bounds, std::array{frustum, shadowFrustum},
+                              visibility);
+
+  EXPECT_EQ(visibility, std::vector<u32>({1, 2, 3, 0}));
+}
+
+class FrustumCullingMockDeviceTest : public FrustumCullingTest {
+public:
+  FrustumCullingMockDeviceTest()
+      : renderStorage(&device, metricsCollector),
+        frameData(renderStorage, 10) {
+    drawData.geometries.push_back({.numVertices = 24,
+                                   .numIndices = 36,
+                                   .bounds = unitBox});
+  }
+
+  std::vector<const quoll::rhi::MockCommandDrawIndexed *>
+  getDrawCalls(const quoll::rhi::RenderCommandList &commandList) {
+    const auto *mockCommandList =
+        static_cast<const quoll::rhi::MockCommandList *>(
+            commandList.getNativeRenderCommandList().get());
+
+    std::vector<const quoll::rhi::MockCommandDrawIndexed *> drawCalls;
+    for (const auto &drawCall : mockCommandList->getDrawCalls()) {
+      if (drawCall.type == quoll::rhi::DrawCallType::DrawIndexed) {
+        drawCalls.push_back(
+            static_cast<const quoll::rhi::MockCommandDrawIndexed *>(
+                drawCall.command));
+      }
+    }
+
+    return drawCalls;
+  }
+
+  quoll::rhi::MockRenderDevice device;
+  quoll::MetricsCollector metricsCollector;
+  quoll::RenderStorage renderStorage;
+  quoll::SceneRendererFrameData frameData;
+
+  quoll::MeshDrawData drawData;
+};
+
+TEST_F(FrustumCullingMockDeviceTest, DoesNotDrawOffScreenInstances) {
+  quoll::AssetHandle<quoll::MeshAsset> handle{1};
+  std::vector<glm::mat4> transforms{
+      at(glm::vec3(0.0f, 0.0f, -5.0f)), at(glm::vec3(1.0f, 0.0f, -5.0f)),
+      at(glm::vec3(0.0f, 0.0f, 50.0f)), at(glm::vec3(0.0f, 1.0f, -5.0f)),
+      at(glm::vec3(0.0f, 0.0f, 20.0f))};
+
+  quoll::CullingBounds bounds;
+  for (const auto &transform : transforms) {
+    bounds.add(drawData.geometries.at(0).bounds, transform);
+  }
+
+  std::vector<u32> visibility(bounds.size());
+  quoll::FrustumCulling::cull(bounds, std::array{frustum}, visibility);
+
+  for (usize i = 0; i < transforms.size(); ++i) {
+    frameData.addMesh(handle, drawData, quoll::Entity{static_cast<u32>(i)},
+                      transforms.at(i), {},
+                      std::span(visibility).subspan(i, 1));
+  }
+
+  const auto &meshData = frameData.getMeshGroups().at(0);
+  ASSERT_EQ(meshData.visibility.size(), transforms.size());
+
+  quoll::rhi::RenderCommandList commandList(new quoll::rhi::MockCommandList);
+  quoll::MeshRenderUtils::drawVisibleInstances(
+      commandList, &drawData, 0, 0, 0, 0, meshData.visibility,
+      quoll::SceneRendererFrameData::CameraViewBit);
+
+  auto drawCalls = getDrawCalls(commandList);
+  ASSERT_EQ(drawCalls.size(), 2);
+
+  EXPECT_EQ(drawCalls.at(0)->indexCount, 36);
+  EXPECT_EQ(drawCalls.at(0)->firstInstance, 0);
+  EXPECT_EQ(drawCalls.at(0)->instanceCount, 2);
+
+  EXPECT_EQ(drawCalls.at(1)->indexCount, 36);
+  EXPECT_EQ(drawCalls.at(1)->firstInstance, 3);
+  EXPECT_EQ(drawCalls.at(1)->instanceCount, 1);
+}
+
+TEST_F(FrustumCullingMockDeviceTest, DrawsInstancesVisibleInShadowMap) {
+  quoll::AssetHandle<quoll::MeshAsset> handle{1};
+
+  const u32 shadowBit = quoll::SceneRendererFrameData::getShadowMapViewBit(0);
+  std::vector<u32> visibility{quoll::SceneRendererFrameData::CameraViewBit,
+                              shadowBit, 0,
+                              quoll::SceneRendererFrameData::CameraViewBit |
+                                  shadowBit};
+
+  for (usize i = 0; i < visibility.size(); ++i) {
+    frameData.addMesh(handle, drawData, quoll::Entity{static_cast<u32>(i)},
+                      glm::mat4{1.0f}, {},
+                      std::span(visibility).subspan(i, 1));
+  }
+
+  const auto &meshData = frameData.getMeshGroups().at(0);
+
+  quoll::rhi::RenderCommandList commandList(new quoll::rhi::MockCommandList);
+  quoll::MeshRenderUtils::drawVisibleInstances(commandList, &drawData, 0, 0, 0,
+                                               10, meshData.visibility,
+                                               shadowBit);
+
+  auto drawCalls = getDrawCalls(commandList);
+  ASSERT_EQ(drawCalls.size(), 2);
+  EXPECT_EQ(drawCalls.at(0)->firstInstance, 11);
+  EXPECT_EQ(drawCalls.at(0)->instanceCount, 1);
+  EXPECT_EQ(drawCalls.at(1)->firstInstance, 13);
+  EXPECT_EQ(drawCalls.at(1)->instanceCount, 1);
+}
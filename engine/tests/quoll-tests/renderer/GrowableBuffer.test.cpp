@@ -0,0 +1,139 @@
+#include "quoll/core/Base.h"
+#include "quoll/profiler/MetricsCollector.h"
+#include "quoll/renderer/GrowableBuffer.h"
+#include "quoll/renderer/RenderStorage.h"
+#include "quoll/rhi-mock/MockRenderDevice.h"
+#include "quoll-tests/Testing.h"
+
+class GrowableBufferTest : public ::testing::Test {
+public:
+  GrowableBufferTest() : renderStorage(&device, metricsCollector) {
+    description.usage = quoll::rhi::BufferUsage::Storage;
+    description.mapped = true;
+  }
+
+  quoll::GrowableBuffer createBuffer(usize initialCapacity,
+                                     bool shrink = true) {
+    return quoll::GrowableBuffer(renderStorage, description, sizeof(u32),
+                                 initialCapacity, shrink);
+  }
+
+  void fill(quoll::GrowableBuffer &buffer, usize size) {
+    auto *data = static_cast<u32 *>(buffer.map());
+    for (usize i = 0; i < size; ++i) {
+      data[i] = static_cast<u32>(i);
+    }
+    buffer.unmap();
+  }
+
+  quoll::rhi::MockRenderDevice device;
+  quoll::MetricsCollector metricsCollector;
+  quoll::RenderStorage renderStorage;
+  quoll::rhi::BufferDescription description;
+};
+
+TEST_F(GrowableBufferTest, CreatesBufferWithInitialCapacity) {
+  auto buffer = createBuffer(16);
+
+  EXPECT_EQ(buffer.getCapacity(), 16);
+  EXPECT_EQ(device.getBuffer(buffer.getHandle())->getDescription().size,
+            16 * sizeof(u32));
+}
+
+TEST_F(GrowableBufferTest, DoesNotRecreateBufferIfItemsFit) {
+  auto buffer = createBuffer(16);
+  auto handle = buffer.getHandle();
+
+  EXPECT_FALSE(buffer.reserve(16));
+  EXPECT_EQ(buffer.getHandle(), handle);
+  EXPECT_EQ(buffer.getCapacity(), 16);
+  EXPECT_EQ(buffer.getNumRetired(), 0);
+}
+
+TEST_F(GrowableBufferTest, DoublesCapacityIfItemsDoNotFit) {
+  auto buffer = createBuffer(16);
+  auto handle = buffer.getHandle();
+  auto address = buffer.getAddress();
+
+  EXPECT_TRUE(buffer.reserve(17));
+  EXPECT_NE(buffer.getHandle(), handle);
+  EXPECT_NE(buffer.getAddress(), address);
+  EXPECT_EQ(buffer.getCapacity(), 32);
+  EXPECT_EQ(device.getBuffer(buffer.getHandle())->getDescription().size,
+            32 * sizeof(u32));
+}
+
+TEST_F(GrowableBufferTest, GrowsToReservedSizeIfItIsLargerThanDoubleCapacity) {
+  auto buffer = createBuffer(16);
+
+  EXPECT_TRUE(buffer.reserve(100));
+  EXPECT_EQ(buffer.getCapacity(), 100);
+}
+
+TEST_F(GrowableBufferTest, CopiesContentsToRecreatedBuffer) {
+  auto buffer = createBuffer(16);
+  fill(buffer, 16);
+
+  buffer.reserve(40);
+
+  auto *data = static_cast<u32 *>(buffer.map());
+  for (u32 i = 0; i < 16; ++i) {
+    EXPECT_EQ(data[i], i);
+  }
+  buffer.unmap();
+}
+
+TEST_F(GrowableBufferTest, KeepsReplacedBuffersUntilGarbageIsCollected) {
+  auto buffer = createBuffer(16);
+  auto first = buffer.getHandle();
+  buffer.reserve(40);
+  auto second = buffer.getHandle();
+  buffer.reserve(100);
+
+  EXPECT_EQ(buffer.getNumRetired(), 2);
+  EXPECT_NE(device.getBuffer(first), nullptr);
+  EXPECT_NE(device.getBuffer(second), nullptr);
+
+  buffer.collectGarbage();
+  EXPECT_EQ(buffer.getNumRetired(), 0);
+  EXPECT_THROW(device.getBuffer(first), std::out_of_range);
+  EXPECT_THROW(device.getBuffer(second), std::out_of_range);
+  EXPECT_NE(device.getBuffer(buffer.getHandle()), nullptr);
+}
+
+TEST_F(GrowableBufferTest, ShrinksIfLessThanQuarterOfCapacityIsUsed) {
+  auto buffer = createBuffer(16);
+  fill(buffer, 16);
+  buffer.reserve(200);
+
+  EXPECT_FALSE(buffer.reserve(50));
+  EXPECT_EQ(buffer.getCapacity(), 200);
+
+  EXPECT_TRUE(buffer.reserve(40));
+  EXPECT_EQ(buffer.getCapacity(), 80);
+
+  auto *data = static_cast<u32 *>(buffer.map());
+  for (u32 i = 0; i < 16; ++i) {
+    EXPECT_EQ(data[i], i);
+  }
+  buffer.unmap();
+}
+
+TEST_F(GrowableBufferTest, DoesNotShrinkBelowInitialCapacity) {
+  auto buffer = createBuffer(16);
+  buffer.reserve(200);
+
+  EXPECT_TRUE(buffer.reserve(0));
+  EXPECT_EQ(buffer.getCapacity(), 16);
+
+  EXPECT_FALSE(buffer.reserve(0));
+  EXPECT_EQ(buffer.getCapacity(), 16);
+}
+
+TEST_F(GrowableBufferTest, DoesNotShrinkIfShrinkingIsDisabled) {
+  auto buffer = createBuffer(16, false);
+  buffer.reserve(200);
+
+  EXPECT_FALSE(buffer.reserve(0));
+  EXPECT_EQ(buffer.getCapacity(), 200);
+}
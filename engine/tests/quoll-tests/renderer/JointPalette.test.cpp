@@ -0,0 +1,140 @@
+#include "quoll/core/Base.h"
+#include "quoll/renderer/JointPalette.h"
+#include "quoll-tests/Testing.h"
+
+class JointPaletteTest : public ::testing::Test {
+public:
+  JointPaletteTest() { target.resize(200); }
+
+  std::vector<glm::mat4> createJoints(usize count, f32 start = 0.0f) {
+    std::vector<glm::mat4> joints;
+    for (usize i = 0; i < count; ++i) {
+      joints.push_back(at(start + static_cast<f32>(i)));
+    }
+    return joints;
+  }
+
+  glm::mat4 at(f32 x) {
+    return glm::translate(glm::mat4{1.0f}, glm::vec3(x, 0.0f, 0.0f));
+  }
+
+  quoll::JointPalette palette;
+  std::vector<glm::mat4> target;
+};
+
+TEST_F(JointPaletteTest, PacksJointsOfSkeletonsWithExactCounts) {
+  auto small = createJoints(3);
+  auto large = createJoints(70, 10.0f);
+
+  palette.begin();
+  auto first = palette.set(quoll::Entity{1}, small);
+  auto second = palette.set(quoll::Entity{2}, large);
+  palette.end();
+
+  EXPECT_EQ(first.offset, 0);
+  EXPECT_EQ(first.count, 3);
+  EXPECT_EQ(second.offset, 3);
+  EXPECT_EQ(second.count, 70);
+  EXPECT_EQ(palette.getCapacity(), 73);
+
+  EXPECT_EQ(palette.upload(target.data()), 73 * sizeof(glm::mat4));
+  EXPECT_EQ(target.at(2), at(2.0f));
+  EXPECT_EQ(target.at(3 + 69), at(79.0f));
+}
+
+TEST_F(JointPaletteTest, SharesRangeOfSkeletonThatIsSetMultipleTimes) {
+  auto joints = createJoints(4);
+
+  palette.begin();
+  auto first = palette.set(quoll::Entity{1}, joints);
+  auto second = palette.set(quoll::Entity{1}, joints);
+  palette.end();
+
+  EXPECT_EQ(first, second);
+  EXPECT_EQ(palette.size(), 1);
+  EXPECT_EQ(palette.getCapacity(), 4);
+  EXPECT_EQ(palette.upload(target.data()), 4 * sizeof(glm::mat4));
+}
+
+TEST_F(JointPaletteTest, UploadsOnlyChangedSkeletons) {
+  auto a = createJoints(4);
+  auto b = createJoints(4, 10.0f);
+
+  palette.begin();
+  palette.set(quoll::Entity{1}, a);
+  auto range = palette.set(quoll::Entity{2}, b);
+  palette.end();
+  palette.upload(target.data());
+
+  b.at(1) = at(50.0f);
+  palette.begin();
+  palette.set(quoll::Entity{1}, a);
+  EXPECT_EQ(palette.set(quoll::Entity{2}, b), range);
+  palette.end();
+
+  EXPECT_EQ(palette.upload(target.data()), 4 * sizeof(glm::mat4));
+  EXPECT_EQ(target.at(range.offset + 1), at(50.0f));
+}
+
+TEST_F(JointPaletteTest, RemovesSkeletonsThatAreNotSetOrKept) {
+  palette.begin();
+  palette.set(quoll::Entity{1}, createJoints(4));
+  palette.set(quoll::Entity{2}, createJoints(4));
+  palette.set(quoll::Entity{3}, createJoints(4));
+  palette.end();
+
+  palette.begin();
+  EXPECT_TRUE(palette.keep(quoll::Entity{1}));
+  palette.set(quoll::Entity{2}, createJoints(4));
+  EXPECT_FALSE(palette.keep(quoll::Entity{10}));
+  palette.end();
+
+  EXPECT_TRUE(palette.contains(quoll::Entity{1}));
+  EXPECT_TRUE(palette.contains(quoll::Entity{2}));
+  EXPECT_FALSE(palette.contains(quoll::Entity{3}));
+  EXPECT_EQ(palette.size(), 2);
+
+  // Freed range at the end shrinks the palette
+  EXPECT_EQ(palette.getCapacity(), 8);
+}
+
+TEST_F(JointPaletteTest, ReusesFreedRangesForNewSkeletons) {
+  palette.begin();
+  palette.set(quoll::Entity{1}, createJoints(4));
+  palette.set(quoll::Entity{2}, createJoints(6));
+  palette.set(quoll::Entity{3}, createJoints(4));
+  palette.end();
+
+  palette.begin();
+  palette.keep(quoll::Entity{1});
+  palette.keep(quoll::Entity{3});
+  palette.end();
+
+  palette.begin();
+  palette.keep(quoll::Entity{1});
+  palette.keep(quoll::Entity{3});
+  auto range = palette.set(quoll::Entity{4}, createJoints(5));
+  palette.end();
+
+  EXPECT_EQ(range.offset, 4);
+  EXPECT_EQ(range.count, 5);
+  EXPECT_EQ(palette.getCapacity(), 14);
+}
+
+TEST_F(JointPaletteTest, MovesSkeletonWhenNumberOfJointsChanges) {
+  palette.begin();
+  palette.set(quoll::Entity{1}, createJoints(4));
+  palette.set(quoll::Entity{2}, createJoints(4));
+  palette.end();
+
+  palette.begin();
+  auto range = palette.set(quoll::Entity{1}, createJoints(8, 20.0f));
+  palette.keep(quoll::Entity{2});
+  palette.end();
+
+  EXPECT_EQ(range.count, 8);
+  EXPECT_EQ(palette.getRange(quoll::Entity{1}), range);
+
+  palette.upload(target.data());
+  EXPECT_EQ(target.at(range.offset + 7), at(27.0f));
+}
@@ -0,0 +1,325 @@
+#include "quoll/core/Base.h"
+#include "quoll/renderer/MeshInstanceTable.h"
+#include "quoll-tests/Testing.h"
+
+class MeshInstanceTableTest : public ::testing::Test {
+public:
+  MeshInstanceTableTest() {
+    drawData.geometries.resize(2);
+
+    transforms.resize(100);
+    materialRanges.resize(100);
+    materials.resize(400);
+    jointRanges.resize(100);
+  }
+
+  glm::mat4 at(f32 x) {
+    return glm::translate(glm::mat4{1.0f}, glm::vec3(x, 0.0f, 0.0f));
+  }
+
+  void set(quoll::MeshInstanceTable &table, quoll::Entity entity,
+           quoll::AssetHandle<quoll::MeshAsset> handle,
+           const glm::mat4 &transform,
+           std::vector<quoll::rhi::DeviceAddress> instanceMaterials = {},
+           quoll::JointRange joints = {}) {
+    table.set(entity, handle, drawData, transform, instanceMaterials, joints,
+              visibility);
+  }
+
+  usize upload(quoll::MeshInstanceTable &table) {
+    return table.upload({transforms.data(), materialRanges.data(),
+                         materials.data(), jointRanges.data()});
+  }
+
+  quoll::MeshDrawData drawData;
+  std::vector<u32> visibility{1, 1};
+
+  std::vector<glm::mat4> transforms;
+  std::vector<quoll::MeshInstanceTable::MaterialRange> materialRanges;
+  std::vector<quoll::rhi::DeviceAddress> materials;
+  std::vector<quoll::JointRange> jointRanges;
+
+  quoll::AssetHandle<quoll::MeshAsset> meshA{1};
+  quoll::AssetHandle<quoll::MeshAsset> meshB{2};
+};
+
+TEST_F(MeshInstanceTableTest, StoresGroupsSortedByMeshHandle) {
+  quoll::MeshInstanceTable table;
+
+  table.begin();
+  set(table, quoll::Entity{1}, meshB, at(1.0f));
+  set(table, quoll::Entity{2}, meshA, at(2.0f));
+  set(table, quoll::Entity{3}, meshB, at(3.0f));
+  table.end();
+
+  const auto &groups = table.getGroups();
+  ASSERT_EQ(groups.size(), 2);
+  EXPECT_EQ(groups.at(0).handle, meshA);
+  EXPECT_EQ(groups.at(0).entities,
+            std::vector<quoll::Entity>{quoll::Entity{2}});
+  EXPECT_EQ(groups.at(1).handle, meshB);
+  EXPECT_EQ(groups.at(1).entities,
+            std::vector<quoll::Entity>({quoll::Entity{1}, quoll::Entity{3}}));
+
+  // Groups do not overlap
+  EXPECT_LE(groups.at(0).firstSlot + groups.at(0).capacity,
+            groups.at(1).firstSlot);
+  EXPECT_EQ(groups.at(1).visibility.size(), 4);
+
+  EXPECT_EQ(table.size(), 3);
+  EXPECT_EQ(table.getTransforms().at(table.getSlot(quoll::Entity{3})),
+            at(3.0f));
+}
+
+TEST_F(MeshInstanceTableTest, UploadsOnlyChangedInstances) {
+  quoll::MeshInstanceTable table;
+
+  table.begin();
+  for (u32 i = 1; i <= 3; ++i) {
+    set(table, quoll::Entity{i}, meshA, at(static_cast<f32>(i)));
+  }
+  table.end();
+
+  EXPECT_EQ(table.getNumChanged(), 3);
+  const usize instanceSize = sizeof(glm::mat4) +
+                             sizeof(quoll::MeshInstanceTable::MaterialRange) +
+                             sizeof(quoll::JointRange);
+  EXPECT_EQ(upload(table), 3 * instanceSize);
+  EXPECT_EQ(table.getNumChanged(), 0);
+
+  const u32 slot = table.getSlot(quoll::Entity{2});
+
+  table.begin();
+  for (u32 i = 1; i <= 3; ++i) {
+    set(table, quoll::Entity{i}, meshA,
+        at(static_cast<f32>(i == 2 ? 20 : i)));
+  }
+  table.end();
+
+  EXPECT_EQ(table.getSlot(quoll::Entity{2}), slot);
+  EXPECT_EQ(table.getNumChanged(), 1);
+  EXPECT_EQ(upload(table), sizeof(glm::mat4));
+  EXPECT_EQ(transforms.at(slot), at(20.0f));
+
+  // Nothing is changed
+  table.begin();
+  for (u32 i = 1; i <= 3; ++i) {
+    set(table, quoll::Entity{i}, meshA,
+        at(static_cast<f32>(i == 2 ? 20 : i)));
+  }
+  table.end();
+  EXPECT_EQ(upload(table), 0);
+}
+
+TEST_F(MeshInstanceTableTest, UploadsChangedMaterials) {
+  quoll::MeshInstanceTable table;
+  table.setMaterialBase(1);
+
+  std::vector<quoll::rhi::DeviceAddress> instanceMaterials{
+      quoll::rhi::DeviceAddress{10}, quoll::rhi::DeviceAddress{20}};
+
+  table.begin();
+  set(table, quoll::Entity{1}, meshA, at(0.0f), instanceMaterials);
+  table.end();
+  upload(table);
+
+  const u32 slot = table.getSlot(quoll::Entity{1});
+  auto range = materialRanges.at(slot);
+  EXPECT_EQ(range.end - range.start, 1);
+  EXPECT_GE(range.start, 1);
+  EXPECT_EQ(materials.at(range.start - 1), quoll::rhi::DeviceAddress{10});
+  EXPECT_EQ(materials.at(range.end - 1), quoll::rhi::DeviceAddress{20});
+
+  instanceMaterials.at(1) = quoll::rhi::DeviceAddress{30};
+  table.begin();
+  set(table, quoll::Entity{1}, meshA, at(0.0f), instanceMaterials);
+  table.end();
+
+  EXPECT_GT(upload(table), 0);
+  EXPECT_EQ(materials.at(range.end - 1), quoll::rhi::DeviceAddress{30});
+
+  // Material ranges move with base
+  table.setMaterialBase(5);
+  EXPECT_EQ(table.getNumChanged(), 1);
+  upload(table);
+  EXPECT_EQ(materialRanges.at(slot).start, range.start + 4);
+}
+
+TEST_F(MeshInstanceTableTest, InstancesWithoutMaterialsUseDefaultMaterial) {
+  quoll::MeshInstanceTable table;
+  table.setMaterialBase(1);
+
+  table.begin();
+  set(table, quoll::Entity{1}, meshA, at(0.0f));
+  table.end();
+  upload(table);
+
+  const auto &range = materialRanges.at(table.getSlot(quoll::Entity{1}));
+  EXPECT_EQ(range.start, 0);
+  EXPECT_EQ(range.end, 0);
+}
+
+TEST_F(MeshInstanceTableTest, RemovesInstancesThatAreNotSetOrKept) {
+  quoll::MeshInstanceTable table;
+
+  table.begin();
+  for (u32 i = 1; i <= 4; ++i) {
+    set(table, quoll::Entity{i}, meshA, at(static_cast<f32>(i)));
+  }
+  table.end();
+  upload(table);
+
+  const u32 removedSlot = table.getSlot(quoll::Entity{2});
+
+  table.begin();
+  set(table, quoll::Entity{1}, meshA, at(1.0f));
+  EXPECT_TRUE(table.keep(quoll::Entity{3}));
+  set(table, quoll::Entity{4}, meshA, at(4.0f));
+  EXPECT_FALSE(table.keep(quoll::Entity{10}));
+  table.end();
+
+  EXPECT_FALSE(table.contains(quoll::Entity{2}));
+  EXPECT_TRUE(table.contains(quoll::Entity{3}));
+  EXPECT_EQ(table.size(), 3);
+
+  // Last instance is moved to the removed slot
+  EXPECT_EQ(table.getSlot(quoll::Entity{4}), removedSlot);
+  EXPECT_EQ(table.getNumChanged(), 1);
+  upload(table);
+  EXPECT_EQ(transforms.at(removedSlot), at(4.0f));
+
+  // Kept instances are not visible
+  const auto &group = table.getGroups().at(0);
+  EXPECT_EQ(group.visibility, std::vector<u32>({1, 1, 1, 1, 0, 0}));
+
+  // Empty groups are removed
+  table.begin();
+  table.end();
+  EXPECT_EQ(table.size(), 0);
+  EXPECT_TRUE(table.getGroups().empty());
+}
+
+TEST_F(MeshInstanceTableTest, MovesInstanceToNewGroupWhenMeshChanges) {
+  quoll::MeshInstanceTable table;
+
+  table.begin();
+  set(table, quoll::Entity{1}, meshA, at(1.0f));
+  table.end();
+  upload(table);
+
+  table.begin();
+  set(table, quoll::Entity{1}, meshB, at(1.0f));
+  table.end();
+
+  ASSERT_EQ(table.getGroups().size(), 1);
+  EXPECT_EQ(table.getGroups().at(0).handle, meshB);
+  EXPECT_EQ(table.getNumChanged(), 1);
+
+  upload(table);
+  EXPECT_EQ(transforms.at(table.getSlot(quoll::Entity{1})), at(1.0f));
+}
+
+TEST_F(MeshInstanceTableTest, KeepsDataWhenGroupsAreLaidOutAgain) {
+  quoll::MeshInstanceTable table;
+
+  table.begin();
+  for (u32 i = 1; i <= 30; ++i) {
+    set(table, quoll::Entity{i}, i % 2 == 0 ? meshA : meshB,
+        at(static_cast<f32>(i)),
+        {quoll::rhi::DeviceAddress{static_cast<u64>(i)}});
+  }
+  table.end();
+  upload(table);
+
+  for (u32 i = 1; i <= 30; ++i) {
+    const u32 slot = table.getSlot(quoll::Entity{i});
+    EXPECT_EQ(transforms.at(slot), at(static_cast<f32>(i)));
+    EXPECT_EQ(materials.at(materialRanges.at(slot).start),
+              quoll::rhi::DeviceAddress{static_cast<u64>(i)});
+  }
+}
+
+TEST_F(MeshInstanceTableTest, UploadsJointRangesOfSkinnedInstances) {
+  quoll::MeshInstanceTable table;
+
+  const quoll::JointRange first{4, 40};
+  const quoll::JointRange second{60, 40};
+
+  table.begin();
+  set(table, quoll::Entity{1}, meshA, at(0.0f), {}, first);
+  table.end();
+  upload(table);
+
+  const u32 slot = table.getSlot(quoll::Entity{1});
+  EXPECT_EQ(jointRanges.at(slot), first);
+
+  table.begin();
+  set(table, quoll::Entity{1}, meshA, at(0.0f), {}, first);
+  table.end();
+  EXPECT_EQ(table.getNumChanged(), 0);
+
+  table.begin();
+  set(table, quoll::Entity{1}, meshA, at(0.0f), {}, second);
+  table.end();
+
+  EXPECT_EQ(upload(table), sizeof(quoll::JointRange));
+  EXPECT_EQ(jointRanges.at(slot), second);
+}
+
+TEST_F(MeshInstanceTableTest, CompactsSlotsWhenMostInstancesAreRemoved) {
+  quoll::MeshInstanceTable table;
+
+  table.begin();
+  for (u32 i = 1; i <= 100; ++i) {
+    set(table, quoll::Entity{i}, meshA, at(static_cast<f32>(i)));
+  }
+  table.end();
+  upload(table);
+  EXPECT_GE(table.getCapacity(), 100);
+
+  table.begin();
+  for (u32 i = 1; i <= 10; ++i) {
+    set(table, quoll::Entity{i}, meshA, at(static_cast<f32>(i)));
+  }
+  table.end();
+
+  EXPECT_EQ(table.size(), 10);
+  EXPECT_LT(table.getCapacity(), 40);
+
+  // Compacted instances are uploaded again
+  EXPECT_EQ(table.getNumChanged(), 10);
+  upload(table);
+  for (u32 i = 1; i <= 10; ++i) {
+    EXPECT_EQ(transforms.at(table.getSlot(quoll::Entity{i})),
+              at(static_cast<f32>(i)));
+  }
+}
+
+TEST_F(MeshInstanceTableTest, RemovesInstancesOfRecycledEntities) {
+  quoll::MeshInstanceTable table;
+
+  std::vector<quoll::Entity> entities;
+  for (u32 i = 0; i < 3; ++i) {
+    entities.push_back(quoll::makeEntity(i, 1));
+  }
+
+  table.begin();
+  for (u32 i = 0; i < 3; ++i) {
+    set(table, entities.at(i), meshA, at(static_cast<f32>(i)));
+  }
+  table.end();
+
+  const u32 removedSlot = table.getSlot(entities.at(0));
+
+  table.begin();
+  EXPECT_TRUE(table.keep(entities.at(1)));
+  EXPECT_TRUE(table.keep(entities.at(2)));
+  table.end();
+
+  EXPECT_FALSE(table.contains(entities.at(0)));
+  EXPECT_EQ(table.size(), 2);
+
+  // Last instance is moved to the removed slot
+  EXPECT_EQ(table.getSlot(entities.at(2)), removedSlot);
+  EXPECT_EQ(table.getTransforms().at(removedSlot), at(2.0f));
+}
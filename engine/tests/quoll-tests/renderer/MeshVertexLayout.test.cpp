@@ -0,0 +1,195 @@
+#include "quoll/core/Base.h"
+#include "quoll/renderer/MeshAsset.h"
+#include "quoll/renderer/MeshVertexLayout.h"
+#include "quoll-tests/Testing.h"
+
+class MeshVertexLayoutTest : public ::testing::Test {
+public:
+  static constexpr f32 Epsilon = 0.001f;
+
+  quoll::BaseGeometryAsset createGeometry() {
+    quoll::BaseGeometryAsset geometry{};
+    geometry.positions = {{1.0f, 2.0f, 3.0f}};
+    geometry.normals = {glm::normalize(glm::vec3(-1.0f, 2.0f, -3.0f))};
+    geometry.tangents = {glm::vec4(0.0f, 0.0f, -1.0f, -1.0f)};
+    geometry.texCoords0 = {{0.25f, 0.5f}};
+    geometry.texCoords1 = {{1.5f, -0.75f}};
+    geometry.joints = {{1, 300, 2, 65535}};
+    geometry.weights = {{0.5f, 0.25f, 0.25f, 0.0f}};
+    return geometry;
+  }
+
+  template <class TValue> TValue read(const u8 *&data) {
+    TValue value{};
+    memcpy(&value, data, sizeof(TValue));
+    data += sizeof(TValue);
+    return value;
+  }
+
+  glm::vec2 readSnorm(const u8 *&data) {
+    const f32 x = glm::unpackSnorm1x16(read<u16>(data));
+    const f32 y = glm::unpackSnorm1x16(read<u16>(data));
+    return glm::vec2(x, y);
+  }
+};
+
+TEST_F(MeshVertexLayoutTest, EncodesAndDecodesOctahedralVectors) {
+  std::vector<glm::vec3> vectors{
+      {0.0f, 0.0f, 1.0f},  {0.0f, 0.0f, -1.0f}, {1.0f, 0.0f, 0.0f},
+      {0.0f, -1.0f, 0.0f}, {-1.0f, 2.0f, -3.0f}, {3.0f, -2.0f, 1.0f}};
+
+  for (auto vector : vectors) {
+    vector = glm::normalize(vector);
+
+    auto encoded = quoll::encodeOctahedral(vector);
+    EXPECT_LE(std::abs(encoded.x), 1.0f);
+    EXPECT_LE(std::abs(encoded.y), 1.0f);
+
+    auto decoded = quoll::decodeOctahedral(encoded);
+    EXPECT_NEAR(decoded.x, vector.x, Epsilon);
+    EXPECT_NEAR(decoded.y, vector.y, Epsilon);
+    EXPECT_NEAR(decoded.z, vector.z, Epsilon);
+  }
+}
+
+TEST_F(MeshVertexLayoutTest, StoresBitangentSignInEncodedTangent) {
+  for (f32 sign : {1.0f, -1.0f}) {
+    glm::vec4 tangent(glm::normalize(glm::vec3(1.0f, -1.0f, -0.5f)), sign);
+
+    auto encoded = quoll::encodeOctahedralTangent(tangent);
+    auto decoded = quoll::decodeOctahedralTangent(encoded);
+
+    EXPECT_NEAR(decoded.x, tangent.x, Epsilon);
+    EXPECT_NEAR(decoded.y, tangent.y, Epsilon);
+    EXPECT_NEAR(decoded.z, tangent.z, Epsilon);
+    EXPECT_EQ(decoded.w, sign);
+  }
+}
+
+TEST_F(MeshVertexLayoutTest,
+       ChoosesHalfTexCoordsIfAllTexCoordsAreWithinHalfRange) {
+  quoll::MeshAsset mesh{};
+  mesh.geometries.push_back(createGeometry());
+
+  EXPECT_EQ(quoll::MeshVertexLayout::choose(mesh).texCoordFormat,
+            quoll::rhi::Format::Rg16Float);
+
+  mesh.geometries.push_back(createGeometry());
+  mesh.geometries.back().texCoords1.at(0).y = 4.0f;
+
+  EXPECT_EQ(quoll::MeshVertexLayout::choose(mesh).texCoordFormat,
+            quoll::rhi::Format::Rg32Float);
+}
+
+TEST_F(MeshVertexLayoutTest, VariantsMapToLayouts) {
+  for (usize i = 0; i < quoll::MeshVertexLayout::NumVariants; ++i) {
+    EXPECT_EQ(quoll::MeshVertexLayout::fromVariant(i).getVariant(), i);
+  }
+}
+
+TEST_F(MeshVertexLayoutTest, WritesQuantizedInterleavedAttributes) {
+  auto geometry = createGeometry();
+  quoll::MeshVertexLayout layout{.texCoordFormat =
+                                     quoll::rhi::Format::Rg16Float};
+  EXPECT_EQ(layout.getAttributeStride(), 16);
+
+  std::vector<u8> data(layout.getAttributeStride());
+  layout.writeAttributes(geometry, data.data());
+
+  const u8 *ptr = data.data();
+  auto normal = readSnorm(ptr);
+  auto tangent = readSnorm(ptr);
+
+  auto decodedNormal = quoll::decodeOctahedral(normal);
+  EXPECT_NEAR(decodedNormal.x, geometry.normals.at(0).x, Epsilon);
+  EXPECT_NEAR(decodedNormal.y, geometry.normals.at(0).y, Epsilon);
+  EXPECT_NEAR(decodedNormal.z, geometry.normals.at(0).z, Epsilon);
+
+  auto decodedTangent = quoll::decodeOctahedralTangent(tangent);
+  EXPECT_NEAR(decodedTangent.z, -1.0f, Epsilon);
+  EXPECT_EQ(decodedTangent.w, -1.0f);
+
+  EXPECT_EQ(glm::unpackHalf1x16(read<u16>(ptr)), 0.25f);
+  EXPECT_EQ(glm::unpackHalf1x16(read<u16>(ptr)), 0.5f);
+  EXPECT_EQ(glm::unpackHalf1x16(read<u16>(ptr)), 1.5f);
+  EXPECT_EQ(glm::unpackHalf1x16(read<u16>(ptr)), -0.75f);
+  EXPECT_EQ(ptr, data.data() + data.size());
+}
+
+TEST_F(MeshVertexLayoutTest, WritesFullPrecisionTexCoords) {
+  auto geometry = createGeometry();
+  quoll::MeshVertexLayout layout{.texCoordFormat =
+                                     quoll::rhi::Format::Rg32Float};
+  EXPECT_EQ(layout.getAttributeStride(), 24);
+
+  std::vector<u8> data(layout.getAttributeStride());
+  layout.writeAttributes(geometry, data.data());
+
+  const u8 *ptr = data.data() + 4 * sizeof(u16);
+  EXPECT_EQ(read<f32>(ptr), 0.25f);
+  EXPECT_EQ(read<f32>(ptr), 0.5f);
+  EXPECT_EQ(read<f32>(ptr), 1.5f);
+  EXPECT_EQ(read<f32>(ptr), -0.75f);
+}
+
+TEST_F(MeshVertexLayoutTest, FillsMissingAttributesWithDefaults) {
+  quoll::BaseGeometryAsset geometry{};
+  geometry.positions = {{0.0f, 0.0f, 0.0f}};
+
+  quoll::MeshVertexLayout layout{};
+  std::vector<u8> data(layout.getAttributeStride());
+  layout.writeAttributes(geometry, data.data());
+
+  const u8 *ptr = data.data();
+  auto normal = readSnorm(ptr);
+  auto decodedNormal = quoll::decodeOctahedral(normal);
+  EXPECT_NEAR(decodedNormal.z, 1.0f, Epsilon);
+
+  auto tangent = readSnorm(ptr);
+  auto decodedTangent = quoll::decodeOctahedralTangent(tangent);
+  EXPECT_NEAR(decodedTangent.x, 1.0f, Epsilon);
+  EXPECT_EQ(decodedTangent.w, 1.0f);
+}
+
+TEST_F(MeshVertexLayoutTest, WritesInterleavedJointsAndWeights) {
+  auto geometry = createGeometry();
+
+  std::vector<u8> data(quoll::MeshVertexLayout::SkinStride);
+  quoll::MeshVertexLayout::writeSkin(geometry, data.data());
+
+  const u8 *ptr = data.data();
+  EXPECT_EQ(read<u16>(ptr), 1);
+  EXPECT_EQ(read<u16>(ptr), 300);
+  EXPECT_EQ(read<u16>(ptr), 2);
+  EXPECT_EQ(read<u16>(ptr), 65535);
+
+  EXPECT_NEAR(glm::unpackUnorm1x16(read<u16>(ptr)), 0.5f, Epsilon);
+  EXPECT_NEAR(glm::unpackUnorm1x16(read<u16>(ptr)), 0.25f, Epsilon);
+  EXPECT_NEAR(glm::unpackUnorm1x16(read<u16>(ptr)), 0.25f, Epsilon);
+  EXPECT_EQ(glm::unpackUnorm1x16(read<u16>(ptr)), 0.0f);
+}
+
+TEST_F(MeshVertexLayoutTest, SkinnedVertexLayoutHasThreeStreams) {
+  quoll::MeshVertexLayout meshLayout{.texCoordFormat =
+                                         quoll::rhi::Format::Rg16Float};
+  auto layout = quoll::createSkinnedMeshVertexLayout(meshLayout);
+
+  ASSERT_EQ(layout.bindings.size(), 3);
+  EXPECT_EQ(layout.bindings.at(0).stride,
+            quoll::MeshVertexLayout::PositionStride);
+  EXPECT_EQ(layout.bindings.at(1).stride, meshLayout.getAttributeStride());
+  EXPECT_EQ(layout.bindings.at(2).stride,
+            quoll::MeshVertexLayout::SkinStride);
+
+  ASSERT_EQ(layout.attributes.size(), 7);
+  for (u32 i = 0; i < layout.attributes.size(); ++i) {
+    EXPECT_EQ(layout.attributes.at(i).slot, i);
+  }
+
+  EXPECT_EQ(layout.attributes.at(1).format, quoll::rhi::Format::Rg16Snorm);
+  EXPECT_EQ(layout.attributes.at(3).format, quoll::rhi::Format::Rg16Float);
+  EXPECT_EQ(layout.attributes.at(4).offset, 12);
+  EXPECT_EQ(layout.attributes.at(5).format, quoll::rhi::Format::Rgba16Uint);
+  EXPECT_EQ(layout.attributes.at(6).format, quoll::rhi::Format::Rgba16Unorm);
+  EXPECT_EQ(layout.attributes.at(6).offset, 8);
+}
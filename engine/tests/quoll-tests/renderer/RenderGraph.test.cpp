@@ -2,6 +2,7 @@
 #include "quoll/profiler/MetricsCollector.h"
 #include "quoll/renderer/RenderGraph.h"
 #include "quoll/renderer/RenderStorage.h"
+#include "quoll/rhi-mock/MockCommandList.h"
 #include "quoll/rhi-mock/MockRenderDevice.h"
 #include "quoll-tests/Testing.h"
 
@@ -16,6 +17,24 @@ public:
     return graph.create(desc);
   }
 
+  std::vector<const MockCommandPipelineBarrier *>
+  getPipelineBarriers(const RenderCommandList &commandList) {
+    const auto &commands = static_cast<const MockCommandList *>(
+                               commandList.getNativeRenderCommandList().get())
+                               ->getCommands();
+
+    std::vector<const MockCommandPipelineBarrier *> barriers;
+    for (const auto &command : commands) {
+      const auto *barrier =
+          static_cast<const MockCommandPipelineBarrier *>(command.get());
+      if (barrier->type == MockCommandType::PipelineBarrier) {
+        barriers.push_back(barrier);
+      }
+    }
+
+    return barriers;
+  }
+
   MockRenderDevice device;
   quoll::MetricsCollector metricsCollector;
   quoll::RenderStorage storage;
@@ -501,7 +520,7 @@ TEST_F(RenderGraphTest, SetsImageBarrierBetweenPassWriteAndPassRead) {
             quoll::rhi::ImageLayout::ShaderReadOnlyOptimal);
 }
 
-TEST_F(RenderGraphTest, SetsImageBarriersBetweenPassReads) {
+TEST_F(RenderGraphTest, MergesImageBarriersOfPassReadsIntoFirstRead) {
   quoll::rhi::TextureDescription colorDescription{};
   colorDescription.usage = quoll::rhi::TextureUsage::Color;
   auto colorTexture = createTexture(colorDescription);
@@ -532,7 +551,9 @@ TEST_F(RenderGraphTest, SetsImageBarriersBetweenPassReads) {
     EXPECT_EQ(imageBarrier.texture, colorTexture.getHandle());
     EXPECT_EQ(imageBarrier.srcStage,
               quoll::rhi::PipelineStage::ColorAttachmentOutput);
-    EXPECT_EQ(imageBarrier.dstStage, quoll::rhi::PipelineStage::FragmentShader);
+    EXPECT_EQ(imageBarrier.dstStage,
+              quoll::rhi::PipelineStage::FragmentShader |
+                  quoll::rhi::PipelineStage::ComputeShader);
     EXPECT_EQ(imageBarrier.srcAccess, quoll::rhi::Access::ColorAttachmentWrite);
     EXPECT_EQ(imageBarrier.dstAccess, quoll::rhi::Access::ShaderRead);
     EXPECT_EQ(imageBarrier.srcLayout,
@@ -541,22 +562,9 @@ TEST_F(RenderGraphTest, SetsImageBarriersBetweenPassReads) {
               quoll::rhi::ImageLayout::ShaderReadOnlyOptimal);
   }
 
-  auto dependencies2 = graph.getCompiledPasses().at(2).getSyncDependencies();
-  EXPECT_EQ(dependencies2.imageBarriers.size(), 1);
-
-  {
-    const auto &imageBarrier = dependencies2.imageBarriers.at(0);
-
-    EXPECT_EQ(imageBarrier.texture, colorTexture.getHandle());
-    EXPECT_EQ(imageBarrier.srcStage, quoll::rhi::PipelineStage::FragmentShader);
-    EXPECT_EQ(imageBarrier.dstStage, quoll::rhi::PipelineStage::ComputeShader);
-    EXPECT_EQ(imageBarrier.srcAccess, quoll::rhi::Access::ShaderRead);
-    EXPECT_EQ(imageBarrier.dstAccess, quoll::rhi::Access::ShaderRead);
-    EXPECT_EQ(imageBarrier.srcLayout,
-              quoll::rhi::ImageLayout::ShaderReadOnlyOptimal);
-    EXPECT_EQ(imageBarrier.dstLayout,
-              quoll::rhi::ImageLayout::ShaderReadOnlyOptimal);
-  }
+  const auto &dependencies2 =
+      graph.getCompiledPasses().at(2).getSyncDependencies();
+  EXPECT_TRUE(dependencies2.imageBarriers.empty());
 }
 
 TEST_F(RenderGraphTest, SetsImageBarrierBetweenPassReadAndPassWrite) {
@@ -1119,3 +1127,346 @@ TEST_F(RenderGraphTest, DoesNotDestroyImportedResourcesOnDestroy) {
 
   EXPECT_TRUE(device.hasTexture(texture));
 }
+
+TEST_F(RenderGraphTest, AliasesTransientTexturesWithDisjointLifetimes) {
+  TextureDescription description{};
+  description.usage = TextureUsage::Color | TextureUsage::Sampled;
+  description.format = Format::Rgba8Unorm;
+  description.width = 64;
+  description.height = 32;
+
+  auto t1 = createTexture(description);
+  auto t2 = createTexture(description);
+  auto t3 = createTexture(description);
+  auto t4 = createTexture(description);
+
+  graph.addGraphicsPass("A").write(t1, quoll::AttachmentType::Color, {});
+
+  auto &passB = graph.addGraphicsPass("B");
+  passB.read(t1);
+  passB.write(t2, quoll::AttachmentType::Color, {});
+
+  auto &passC = graph.addGraphicsPass("C");
+  passC.read(t2);
+  passC.write(t3, quoll::AttachmentType::Color, {});
+
+  auto &passD = graph.addGraphicsPass("D");
+  passD.read(t3);
+  passD.write(t4, quoll::AttachmentType::Color, {});
+
+  const auto *metrics = device.getDeviceStats().getResourceMetrics();
+  const auto numTextures = metrics->getTexturesCount();
+
+  graph.build(storage);
+
+  EXPECT_EQ(t1.getHandle(), t3.getHandle());
+  EXPECT_EQ(t2.getHandle(), t4.getHandle());
+  EXPECT_NE(t1.getHandle(), t2.getHandle());
+  EXPECT_EQ(metrics->getTexturesCount(), numTextures + 2);
+
+  const usize textureSize = 64 * 32 * 4;
+  const auto &stats = graph.getMemoryStats();
+  EXPECT_EQ(stats.numTransientTextures, 4);
+  EXPECT_EQ(stats.numDeviceTextures, 2);
+  EXPECT_EQ(stats.peakMemory, 4 * textureSize);
+  EXPECT_EQ(stats.aliasedPeakMemory, 2 * textureSize);
+
+  graph.destroy(storage);
+  EXPECT_FALSE(device.hasTexture(t1.getHandle()));
+  EXPECT_FALSE(device.hasTexture(t2.getHandle()));
+  EXPECT_EQ(metrics->getTexturesCount(), numTextures);
+}
+
+TEST_F(RenderGraphTest, DoesNotAliasTexturesWithDifferentDescriptions) {
+  TextureDescription description{};
+  description.format = Format::Rgba8Unorm;
+  description.width = 64;
+  description.height = 32;
+
+  auto halfDescription = description;
+  halfDescription.width = 32;
+
+  auto t1 = createTexture(description);
+  auto t2 = createTexture(description);
+  auto t3 = createTexture(halfDescription);
+
+  graph.addGraphicsPass("A").write(t1, quoll::AttachmentType::Color, {});
+
+  auto &passB = graph.addGraphicsPass("B");
+  passB.read(t1);
+  passB.write(t2, quoll::AttachmentType::Color, {});
+
+  auto &passC = graph.addGraphicsPass("C");
+  passC.read(t2);
+  passC.write(t3, quoll::AttachmentType::Color, {});
+
+  graph.build(storage);
+
+  EXPECT_NE(t3.getHandle(), t1.getHandle());
+  EXPECT_EQ(graph.getMemoryStats().numDeviceTextures, 3);
+  EXPECT_EQ(graph.getMemoryStats().peakMemory,
+            graph.getMemoryStats().aliasedPeakMemory);
+}
+
+TEST_F(RenderGraphTest, DoesNotAliasTexturesThatAreNotReadAfterLastWrite) {
+  TextureDescription description{};
+  description.format = Format::Rgba8Unorm;
+  description.width = 64;
+  description.height = 32;
+
+  auto output = createTexture(description);
+  auto t1 = createTexture(description);
+  auto t2 = createTexture(description);
+  auto t3 = createTexture(description);
+
+  auto &passA = graph.addGraphicsPass("A");
+  passA.write(output, quoll::AttachmentType::Color, {});
+  passA.write(t1, quoll::AttachmentType::Color, {});
+
+  auto &passB = graph.addGraphicsPass("B");
+  passB.read(t1);
+  passB.write(t2, quoll::AttachmentType::Color, {});
+
+  auto &passC = graph.addGraphicsPass("C");
+  passC.read(t2);
+  passC.write(t3, quoll::AttachmentType::Color, {});
+
+  graph.build(storage);
+
+  EXPECT_NE(t3.getHandle(), output.getHandle());
+  EXPECT_EQ(t3.getHandle(), t1.getHandle());
+}
+
+TEST_F(RenderGraphTest, ViewUsesExtendLifetimeOfAliasedTexture) {
+  TextureDescription description{};
+  description.format = Format::Rgba8Unorm;
+  description.width = 64;
+  description.height = 32;
+  description.mipLevelCount = 2;
+
+  auto t1 = createTexture(description);
+  auto view = graph.createView(t1, 1);
+  auto t2 = createTexture(description);
+  auto t3 = createTexture(description);
+
+  graph.addGraphicsPass("A").write(t1, quoll::AttachmentType::Color, {});
+
+  auto &passB = graph.addGraphicsPass("B");
+  passB.read(t1);
+  passB.write(t2, quoll::AttachmentType::Color, {});
+
+  auto &passC = graph.addGraphicsPass("C");
+  passC.read(t2);
+  passC.write(view, quoll::AttachmentType::Color, {});
+
+  auto &passD = graph.addGraphicsPass("D");
+  passD.read(view);
+  passD.write(t3, quoll::AttachmentType::Color, {});
+
+  graph.build(storage);
+
+  EXPECT_NE(t3.getHandle(), t1.getHandle());
+  EXPECT_EQ(t3.getHandle(), t2.getHandle());
+  EXPECT_EQ(device.getTextureViewDescription(view.getHandle()).texture,
+            t1.getHandle());
+}
+
+TEST_F(RenderGraphTest, DiscardsContentsOfAliasedTextureOnFirstWrite) {
+  TextureDescription description{};
+  description.format = Format::Rgba8Unorm;
+  description.width = 64;
+  description.height = 32;
+
+  auto t1 = createTexture(description);
+  auto t2 = createTexture(description);
+  auto t3 = createTexture(description);
+
+  graph.addGraphicsPass("A").write(t1, quoll::AttachmentType::Color, {});
+
+  auto &passB = graph.addGraphicsPass("B");
+  passB.read(t1);
+  passB.write(t2, quoll::AttachmentType::Color, {});
+
+  auto &passC = graph.addGraphicsPass("C");
+  passC.read(t2);
+  passC.write(t3, quoll::AttachmentType::Color, {});
+
+  graph.build(storage);
+  ASSERT_EQ(t3.getHandle(), t1.getHandle());
+
+  const auto &pass = graph.getCompiledPasses().at(2);
+  EXPECT_EQ(pass.getName(), "C");
+  EXPECT_EQ(pass.getAttachments().at(0).loadOp, AttachmentLoadOp::Clear);
+  EXPECT_EQ(pass.getTextureOutputs().at(0).srcLayout, ImageLayout::Undefined);
+
+  const auto &imageBarrier = pass.getSyncDependencies().imageBarriers.at(0);
+  EXPECT_EQ(imageBarrier.texture, t3.getHandle());
+  EXPECT_EQ(imageBarrier.srcLayout, ImageLayout::Undefined);
+  EXPECT_EQ(imageBarrier.srcAccess, Access::ShaderRead);
+  EXPECT_EQ(imageBarrier.srcStage, PipelineStage::FragmentShader);
+  EXPECT_EQ(imageBarrier.dstAccess, Access::ColorAttachmentWrite);
+}
+
+TEST_F(RenderGraphTest, FirstWriteThroughViewWaitsForPreviousUserOfAlias) {
+  TextureDescription description{};
+  description.format = Format::Rgba8Unorm;
+  description.width = 64;
+  description.height = 32;
+  description.mipLevelCount = 2;
+
+  auto t1 = createTexture(description);
+  auto t2 = createTexture(description);
+  auto t3 = createTexture(description);
+  auto view = graph.createView(t3, 1);
+
+  graph.addGraphicsPass("A").write(t1, quoll::AttachmentType::Color, {});
+
+  auto &passB = graph.addGraphicsPass("B");
+  passB.read(t1);
+  passB.write(t2, quoll::AttachmentType::Color, {});
+
+  auto &passC = graph.addGraphicsPass("C");
+  passC.read(t2);
+  passC.write(view, quoll::AttachmentType::Color, {});
+
+  graph.build(storage);
+  ASSERT_EQ(t3.getHandle(), t1.getHandle());
+
+  const auto &pass = graph.getCompiledPasses().at(2);
+  EXPECT_EQ(pass.getName(), "C");
+  EXPECT_EQ(pass.getAttachments().at(0).loadOp, AttachmentLoadOp::Clear);
+  EXPECT_EQ(pass.getTextureOutputs().at(0).srcLayout, ImageLayout::Undefined);
+
+  const auto &imageBarrier = pass.getSyncDependencies().imageBarriers.at(0);
+  EXPECT_EQ(imageBarrier.texture, view.getHandle());
+  EXPECT_EQ(imageBarrier.srcLayout, ImageLayout::Undefined);
+  EXPECT_EQ(imageBarrier.srcAccess, Access::ShaderRead);
+  EXPECT_EQ(imageBarrier.srcStage, PipelineStage::FragmentShader);
+  EXPECT_EQ(imageBarrier.dstAccess, Access::ColorAttachmentWrite);
+}
+
+TEST_F(RenderGraphTest, CullsPassesWhoseOutputsAreNeverUsed) {
+  auto t1 = createTexture({});
+  auto t2 = createTexture({});
+  auto t3 = createTexture({});
+  auto t4 = createTexture({});
+  auto imported = graph.import(storage.createTexture({}));
+  auto buffer = device.createBuffer({}).getHandle();
+
+  graph.addGraphicsPass("A").write(t1, quoll::AttachmentType::Color, {});
+
+  auto &passB = graph.addGraphicsPass("B");
+  passB.read(t1);
+  passB.write(t2, quoll::AttachmentType::Color, {});
+
+  graph.addGraphicsPass("C").write(t3, quoll::AttachmentType::Color, {});
+
+  auto &passD = graph.addGraphicsPass("D");
+  passD.read(t3);
+  passD.write(t4, quoll::AttachmentType::Color, {});
+
+  graph.addGraphicsPass("E").write(imported, quoll::AttachmentType::Color,
+                                   {});
+
+  auto &passF = graph.addComputePass("F");
+  passF.write(t3, quoll::AttachmentType::Color, {});
+  passF.write(buffer, BufferUsage::Storage);
+
+  graph.addOutput(t2);
+  graph.build(storage);
+
+  std::vector<quoll::String> names;
+  for (const auto &pass : graph.getCompiledPasses()) {
+    names.push_back(pass.getName());
+  }
+
+  std::sort(names.begin(), names.end());
+  EXPECT_EQ(names, std::vector<quoll::String>({"A", "B", "E", "F"}));
+}
+
+TEST_F(RenderGraphTest,
+       KeepsPassesThatWriteTexturesNotReadByOtherPassesIfNoOutputsAreAdded) {
+  auto t1 = createTexture({});
+  auto t2 = createTexture({});
+
+  graph.addGraphicsPass("A").write(t1, quoll::AttachmentType::Color, {});
+
+  auto &passB = graph.addGraphicsPass("B");
+  passB.read(t1);
+  passB.write(t2, quoll::AttachmentType::Color, {});
+
+  graph.build(storage);
+
+  EXPECT_EQ(graph.getCompiledPasses().size(), 2);
+}
+
+TEST_F(RenderGraphTest, RecordsOneBarrierCallPerPassThatNeedsBarriers) {
+  auto t1 = createTexture({});
+  auto t2 = createTexture({});
+  auto t3 = createTexture({});
+  auto buffer = device.createBuffer({}).getHandle();
+
+  auto noop = [](RenderCommandList &, u32) {};
+
+  auto &passA = graph.addGraphicsPass("A");
+  passA.write(t1, quoll::AttachmentType::Color, {});
+  passA.setExecutor(noop);
+
+  auto &passB = graph.addGraphicsPass("B");
+  passB.read(t1);
+  passB.write(t2, quoll::AttachmentType::Color, {});
+  passB.setExecutor(noop);
+
+  auto &passC = graph.addComputePass("C");
+  passC.read(t1);
+  passC.read(t2);
+  passC.write(t3, quoll::AttachmentType::Color, {});
+  passC.write(buffer, BufferUsage::Storage);
+  passC.read(buffer, BufferUsage::Storage);
+  passC.setExecutor(noop);
+
+  auto &passD = graph.addGraphicsPass("D");
+  passD.read(t1);
+  passD.read(t2);
+  passD.read(buffer, BufferUsage::Vertex);
+  passD.setExecutor(noop);
+
+  auto &passE = graph.addGraphicsPass("E");
+  passE.read(t1);
+  passE.read(t2);
+  passE.setExecutor(noop);
+
+  graph.build(storage);
+  ASSERT_EQ(graph.getCompiledPasses().size(), 5);
+
+  RenderCommandList commandList(new MockCommandList);
+  graph.execute(commandList, 0);
+
+  auto barriers = getPipelineBarriers(commandList);
+  ASSERT_EQ(barriers.size(), 4);
+
+  // A: undefined to color attachment
+  EXPECT_EQ(barriers.at(0)->imageBarriers.size(), 1);
+
+  // B: t1 to shader read, t2 to color attachment
+  EXPECT_EQ(barriers.at(1)->imageBarriers.size(), 2);
+  EXPECT_EQ(barriers.at(1)->imageBarriers.at(1).dstStage,
+            PipelineStage::FragmentShader | PipelineStage::ComputeShader);
+
+  // C: t2 to shader read, t3 to general, one barrier
+  // for both accesses of the buffer
+  EXPECT_EQ(barriers.at(2)->imageBarriers.size(), 2);
+  ASSERT_EQ(barriers.at(2)->bufferBarriers.size(), 1);
+  EXPECT_EQ(barriers.at(2)->bufferBarriers.at(0).dstAccess,
+            Access::ShaderWrite | Access::ShaderRead);
+
+  // D: texture reads are merged into earlier barriers
+  EXPECT_TRUE(barriers.at(3)->imageBarriers.empty());
+  ASSERT_EQ(barriers.at(3)->bufferBarriers.size(), 1);
+  EXPECT_EQ(barriers.at(3)->bufferBarriers.at(0).dstStage,
+            PipelineStage::VertexAttributeInput);
+
+  // E: no barrier call is recorded
+  EXPECT_TRUE(graph.getCompiledPasses().at(4).getSyncDependencies()
+                  .imageBarriers.empty());
+}
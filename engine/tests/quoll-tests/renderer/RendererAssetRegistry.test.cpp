@@ -0,0 +1,200 @@
+#include "quoll/core/Base.h"
+#include "quoll/profiler/MetricsCollector.h"
+#include "quoll/renderer/RenderStorage.h"
+#include "quoll/renderer/RendererAssetRegistry.h"
+#include "quoll/rhi-mock/MockRenderDevice.h"
+#include "quoll-tests/Testing.h"
+
+class RendererAssetRegistryTest : public ::testing::Test {
+public:
+  static constexpr usize TextureSize = 64;
+
+  RendererAssetRegistryTest()
+      : renderStorage(&device, metricsCollector),
+        registry(renderStorage) {}
+
+  quoll::AssetRef<quoll::TextureAsset> createTexture() {
+    quoll::TextureAsset texture{};
+    texture.width = 4;
+    texture.height = 4;
+    texture.layers = 1;
+    texture.data.resize(TextureSize, 255);
+    texture.levels = {{0, TextureSize, 4, 4}};
+
+    auto handle = textures.allocate({.uuid = quoll::Uuid::generate()});
+    textures.store(handle, texture);
+    return quoll::AssetRef(textures, handle);
+  }
+
+  quoll::AssetRef<quoll::MeshAsset> createMesh() {
+    quoll::BaseGeometryAsset geometry{};
+    geometry.positions.resize(3);
+    geometry.indices = {0, 1, 2};
+
+    quoll::MeshAsset mesh{};
+    mesh.geometries.push_back(geometry);
+
+    auto handle = meshes.allocate({.uuid = quoll::Uuid::generate()});
+    meshes.store(handle, mesh);
+    return quoll::AssetRef(meshes, handle);
+  }
+
+  void update(u32 numFrames = 1) {
+    for (u32 i = 0; i < numFrames; ++i) {
+      auto commandList = device.requestImmediateCommandList();
+      registry.update(commandList, frameIndex);
+      frameIndex = (frameIndex + 1) % quoll::rhi::RenderDevice::NumFrames;
+    }
+  }
+
+  quoll::rhi::MockRenderDevice device;
+  quoll::MetricsCollector metricsCollector;
+  quoll::RenderStorage renderStorage;
+  quoll::AssetMap<quoll::TextureAsset> textures;
+  quoll::AssetMap<quoll::MeshAsset> meshes;
+  quoll::RendererAssetRegistry registry;
+  u32 frameIndex = 0;
+};
+
+TEST_F(RendererAssetRegistryTest, TracksMemoryUsageOfCreatedResources) {
+  auto texture = createTexture();
+  auto mesh = createMesh();
+
+  registry.get(texture);
+  registry.get(mesh);
+
+  const auto &stats = registry.getResidencyStats();
+  EXPECT_EQ(stats.memoryBudget,
+            quoll::RendererAssetRegistry::DefaultMemoryBudget);
+  const usize vertexSize = quoll::MeshVertexLayout::PositionStride +
+                           quoll::MeshVertexLayout{}.getAttributeStride();
+  EXPECT_EQ(stats.memoryUsage,
+            TextureSize + 3 * vertexSize + 3 * sizeof(u32));
+  EXPECT_EQ(stats.numResident, 2);
+}
+
+TEST_F(RendererAssetRegistryTest, CreatesVertexStreamsOfMeshLayout) {
+  auto mesh = createMesh();
+  EXPECT_EQ(registry.get(mesh).vertexBuffers.size(), 2);
+
+  quoll::MeshAsset skinnedMesh = mesh.get();
+  skinnedMesh.geometries.at(0).joints.resize(3);
+  skinnedMesh.geometries.at(0).weights.resize(3);
+  skinnedMesh.vertexLayout.texCoordFormat = quoll::rhi::Format::Rg16Float;
+
+  auto handle = meshes.allocate({.uuid = quoll::Uuid::generate()});
+  meshes.store(handle, skinnedMesh);
+
+  const auto &drawData = registry.get(quoll::AssetRef(meshes, handle));
+  ASSERT_EQ(drawData.vertexBuffers.size(), 3);
+  EXPECT_EQ(drawData.vertexLayout, skinnedMesh.vertexLayout);
+
+  const auto *skin = device.getBuffer(
+      drawData.vertexBuffers.at(quoll::MeshVertexLayout::SkinStream));
+  EXPECT_EQ(skin->getDescription().size,
+            3 * quoll::MeshVertexLayout::SkinStride);
+}
+
+TEST_F(RendererAssetRegistryTest, DoesNotEvictResourcesWithinBudget) {
+  quoll::rhi::TextureHandle handle = quoll::rhi::TextureHandle::Null;
+  {
+    auto texture = createTexture();
+    handle = registry.get(texture);
+  }
+
+  update(5);
+
+  EXPECT_TRUE(device.hasTexture(handle));
+  EXPECT_EQ(registry.getResidencyStats().numEvicted, 0);
+}
+
+TEST_F(RendererAssetRegistryTest, DoesNotEvictReferencedResources) {
+  registry.setMemoryBudget(0);
+
+  auto texture = createTexture();
+  auto handle = registry.get(texture);
+  update(5);
+
+  EXPECT_TRUE(device.hasTexture(handle));
+  EXPECT_EQ(registry.get(texture), handle);
+  EXPECT_EQ(registry.getResidencyStats().numEvicted, 0);
+}
+
+TEST_F(RendererAssetRegistryTest,
+       EvictsLeastRecentlyUsedUnreferencedResourcesUntilWithinBudget) {
+  registry.setMemoryBudget(TextureSize);
+
+  auto texture1 = createTexture();
+  auto texture2 = createTexture();
+  auto handle1 = registry.get(texture1);
+  auto handle2 = registry.get(texture2);
+  update();
+
+  // Texture 1 is used more recently
+  registry.get(texture1);
+  update();
+
+  auto rawHandle1 = texture1.handle();
+  auto rawHandle2 = texture2.handle();
+  texture1 = {};
+  texture2 = {};
+  update();
+
+  const auto &stats = registry.getResidencyStats();
+  EXPECT_EQ(stats.numEvicted, 1);
+  EXPECT_EQ(stats.numResident, 1);
+  EXPECT_EQ(stats.memoryUsage, TextureSize);
+
+  // Texture 1 is still resident
+  EXPECT_EQ(registry.get(quoll::AssetRef(textures, rawHandle1)), handle1);
+
+  // Texture 2 is evicted and recreated
+  EXPECT_NE(registry.get(quoll::AssetRef(textures, rawHandle2)), handle2);
+}
+
+TEST_F(RendererAssetRegistryTest, DefersDestructionUntilFramesInFlightRetire) {
+  registry.setMemoryBudget(0);
+
+  quoll::rhi::TextureHandle texture = quoll::rhi::TextureHandle::Null;
+  quoll::rhi::BufferHandle indexBuffer = quoll::rhi::BufferHandle::Null;
+  {
+    auto textureRef = createTexture();
+    auto meshRef = createMesh();
+    texture = registry.get(textureRef);
+    indexBuffer = registry.get(meshRef).indexBuffer;
+  }
+
+  // Resources used in a frame are not evicted in it
+  update();
+  EXPECT_EQ(registry.getResidencyStats().numEvicted, 0);
+
+  update();
+  EXPECT_EQ(registry.getResidencyStats().numEvicted, 2);
+  EXPECT_EQ(registry.getResidencyStats().numRetired, 4);
+  EXPECT_EQ(registry.getResidencyStats().memoryUsage, 0);
+
+  for (u32 i = 1; i < quoll::rhi::RenderDevice::NumFrames; ++i) {
+    update();
+    EXPECT_TRUE(device.hasTexture(texture));
+    EXPECT_TRUE(device.hasBuffer(indexBuffer));
+  }
+
+  update();
+  EXPECT_FALSE(device.hasTexture(texture));
+  EXPECT_FALSE(device.hasBuffer(indexBuffer));
+  EXPECT_EQ(registry.getResidencyStats().numRetired, 0);
+}
+
+TEST_F(RendererAssetRegistryTest, DoesNotEvictResourcesUsedInCurrentFrame) {
+  registry.setMemoryBudget(0);
+
+  auto texture = createTexture();
+  auto rawHandle = texture.handle();
+  texture = {};
+
+  auto handle = registry.get(quoll::AssetRef(textures, rawHandle));
+  update();
+
+  EXPECT_TRUE(device.hasTexture(handle));
+  EXPECT_EQ(registry.getResidencyStats().numEvicted, 0);
+}
@@ -0,0 +1,326 @@
+#include "quoll/core/Base.h"
+#include "quoll/profiler/MetricsCollector.h"
+#include "quoll/renderer/MeshRenderUtils.h"
+#include "quoll/renderer/RenderStorage.h"
+#include "quoll/renderer/SceneRendererFrameData.h"
+#include "quoll/rhi-mock/MockCommandList.h"
+#include "quoll/rhi-mock/MockRenderDevice.h"
+#include "quoll-tests/Testing.h"
+
+class SceneRendererFrameDataTest : public ::testing::Test {
+public:
+  static constexpr u32 CameraBit = quoll::SceneRendererFrameData::CameraViewBit;
+  static constexpr u32 ShadowBit =
+      quoll::SceneRendererFrameData::getShadowMapViewBit(0);
+
+public:
+  SceneRendererFrameDataTest()
+      : renderStorage(&device, metricsCollector),
+        frameData(renderStorage, 10) {
+    drawData.geometries.push_back({.numVertices = 24, .numIndices = 36});
+    drawData.geometries.push_back({.numVertices = 8, .numIndices = 12});
+  }
+
+  void addMeshes(quoll::AssetHandle<quoll::MeshAsset> handle,
+                 std::span<const u32> visibility, u32 firstEntity = 0) {
+    const usize numGeometries = drawData.geometries.size();
+    for (usize i = 0; i < visibility.size() / numGeometries; ++i) {
+      frameData.addMesh(
+          handle, drawData, quoll::Entity{firstEntity + static_cast<u32>(i)},
+          glm::mat4{1.0f}, {},
+          visibility.subspan(i * numGeometries, numGeometries));
+    }
+  }
+
+  void addShadowMap() {
+    frameData.setCameraData({}, {});
+    frameData.addLight(
+        quoll::DirectionalLight{.direction = glm::vec3(1.0f, -1.0f, 0.0f)},
+        quoll::CascadedShadowMap{.numCascades = 1});
+  }
+
+  std::vector<quoll::MeshDrawCommand> getUploadedCommands() {
+    auto *data = static_cast<quoll::MeshDrawCommand *>(
+        device.getBuffer(frameData.getDrawCommandsBufferHandle())->map());
+    return {data, data + frameData.getDrawCommands().size()};
+  }
+
+  quoll::rhi::MockRenderDevice device;
+  quoll::MetricsCollector metricsCollector;
+  quoll::RenderStorage renderStorage;
+  quoll::SceneRendererFrameData frameData;
+
+  quoll::MeshDrawData drawData;
+};
+
+TEST_F(SceneRendererFrameDataTest,
+       BuildsDrawCommandOfEveryVisibleInstanceRunOfEveryGeometry) {
+  // Visibility of geometry 0 and geometry 1 of every instance
+  std::vector<u32> visibility{CameraBit, CameraBit, CameraBit, 0,
+                              0,         CameraBit, CameraBit, CameraBit};
+  addMeshes(quoll::AssetHandle<quoll::MeshAsset>{1}, visibility);
+  frameData.updateBuffers();
+
+  const auto &commands = frameData.getDrawCommands();
+  ASSERT_EQ(commands.size(), 4);
+
+  EXPECT_EQ(commands.at(0).geometryIndex, 0);
+  EXPECT_EQ(commands.at(0).command.indexCount, 36);
+  EXPECT_EQ(commands.at(0).command.firstIndex, 0);
+  EXPECT_EQ(commands.at(0).command.vertexOffset, 0);
+  EXPECT_EQ(commands.at(0).command.firstInstance, 0);
+  EXPECT_EQ(commands.at(0).command.instanceCount, 2);
+
+  EXPECT_EQ(commands.at(1).geometryIndex, 0);
+  EXPECT_EQ(commands.at(1).command.firstInstance, 3);
+  EXPECT_EQ(commands.at(1).command.instanceCount, 1);
+
+  EXPECT_EQ(commands.at(2).geometryIndex, 1);
+  EXPECT_EQ(commands.at(2).command.indexCount, 12);
+  EXPECT_EQ(commands.at(2).command.firstIndex, 36);
+  EXPECT_EQ(commands.at(2).command.vertexOffset, 24);
+  EXPECT_EQ(commands.at(2).command.firstInstance, 0);
+  EXPECT_EQ(commands.at(2).command.instanceCount, 1);
+
+  EXPECT_EQ(commands.at(3).geometryIndex, 1);
+  EXPECT_EQ(commands.at(3).command.firstInstance, 2);
+  EXPECT_EQ(commands.at(3).command.instanceCount, 2);
+
+  auto draws = frameData.getMeshDraws(0);
+  ASSERT_EQ(draws.size(), 1);
+  EXPECT_EQ(draws[0].firstDraw, 0);
+  EXPECT_EQ(draws[0].numDraws, 4);
+}
+
+TEST_F(SceneRendererFrameDataTest, UploadsDrawCommandsToIndirectBuffer) {
+  std::vector<u32> visibility{CameraBit, 0, 0, CameraBit};
+  addMeshes(quoll::AssetHandle<quoll::MeshAsset>{1}, visibility);
+  frameData.updateBuffers();
+
+  auto uploaded = getUploadedCommands();
+  const auto &commands = frameData.getDrawCommands();
+  ASSERT_EQ(uploaded.size(), 2);
+
+  for (usize i = 0; i < commands.size(); ++i) {
+    EXPECT_EQ(uploaded.at(i).geometryIndex, commands.at(i).geometryIndex);
+    EXPECT_EQ(uploaded.at(i).command.indexCount,
+              commands.at(i).command.indexCount);
+    EXPECT_EQ(uploaded.at(i).command.firstInstance,
+              commands.at(i).command.firstInstance);
+    EXPECT_EQ(uploaded.at(i).command.instanceCount,
+              commands.at(i).command.instanceCount);
+  }
+}
+
+TEST_F(SceneRendererFrameDataTest, BuildsDrawRangesOfEveryViewAndMeshGroup) {
+  addShadowMap();
+  ASSERT_EQ(frameData.getNumShadowMaps(), 1);
+
+  std::vector<u32> first{CameraBit | ShadowBit, CameraBit | ShadowBit};
+  std::vector<u32> second{ShadowBit, 0, ShadowBit, ShadowBit};
+  addMeshes(quoll::AssetHandle<quoll::MeshAsset>{1}, first);
+  addMeshes(quoll::AssetHandle<quoll::MeshAsset>{2}, second, 1);
+  frameData.updateBuffers();
+
+  const auto &groups = frameData.getMeshGroups();
+  ASSERT_EQ(groups.size(), 2);
+
+  auto cameraDraws = frameData.getMeshDraws(0);
+  ASSERT_EQ(cameraDraws.size(), 2);
+  EXPECT_EQ(cameraDraws[0].firstDraw, 0);
+  EXPECT_EQ(cameraDraws[0].numDraws, 2);
+  EXPECT_EQ(cameraDraws[1].numDraws, 0);
+
+  auto shadowDraws = frameData.getMeshDraws(1);
+  ASSERT_EQ(shadowDraws.size(), 2);
+  EXPECT_EQ(shadowDraws[0].firstDraw, 2);
+  EXPECT_EQ(shadowDraws[0].numDraws, 2);
+  EXPECT_EQ(shadowDraws[1].firstDraw, 4);
+  EXPECT_EQ(shadowDraws[1].numDraws, 2);
+
+  const auto &commands = frameData.getDrawCommands();
+  ASSERT_EQ(commands.size(), 6);
+
+  // Geometry 0 of both instances of second mesh
+  EXPECT_EQ(commands.at(4).geometryIndex, 0);
+  EXPECT_EQ(commands.at(4).command.firstInstance, groups.at(1).firstSlot);
+  EXPECT_EQ(commands.at(4).command.instanceCount, 2);
+
+  // Geometry 1 of second instance of second mesh
+  EXPECT_EQ(commands.at(5).geometryIndex, 1);
+  EXPECT_EQ(commands.at(5).command.firstInstance, groups.at(1).firstSlot + 1);
+  EXPECT_EQ(commands.at(5).command.instanceCount, 1);
+}
+
+TEST_F(SceneRendererFrameDataTest, DoesNotBuildDrawCommandsOfKeptMeshes) {
+  std::vector<u32> visibility{CameraBit, CameraBit, CameraBit, CameraBit};
+  addMeshes(quoll::AssetHandle<quoll::MeshAsset>{1}, visibility);
+  frameData.updateBuffers();
+  EXPECT_EQ(frameData.getDrawCommands().size(), 2);
+
+  frameData.clear();
+  EXPECT_TRUE(frameData.keepMesh(quoll::Entity{0}));
+  EXPECT_TRUE(frameData.keepMesh(quoll::Entity{1}));
+  frameData.updateBuffers();
+
+  EXPECT_TRUE(frameData.getDrawCommands().empty());
+  ASSERT_EQ(frameData.getMeshDraws(0).size(), 1);
+  EXPECT_EQ(frameData.getMeshDraws(0)[0].numDraws, 0);
+}
+
+TEST_F(SceneRendererFrameDataTest, RecordsIndirectDrawsInCommandList) {
+  addShadowMap();
+
+  std::vector<u32> visibility{CameraBit, ShadowBit, ShadowBit, CameraBit};
+  addMeshes(quoll::AssetHandle<quoll::MeshAsset>{1}, visibility);
+  frameData.updateBuffers();
+
+  quoll::rhi::RenderCommandList commandList(new quoll::rhi::MockCommandList);
+  for (usize view = 0; view <= frameData.getNumShadowMaps(); ++view) {
+    const auto &draw = frameData.getMeshDraws(view)[0];
+    commandList.drawIndexedIndirect(
+        frameData.getDrawCommandsBufferHandle(),
+        draw.firstDraw * sizeof(quoll::MeshDrawCommand), draw.numDraws,
+        sizeof(quoll::MeshDrawCommand));
+  }
+
+  const auto *mockCommandList =
+      static_cast<const quoll::rhi::MockCommandList *>(
+          commandList.getNativeRenderCommandList().get());
+  const auto &drawCalls = mockCommandList->getDrawCalls();
+  ASSERT_EQ(drawCalls.size(), 2);
+
+  auto commands = getUploadedCommands();
+  ASSERT_EQ(commands.size(), 4);
+
+  for (usize view = 0; view < drawCalls.size(); ++view) {
+    ASSERT_EQ(drawCalls.at(view).type,
+              quoll::rhi::DrawCallType::DrawIndexedIndirect);
+    const auto *command =
+        static_cast<const quoll::rhi::MockCommandDrawIndexedIndirect *>(
+            drawCalls.at(view).command);
+
+    EXPECT_EQ(command->buffer, frameData.getDrawCommandsBufferHandle());
+    EXPECT_EQ(command->stride, sizeof(quoll::MeshDrawCommand));
+    EXPECT_EQ(command->drawCount, 2);
+
+    // Every view draws one instance of every geometry
+    const usize firstDraw = command->offset / command->stride;
+    const u32 viewMask =
+        view == 0 ? CameraBit
+                  : quoll::SceneRendererFrameData::getShadowMapViewBit(
+                        static_cast<u32>(view - 1));
+    for (usize i = 0; i < command->drawCount; ++i) {
+      const auto &drawCommand = commands.at(firstDraw + i);
+      const u32 instance = drawCommand.command.firstInstance;
+      EXPECT_EQ(drawCommand.command.instanceCount, 1);
+      EXPECT_NE(visibility.at(instance * 2 + drawCommand.geometryIndex) &
+                    viewMask,
+                0);
+    }
+  }
+}
+
+TEST_F(SceneRendererFrameDataTest,
+       GrowsInstanceBuffersIfInstancesDoNotFitInReservedSpace) {
+  static constexpr u32 NumInstances = 12000;
+  for (u32 i = 0; i < NumInstances; ++i) {
+    std::array<u32, 2> visibility{CameraBit, CameraBit};
+    frameData.addMesh(quoll::AssetHandle<quoll::MeshAsset>{1}, drawData,
+                      quoll::Entity{i},
+                      glm::translate(glm::mat4{1.0f}, glm::vec3(f32(i))), {},
+                      visibility);
+  }
+
+  auto handle = frameData.getMeshTransformsBufferHandle();
+  frameData.updateBuffers();
+
+  EXPECT_NE(frameData.getMeshTransformsBufferHandle(), handle);
+  EXPECT_GE(frameData.getMeshBufferCapacity(), NumInstances);
+  EXPECT_GE(device.getBuffer(frameData.getMeshTransformsBufferHandle())
+                ->getDescription()
+                .size,
+            NumInstances * sizeof(glm::mat4));
+
+  const auto &groups = frameData.getMeshGroups();
+  ASSERT_EQ(groups.size(), 1);
+
+  auto *transforms = static_cast<glm::mat4 *>(
+      device.getBuffer(frameData.getMeshTransformsBufferHandle())->map());
+  for (u32 i = 0; i < NumInstances; ++i) {
+    EXPECT_EQ(transforms[groups.at(0).firstSlot + i][3].x, f32(i));
+  }
+
+  // Replaced buffer is destroyed in the next update
+  EXPECT_NO_THROW(device.getBuffer(handle));
+  frameData.clear();
+  frameData.updateBuffers();
+  EXPECT_THROW(device.getBuffer(handle), std::out_of_range);
+}
+
+TEST_F(SceneRendererFrameDataTest,
+       UpdatesBindlessParametersIfInstanceBuffersAreRecreated) {
+  auto &params = frameData.getBindlessParams();
+  auto offset = params.addDynamicRange(
+      [this] { return frameData.getMeshTransformsBuffer(); });
+  params.build(&device);
+
+  std::vector<u32> visibility(2 * 100, CameraBit);
+  addMeshes(quoll::AssetHandle<quoll::MeshAsset>{1}, visibility);
+  frameData.updateBuffers();
+
+  auto *data = static_cast<u8 *>(
+      device.getBuffer(params.getBufferHandle())->map());
+  quoll::rhi::DeviceAddress address{};
+  memcpy(&address, data + offset, sizeof(quoll::rhi::DeviceAddress));
+  EXPECT_EQ(address, frameData.getMeshTransformsBuffer());
+}
+
+TEST_F(SceneRendererFrameDataTest,
+       ShrinksInstanceBuffersIfMostInstancesAreRemoved) {
+  std::vector<u32> visibility(2 * 100, CameraBit);
+  addMeshes(quoll::AssetHandle<quoll::MeshAsset>{1}, visibility);
+  frameData.updateBuffers();
+  EXPECT_GE(frameData.getMeshBufferCapacity(), 100);
+
+  frameData.clear();
+  frameData.updateBuffers();
+  EXPECT_EQ(frameData.getMeshBufferCapacity(), 10);
+}
+
+TEST_F(SceneRendererFrameDataTest,
+       DoesNotShrinkInstanceBuffersIfShrinkingIsDisabled) {
+  quoll::SceneRendererFrameData fixedFrameData(renderStorage, 10, false);
+
+  for (u32 i = 0; i < 100; ++i) {
+    std::array<u32, 2> visibility{CameraBit, CameraBit};
+    fixedFrameData.addMesh(quoll::AssetHandle<quoll::MeshAsset>{1}, drawData,
+                           quoll::Entity{i}, glm::mat4{1.0f}, {}, visibility);
+  }
+  fixedFrameData.updateBuffers();
+  const usize capacity = fixedFrameData.getMeshBufferCapacity();
+  EXPECT_GE(capacity, 100);
+
+  fixedFrameData.clear();
+  fixedFrameData.updateBuffers();
+  EXPECT_EQ(fixedFrameData.getMeshBufferCapacity(), capacity);
+}
+
+TEST_F(SceneRendererFrameDataTest, StoresJointsOfLargeSkeletonsInJointPalette) {
+  std::vector<glm::mat4> joints;
+  for (u32 i = 0; i < 40; ++i) {
+    joints.push_back(glm::translate(glm::mat4{1.0f}, glm::vec3(f32(i))));
+  }
+
+  std::array<u32, 2> visibility{CameraBit, CameraBit};
+  auto range = frameData.addSkeleton(quoll::Entity{1}, joints);
+  frameData.addSkinnedMesh(quoll::AssetHandle<quoll::MeshAsset>{1}, drawData,
+                           quoll::Entity{1}, glm::mat4{1.0f}, range, {},
+                           visibility);
+  frameData.updateBuffers();
+
+  EXPECT_EQ(range.count, 40);
+  const auto &palette = frameData.getJointPalette().getJoints();
+  ASSERT_EQ(palette.size(), 40);
+  EXPECT_EQ(palette.at(range.offset + 39), joints.at(39));
+}
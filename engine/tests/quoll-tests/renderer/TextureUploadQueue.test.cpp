@@ -0,0 +1,227 @@
+#include "quoll/core/Base.h"
+#include "quoll/profiler/MetricsCollector.h"
+#include "quoll/renderer/RenderStorage.h"
+#include "quoll/renderer/TextureUploadQueue.h"
+#include "quoll/rhi-mock/MockCommandList.h"
+#include "quoll/rhi-mock/MockRenderDevice.h"
+#include "quoll-tests/Testing.h"
+
+class TextureUploadQueueTest : public ::testing::Test {
+public:
+  static constexpr usize StagingSize = 1024;
+
+  TextureUploadQueueTest()
+      : renderStorage(&device, metricsCollector),
+        uploadQueue(renderStorage, StagingSize) {}
+
+  quoll::rhi::TextureHandle createTexture() {
+    quoll::rhi::TextureDescription description{};
+    description.width = 4;
+    description.height = 4;
+    description.usage = quoll::rhi::TextureUsage::Color |
+                        quoll::rhi::TextureUsage::TransferDestination |
+                        quoll::rhi::TextureUsage::Sampled;
+    return renderStorage.createTexture(description, false);
+  }
+
+  void enqueue(quoll::rhi::TextureHandle texture,
+               const std::vector<u8> &data) {
+    uploadQueue.enqueue(texture, data.data(),
+                        quoll::rhi::ImageLayout::ShaderReadOnlyOptimal, 1,
+                        {{0, data.size(), 4, 4}});
+  }
+
+  const std::vector<std::unique_ptr<quoll::rhi::MockCommand>> &
+  getCommands(const quoll::rhi::RenderCommandList &commandList) {
+    return static_cast<const quoll::rhi::MockCommandList *>(
+               commandList.getNativeRenderCommandList().get())
+        ->getCommands();
+  }
+
+  std::vector<const quoll::rhi::MockCommandCopyBufferToTexture *>
+  getCopies(const quoll::rhi::RenderCommandList &commandList) {
+    std::vector<const quoll::rhi::MockCommandCopyBufferToTexture *> copies;
+    for (const auto &command : getCommands(commandList)) {
+      const auto *copy =
+          static_cast<const quoll::rhi::MockCommandCopyBufferToTexture *>(
+              command.get());
+      if (copy->type == quoll::rhi::MockCommandType::CopyBufferToTexture) {
+        copies.push_back(copy);
+      }
+    }
+
+    return copies;
+  }
+
+  const u8 *getStagingData(const quoll::rhi::MockCommandCopyBufferToTexture
+                               *copy) {
+    return static_cast<const u8 *>(
+               device.getBuffer(copy->srcBuffer)->map()) +
+           copy->copyRegions.at(0).bufferOffset;
+  }
+
+  quoll::rhi::MockRenderDevice device;
+  quoll::MetricsCollector metricsCollector;
+  quoll::RenderStorage renderStorage;
+  quoll::TextureUploadQueue uploadQueue;
+};
+
+TEST_F(TextureUploadQueueTest, DoesNotUploadTextureUntilRecorded) {
+  auto texture = createTexture();
+  enqueue(texture, std::vector<u8>(64, 1));
+
+  EXPECT_FALSE(uploadQueue.isResident(texture));
+  EXPECT_EQ(uploadQueue.getNumQueued(), 1);
+  EXPECT_EQ(uploadQueue.getStagingUsage(), 64);
+}
+
+TEST_F(TextureUploadQueueTest, RecordsQueuedUploadsInOneBatch) {
+  std::vector<quoll::rhi::TextureHandle> textures;
+  for (u8 i = 0; i < 3; ++i) {
+    auto texture = createTexture();
+    enqueue(texture, std::vector<u8>(64, i));
+    textures.push_back(texture);
+  }
+
+  auto commandList = device.requestImmediateCommandList();
+  uploadQueue.record(commandList, 0);
+
+  const auto &commands = getCommands(commandList);
+  ASSERT_EQ(commands.size(), 5);
+
+  auto *preBarrier = static_cast<quoll::rhi::MockCommandPipelineBarrier *>(
+      commands.at(0).get());
+  auto *postBarrier = static_cast<quoll::rhi::MockCommandPipelineBarrier *>(
+      commands.at(4).get());
+  EXPECT_EQ(preBarrier->type, quoll::rhi::MockCommandType::PipelineBarrier);
+  EXPECT_EQ(postBarrier->type, quoll::rhi::MockCommandType::PipelineBarrier);
+  ASSERT_EQ(preBarrier->imageBarriers.size(), 3);
+  ASSERT_EQ(postBarrier->imageBarriers.size(), 3);
+
+  auto copies = getCopies(commandList);
+  ASSERT_EQ(copies.size(), 3);
+
+  for (usize i = 0; i < textures.size(); ++i) {
+    EXPECT_TRUE(uploadQueue.isResident(textures.at(i)));
+    EXPECT_EQ(preBarrier->imageBarriers.at(i).texture, textures.at(i));
+    EXPECT_EQ(preBarrier->imageBarriers.at(i).dstLayout,
+              quoll::rhi::ImageLayout::TransferDestinationOptimal);
+    EXPECT_EQ(postBarrier->imageBarriers.at(i).dstLayout,
+              quoll::rhi::ImageLayout::ShaderReadOnlyOptimal);
+
+    EXPECT_EQ(copies.at(i)->dstTexture, textures.at(i));
+    EXPECT_EQ(getStagingData(copies.at(i))[0], static_cast<u8>(i));
+    EXPECT_EQ(getStagingData(copies.at(i))[63], static_cast<u8>(i));
+  }
+
+  EXPECT_EQ(uploadQueue.getNumQueued(), 0);
+}
+
+TEST_F(TextureUploadQueueTest, DoesNotRecordAnythingIfQueueIsEmpty) {
+  auto commandList = device.requestImmediateCommandList();
+  uploadQueue.record(commandList, 0);
+
+  EXPECT_TRUE(getCommands(commandList).empty());
+}
+
+TEST_F(TextureUploadQueueTest, RecordsUploadsInLaterFramesIfStagingIsFull) {
+  auto texture1 = createTexture();
+  auto texture2 = createTexture();
+  enqueue(texture1, std::vector<u8>(600, 1));
+  enqueue(texture2, std::vector<u8>(600, 2));
+
+  {
+    auto commandList = device.requestImmediateCommandList();
+    uploadQueue.record(commandList, 0);
+    EXPECT_EQ(getCopies(commandList).size(), 1);
+    EXPECT_TRUE(uploadQueue.isResident(texture1));
+    EXPECT_FALSE(uploadQueue.isResident(texture2));
+  }
+
+  // Copies of frame 0 can still be running
+  {
+    auto commandList = device.requestImmediateCommandList();
+    uploadQueue.record(commandList, 1);
+    EXPECT_TRUE(getCopies(commandList).empty());
+    EXPECT_FALSE(uploadQueue.isResident(texture2));
+  }
+
+  {
+    auto commandList = device.requestImmediateCommandList();
+    uploadQueue.record(commandList, 0);
+    auto copies = getCopies(commandList);
+    ASSERT_EQ(copies.size(), 1);
+    EXPECT_EQ(copies.at(0)->dstTexture, texture2);
+    EXPECT_EQ(getStagingData(copies.at(0))[599], 2);
+    EXPECT_TRUE(uploadQueue.isResident(texture2));
+  }
+}
+
+TEST_F(TextureUploadQueueTest, KeepsDataOfUploadsThatAreNotStaged) {
+  auto texture1 = createTexture();
+  auto texture2 = createTexture();
+  enqueue(texture1, std::vector<u8>(600, 1));
+
+  {
+    std::vector<u8> data(600, 2);
+    enqueue(texture2, data);
+    std::fill(data.begin(), data.end(), 0);
+  }
+
+  auto commandList = device.requestImmediateCommandList();
+  uploadQueue.record(commandList, 0);
+  uploadQueue.record(commandList, 1);
+  uploadQueue.record(commandList, 0);
+
+  auto copies = getCopies(commandList);
+  ASSERT_EQ(copies.size(), 2);
+  EXPECT_EQ(copies.at(1)->dstTexture, texture2);
+  EXPECT_EQ(getStagingData(copies.at(1))[0], 2);
+}
+
+TEST_F(TextureUploadQueueTest, WrapsStagingBufferAroundWhenEndIsReached) {
+  auto texture1 = createTexture();
+  auto texture2 = createTexture();
+  enqueue(texture1, std::vector<u8>(800, 1));
+
+  auto commandList = device.requestImmediateCommandList();
+  uploadQueue.record(commandList, 0);
+  uploadQueue.record(commandList, 1);
+  uploadQueue.record(commandList, 0);
+
+  enqueue(texture2, std::vector<u8>(400, 2));
+  EXPECT_EQ(uploadQueue.getStagingUsage(), StagingSize - 800 + 400);
+
+  uploadQueue.record(commandList, 1);
+  auto copies = getCopies(commandList);
+  ASSERT_EQ(copies.size(), 2);
+  EXPECT_EQ(copies.at(1)->copyRegions.at(0).bufferOffset, 0);
+  EXPECT_EQ(getStagingData(copies.at(1))[399], 2);
+}
+
+TEST_F(TextureUploadQueueTest,
+       UploadsTexturesThatDoNotFitStagingImmediately) {
+  auto texture = createTexture();
+  enqueue(texture, std::vector<u8>(StagingSize + 1, 1));
+
+  EXPECT_TRUE(uploadQueue.isResident(texture));
+  EXPECT_EQ(uploadQueue.getNumQueued(), 0);
+  EXPECT_EQ(uploadQueue.getStagingUsage(), 0);
+}
+
+TEST_F(TextureUploadQueueTest, DoesNotRecordCancelledUploads) {
+  auto texture1 = createTexture();
+  auto texture2 = createTexture();
+  enqueue(texture1, std::vector<u8>(64, 1));
+  enqueue(texture2, std::vector<u8>(64, 2));
+
+  uploadQueue.cancel(texture1);
+  EXPECT_EQ(uploadQueue.getNumQueued(), 1);
+
+  auto commandList = device.requestImmediateCommandList();
+  uploadQueue.record(commandList, 0);
+
+  auto copies = getCopies(commandList);
+  ASSERT_EQ(copies.size(), 1);
+  EXPECT_EQ(copies.at(0)->dstTexture, texture2);
+}
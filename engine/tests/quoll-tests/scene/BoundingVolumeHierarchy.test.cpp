@@ -0,0 +1,321 @@
+#include "quoll/core/Base.h"
+#include "quoll/scene/BoundingVolumeHierarchy.h"
+#include "quoll-tests/Testing.h"
+
+class BoundingVolumeHierarchyTest : public ::testing::Test {
+public:
+  quoll::BoundingBox createBox(glm::vec3 center, f32 halfSize = 0.5f) {
+    return {center - glm::vec3(halfSize), center + glm::vec3(halfSize)};
+  }
+
+  /**
+   * @brief Create random boxes
+   *
+   * Boxes are spread in a 100x100x100 cube
+   *
+   * @param count Number of boxes
+   * @return Entries with entities starting from one
+   */
+  std::vector<quoll::BoundingVolumeHierarchy::Entry>
+  createEntries(usize count) {
+    std::vector<quoll::BoundingVolumeHierarchy::Entry> entries(count);
+    for (usize i = 0; i < count; ++i) {
+      entries.at(i) = {static_cast<quoll::Entity>(i + 1),
+                       createBox(randomPosition(), random(0.1f, 2.0f))};
+    }
+
+    return entries;
+  }
+
+  f32 random(f32 min, f32 max) {
+    return std::uniform_real_distribution<f32>{min, max}(generator);
+  }
+
+  glm::vec3 randomPosition() {
+    return glm::vec3(random(-50.0f, 50.0f), random(-50.0f, 50.0f),
+                     random(-50.0f, 50.0f));
+  }
+
+  std::vector<quoll::Entity> sorted(std::vector<quoll::Entity> entities) {
+    std::sort(entities.begin(), entities.end());
+    return entities;
+  }
+
+  /**
+   * @brief Check that all nodes enclose their children
+   *
+   * @param hierarchy Bounding volume hierarchy
+   * @return Number of leaves
+   */
+  usize validate(const quoll::BoundingVolumeHierarchy &hierarchy) {
+    if (hierarchy.getRoot() == quoll::BoundingVolumeHierarchy::NullNode) {
+      return 0;
+    }
+
+    usize numLeaves = 0;
+    std::vector<u32> stack{hierarchy.getRoot()};
+    while (!stack.empty()) {
+      const u32 index = stack.back();
+      stack.pop_back();
+
+      const auto &node = hierarchy.getNode(index);
+      if (node.isLeaf()) {
+        EXPECT_TRUE(node.bounds.contains(node.object));
+        numLeaves++;
+        continue;
+      }
+
+      for (auto child : {node.left, node.right}) {
+        EXPECT_EQ(hierarchy.getNode(child).parent, index);
+        EXPECT_TRUE(node.bounds.contains(hierarchy.getNode(child).bounds));
+        stack.push_back(child);
+      }
+    }
+
+    return numLeaves;
+  }
+
+  std::mt19937 generator{1};
+};
+
+using BoundingVolumeHierarchyDeathTest = BoundingVolumeHierarchyTest;
+
+TEST_F(BoundingVolumeHierarchyTest, InsertsAndRemovesEntities) {
+  quoll::BoundingVolumeHierarchy hierarchy;
+  auto entries = createEntries(100);
+
+  for (const auto &entry : entries) {
+    hierarchy.insert(entry.entity, entry.bounds);
+  }
+
+  EXPECT_EQ(hierarchy.size(), 100);
+  EXPECT_EQ(validate(hierarchy), 100);
+
+  for (usize i = 0; i < entries.size(); i += 2) {
+    hierarchy.remove(entries.at(i).entity);
+  }
+
+  EXPECT_EQ(hierarchy.size(), 50);
+  EXPECT_EQ(validate(hierarchy), 50);
+
+  for (usize i = 0; i < entries.size(); ++i) {
+    EXPECT_EQ(hierarchy.contains(entries.at(i).entity), i % 2 == 1);
+  }
+
+  for (usize i = 1; i < entries.size(); i += 2) {
+    hierarchy.remove(entries.at(i).entity);
+  }
+
+  EXPECT_EQ(hierarchy.size(), 0);
+  EXPECT_EQ(hierarchy.getRoot(), quoll::BoundingVolumeHierarchy::NullNode);
+}
+
+TEST_F(BoundingVolumeHierarchyTest, DoesNotRefitIfBoundsAreInsideMargin) {
+  quoll::BoundingVolumeHierarchy hierarchy;
+  hierarchy.insert(quoll::Entity{1}, createBox(glm::vec3(0.0f)));
+  hierarchy.insert(quoll::Entity{2}, createBox(glm::vec3(5.0f)));
+
+  const auto rootBounds = hierarchy.getNode(hierarchy.getRoot()).bounds;
+
+  auto moved = createBox(
+      glm::vec3(quoll::BoundingVolumeHierarchy::Margin * 0.5f, 0.0f, 0.0f));
+  EXPECT_FALSE(hierarchy.update(quoll::Entity{1}, moved));
+  EXPECT_EQ(hierarchy.getBounds(quoll::Entity{1}).min, moved.min);
+  EXPECT_EQ(hierarchy.getNode(hierarchy.getRoot()).bounds.min,
+            rootBounds.min);
+
+  auto far = createBox(glm::vec3(-10.0f, 0.0f, 0.0f));
+  EXPECT_TRUE(hierarchy.update(quoll::Entity{1}, far));
+  EXPECT_TRUE(hierarchy.getNode(hierarchy.getRoot()).bounds.contains(far));
+  EXPECT_EQ(validate(hierarchy), 2);
+}
+
+TEST_F(BoundingVolumeHierarchyTest, BuildsHierarchyFromEntries) {
+  auto entries = createEntries(1000);
+
+  quoll::BoundingVolumeHierarchy hierarchy;
+  hierarchy.build(entries);
+
+  EXPECT_EQ(hierarchy.size(), entries.size());
+  EXPECT_EQ(validate(hierarchy), entries.size());
+
+  auto result = hierarchy.getEntries();
+  ASSERT_EQ(result.size(), entries.size());
+  for (usize i = 0; i < entries.size(); ++i) {
+    EXPECT_EQ(result.at(i).entity, entries.at(i).entity);
+    EXPECT_EQ(result.at(i).bounds.min, entries.at(i).bounds.min);
+    EXPECT_EQ(result.at(i).bounds.max, entries.at(i).bounds.max);
+  }
+}
+
+TEST_F(BoundingVolumeHierarchyTest, BuildsHierarchyFromBoxesAtSamePosition) {
+  std::vector<quoll::BoundingVolumeHierarchy::Entry> entries;
+  for (u32 i = 1; i <= 10; ++i) {
+    entries.push_back({quoll::Entity{i}, createBox(glm::vec3(1.0f))});
+  }
+
+  quoll::BoundingVolumeHierarchy hierarchy;
+  hierarchy.build(entries);
+
+  EXPECT_EQ(validate(hierarchy), 10);
+}
+
+TEST_F(BoundingVolumeHierarchyTest, RebuiltHierarchyHasLowerCost) {
+  auto entries = createEntries(1000);
+
+  quoll::BoundingVolumeHierarchy hierarchy;
+  hierarchy.build(entries);
+
+  // Teleport every entity to a random position
+  for (auto &entry : entries) {
+    entry.bounds = createBox(randomPosition());
+    hierarchy.update(entry.entity, entry.bounds);
+  }
+  EXPECT_EQ(validate(hierarchy), entries.size());
+
+  quoll::BoundingVolumeHierarchy rebuilt;
+  rebuilt.build(hierarchy.getEntries());
+
+  EXPECT_LT(rebuilt.getCost(), hierarchy.getCost());
+}
+
+TEST_F(BoundingVolumeHierarchyTest, QueriesMatchTestingEveryEntity) {
+  auto entries = createEntries(500);
+
+  quoll::BoundingVolumeHierarchy hierarchy;
+  for (const auto &entry : entries) {
+    hierarchy.insert(entry.entity, entry.bounds);
+  }
+
+  for (usize i = 0; i < entries.size(); i += 3) {
+    entries.at(i).bounds = createBox(randomPosition(), random(0.1f, 2.0f));
+    hierarchy.update(entries.at(i).entity, entries.at(i).bounds);
+  }
+
+  for (u32 query = 0; query < 20; ++query) {
+    auto box = createBox(randomPosition(), random(1.0f, 20.0f));
+
+    std::vector<quoll::Entity> expected;
+    for (const auto &entry : entries) {
+      if (entry.bounds.overlaps(box)) {
+        expected.push_back(entry.entity);
+      }
+    }
+
+    std::vector<quoll::Entity> actual;
+    hierarchy.queryOverlap(box, actual);
+    EXPECT_EQ(sorted(actual), sorted(expected));
+  }
+
+  for (u32 query = 0; query < 20; ++query) {
+    const glm::vec3 origin = randomPosition();
+    const glm::vec3 direction = glm::normalize(glm::vec3(
+        random(-1.0f, 1.0f), random(-1.0f, 1.0f), random(-1.0f, 1.0f)));
+
+    f32 closest = 200.0f;
+    quoll::Entity expected = quoll::Entity::Null;
+    for (const auto &entry : entries) {
+      // Slab test against every box
+      const glm::vec3 t0 = (entry.bounds.min - origin) / direction;
+      const glm::vec3 t1 = (entry.bounds.max - origin) / direction;
+      const glm::vec3 tNear = glm::min(t0, t1);
+      const glm::vec3 tFar = glm::max(t0, t1);
+      const f32 enter = std::max(tNear.x, std::max(tNear.y, tNear.z));
+      const f32 exit = std::min(tFar.x, std::min(tFar.y, tFar.z));
+
+      if (enter <= exit && exit >= 0.0f && std::max(enter, 0.0f) < closest) {
+        closest = std::max(enter, 0.0f);
+        expected = entry.entity;
+      }
+    }
+
+    quoll::CollisionHit hit{};
+    const bool found = hierarchy.raycast(origin, direction, 200.0f, hit);
+    EXPECT_EQ(found, expected != quoll::Entity::Null);
+    if (found) {
+      EXPECT_EQ(hit.entity, expected);
+      EXPECT_NEAR(hit.distance, closest, 0.0001f);
+    }
+  }
+
+  for (u32 query = 0; query < 20; ++query) {
+    const glm::vec3 point = randomPosition();
+
+    f32 closest = std::numeric_limits<f32>::max();
+    for (const auto &entry : entries) {
+      const glm::vec3 surface =
+          glm::clamp(point, entry.bounds.min, entry.bounds.max);
+      closest = std::min(closest, glm::length(point - surface));
+    }
+
+    quoll::CollisionHit hit{};
+    ASSERT_TRUE(hierarchy.findNearest(point, 1000.0f, hit));
+    EXPECT_NEAR(hit.distance, closest, 0.0001f);
+  }
+}
+
+TEST_F(BoundingVolumeHierarchyTest, QueriesEntitiesInFrustum) {
+  quoll::BoundingVolumeHierarchy hierarchy;
+  hierarchy.insert(quoll::Entity{1}, createBox(glm::vec3(0.0f, 0.0f, -5.0f)));
+  hierarchy.insert(quoll::Entity{2}, createBox(glm::vec3(0.0f, 0.0f, 5.0f)));
+  hierarchy.insert(quoll::Entity{3}, createBox(glm::vec3(2.0f, 0.0f, -5.0f)));
+  hierarchy.insert(quoll::Entity{4}, createBox(glm::vec3(50.0f, 0.0f, -5.0f)));
+  hierarchy.insert(quoll::Entity{5},
+                   createBox(glm::vec3(0.0f, 0.0f, -200.0f)));
+
+  // Camera at origin that looks towards -Z
+  auto frustum = quoll::Frustum::fromMatrix(
+      glm::perspective(glm::radians(90.0f), 1.0f, 0.1f, 100.0f));
+
+  std::vector<quoll::Entity> entities;
+  hierarchy.queryFrustum(frustum, entities);
+
+  EXPECT_EQ(sorted(entities),
+            std::vector<quoll::Entity>({quoll::Entity{1}, quoll::Entity{3}}));
+}
+
+TEST_F(BoundingVolumeHierarchyTest, RaycastReturnsNormalOfHitFace) {
+  quoll::BoundingVolumeHierarchy hierarchy;
+  hierarchy.insert(quoll::Entity{1}, createBox(glm::vec3(0.0f, 0.0f, -5.0f)));
+  hierarchy.insert(quoll::Entity{2}, createBox(glm::vec3(0.0f, 0.0f, -8.0f)));
+
+  quoll::CollisionHit hit{};
+  ASSERT_TRUE(hierarchy.raycast(glm::vec3(0.0f),
+                                glm::vec3(0.0f, 0.0f, -1.0f), 100.0f, hit));
+  EXPECT_EQ(hit.entity, quoll::Entity{1});
+  EXPECT_EQ(hit.distance, 4.5f);
+  EXPECT_EQ(hit.normal, glm::vec3(0.0f, 0.0f, 1.0f));
+
+  EXPECT_FALSE(hierarchy.raycast(glm::vec3(0.0f),
+                                 glm::vec3(0.0f, 0.0f, -1.0f), 4.0f, hit));
+  EXPECT_FALSE(hierarchy.raycast(glm::vec3(0.0f),
+                                 glm::vec3(0.0f, 0.0f, 1.0f), 100.0f, hit));
+}
+
+TEST_F(BoundingVolumeHierarchyTest, FindNearestReturnsNothingIfTooFar) {
+  quoll::BoundingVolumeHierarchy hierarchy;
+  hierarchy.insert(quoll::Entity{1}, createBox(glm::vec3(10.0f, 0.0f, 0.0f)));
+
+  quoll::CollisionHit hit{};
+  EXPECT_FALSE(hierarchy.findNearest(glm::vec3(0.0f), 5.0f, hit));
+
+  ASSERT_TRUE(hierarchy.findNearest(glm::vec3(0.0f), 10.0f, hit));
+  EXPECT_EQ(hit.entity, quoll::Entity{1});
+  EXPECT_EQ(hit.distance, 9.5f);
+  EXPECT_EQ(hit.normal, glm::vec3(-1.0f, 0.0f, 0.0f));
+}
+
+TEST_F(BoundingVolumeHierarchyDeathTest, InsertFailsIfEntityExists) {
+  quoll::BoundingVolumeHierarchy hierarchy;
+  hierarchy.insert(quoll::Entity{1}, createBox(glm::vec3(0.0f)));
+
+  EXPECT_DEATH(hierarchy.insert(quoll::Entity{1}, createBox(glm::vec3(0.0f))),
+               ".*");
+}
+
+TEST_F(BoundingVolumeHierarchyDeathTest, UpdateFailsIfEntityDoesNotExist) {
+  quoll::BoundingVolumeHierarchy hierarchy;
+
+  EXPECT_DEATH(hierarchy.update(quoll::Entity{1}, createBox(glm::vec3(0.0f))),
+               ".*");
+}
@@ -90,6 +90,237 @@ TEST_F(SceneUpdaterTest, CalculatesWorldTransformFromParentWorldTransform) {
                 getLocalTransform(child2Transform));
 }
 
+TEST_F(SceneUpdaterTest,
+       CalculatesWorldTransformsOfDeepHierarchyInSingleUpdate) {
+  static constexpr usize NumLevels = 64;
+
+  quoll::LocalTransform transform{};
+  transform.localPosition = glm::vec3(1.0f, 0.5f, 2.5f);
+  transform.localRotation = glm::quat(0.924f, 0.0f, 0.383f, 0.0f);
+
+  std::vector<quoll::Entity> chain(NumLevels);
+  for (auto &entity : chain) {
+    entity = entityDatabase.create();
+    entityDatabase.set(entity, transform);
+    entityDatabase.set<quoll::WorldTransform>(entity, {});
+  }
+
+  // Parents are set from the deepest entity
+  // so that children come before their parents
+  // in the parent pool
+  for (usize i = NumLevels - 1; i > 0; --i) {
+    entityDatabase.set<quoll::Parent>(chain.at(i), {chain.at(i - 1)});
+  }
+
+  sceneUpdater.update(view);
+
+  glm::mat4 expected = getLocalTransform(transform);
+  for (auto entity : chain) {
+    EXPECT_EQ(entityDatabase.get<quoll::WorldTransform>(entity).worldTransform,
+              expected);
+    expected = expected * getLocalTransform(transform);
+  }
+}
+
+TEST_F(SceneUpdaterTest, DoesNotHangIfParentsFormCycle) {
+  quoll::LocalTransform transform{};
+  transform.localPosition = glm::vec3(1.0f, 0.5f, 2.5f);
+
+  auto root = entityDatabase.create();
+  auto a = entityDatabase.create();
+  auto b = entityDatabase.create();
+  auto child = entityDatabase.create();
+  for (auto entity : {root, a, b, child}) {
+    entityDatabase.set(entity, transform);
+    entityDatabase.set<quoll::WorldTransform>(entity, {});
+  }
+
+  // a -> b -> a
+  // b -> child
+  entityDatabase.set<quoll::Parent>(a, {b});
+  entityDatabase.set<quoll::Parent>(b, {a});
+  entityDatabase.set<quoll::Parent>(child, {b});
+
+  sceneUpdater.update(view);
+
+  // Parent of a is ignored to break the cycle
+  EXPECT_EQ(sceneUpdater.getUpdatedEntities(),
+            std::vector<quoll::Entity>({root, a, b, child}));
+
+  auto local = getLocalTransform(transform);
+  EXPECT_EQ(entityDatabase.get<quoll::WorldTransform>(root).worldTransform,
+            local);
+  EXPECT_EQ(entityDatabase.get<quoll::WorldTransform>(a).worldTransform,
+            local);
+  EXPECT_EQ(entityDatabase.get<quoll::WorldTransform>(b).worldTransform,
+            local * local);
+  EXPECT_EQ(entityDatabase.get<quoll::WorldTransform>(child).worldTransform,
+            local * local * local);
+}
+
+TEST_F(SceneUpdaterTest, UpdatesAllTransformsOfDuplicatedScene) {
+  auto entity = entityDatabase.create();
+  quoll::LocalTransform transform{};
+  transform.localPosition = glm::vec3(1.0f, 0.5f, 2.5f);
+  entityDatabase.set(entity, transform);
+  entityDatabase.set<quoll::WorldTransform>(entity, {});
+  sceneUpdater.update(view);
+
+  quoll::Scene duplicate;
+  entityDatabase.duplicate(duplicate.entityDatabase);
+  duplicate.entityDatabase.get<quoll::LocalTransform>(entity).localPosition =
+      glm::vec3(2.0f);
+  quoll::SystemView duplicateView{&duplicate};
+
+  sceneUpdater.update(duplicateView);
+
+  auto &world = duplicate.entityDatabase.get<quoll::WorldTransform>(entity);
+  EXPECT_EQ(sceneUpdater.getNumUpdatedTransforms(), 1);
+  EXPECT_EQ(world.worldTransform,
+            glm::translate(glm::mat4(1.0f), glm::vec3(2.0f)));
+}
+
+TEST_F(SceneUpdaterTest, UpdatesHierarchyOrderWhenParentChanges) {
+  quoll::LocalTransform transform{};
+  transform.localPosition = glm::vec3(1.0f, 0.5f, 2.5f);
+
+  auto root = entityDatabase.create();
+  auto child1 = entityDatabase.create();
+  auto child2 = entityDatabase.create();
+  for (auto entity : {root, child1, child2}) {
+    entityDatabase.set(entity, transform);
+    entityDatabase.set<quoll::WorldTransform>(entity, {});
+  }
+
+  // root -> child1
+  // root -> child2
+  entityDatabase.set<quoll::Parent>(child1, {root});
+  entityDatabase.set<quoll::Parent>(child2, {root});
+  sceneUpdater.update(view);
+
+  // root -> child2 -> child1
+  entityDatabase.set<quoll::Parent>(child1, {child2});
+  sceneUpdater.update(view);
+
+  EXPECT_EQ(entityDatabase.get<quoll::WorldTransform>(child1).worldTransform,
+            getLocalTransform(transform) * getLocalTransform(transform) *
+                getLocalTransform(transform));
+
+  // root
+  // child2 -> child1
+  entityDatabase.remove<quoll::Parent>(child2);
+  sceneUpdater.update(view);
+
+  EXPECT_EQ(entityDatabase.get<quoll::WorldTransform>(child2).worldTransform,
+            getLocalTransform(transform));
+  EXPECT_EQ(entityDatabase.get<quoll::WorldTransform>(child1).worldTransform,
+            getLocalTransform(transform) * getLocalTransform(transform));
+}
+
+TEST_F(SceneUpdaterTest, DoesNotUpdateWorldTransformIfLocalTransformIsClean) {
+  auto entity = entityDatabase.create();
+  entityDatabase.set<quoll::LocalTransform>(entity, {});
+  entityDatabase.set<quoll::WorldTransform>(entity, {});
+  sceneUpdater.update(view);
+  EXPECT_EQ(sceneUpdater.getNumUpdatedTransforms(), 1);
+
+  auto &transform = entityDatabase.get<quoll::LocalTransform>(entity);
+  EXPECT_FALSE(transform.dirty.isDirty());
+
+  transform.localPosition = glm::vec3(1.0f, 0.5f, 2.5f);
+  sceneUpdater.update(view);
+
+  EXPECT_EQ(sceneUpdater.getNumUpdatedTransforms(), 0);
+  EXPECT_EQ(entityDatabase.get<quoll::WorldTransform>(entity).worldTransform,
+            glm::mat4{1.0f});
+}
+
+TEST_F(SceneUpdaterTest, UpdatesWorldTransformIfLocalTransformIsMarkedDirty) {
+  auto entity = entityDatabase.create();
+  entityDatabase.set<quoll::LocalTransform>(entity, {});
+  entityDatabase.set<quoll::WorldTransform>(entity, {});
+  sceneUpdater.update(view);
+
+  auto &transform = entityDatabase.get<quoll::LocalTransform>(entity);
+  transform.localPosition = glm::vec3(1.0f, 0.5f, 2.5f);
+  transform.dirty.mark();
+  sceneUpdater.update(view);
+
+  EXPECT_EQ(sceneUpdater.getNumUpdatedTransforms(), 1);
+  EXPECT_FALSE(transform.dirty.isDirty());
+  EXPECT_EQ(entityDatabase.get<quoll::WorldTransform>(entity).worldTransform,
+            getLocalTransform(transform));
+}
+
+TEST_F(SceneUpdaterTest, UpdatesOnlyDirtySubtrees) {
+  quoll::LocalTransform transform{};
+  transform.localPosition = glm::vec3(1.0f, 0.5f, 2.5f);
+
+  // root1 -> child1 -> grandchild1
+  // root2 -> child2
+  auto root1 = entityDatabase.create();
+  auto child1 = entityDatabase.create();
+  auto grandchild1 = entityDatabase.create();
+  auto root2 = entityDatabase.create();
+  auto child2 = entityDatabase.create();
+  for (auto entity : {root1, child1, grandchild1, root2, child2}) {
+    entityDatabase.set(entity, transform);
+    entityDatabase.set<quoll::WorldTransform>(entity, {});
+  }
+  entityDatabase.set<quoll::Parent>(child1, {root1});
+  entityDatabase.set<quoll::Parent>(grandchild1, {child1});
+  entityDatabase.set<quoll::Parent>(child2, {root2});
+
+  sceneUpdater.update(view);
+  EXPECT_EQ(sceneUpdater.getNumUpdatedTransforms(), 5);
+
+  sceneUpdater.update(view);
+  EXPECT_EQ(sceneUpdater.getNumUpdatedTransforms(), 0);
+
+  auto &root1Transform = entityDatabase.get<quoll::LocalTransform>(root1);
+  root1Transform.localScale = glm::vec3(2.0f);
+  root1Transform.dirty.mark();
+  sceneUpdater.update(view);
+
+  EXPECT_EQ(sceneUpdater.getNumUpdatedTransforms(), 3);
+  EXPECT_EQ(
+      entityDatabase.get<quoll::WorldTransform>(grandchild1).worldTransform,
+      getLocalTransform(root1Transform) * getLocalTransform(transform) *
+          getLocalTransform(transform));
+  EXPECT_EQ(entityDatabase.get<quoll::WorldTransform>(child2).worldTransform,
+            getLocalTransform(transform) * getLocalTransform(transform));
+
+  entityDatabase.set(child2, transform);
+  sceneUpdater.update(view);
+  EXPECT_EQ(sceneUpdater.getNumUpdatedTransforms(), 1);
+}
+
+TEST_F(SceneUpdaterTest, DoesNotUpdateTransformsThatAreMovedInStorage) {
+  quoll::LocalTransform transform{};
+  transform.localPosition = glm::vec3(1.0f, 0.5f, 2.5f);
+
+  std::vector<quoll::Entity> entities(8);
+  for (auto &entity : entities) {
+    entity = entityDatabase.create();
+    entityDatabase.set(entity, transform);
+    entityDatabase.set<quoll::WorldTransform>(entity, {});
+  }
+
+  sceneUpdater.update(view);
+  EXPECT_EQ(sceneUpdater.getNumUpdatedTransforms(), 8);
+
+  // Last transform is moved to the removed one
+  entityDatabase.remove<quoll::LocalTransform>(entities.at(0));
+
+  // Pool grows and moves all transforms
+  for (usize i = 0; i < 16; ++i) {
+    entityDatabase.set(entityDatabase.create(), transform);
+  }
+
+  sceneUpdater.update(view);
+  EXPECT_EQ(sceneUpdater.getNumUpdatedTransforms(), 0);
+}
+
 TEST_F(SceneUpdaterTest,
        CalculatesWorldBasedOnParentIfJointAttachmentIsInvalid) {
   // parent
@@ -0,0 +1,120 @@
+#include "quoll/core/Base.h"
+#include "quoll/core/ThreadPool.h"
+#include "quoll/scene/SpatialIndex.h"
+#include "quoll-tests/Testing.h"
+
+class SpatialIndexTest : public ::testing::Test {
+public:
+  quoll::BoundingBox createBox(glm::vec3 center) {
+    return {center - glm::vec3(0.5f), center + glm::vec3(0.5f)};
+  }
+
+  void addEntities(u32 count) {
+    for (u32 i = 1; i <= count; ++i) {
+      spatialIndex.set(quoll::Entity{i},
+                       createBox(glm::vec3(static_cast<f32>(i) * 2.0f)));
+    }
+  }
+
+  quoll::SpatialIndex spatialIndex;
+};
+
+TEST_F(SpatialIndexTest, SetAddsEntityIfItDoesNotExist) {
+  spatialIndex.set(quoll::Entity{5}, createBox(glm::vec3(1.0f)));
+
+  EXPECT_TRUE(spatialIndex.contains(quoll::Entity{5}));
+  EXPECT_EQ(spatialIndex.size(), 1);
+  EXPECT_EQ(spatialIndex.getNumRefits(), 0);
+
+  spatialIndex.set(quoll::Entity{5}, createBox(glm::vec3(10.0f)));
+  EXPECT_EQ(spatialIndex.size(), 1);
+  EXPECT_EQ(spatialIndex.getNumRefits(), 1);
+  EXPECT_EQ(spatialIndex.getHierarchy().getBounds(quoll::Entity{5}).min,
+            glm::vec3(9.5f));
+
+  spatialIndex.remove(quoll::Entity{5});
+  EXPECT_FALSE(spatialIndex.contains(quoll::Entity{5}));
+  EXPECT_EQ(spatialIndex.size(), 0);
+}
+
+TEST_F(SpatialIndexTest, RebuildsHierarchyWhenEnoughEntitiesAreRefitted) {
+  quoll::ThreadPool threadPool(0);
+  addEntities(8);
+
+  spatialIndex.set(quoll::Entity{1}, createBox(glm::vec3(100.0f)));
+  spatialIndex.update(threadPool);
+  EXPECT_EQ(spatialIndex.getNumRefits(), 1);
+
+  spatialIndex.set(quoll::Entity{2}, createBox(glm::vec3(-100.0f)));
+  spatialIndex.update(threadPool);
+
+  EXPECT_EQ(spatialIndex.getNumRefits(), 0);
+  EXPECT_FALSE(spatialIndex.isRebuilding());
+  EXPECT_EQ(spatialIndex.size(), 8);
+  EXPECT_EQ(spatialIndex.getHierarchy().getBounds(quoll::Entity{1}).min,
+            glm::vec3(99.5f));
+}
+
+TEST_F(SpatialIndexTest, AppliesChangesThatHappenDuringRebuild) {
+  quoll::ThreadPool threadPool(1);
+  addEntities(8);
+
+  // Rebuild job waits in the queue
+  // until changes are made
+  std::promise<void> blocker;
+  auto blocked = blocker.get_future().share();
+  threadPool.submit([blocked] { blocked.wait(); });
+
+  spatialIndex.rebuild(threadPool);
+  EXPECT_TRUE(spatialIndex.isRebuilding());
+
+  spatialIndex.set(quoll::Entity{1}, createBox(glm::vec3(100.0f)));
+  spatialIndex.remove(quoll::Entity{2});
+  spatialIndex.set(quoll::Entity{20}, createBox(glm::vec3(-100.0f)));
+
+  blocker.set_value();
+  while (spatialIndex.isRebuilding()) {
+    std::this_thread::yield();
+    spatialIndex.update(threadPool);
+  }
+
+  EXPECT_EQ(spatialIndex.size(), 8);
+  EXPECT_EQ(spatialIndex.getHierarchy().getBounds(quoll::Entity{1}).min,
+            glm::vec3(99.5f));
+  EXPECT_FALSE(spatialIndex.contains(quoll::Entity{2}));
+  EXPECT_TRUE(spatialIndex.contains(quoll::Entity{20}));
+
+  std::vector<quoll::Entity> entities;
+  spatialIndex.queryOverlap(createBox(glm::vec3(100.0f)), entities);
+  EXPECT_EQ(entities, std::vector<quoll::Entity>{quoll::Entity{1}});
+}
+
+TEST_F(SpatialIndexTest, UsesRecycledEntityHandlesChangedDuringRebuild) {
+  quoll::ThreadPool threadPool(1);
+  addEntities(8);
+
+  std::promise<void> blocker;
+  auto blocked = blocker.get_future().share();
+  threadPool.submit([blocked] { blocked.wait(); });
+
+  spatialIndex.rebuild(threadPool);
+  EXPECT_TRUE(spatialIndex.isRebuilding());
+
+  // Index of entity is recycled by a new
+  // entity while hierarchy is rebuilt
+  auto recycled = quoll::makeEntity(1, 1);
+  spatialIndex.remove(quoll::Entity{1});
+  spatialIndex.set(recycled, createBox(glm::vec3(100.0f)));
+
+  blocker.set_value();
+  while (spatialIndex.isRebuilding()) {
+    std::this_thread::yield();
+    spatialIndex.update(threadPool);
+  }
+
+  EXPECT_EQ(spatialIndex.size(), 8);
+
+  std::vector<quoll::Entity> entities;
+  spatialIndex.queryOverlap(createBox(glm::vec3(100.0f)), entities);
+  EXPECT_EQ(entities, std::vector<quoll::Entity>{recycled});
+}
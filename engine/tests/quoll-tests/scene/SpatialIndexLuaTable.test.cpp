@@ -0,0 +1,63 @@
+#include "quoll/core/Base.h"
+#include "quoll/core/Name.h"
+#include "quoll-tests/Testing.h"
+#include "quoll-tests/test-utils/ScriptingInterfaceTestBase.h"
+
+class SpatialIndexLuaTableTest : public LuaScriptingInterfaceTestBase {
+public:
+  SpatialIndexLuaTableTest()
+      : LuaScriptingInterfaceTestBase("spatial-index-service.lua") {}
+
+  quoll::Entity createIndexedEntity(quoll::String name, glm::vec3 center) {
+    auto entity = entityDatabase.create();
+    entityDatabase.set<quoll::Name>(entity, {name});
+    scene.spatialIndex.set(entity, {center - glm::vec3(1.0f),
+                                    center + glm::vec3(1.0f)});
+    return entity;
+  }
+};
+
+TEST_F(SpatialIndexLuaTableTest, RaycastReturnsFalseIfNothingIsHit) {
+  createIndexedEntity("Above", glm::vec3(0.0f, 10.0f, 0.0f));
+
+  auto entity = entityDatabase.create();
+  auto state = call(entity, "raycast");
+
+  EXPECT_TRUE(state["raycastOutput"].is<bool>());
+  EXPECT_FALSE(state["raycastOutput"].get<bool>());
+  EXPECT_TRUE(state["raycastDistance"].is<sol::nil_t>());
+}
+
+TEST_F(SpatialIndexLuaTableTest, RaycastReturnsClosestHit) {
+  createIndexedEntity("Far", glm::vec3(20.0f, 0.0f, 0.0f));
+  createIndexedEntity("Near", glm::vec3(10.0f, 0.0f, 0.0f));
+
+  auto entity = entityDatabase.create();
+  auto state = call(entity, "raycast");
+
+  EXPECT_TRUE(state["raycastOutput"].get<bool>());
+  EXPECT_EQ(state["raycastDistance"].get<f32>(), 9.0f);
+  EXPECT_EQ(state["raycastEntityName"].get<quoll::String>(), "Near");
+}
+
+TEST_F(SpatialIndexLuaTableTest, FindNearestReturnsClosestEntity) {
+  createIndexedEntity("Origin", glm::vec3(0.0f));
+  createIndexedEntity("Above", glm::vec3(0.0f, 15.0f, 0.0f));
+
+  auto entity = entityDatabase.create();
+  auto state = call(entity, "findNearest");
+
+  EXPECT_TRUE(state["nearestOutput"].get<bool>());
+  EXPECT_EQ(state["nearestEntityName"].get<quoll::String>(), "Above");
+}
+
+TEST_F(SpatialIndexLuaTableTest, QueryBoxReturnsOverlappingEntities) {
+  createIndexedEntity("A", glm::vec3(0.0f));
+  createIndexedEntity("B", glm::vec3(10.0f, 0.0f, 0.0f));
+  createIndexedEntity("C", glm::vec3(0.0f, 10.0f, 0.0f));
+
+  auto entity = entityDatabase.create();
+  auto state = call(entity, "queryBox");
+
+  EXPECT_EQ(state["numEntitiesInBox"].get<u32>(), 2);
+}
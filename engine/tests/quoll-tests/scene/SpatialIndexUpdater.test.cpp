@@ -0,0 +1,120 @@
+#include "quoll/core/Base.h"
+#include "quoll/asset/AssetCache.h"
+#include "quoll/entity/EntityDatabase.h"
+#include "quoll/renderer/Mesh.h"
+#include "quoll/scene/Scene.h"
+#include "quoll/scene/SpatialIndexUpdater.h"
+#include "quoll/scene/WorldTransform.h"
+#include "quoll/skeleton/Skeleton.h"
+#include "quoll/system/SystemView.h"
+#include "quoll-tests/Testing.h"
+#include "quoll-tests/test-utils/AssetCacheUtils.h"
+
+class SpatialIndexUpdaterTest : public ::testing::Test {
+public:
+  SpatialIndexUpdaterTest() : assetCache("/") {
+    quoll::MeshAsset mesh;
+    mesh.geometries.resize(2);
+    mesh.geometries.at(0).bounds = {glm::vec3(-1.0f), glm::vec3(0.0f)};
+    mesh.geometries.at(1).bounds = {glm::vec3(0.0f), glm::vec3(1.0f)};
+    meshAsset = createAssetInCache(assetCache, mesh);
+  }
+
+  quoll::Entity createMeshEntity(glm::vec3 position) {
+    auto entity = entityDatabase.create();
+    entityDatabase.set<quoll::Mesh>(entity, {meshAsset});
+    entityDatabase.set<quoll::WorldTransform>(
+        entity, {glm::translate(glm::mat4{1.0f}, position)});
+    return entity;
+  }
+
+  const quoll::BoundingBox &getBounds(quoll::Entity entity) {
+    return scene.spatialIndex.getHierarchy().getBounds(entity);
+  }
+
+  quoll::AssetCache assetCache;
+  quoll::AssetRef<quoll::MeshAsset> meshAsset;
+
+  quoll::Scene scene;
+  quoll::EntityDatabase &entityDatabase = scene.entityDatabase;
+  quoll::SystemView view{&scene};
+
+  quoll::SpatialIndexUpdater spatialIndexUpdater;
+};
+
+TEST_F(SpatialIndexUpdaterTest, AddsWorldBoundsOfAllGeometries) {
+  auto entity = createMeshEntity(glm::vec3(5.0f, 0.0f, 0.0f));
+
+  spatialIndexUpdater.update(view, {});
+
+  ASSERT_TRUE(scene.spatialIndex.contains(entity));
+  EXPECT_EQ(getBounds(entity).min, glm::vec3(4.0f, -1.0f, -1.0f));
+  EXPECT_EQ(getBounds(entity).max, glm::vec3(6.0f, 1.0f, 1.0f));
+}
+
+TEST_F(SpatialIndexUpdaterTest, OnlyUpdatesEntitiesWithUpdatedTransforms) {
+  auto entity1 = createMeshEntity(glm::vec3(0.0f));
+  auto entity2 = createMeshEntity(glm::vec3(0.0f));
+  spatialIndexUpdater.update(view, {});
+
+  // Transforms are written in place by
+  // scene updater; so, versions do not change
+  entityDatabase.get<quoll::WorldTransform>(entity1).worldTransform =
+      glm::translate(glm::mat4{1.0f}, glm::vec3(10.0f));
+  entityDatabase.get<quoll::WorldTransform>(entity2).worldTransform =
+      glm::translate(glm::mat4{1.0f}, glm::vec3(10.0f));
+
+  std::vector<quoll::Entity> updated{entity1};
+  spatialIndexUpdater.update(view, updated);
+
+  EXPECT_EQ(getBounds(entity1).min, glm::vec3(9.0f));
+  EXPECT_EQ(getBounds(entity2).min, glm::vec3(-1.0f));
+}
+
+TEST_F(SpatialIndexUpdaterTest, UpdatesAllEntitiesOfDuplicatedScene) {
+  auto entity = createMeshEntity(glm::vec3(0.0f));
+  spatialIndexUpdater.update(view, {});
+
+  quoll::Scene duplicate;
+  entityDatabase.duplicate(duplicate.entityDatabase);
+  quoll::SystemView duplicateView{&duplicate};
+
+  spatialIndexUpdater.update(duplicateView, {});
+
+  EXPECT_TRUE(duplicate.spatialIndex.contains(entity));
+}
+
+TEST_F(SpatialIndexUpdaterTest, RemovesEntitiesWithoutMeshes) {
+  auto entity1 = createMeshEntity(glm::vec3(0.0f));
+  auto entity2 = createMeshEntity(glm::vec3(0.0f));
+  spatialIndexUpdater.update(view, {});
+  EXPECT_EQ(scene.spatialIndex.size(), 2);
+
+  entityDatabase.remove<quoll::Mesh>(entity1);
+  entityDatabase.deleteEntity(entity2);
+  spatialIndexUpdater.update(view, {});
+
+  EXPECT_EQ(scene.spatialIndex.size(), 0);
+}
+
+TEST_F(SpatialIndexUpdaterTest, AddsBoundsOfAllJointsForSkinnedMeshes) {
+  auto entity = createMeshEntity(glm::vec3(0.0f));
+
+  quoll::Skeleton skeleton{};
+  skeleton.jointFinalTransforms.push_back(glm::mat4{1.0f});
+  skeleton.jointFinalTransforms.push_back(
+      glm::translate(glm::mat4{1.0f}, glm::vec3(0.0f, 5.0f, 0.0f)));
+  entityDatabase.set(entity, skeleton);
+
+  spatialIndexUpdater.update(view, {});
+  EXPECT_EQ(getBounds(entity).min, glm::vec3(-1.0f));
+  EXPECT_EQ(getBounds(entity).max, glm::vec3(1.0f, 6.0f, 1.0f));
+
+  // Joints are updated without transform changes
+  entityDatabase.get<quoll::Skeleton>(entity).jointFinalTransforms.at(1) =
+      glm::translate(glm::mat4{1.0f}, glm::vec3(0.0f, -5.0f, 0.0f));
+  spatialIndexUpdater.update(view, {});
+
+  EXPECT_EQ(getBounds(entity).min, glm::vec3(-1.0f, -6.0f, -1.0f));
+  EXPECT_EQ(getBounds(entity).max, glm::vec3(1.0f));
+}
@@ -0,0 +1,158 @@
+#include "quoll/core/Base.h"
+#include "quoll/scene/TransformKernel.h"
+#include "quoll-tests/Testing.h"
+
+using IS = quoll::TransformKernelInstructionSet;
+
+class TransformKernelTest : public ::testing::TestWithParam<IS> {
+public:
+  void SetUp() override {
+    if (!quoll::TransformKernel::isSupported(GetParam())) {
+      GTEST_SKIP() << "Instruction set is not supported by the CPU";
+    }
+
+    mPreviousInstructionSet = quoll::TransformKernel::getInstructionSet();
+    quoll::TransformKernel::setInstructionSet(GetParam());
+  }
+
+  void TearDown() override {
+    quoll::TransformKernel::setInstructionSet(mPreviousInstructionSet);
+  }
+
+  f32 random() { return distribution(generator); }
+
+  glm::vec3 randomVec3() { return glm::vec3(random(), random(), random()); }
+
+  glm::quat randomQuat() {
+    glm::quat q(random(), random(), random(), random());
+    f32 length = std::sqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+    return glm::quat(q.w / length, q.x / length, q.y / length, q.z / length);
+  }
+
+  glm::mat4 randomMat4() {
+    glm::mat4 matrix{1.0f};
+    for (glm::length_t i = 0; i < 4; ++i) {
+      matrix[i] = glm::vec4(random(), random(), random(), random());
+    }
+    return matrix;
+  }
+
+  std::mt19937 generator{7};
+  std::uniform_real_distribution<f32> distribution{-10.0f, 10.0f};
+
+private:
+  IS mPreviousInstructionSet = IS::Scalar;
+};
+
+using TransformKernelDeathTest = TransformKernelTest;
+
+TEST_P(TransformKernelTest, ComposesTransformsEqualToGlm) {
+  // Sizes cover empty batches, partial
+  // batches, and multiple full batches
+  for (usize count : {0, 1, 3, 4, 5, 8, 9, 16, 17, 33}) {
+    std::vector<glm::vec3> positions(count);
+    std::vector<glm::quat> rotations(count);
+    std::vector<glm::vec3> scales(count);
+    for (usize i = 0; i < count; ++i) {
+      positions.at(i) = randomVec3();
+      rotations.at(i) = randomQuat();
+      scales.at(i) = randomVec3();
+    }
+
+    std::vector<glm::mat4> transforms(count, glm::mat4{0.0f});
+    quoll::TransformKernel::compose(positions, rotations, scales, transforms);
+
+    for (usize i = 0; i < count; ++i) {
+      const glm::mat4 identity{1.0f};
+      const glm::mat4 expected = glm::translate(identity, positions.at(i)) *
+                                 glm::toMat4(rotations.at(i)) *
+                                 glm::scale(identity, scales.at(i));
+
+      EXPECT_EQ(transforms.at(i), expected) << "Count " << count << " index "
+                                            << i;
+    }
+  }
+}
+
+TEST_P(TransformKernelTest, MultipliesMatricesEqualToGlm) {
+  for (usize count : {0, 1, 2, 3, 8, 17}) {
+    std::vector<glm::mat4> lhs(count);
+    std::vector<glm::mat4> rhs(count);
+    for (usize i = 0; i < count; ++i) {
+      lhs.at(i) = randomMat4();
+      rhs.at(i) = randomMat4();
+    }
+
+    std::vector<glm::mat4> result(count, glm::mat4{0.0f});
+    quoll::TransformKernel::multiply(lhs, rhs, result);
+
+    for (usize i = 0; i < count; ++i) {
+      EXPECT_EQ(result.at(i), lhs.at(i) * rhs.at(i))
+          << "Count " << count << " index " << i;
+    }
+  }
+}
+
+TEST_P(TransformKernelTest, MultipliesMatricesInPlace) {
+  static constexpr usize Count = 9;
+
+  std::vector<glm::mat4> lhs(Count);
+  std::vector<glm::mat4> rhs(Count);
+  for (usize i = 0; i < Count; ++i) {
+    lhs.at(i) = randomMat4();
+    rhs.at(i) = randomMat4();
+  }
+
+  std::vector<glm::mat4> expected(Count);
+  for (usize i = 0; i < Count; ++i) {
+    expected.at(i) = lhs.at(i) * rhs.at(i);
+  }
+
+  auto rhsResult = rhs;
+  quoll::TransformKernel::multiply(lhs, rhsResult, rhsResult);
+  EXPECT_EQ(rhsResult, expected);
+
+  auto lhsResult = lhs;
+  quoll::TransformKernel::multiply(lhsResult, rhs, lhsResult);
+  EXPECT_EQ(lhsResult, expected);
+}
+
+TEST_P(TransformKernelDeathTest, ComposeFailsIfSpanSizesAreDifferent) {
+  std::vector<glm::vec3> positions(2);
+  std::vector<glm::quat> rotations(2);
+  std::vector<glm::vec3> scales(2);
+  std::vector<glm::mat4> transforms(3);
+
+  EXPECT_DEATH(
+      quoll::TransformKernel::compose(positions, rotations, scales, transforms),
+      ".*");
+}
+
+TEST_P(TransformKernelDeathTest, MultiplyFailsIfSpanSizesAreDifferent) {
+  std::vector<glm::mat4> lhs(2);
+  std::vector<glm::mat4> rhs(3);
+  std::vector<glm::mat4> result(2);
+
+  EXPECT_DEATH(quoll::TransformKernel::multiply(lhs, rhs, result), ".*");
+}
+
+static const auto InstructionSets = ::testing::Values(IS::Scalar, IS::SSE,
+                                                      IS::AVX2);
+
+static const auto InstructionSetName =
+    [](const ::testing::TestParamInfo<IS> &info) -> quoll::String {
+  switch (info.param) {
+  case IS::SSE:
+    return "SSE";
+  case IS::AVX2:
+    return "AVX2";
+  default:
+    return "Scalar";
+  }
+};
+
+INSTANTIATE_TEST_SUITE_P(TransformKernelTest, TransformKernelTest,
+                         InstructionSets, InstructionSetName);
+
+INSTANTIATE_TEST_SUITE_P(TransformKernelDeathTest, TransformKernelDeathTest,
+                         InstructionSets, InstructionSetName);
@@ -24,6 +24,18 @@ TEST_F(TransformLuaTableTest, GetsPositionValue) {
             glm::vec3(2.5f, 0.2f, 0.5f));
 }
 
+TEST_F(TransformLuaTableTest, GetPositionDoesNotMarkTransformAsDirty) {
+  auto entity = entityDatabase.create();
+  entityDatabase.set<quoll::LocalTransform>(entity,
+                                            {glm::vec3(2.5f, 0.2f, 0.5f)});
+  entityDatabase.get<quoll::LocalTransform>(entity).dirty.clear();
+
+  call(entity, "localTransformPositionGet");
+
+  EXPECT_FALSE(
+      entityDatabase.get<quoll::LocalTransform>(entity).dirty.isDirty());
+}
+
 TEST_F(TransformLuaTableDeathTest, SetPositionFailsIfComponentDoesNotExist) {
   auto entity = entityDatabase.create();
   EXPECT_DEATH(call(entity, "localTransformPositionSet"), ".*");
@@ -40,6 +52,18 @@ TEST_F(TransformLuaTableTest, SetsPositionValue) {
             glm::vec3(2.5f, 3.5f, 0.2f));
 }
 
+TEST_F(TransformLuaTableTest, SetPositionMarksTransformAsDirty) {
+  auto entity = entityDatabase.create();
+  entityDatabase.set<quoll::LocalTransform>(entity,
+                                            {glm::vec3(1.5f, 0.2f, 0.5f)});
+  entityDatabase.get<quoll::LocalTransform>(entity).dirty.clear();
+
+  call(entity, "localTransformPositionSet");
+
+  EXPECT_TRUE(
+      entityDatabase.get<quoll::LocalTransform>(entity).dirty.isDirty());
+}
+
 TEST_F(TransformLuaTableTest, SetPositionValuesInvidiually) {
   auto entity = entityDatabase.create();
   entityDatabase.set<quoll::LocalTransform>(entity,
@@ -0,0 +1,261 @@
+#include "quoll/core/Base.h"
+#include "quoll/animation/Animator.h"
+#include "quoll/renderer/Mesh.h"
+#include "quoll/renderer/MeshRenderer.h"
+#include "quoll/scene/AutoAspectRatio.h"
+#include "quoll/scene/Camera.h"
+#include "quoll/scene/DirectionalLight.h"
+#include "quoll/scene/LocalTransform.h"
+#include "quoll/scene/Parent.h"
+#include "quoll/scene/PerspectiveLens.h"
+#include "quoll/scene/WorldTransform.h"
+#include "quoll/skeleton/JointAttachment.h"
+#include "quoll/skeleton/Skeleton.h"
+#include "quoll/system/SystemScheduler.h"
+#include "quoll/system/SystemView.h"
+#include "quoll-tests/Testing.h"
+
+class SystemSchedulerTest : public ::testing::Test {
+public:
+  quoll::Scene scene;
+  quoll::SystemView view{&scene};
+
+  quoll::ThreadPool threadPool{4};
+  quoll::SystemScheduler scheduler{threadPool};
+};
+
+TEST(SystemAccessTest, AccessesConflictIfEitherWritesComponentOfOther) {
+  using namespace quoll;
+
+  auto readLocal = SystemAccess().read<LocalTransform>();
+  auto writeLocal = SystemAccess().write<LocalTransform>();
+  auto writeWorld = SystemAccess().read<Parent>().write<WorldTransform>();
+
+  EXPECT_FALSE(readLocal.conflicts(readLocal));
+  EXPECT_FALSE(writeLocal.conflicts(writeWorld));
+  EXPECT_FALSE(readLocal.conflicts(writeWorld));
+  EXPECT_TRUE(readLocal.conflicts(writeLocal));
+  EXPECT_TRUE(writeLocal.conflicts(readLocal));
+  EXPECT_TRUE(writeLocal.conflicts(writeLocal));
+  EXPECT_TRUE(writeWorld.conflicts(SystemAccess().read<WorldTransform>()));
+}
+
+TEST(SystemAccessTest, ExclusiveAccessConflictsWithAllAccesses) {
+  using namespace quoll;
+
+  auto exclusive = SystemAccess().exclusive();
+
+  EXPECT_TRUE(exclusive.conflicts(SystemAccess()));
+  EXPECT_TRUE(SystemAccess().conflicts(exclusive));
+  EXPECT_TRUE(exclusive.conflicts(SystemAccess().read<Parent>()));
+}
+
+TEST(SystemAccessTest, StructuralAccessConflictsWithAccessesOfGroup) {
+  using namespace quoll;
+
+  auto addLocal = SystemAccess().structural<LocalTransform>();
+  auto addParent = SystemAccess().structural<Parent>();
+  auto addMesh = SystemAccess().structural<Mesh>();
+
+  EXPECT_TRUE(addLocal.conflicts(SystemAccess().read<LocalTransform>()));
+  EXPECT_TRUE(addLocal.conflicts(SystemAccess().read<WorldTransform>()));
+  EXPECT_TRUE(SystemAccess().write<WorldTransform>().conflicts(addLocal));
+  EXPECT_TRUE(addParent.conflicts(SystemAccess().read<Parent>()));
+  EXPECT_FALSE(addLocal.conflicts(addParent));
+  EXPECT_FALSE(addLocal.conflicts(addMesh));
+  EXPECT_FALSE(addParent.conflicts(SystemAccess().read<WorldTransform>()));
+  EXPECT_FALSE(SystemAccess().conflicts(addLocal));
+}
+
+TEST_F(SystemSchedulerTest, AddsDependenciesOnPreviousConflictingSystems) {
+  using namespace quoll;
+
+  auto noop = [](f32, SystemView &) {};
+  scheduler.add("A", SystemAccess().write<LocalTransform>(), noop);
+  scheduler.add("B", SystemAccess().write<Parent>(), noop);
+  scheduler.add("C", SystemAccess().read<LocalTransform, Parent>(), noop);
+  scheduler.add("D", SystemAccess().read<LocalTransform>(), noop);
+  scheduler.add("E", SystemAccess().exclusive(), noop);
+
+  EXPECT_EQ(scheduler.getNumSystems(), 5);
+  EXPECT_EQ(scheduler.getNumDependencies(0), 0);
+  EXPECT_EQ(scheduler.getNumDependencies(1), 0);
+  EXPECT_EQ(scheduler.getNumDependencies(2), 2);
+  EXPECT_EQ(scheduler.getNumDependencies(3), 1);
+  EXPECT_EQ(scheduler.getNumDependencies(4), 4);
+}
+
+TEST_F(SystemSchedulerTest, RunsConflictingSystemsInOrderOfAddition) {
+  using namespace quoll;
+
+  std::vector<u32> order;
+  for (u32 i = 0; i < 10; ++i) {
+    auto access = i % 3 == 0 ? SystemAccess().exclusive()
+                             : SystemAccess().write<LocalTransform>();
+
+    scheduler.add("System", access,
+                  [&order, i](f32, SystemView &) { order.push_back(i); });
+  }
+
+  for (u32 frame = 0; frame < 10; ++frame) {
+    order.clear();
+    scheduler.run(0.0f, view);
+
+    EXPECT_EQ(order, std::vector<u32>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+  }
+}
+
+TEST_F(SystemSchedulerTest, RunsIndependentSystemsConcurrently) {
+  using namespace quoll;
+
+  // Both systems wait until the other one starts,
+  // which only succeeds if they run at the same time
+  std::atomic<u32> started{0};
+  std::atomic<u32> overlapped{0};
+  auto system = [&started, &overlapped](f32, SystemView &) {
+    started++;
+
+    auto start = std::chrono::steady_clock::now();
+    while (started < 2 &&
+           std::chrono::steady_clock::now() - start < std::chrono::seconds(5)) {
+      std::this_thread::yield();
+    }
+
+    if (started == 2) {
+      overlapped++;
+    }
+  };
+
+  scheduler.add("A", SystemAccess().write<LocalTransform>(), system);
+  scheduler.add("B", SystemAccess().write<WorldTransform>(), system);
+  scheduler.run(0.0f, view);
+
+  EXPECT_EQ(overlapped, 2);
+}
+
+TEST_F(SystemSchedulerTest, RunsSystemsThatAddDifferentComponentsConcurrently) {
+  using namespace quoll;
+
+  auto &entityDatabase = scene.entityDatabase;
+  std::vector<Entity> entities;
+  for (u32 i = 0; i < 1000; ++i) {
+    auto entity = entityDatabase.create();
+    entityDatabase.set<WorldTransform>(entity, {});
+    entityDatabase.set<MeshRenderer>(entity, {});
+    entities.push_back(entity);
+  }
+
+  std::atomic<u32> started{0};
+  auto waitForOther = [&started]() {
+    started++;
+
+    auto start = std::chrono::steady_clock::now();
+    while (started < 2 &&
+           std::chrono::steady_clock::now() - start < std::chrono::seconds(5)) {
+      std::this_thread::yield();
+    }
+  };
+
+  // Mask words of entities are shared between
+  // both components and both systems add
+  // entities to groups
+  scheduler.add("A", SystemAccess().structural<LocalTransform>(),
+                [&](f32, SystemView &view) {
+                  waitForOther();
+                  for (auto entity : entities) {
+                    view.scene->entityDatabase.set<LocalTransform>(entity, {});
+                  }
+                });
+  scheduler.add("B", SystemAccess().structural<Mesh>(),
+                [&](f32, SystemView &view) {
+                  waitForOther();
+                  for (auto entity : entities) {
+                    view.scene->entityDatabase.set<Mesh>(entity, {});
+                  }
+                });
+  scheduler.run(0.0f, view);
+
+  EXPECT_EQ(scheduler.getNumDependencies(1), 0);
+  EXPECT_EQ(started, 2);
+  EXPECT_EQ((entityDatabase.getGroupSize<LocalTransform, WorldTransform>()),
+            entities.size());
+  EXPECT_EQ((entityDatabase.getGroupSize<Mesh, MeshRenderer>()),
+            entities.size());
+}
+
+TEST_F(SystemSchedulerTest, RunsIndependentEnginePrepareSystemsConcurrently) {
+  using namespace quoll;
+
+  // Accesses of prepare systems of main engine modules
+  auto noop = [](f32, SystemView &) {};
+  scheduler.add("EntityDeleter", SystemAccess().exclusive(), noop);
+  scheduler.add(
+      "CameraAspectRatioUpdater",
+      SystemAccess().read<AutoAspectRatio>().write<PerspectiveLens>(), noop);
+  scheduler.add("SkeletonUpdater",
+                SystemAccess()
+                    .read<SkeletonAssetRef>()
+                    .write<SkeletonDebug>()
+                    .structural<Skeleton, SkeletonCurrentAsset>(),
+                noop);
+  scheduler.add(
+      "SceneUpdater",
+      SystemAccess()
+          .read<Parent, JointAttachment, Skeleton, PerspectiveLens>()
+          .write<LocalTransform, WorldTransform, Camera, DirectionalLight>(),
+      noop);
+  scheduler.add("SpatialIndexUpdater",
+                SystemAccess()
+                    .read<WorldTransform, Mesh, Skeleton>()
+                    .write<SpatialIndex>(),
+                noop);
+  scheduler.add("AnimationSystem::prepare",
+                SystemAccess()
+                    .read<AnimatorAssetRef>()
+                    .structural<Animator, AnimatorCurrentAsset>(),
+                noop);
+
+  // Skeleton updater runs alongside camera aspect ratio
+  // updater and animation prepare runs alongside all
+  // systems except entity deleter
+  EXPECT_EQ(scheduler.getNumDependencies(1), 1);
+  EXPECT_EQ(scheduler.getNumDependencies(2), 1);
+  EXPECT_EQ(scheduler.getNumDependencies(3), 3);
+  EXPECT_EQ(scheduler.getNumDependencies(4), 3);
+  EXPECT_EQ(scheduler.getNumDependencies(5), 1);
+}
+
+TEST_F(SystemSchedulerTest, PassesTimeDeltaAndViewToSystems) {
+  using namespace quoll;
+
+  f32 dt = 0.0f;
+  SystemView *systemView = nullptr;
+  scheduler.add("A", SystemAccess(), [&dt, &systemView](f32 t, SystemView &v) {
+    dt = t;
+    systemView = &v;
+  });
+  scheduler.run(0.25f, view);
+
+  EXPECT_EQ(dt, 0.25f);
+  EXPECT_EQ(systemView, &view);
+}
+
+TEST(SystemSchedulerNoThreadsTest, RunsSystemsInCallingThread) {
+  using namespace quoll;
+
+  Scene scene;
+  SystemView view{&scene};
+  ThreadPool threadPool(0);
+  SystemScheduler scheduler(threadPool);
+
+  std::vector<std::thread::id> threads;
+  for (u32 i = 0; i < 3; ++i) {
+    scheduler.add("System", SystemAccess(), [&threads](f32, SystemView &) {
+      threads.push_back(std::this_thread::get_id());
+    });
+  }
+  scheduler.run(0.0f, view);
+
+  EXPECT_EQ(threads,
+            std::vector<std::thread::id>(3, std::this_thread::get_id()));
+}
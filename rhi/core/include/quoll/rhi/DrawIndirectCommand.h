@@ -0,0 +1,24 @@
+#pragma once
+
+namespace quoll::rhi {
+
+/**
+ * @brief Indexed indirect draw command
+ *
+ * Layout matches native indexed indirect
+ * commands; so, arrays of commands can be
+ * copied to indirect buffers as they are
+ */
+struct DrawIndexedIndirectCommand {
+  u32 indexCount = 0;
+
+  u32 instanceCount = 0;
+
+  u32 firstIndex = 0;
+
+  i32 vertexOffset = 0;
+
+  u32 firstInstance = 0;
+};
+
+} // namespace quoll::rhi
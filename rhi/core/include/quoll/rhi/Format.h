@@ -8,6 +8,10 @@ enum Format {
   Rgba8Srgb,
   Bgra8Srgb,
   Rgba16Float,
+  Rg16Snorm,
+  Rg16Float,
+  Rgba16Unorm,
+  Rgba16Uint,
   Rg32Float,
   Rgb32Float,
   Rgba32Float,
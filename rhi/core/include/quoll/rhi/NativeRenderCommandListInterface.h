@@ -3,6 +3,7 @@
 #include "quoll/rhi/BlitRegion.h"
 #include "quoll/rhi/CopyRegion.h"
 #include "quoll/rhi/Descriptor.h"
+#include "quoll/rhi/DrawIndirectCommand.h"
 #include "quoll/rhi/Filter.h"
 #include "quoll/rhi/IndexType.h"
 #include "quoll/rhi/PipelineBarrier.h"
@@ -44,6 +45,9 @@ public:
   virtual void drawIndexed(u32 indexCount, u32 firstIndex, i32 vertexOffset,
                            u32 instanceCount, u32 firstInstance) = 0;
 
+  virtual void drawIndexedIndirect(BufferHandle buffer, u64 offset,
+                                   u32 drawCount, u32 stride) = 0;
+
   virtual void dispatch(u32 groupCountX, u32 groupCountY, u32 groupCountZ) = 0;
 
   virtual void setViewport(const glm::vec2 &offset, const glm::vec2 &size,
@@ -78,6 +78,14 @@ public:
                                           instanceCount, firstInstance);
   }
 
+  inline void drawIndexedIndirect(BufferHandle buffer, u64 offset,
+                                  u32 drawCount,
+                                  u32 stride = sizeof(
+                                      DrawIndexedIndirectCommand)) {
+    mNativeRenderCommandList->drawIndexedIndirect(buffer, offset, drawCount,
+                                                  stride);
+  }
+
   inline void dispatch(u32 groupCountX, u32 groupCountY, u32 groupCountZ) {
     mNativeRenderCommandList->dispatch(groupCountX, groupCountY, groupCountZ);
   }
@@ -12,6 +12,7 @@ enum class MockCommandType {
   PushConstants,
   Draw,
   DrawIndexed,
+  DrawIndexedIndirect,
   Dispatch,
   SetViewport,
   SetScissor,
@@ -108,6 +109,17 @@ struct MockCommandDrawIndexed
   u32 firstInstance;
 };
 
+struct MockCommandDrawIndexedIndirect
+    : public MockCommandTyped<MockCommandType::DrawIndexedIndirect> {
+  BufferHandle buffer;
+
+  u64 offset;
+
+  u32 drawCount;
+
+  u32 stride;
+};
+
 struct MockCommandDispatch
     : public MockCommandTyped<MockCommandType::Dispatch> {
   u32 groupCountX;
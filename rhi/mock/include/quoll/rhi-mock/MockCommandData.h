@@ -16,7 +16,7 @@ struct MockBindings {
   IndexType indexType = IndexType::Uint16;
 };
 
-enum class DrawCallType { Draw, DrawIndexed };
+enum class DrawCallType { Draw, DrawIndexed, DrawIndexedIndirect };
 
 struct MockDrawCall {
   MockBindings bindings;
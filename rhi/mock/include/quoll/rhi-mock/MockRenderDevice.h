@@ -18,6 +18,10 @@ public:
     return mBuffers.at(handle).get();
   }
 
+  inline bool hasBuffer(BufferHandle handle) const {
+    return mBuffers.exists(handle);
+  }
+
   inline void
   setTimestampCollectorFn(std::function<void(std::vector<u64> &)> &&fn) {
     mTimestampCollectorFn = fn;
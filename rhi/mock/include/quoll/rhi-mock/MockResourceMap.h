@@ -52,6 +52,12 @@ public:
 
   u32 getEmplaced(THandle handle) const { return mEmplacements.at(handle); }
 
+  usize size() const { return mResources.size(); }
+
+  auto begin() const { return mResources.begin(); }
+
+  auto end() const { return mResources.end(); }
+
 private:
   void incrementEmplacement(THandle handle) {
     auto it = mEmplacements.find(handle);
@@ -1,11 +1,20 @@
 #pragma once
 
 #include "quoll/rhi/NativeResourceMetrics.h"
+#include "MockBuffer.h"
+#include "MockResourceMap.h"
+#include "MockTexture.h"
 
 namespace quoll::rhi {
 
 class MockResourceMetrics : public NativeResourceMetrics {
 public:
+  using BufferMap = MockResourceMap<BufferHandle, std::unique_ptr<MockBuffer>>;
+  using TextureMap = MockResourceMap<TextureHandle, MockTexture>;
+
+public:
+  MockResourceMetrics(const BufferMap &buffers, const TextureMap &textures);
+
   usize getTotalBufferSize() const override;
 
   usize getBuffersCount() const override;
@@ -13,6 +22,10 @@ public:
   usize getTexturesCount() const override;
 
   usize getDescriptorsCount() const override;
+
+private:
+  const BufferMap &mBuffers;
+  const TextureMap &mTextures;
 };
 
 } // namespace quoll::rhi
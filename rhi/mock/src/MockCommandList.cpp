@@ -124,6 +124,22 @@ void MockCommandList::drawIndexed(u32 indexCount, u32 firstIndex,
   mDrawCalls.push_back(call);
 }
 
+void MockCommandList::drawIndexedIndirect(BufferHandle buffer, u64 offset,
+                                          u32 drawCount, u32 stride) {
+  auto *command = new MockCommandDrawIndexedIndirect;
+  command->buffer = buffer;
+  command->offset = offset;
+  command->drawCount = drawCount;
+  command->stride = stride;
+  mCommands.push_back(std::unique_ptr<MockCommand>(command));
+
+  MockDrawCall call{};
+  call.type = DrawCallType::DrawIndexedIndirect;
+  call.bindings = mBindings;
+  call.command = command;
+  mDrawCalls.push_back(call);
+}
+
 void MockCommandList::dispatch(u32 groupCountX, u32 groupCountY,
                                u32 groupCountZ) {
   auto *command = new MockCommandDispatch;
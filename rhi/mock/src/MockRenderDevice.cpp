@@ -4,7 +4,8 @@
 
 namespace quoll::rhi {
 
-MockRenderDevice::MockRenderDevice() : mDeviceStats(new MockResourceMetrics) {
+MockRenderDevice::MockRenderDevice()
+    : mDeviceStats(new MockResourceMetrics(mBuffers, mTextures)) {
   for (auto i = 0; i < NumFrames; ++i) {
     mCommandLists.at(i) = RenderCommandList(new MockCommandList);
   }
@@ -3,11 +3,24 @@
 
 namespace quoll::rhi {
 
-usize MockResourceMetrics::getTotalBufferSize() const { return 0; }
+MockResourceMetrics::MockResourceMetrics(const BufferMap &buffers,
+                                         const TextureMap &textures)
+    : mBuffers(buffers), mTextures(textures) {}
 
-usize MockResourceMetrics::getBuffersCount() const { return 0; }
+usize MockResourceMetrics::getTotalBufferSize() const {
+  usize size = 0;
+  for (const auto &[_, buffer] : mBuffers) {
+    size += buffer->getDescription().size;
+  }
 
-usize MockResourceMetrics::getTexturesCount() const { return 0; }
+  return size;
+}
+
+usize MockResourceMetrics::getBuffersCount() const { return mBuffers.size(); }
+
+usize MockResourceMetrics::getTexturesCount() const {
+  return mTextures.size();
+}
 
 usize MockResourceMetrics::getDescriptorsCount() const { return 0; }
 
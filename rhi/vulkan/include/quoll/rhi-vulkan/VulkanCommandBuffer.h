@@ -49,6 +49,9 @@ public:
   void drawIndexed(u32 indexCount, u32 firstIndex, i32 vertexOffset,
                    u32 instanceCount, u32 firstInstance) override;
 
+  void drawIndexedIndirect(BufferHandle buffer, u64 offset, u32 drawCount,
+                           u32 stride) override;
+
   void dispatch(u32 groupCountX, u32 groupCountY, u32 groupCountZ) override;
 
   void setViewport(const glm::vec2 &offset, const glm::vec2 &size,
@@ -124,6 +124,16 @@ void VulkanCommandBuffer::drawIndexed(u32 indexCount, u32 firstIndex,
   mStats.addDrawCall((indexCount / 3) * instanceCount);
 }
 
+void VulkanCommandBuffer::drawIndexedIndirect(BufferHandle buffer, u64 offset,
+                                              u32 drawCount, u32 stride) {
+  vkCmdDrawIndexedIndirect(mCommandBuffer,
+                           mRegistry.getBuffers().at(buffer)->getBuffer(),
+                           offset, drawCount, stride);
+
+  // Primitive count is only known to the device
+  mStats.addDrawCall(0);
+}
+
 void VulkanCommandBuffer::dispatch(u32 groupCountX, u32 groupCountY,
                                    u32 groupCountZ) {
   vkCmdDispatch(mCommandBuffer, groupCountX, groupCountY, groupCountZ);
@@ -81,10 +81,15 @@ VulkanDeviceObject::VulkanDeviceObject(
       VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_QUERY_RESET_FEATURES;
   queryResetFeatures.pNext = nullptr;
 
+  VkPhysicalDeviceShaderDrawParametersFeatures drawParametersFeatures{};
+  drawParametersFeatures.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_DRAW_PARAMETERS_FEATURES;
+  drawParametersFeatures.pNext = &queryResetFeatures;
+
   VkPhysicalDeviceDescriptorIndexingFeatures descriptorIndexingFeatures{};
   descriptorIndexingFeatures.sType =
       VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
-  descriptorIndexingFeatures.pNext = &queryResetFeatures;
+  descriptorIndexingFeatures.pNext = &drawParametersFeatures;
 
   VkPhysicalDeviceBufferDeviceAddressFeatures bufferDeviceAddressFeatures{};
   bufferDeviceAddressFeatures.sType =
@@ -102,6 +107,10 @@ VulkanDeviceObject::VulkanDeviceObject(
   vkGetPhysicalDeviceFeatures2(physicalDevice, &deviceFeatures);
 
   assertFeature(sync2Features.synchronization2, "Synchronization 2");
+  assertFeature(deviceFeatures.features.multiDrawIndirect,
+                "Multi draw indirect");
+  assertFeature(drawParametersFeatures.shaderDrawParameters,
+                "Shader draw parameters");
   assertFeature(bufferDeviceAddressFeatures.bufferDeviceAddress,
                 "Buffer device address > Buffer device address");
   assertFeature(descriptorIndexingFeatures.descriptorBindingPartiallyBound,
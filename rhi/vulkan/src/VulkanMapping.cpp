@@ -306,6 +306,14 @@ VkFormat VulkanMapping::getFormat(Format format) {
     return VK_FORMAT_B8G8R8A8_SRGB;
   case rhi::Format::Rgba16Float:
     return VK_FORMAT_R16G16B16A16_SFLOAT;
+  case rhi::Format::Rg16Snorm:
+    return VK_FORMAT_R16G16_SNORM;
+  case rhi::Format::Rg16Float:
+    return VK_FORMAT_R16G16_SFLOAT;
+  case rhi::Format::Rgba16Unorm:
+    return VK_FORMAT_R16G16B16A16_UNORM;
+  case rhi::Format::Rgba16Uint:
+    return VK_FORMAT_R16G16B16A16_UINT;
   case rhi::Format::Rg32Float:
     return VK_FORMAT_R32G32_SFLOAT;
   case rhi::Format::Rgb32Float:
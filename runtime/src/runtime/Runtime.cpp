@@ -61,7 +61,7 @@ void Runtime::start() {
   }
 
   SceneRenderer sceneRenderer(assetCache.getRegistry(), renderStorage,
-                              rendererAssetRegistry);
+                              rendererAssetRegistry, initialOptions);
 
   FPSCounter fpsCounter;
   MainLoop mainLoop(window, fpsCounter);
@@ -154,8 +154,11 @@ void Runtime::start() {
 
     if (renderFrame.frameIndex < std::numeric_limits<u32>::max()) {
       sceneRenderer.updateFrameData(scene.entityDatabase, scene.activeCamera,
-                                    renderFrame.frameIndex);
+                                    renderFrame.frameIndex,
+                                    &scene.spatialIndex);
       imguiRenderer.updateFrameData(renderFrame.frameIndex);
+      rendererAssetRegistry.update(renderFrame.commandList,
+                                   renderFrame.frameIndex);
 
       renderer.execute(renderFrame.commandList, renderFrame.frameIndex);
 